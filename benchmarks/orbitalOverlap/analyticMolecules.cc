@@ -0,0 +1,555 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022 The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+//
+// End-to-end regression benchmark of the population analysis (pFOP/pFHP)
+// chain S -> C -> O -> C_bar -> Hproj on analytic molecular orbitals: the
+// bonding orbital of H2 (hydrogenMoleculeBondingOrbital) and the extended
+// Hueckel orbitals of CO (assembleCO_LCAO_MOorbitals). The orbitals and
+// their atomic orbital basis are evaluated at the nodes of uniform meshes
+// with the lumped mass matrix of Gauss-Lobatto-Legendre elements, every
+// stage of the chain is timed for every mesh, and the pCOOP and pCOHP of
+// the atom pairs are checked against analytic values and against reference
+// values of the converged mesh. No DFT input is required.
+//
+// usage: analyticPopulationBenchmark [feOrder] [elementsPerDirection ...]
+//
+// The meshes cover the cube [-8, 8]^3 Bohr, the reference values are only
+// checked on the last (finest) mesh.
+//
+#include <CO_LCAO_MOorbitals.h>
+#include <atomicOrbitalBasisManager.h>
+#include <matrixmatrixmul.h>
+#include <overlapPopulationAnalysis.h>
+#include <populationProfiler.h>
+
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include "benchmarkChecks.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  //
+  // locally owned nodes of a uniform mesh of numElements^3 hexahedra with
+  // the Gauss-Lobatto-Legendre nodes of order feOrder on the cube
+  // [-halfLength, halfLength]^3, and the square roots of the lumped mass
+  // matrix, the tensor product of the assembled 1D Gauss-Lobatto weights.
+  // The nodes are numbered lexicographically and split into contiguous
+  // ranges over the ranks.
+  //
+  struct lumpedMesh
+  {
+    unsigned int                  numNodes;
+    std::vector<dealii::Point<3>> nodes;
+    std::vector<double>           sqrtMass;
+  };
+
+  lumpedMesh
+  uniformLumpedMesh(const double       halfLength,
+                    const unsigned int numElements,
+                    const unsigned int feOrder,
+                    const MPI_Comm &   mpiComm)
+  {
+    const dealii::QGaussLobatto<1>         gll(feOrder + 1);
+    std::vector<std::pair<double, double>> unitPoints;
+    for (unsigned int i = 0; i < gll.size(); ++i)
+      unitPoints.push_back({gll.point(i)[0], gll.weight(i)});
+    std::sort(unitPoints.begin(), unitPoints.end());
+
+    const unsigned int  n1D = numElements * feOrder + 1;
+    const double        h   = 2.0 * halfLength / numElements;
+    std::vector<double> x1D(n1D, 0.0), w1D(n1D, 0.0);
+    for (unsigned int e = 0; e < numElements; ++e)
+      for (unsigned int i = 0; i <= feOrder; ++i)
+        {
+          x1D[e * feOrder + i] = -halfLength + (e + unitPoints[i].first) * h;
+          w1D[e * feOrder + i] += unitPoints[i].second * h;
+        }
+
+    int thisRank, numRanks;
+    MPI_Comm_rank(mpiComm, &thisRank);
+    MPI_Comm_size(mpiComm, &numRanks);
+    lumpedMesh mesh;
+    mesh.numNodes = n1D * n1D * n1D;
+    const unsigned int nodesPerRank =
+      (mesh.numNodes + numRanks - 1) / numRanks;
+    const unsigned int nodeStart =
+      std::min(thisRank * nodesPerRank, mesh.numNodes);
+    const unsigned int nodeEnd =
+      std::min(nodeStart + nodesPerRank, mesh.numNodes);
+    for (unsigned int node = nodeStart; node < nodeEnd; ++node)
+      {
+        const unsigned int i = node / (n1D * n1D);
+        const unsigned int j = (node / n1D) % n1D;
+        const unsigned int k = node % n1D;
+        mesh.nodes.push_back(dealii::Point<3>(x1D[i], x1D[j], x1D[k]));
+        mesh.sqrtMass.push_back(std::sqrt(w1D[i] * w1D[j] * w1D[k]));
+      }
+    return mesh;
+  }
+
+  //
+  // molecular orbitals with their energies and occupations, and the atomic
+  // orbital basis they are expanded in
+  //
+  struct analyticMolecule
+  {
+    std::string                                                 name;
+    std::vector<std::function<double(const dealii::Point<3>)>> basis;
+    std::vector<unsigned int>                                   atomOfBasis;
+    unsigned int                                                numAtoms;
+    std::vector<std::function<double(const dealii::Point<3>)>> orbitals;
+    std::vector<double>                                         energies;
+    std::vector<double>                                         occupations;
+  };
+
+  //
+  // 1s Slater type orbitals of exponent 1.3 on both atoms, the bonding
+  // orbital doubly occupied at the Hartree-Fock energy of H2 (Hartree)
+  //
+  analyticMolecule
+  hydrogenMolecule()
+  {
+    analyticMolecule molecule;
+    molecule.name     = "H2";
+    molecule.numAtoms = 2;
+    const std::array<std::array<double, 3>, 2> atomPositions = {
+      {{{-0.69919867, 0.0, 0.0}}, {{0.69919867, 0.0, 0.0}}}};
+    for (unsigned int atom = 0; atom < 2; ++atom)
+      {
+        const std::array<double, 3> atomPos = atomPositions[atom];
+        molecule.basis.push_back([atomPos](const dealii::Point<3> x) {
+          return radialPartofSlaterTypeOrbitalTest(1, x, atomPos) *
+                 std::sqrt(1.0 / (4.0 * M_PI));
+        });
+        molecule.atomOfBasis.push_back(atom);
+      }
+    molecule.orbitals.push_back(hydrogenMoleculeBondingOrbital);
+    molecule.energies.push_back(-0.5945);
+    molecule.occupations.push_back(2.0);
+    return molecule;
+  }
+
+  //
+  // hydrogenic 2s, 2px, 2py, 2pz orbitals of carbon and oxygen with the
+  // positions and Slater-rule exponents of CO_LCAO_MOorbitals.cc, the eight
+  // extended Hueckel orbitals with their energies relative to the HOMO (eV)
+  //
+  analyticMolecule
+  carbonMonoxide()
+  {
+    analyticMolecule molecule;
+    molecule.name     = "CO";
+    molecule.numAtoms = 2;
+    const std::array<std::array<double, 3>, 2> atomPositions = {
+      {{{-1.06580553409, 0.0, 0.0}}, {{1.06580553409, 0.0, 0.0}}}};
+    const std::array<double, 2> zeta = {{3.25, 4.55}};
+    for (unsigned int atom = 0; atom < 2; ++atom)
+      {
+        const std::array<double, 3> atomPos = atomPositions[atom];
+        const double                z       = zeta[atom];
+        molecule.basis.push_back([atomPos, z](const dealii::Point<3> x) {
+          return hydrogenic2sOrbital(z, distance3d(x, atomPos));
+        });
+        molecule.basis.push_back([atomPos, z](const dealii::Point<3> x) {
+          return hydrogenic2pxOrbital(z,
+                                      distance3d(x, atomPos),
+                                      x[0] - atomPos[0]);
+        });
+        molecule.basis.push_back([atomPos, z](const dealii::Point<3> x) {
+          return hydrogenic2pyOrbital(z,
+                                      distance3d(x, atomPos),
+                                      x[1] - atomPos[1]);
+        });
+        molecule.basis.push_back([atomPos, z](const dealii::Point<3> x) {
+          return hydrogenic2pzOrbital(z,
+                                      distance3d(x, atomPos),
+                                      x[2] - atomPos[2]);
+        });
+        molecule.atomOfBasis.insert(molecule.atomOfBasis.end(), 4, atom);
+      }
+    std::vector<int> occupationNum;
+    assembleCO_LCAO_MOorbitals(molecule.energies,
+                               molecule.orbitals,
+                               occupationNum);
+    molecule.occupations.assign(occupationNum.begin(), occupationNum.end());
+    return molecule;
+  }
+
+  struct chainResults
+  {
+    std::vector<double> S;
+    std::vector<double> projectabilities;
+    std::vector<double> Hproj;
+    std::vector<double> atomPairPopulations;
+    std::vector<double> atomPairICOHP;
+  };
+
+  //
+  // the chain of orbitalPopulationCompute() with the canonical
+  // orthogonalization of S, Phi and Psi distributed over the mesh nodes
+  //
+  chainResults
+  runAnalyticChain(const analyticMolecule &   molecule,
+                   const lumpedMesh &         mesh,
+                   const std::string &        prefix,
+                   dftfe::populationProfiler &profiler)
+  {
+    const unsigned int nDofs  = mesh.nodes.size();
+    const unsigned int nBasis = molecule.basis.size();
+    const unsigned int nKS    = molecule.orbitals.size();
+
+    profiler.enter(prefix + "Phi and Psi evaluation");
+    std::vector<double> Phi(nDofs * nBasis), Psi(nDofs * nKS);
+    for (unsigned int dof = 0; dof < nDofs; ++dof)
+      {
+        for (unsigned int a = 0; a < nBasis; ++a)
+          Phi[dof * nBasis + a] =
+            mesh.sqrtMass[dof] * molecule.basis[a](mesh.nodes[dof]);
+        for (unsigned int j = 0; j < nKS; ++j)
+          Psi[dof * nKS + j] =
+            mesh.sqrtMass[dof] * molecule.orbitals[j](mesh.nodes[dof]);
+      }
+    // normalized with the lumped mass matrix, as the Kohn-Sham orbitals
+    std::vector<double> normsOfOrbitals(nKS, 0.0);
+    for (unsigned int dof = 0; dof < nDofs; ++dof)
+      for (unsigned int j = 0; j < nKS; ++j)
+        normsOfOrbitals[j] += Psi[dof * nKS + j] * Psi[dof * nKS + j];
+    MPI_Allreduce(MPI_IN_PLACE,
+                  &normsOfOrbitals[0],
+                  nKS,
+                  MPI_DOUBLE,
+                  MPI_SUM,
+                  MPI_COMM_WORLD);
+    for (unsigned int dof = 0; dof < nDofs; ++dof)
+      for (unsigned int j = 0; j < nKS; ++j)
+        Psi[dof * nKS + j] /= std::sqrt(normsOfOrbitals[j]);
+    profiler.leave(prefix + "Phi and Psi evaluation");
+
+    profiler.enter(prefix + "S and Phi^T Psi");
+    std::vector<double> buffer(nBasis * nBasis + nBasis * nKS, 0.0);
+    if (nDofs > 0)
+      {
+        const std::vector<double> localS =
+          matrixTmatrixmul(Phi, nDofs, nBasis, Phi, nDofs, nBasis);
+        const std::vector<double> localPhiTPsi =
+          matrixTmatrixmul(Phi, nDofs, nBasis, Psi, nDofs, nKS);
+        std::copy(localS.begin(), localS.end(), buffer.begin());
+        std::copy(localPhiTPsi.begin(),
+                  localPhiTPsi.end(),
+                  buffer.begin() + nBasis * nBasis);
+      }
+    MPI_Allreduce(MPI_IN_PLACE,
+                  &buffer[0],
+                  buffer.size(),
+                  MPI_DOUBLE,
+                  MPI_SUM,
+                  MPI_COMM_WORLD);
+    profiler.leave(prefix + "S and Phi^T Psi");
+    profiler.addFlops(prefix + "S and Phi^T Psi",
+                      dftfe::populationProfiler::gemmFlops(nBasis,
+                                                           nBasis + nKS,
+                                                           nDofs));
+
+    chainResults results;
+    results.S.assign(buffer.begin(), buffer.begin() + nBasis * nBasis);
+    const std::vector<double> PhiTPsi(buffer.begin() + nBasis * nBasis,
+                                      buffer.end());
+
+    profiler.enter(prefix + "S diagonalization");
+    std::vector<double> D(nBasis, 0.0);
+    std::vector<double> U = diagonalization(results.S, nBasis, D);
+    profiler.leave(prefix + "S diagonalization");
+
+    profiler.enter(prefix + "Canonical orthogonalization");
+    std::vector<double> Ut = TransposeMatrix(U, nBasis);
+    std::vector<double> X, Uk;
+    const unsigned int  k =
+      canonicalOrthogonalization(D, Ut, nBasis, 1e-8, X, Uk);
+    profiler.leave(prefix + "Canonical orthogonalization");
+
+    profiler.enter(prefix + "C computation");
+    const std::vector<double> C =
+      matrixTmatrixmul(X, nBasis, k, PhiTPsi, nBasis, nKS);
+    profiler.leave(prefix + "C computation");
+
+    profiler.enter(prefix + "O computation");
+    std::vector<double> O = matrixTmatrixmul(C, k, nKS, C, k, nKS);
+    profiler.leave(prefix + "O computation");
+    results.projectabilities.resize(nKS);
+    for (unsigned int j = 0; j < nKS; ++j)
+      results.projectabilities[j] = O[j * nKS + j];
+
+    profiler.enter(prefix + "O diagonalization");
+    std::vector<double> D_O(nKS, 0.0);
+    std::vector<double> U_O = diagonalization(O, nKS, D_O);
+    profiler.leave(prefix + "O diagonalization");
+
+    profiler.enter(prefix + "O^-1/2");
+    std::vector<double>       U_Ot = TransposeMatrix(U_O, nKS);
+    const std::vector<double> Ominushalf =
+      powerOfMatrix(-0.5, D_O, U_Ot, nKS, U_Ot);
+    profiler.leave(prefix + "O^-1/2");
+
+    profiler.enter(prefix + "C_bar computation");
+    const std::vector<double> reducedC_bar =
+      matrixmatrixmul(C, k, nKS, Ominushalf, nKS, nKS);
+    const std::vector<double> C_bar =
+      matrixmatrixmul(X, nBasis, k, reducedC_bar, k, nKS);
+    profiler.leave(prefix + "C_bar computation");
+
+    profiler.enter(prefix + "C_hat computation");
+    std::vector<double> C_hat =
+      matrixmatrixmul(Uk, nBasis, k, reducedC_bar, k, nKS);
+    profiler.leave(prefix + "C_hat computation");
+
+    profiler.enter(prefix + "Hproj computation");
+    std::vector<double> energies(molecule.energies);
+    results.Hproj = computeHprojOrbital(C_hat, C_hat, nBasis, nKS, energies);
+    profiler.leave(prefix + "Hproj computation");
+
+    profiler.enter(prefix + "Atom pair populations");
+    const unsigned int numAtoms = molecule.numAtoms;
+    results.atomPairPopulations.assign(numAtoms * numAtoms, 0.0);
+    results.atomPairICOHP.assign(numAtoms * numAtoms, 0.0);
+    accumulateAtomPairContractions(C_bar,
+                                   results.S,
+                                   molecule.occupations,
+                                   nBasis,
+                                   nKS,
+                                   molecule.atomOfBasis,
+                                   numAtoms,
+                                   1.0,
+                                   results.atomPairPopulations);
+    accumulateAtomPairContractions(C_hat,
+                                   results.Hproj,
+                                   molecule.occupations,
+                                   nBasis,
+                                   nKS,
+                                   molecule.atomOfBasis,
+                                   numAtoms,
+                                   1.0,
+                                   results.atomPairICOHP);
+    profiler.leave(prefix + "Atom pair populations");
+    return results;
+  }
+
+  //
+  // H2: the bonding orbital lies in the span of the basis and both atoms
+  // are equivalent, so for the overlap s of the mesh the gross populations
+  // are 1, the bond order 2 s / (1 + s) and the bond ICOHP the orbital
+  // energy. s converges to the analytic overlap of the 1s orbitals.
+  //
+  void
+  checkHydrogenMolecule(const chainResults &        results,
+                        const bool                  isFinestMesh,
+                        benchmarkChecks &           checks,
+                        dealii::ConditionalOStream &pcout)
+  {
+    const double s = results.S[1] / std::sqrt(results.S[0] * results.S[3]);
+    const std::vector<double> &P = results.atomPairPopulations;
+    const std::vector<double> &H = results.atomPairICOHP;
+    pcout << "  H2 overlap " << s << ", bond order " << P[1] + P[2]
+          << ", bond ICOHP " << H[1] + H[2] << " Ha" << std::endl;
+
+    checks.check("H2 projectability",
+                 std::abs(results.projectabilities[0] - 1.0),
+                 1e-10,
+                 pcout);
+    checks.check("H2 gross populations",
+                 std::max(std::abs(P[0] + P[1] - 1.0),
+                          std::abs(P[2] + P[3] - 1.0)),
+                 1e-10,
+                 pcout);
+    checks.check("H2 bond order 2 s / (1 + s)",
+                 std::abs(P[1] + P[2] - 2.0 * s / (1.0 + s)),
+                 1e-10,
+                 pcout);
+    checks.check("H2 bond ICOHP", std::abs(H[1] + H[2] + 0.5945), 1e-10, pcout);
+
+    if (isFinestMesh)
+      {
+        // e^{-zR} (1 + zR + (zR)^2 / 3) for z = 1.3, R = 1.39839734
+        const double analyticOverlap = 0.63634108;
+        checks.check("H2 overlap vs analytic",
+                     std::abs(s - analyticOverlap),
+                     1e-3,
+                     pcout);
+        checks.check("H2 bond order vs analytic",
+                     std::abs(P[1] + P[2] -
+                              2.0 * analyticOverlap / (1.0 + analyticOverlap)),
+                     1e-3,
+                     pcout);
+      }
+  }
+
+  //
+  // CO: the eight orbitals span the basis, so they are fully projectable,
+  // Hproj has the orbital energies as eigenvalues and the pCOOP and pCOHP
+  // summed over the atom pairs give the number of electrons and the band
+  // energy. The Mulliken charge of carbon, the bond order and the bond ICOHP
+  // are compared with the values of the converged mesh.
+  //
+  void
+  checkCarbonMonoxide(const chainResults &        results,
+                      const analyticMolecule &    molecule,
+                      const bool                  isFinestMesh,
+                      benchmarkChecks &           checks,
+                      dealii::ConditionalOStream &pcout)
+  {
+    const unsigned int         nKS = molecule.orbitals.size();
+    const std::vector<double> &P   = results.atomPairPopulations;
+    const std::vector<double> &H   = results.atomPairICOHP;
+    const double               carbonCharge = 4.0 - (P[0] + P[1]);
+    pcout << "  CO Mulliken charge of C " << carbonCharge << ", bond order "
+          << P[1] + P[2] << ", bond ICOHP " << H[1] + H[2] << " eV"
+          << std::endl;
+
+    double projectabilityError = 0.0, numElectrons = 0.0, bandEnergy = 0.0;
+    for (unsigned int j = 0; j < nKS; ++j)
+      {
+        projectabilityError =
+          std::max(projectabilityError,
+                   std::abs(results.projectabilities[j] - 1.0));
+        numElectrons += molecule.occupations[j];
+        bandEnergy += molecule.occupations[j] * molecule.energies[j];
+      }
+    checks.check("CO projectabilities", projectabilityError, 1e-10, pcout);
+    checks.check("CO pCOOP sum to the electrons",
+                 std::abs(P[0] + P[1] + P[2] + P[3] - numElectrons),
+                 1e-10,
+                 pcout);
+    checks.check("CO pCOHP sum to the band energy",
+                 std::abs(H[0] + H[1] + H[2] + H[3] - bandEnergy) /
+                   std::abs(bandEnergy),
+                 1e-10,
+                 pcout);
+
+    std::vector<double> Hproj(results.Hproj);
+    std::vector<double> eigenValuesOfHproj(nKS, 0.0);
+    diagonalization(Hproj, nKS, eigenValuesOfHproj);
+    std::vector<double> energies(molecule.energies);
+    std::sort(energies.begin(), energies.end());
+    checks.check("CO eigenvalues of Hproj",
+                 relativeMaxDifference(eigenValuesOfHproj, energies),
+                 1e-10,
+                 pcout);
+
+    //
+    // values of the meshes with 24^3 and 32^3 elements of order 4 and 6, the
+    // bond order carries the large cancellations of the Mulliken overlap
+    // populations in this basis and is the least converged
+    //
+    if (isFinestMesh)
+      {
+        checks.check("CO Mulliken charge of C vs converged mesh",
+                     std::abs(carbonCharge - 1.7879),
+                     1e-3,
+                     pcout);
+        checks.check("CO bond order vs converged mesh",
+                     std::abs(P[1] + P[2] + 6.08),
+                     2e-2,
+                     pcout);
+        checks.check("CO bond ICOHP vs converged mesh",
+                     std::abs(H[1] + H[2] + 14.2746),
+                     1e-2,
+                     pcout);
+      }
+  }
+} // namespace
+
+
+
+int
+main(int argc, char *argv[])
+{
+  MPI_Init(&argc, &argv);
+  int thisRank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+  dealii::ConditionalOStream pcout(std::cout, thisRank == 0);
+
+  const unsigned int        feOrder = argc > 1 ? std::atoi(argv[1]) : 4;
+  std::vector<unsigned int> elementsPerDirection;
+  for (int i = 2; i < argc; ++i)
+    elementsPerDirection.push_back(std::atoi(argv[i]));
+  if (elementsPerDirection.empty())
+    elementsPerDirection = {8, 12, 16};
+
+  if (feOrder < 1 || *std::min_element(elementsPerDirection.begin(),
+                                       elementsPerDirection.end()) < 1)
+    {
+      pcout << "Invalid mesh: require feOrder >= 1 and at least one element "
+               "per direction"
+            << std::endl;
+      MPI_Finalize();
+      return 1;
+    }
+
+  dftfe::populationProfiler profiler(MPI_COMM_WORLD);
+  benchmarkChecks           checks;
+  const analyticMolecule    h2 = hydrogenMolecule();
+  const analyticMolecule    co = carbonMonoxide();
+  for (unsigned int iMesh = 0; iMesh < elementsPerDirection.size(); ++iMesh)
+    {
+      const lumpedMesh mesh = uniformLumpedMesh(8.0,
+                                                elementsPerDirection[iMesh],
+                                                feOrder,
+                                                MPI_COMM_WORLD);
+      const bool isFinestMesh = iMesh + 1 == elementsPerDirection.size();
+      const std::string meshName = std::to_string(mesh.numNodes) + " nodes: ";
+      pcout << std::endl
+            << "Mesh of " << elementsPerDirection[iMesh]
+            << "^3 elements of order " << feOrder << ", " << mesh.numNodes
+            << " nodes" << std::endl;
+
+      checkHydrogenMolecule(
+        runAnalyticChain(h2, mesh, h2.name + " " + meshName, profiler),
+        isFinestMesh,
+        checks,
+        pcout);
+      checkCarbonMonoxide(
+        runAnalyticChain(co, mesh, co.name + " " + meshName, profiler),
+        co,
+        isFinestMesh,
+        checks,
+        pcout);
+    }
+
+  profiler.writeReport("analyticPopulationBenchmark.json", pcout);
+
+  int failed = checks.passed ? 0 : 1;
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  pcout << std::endl
+        << (failed ? "Analytic population checks FAILED" :
+                     "Analytic population checks PASSED")
+        << std::endl;
+
+  MPI_Finalize();
+  return failed;
+}
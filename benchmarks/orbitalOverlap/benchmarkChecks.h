@@ -0,0 +1,68 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022 The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+//
+// pass/fail bookkeeping shared by the orbital overlap benchmarks
+//
+
+#ifndef benchmarkChecks_H_
+#define benchmarkChecks_H_
+
+#include <deal.II/base/conditional_ostream.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+  //
+  // max_{ij} |A_{ij} - B_{ij}| / max(1, max_{ij} |B_{ij}|)
+  //
+  template <typename T>
+  double
+  relativeMaxDifference(const std::vector<T> &A, const std::vector<T> &B)
+  {
+    double maxError = 0.0, maxAbs = 1.0;
+    for (unsigned int i = 0; i < A.size(); ++i)
+      {
+        maxError = std::max(maxError, std::abs(A[i] - B[i]));
+        maxAbs   = std::max(maxAbs, std::abs(B[i]));
+      }
+    return maxError / maxAbs;
+  }
+
+  struct benchmarkChecks
+  {
+    bool passed = true;
+
+    void
+    check(const std::string &         name,
+          const double                error,
+          const double                tolerance,
+          dealii::ConditionalOStream &pcout)
+    {
+      const bool ok = error <= tolerance;
+      pcout << "  " << (ok ? "PASSED " : "FAILED ") << name
+            << ": error = " << error << " (tolerance " << tolerance << ")"
+            << std::endl;
+      passed = passed && ok;
+    }
+  };
+} // namespace
+#endif
@@ -0,0 +1,1142 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022 The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+//
+// Standalone benchmark and regression check of the orbital overlap kernels
+// used by the population analysis (pFOP/pFHP) pipeline. Synthetic Phi
+// (atomic orbitals at FE nodes) and Psi (Kohn-Sham orbitals at FE nodes)
+// are generated, every stage of the chain is timed for the real and the
+// complex kernels, and the results are checked against naive loops or
+// exact algebraic invariants. No DFT input is required. The spatial
+// structures and the output writers of the population analysis are checked
+// by populationSpatialChecks and populationOutputChecks.
+//
+// usage: populationKernelsBenchmark [nDofs] [nBasis] [nKS] [sparsity]
+//                                   [repeats]
+//
+// sparsity is the fraction of FE nodes outside the support of each atomic
+// orbital, mimicking the radial cutoff of the basis.
+//
+
+#include <cachedPopulationProjection.h>
+#include <cellQuadratureOverlapProjection.h>
+#include <dosBroadening.h>
+#include <incrementalProjection.h>
+#include <matrixmatrixmul.h>
+#include <overlapPopulationAnalysis.h>
+#include <pipelinedOverlapProjection.h>
+#include <populationProfiler.h>
+
+#include <deal.II/base/conditional_ostream.h>
+
+#include "benchmarkChecks.h"
+#include "syntheticOrbitals.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+  template <typename T>
+  void
+  runPopulationChain(const unsigned int          nDofs,
+                     const unsigned int          nBasis,
+                     const unsigned int          nKS,
+                     const double                sparsity,
+                     const unsigned int          repeats,
+                     dftfe::populationProfiler & profiler,
+                     benchmarkChecks &           checks,
+                     dealii::ConditionalOStream &pcout)
+  {
+    const bool        isComplex = !std::is_same<T, double>::value;
+    const std::string prefix    = isComplex ? "complex " : "real ";
+    std::mt19937      generator(42);
+
+    const std::vector<T> Phi =
+      syntheticOrbitalMatrix<T>(nDofs, nBasis, sparsity, generator);
+    const std::vector<T> Psi = syntheticDenseMatrix<T>(nDofs, nKS, generator);
+
+    std::vector<double> eigenValues(nKS), occupationNum(nKS, 0.0);
+    for (unsigned int i = 0; i < nKS; ++i)
+      {
+        eigenValues[i]   = -1.0 + 2.0 * i / nKS;
+        occupationNum[i] = i < nKS / 2 ? 1.0 : 0.0;
+      }
+
+    pcout << std::endl
+          << (isComplex ? "Complex" : "Real") << " kernels: nDofs = " << nDofs
+          << ", nBasis = " << nBasis << ", nKS = " << nKS
+          << ", sparsity = " << sparsity << ", memory of Phi and Psi = "
+          << sizeof(T) * (Phi.size() + Psi.size()) / (1024.0 * 1024.0)
+          << " MB" << std::endl;
+
+    for (unsigned int iRepeat = 0; iRepeat < repeats; ++iRepeat)
+      {
+        profiler.enter(prefix + "S = Phi^H Phi");
+        const std::vector<T> Spacked = selfMatrixTmatrixmul(Phi, nDofs, nBasis);
+        profiler.leave(prefix + "S = Phi^H Phi");
+        profiler.addFlops(prefix + "S = Phi^H Phi",
+                          dftfe::populationProfiler::gemmFlops(
+                            nBasis, nBasis, nDofs, isComplex));
+        profiler.addBytes(prefix + "S = Phi^H Phi",
+                          dftfe::populationProfiler::gemmBytes(
+                            nBasis, nBasis, nDofs, isComplex));
+        std::vector<T> S = fullOverlapMatrix(Spacked, nBasis);
+
+        profiler.enter(prefix + "Phi^H Psi");
+        const std::vector<T> PhiTPsi =
+          matrixTmatrixmul(Phi, nDofs, nBasis, Psi, nDofs, nKS);
+        profiler.leave(prefix + "Phi^H Psi");
+        profiler.addFlops(prefix + "Phi^H Psi",
+                          dftfe::populationProfiler::gemmFlops(
+                            nBasis, nKS, nDofs, isComplex));
+        profiler.addBytes(prefix + "Phi^H Psi",
+                          dftfe::populationProfiler::gemmBytes(
+                            nBasis, nKS, nDofs, isComplex));
+
+        std::vector<double> D(nBasis, 0.0);
+        profiler.enter(prefix + "S diagonalization");
+        std::vector<T> U = diagonalization(S, nBasis, D);
+        profiler.leave(prefix + "S diagonalization");
+
+        profiler.enter(prefix + "S powers");
+        std::vector<T>       Ut    = TransposeMatrix(U, nBasis);
+        const std::vector<T> invS  = powerOfMatrix(-1, D, Ut, nBasis, Ut);
+        const std::vector<T> Shalf = powerOfMatrix(0.5, D, Ut, nBasis, Ut);
+        profiler.leave(prefix + "S powers");
+        profiler.addFlops(prefix + "S powers",
+                          2 * dftfe::populationProfiler::gemmFlops(
+                                nBasis, nBasis, nBasis, isComplex));
+
+        profiler.enter(prefix + "C = S^-1 Phi^H Psi");
+        const std::vector<T> C =
+          matrixmatrixmul(invS, nBasis, nBasis, PhiTPsi, nBasis, nKS);
+        profiler.leave(prefix + "C = S^-1 Phi^H Psi");
+        profiler.addFlops(prefix + "C = S^-1 Phi^H Psi",
+                          dftfe::populationProfiler::gemmFlops(
+                            nBasis, nKS, nBasis, isComplex));
+
+        profiler.enter(prefix + "O = C^H S C");
+        const std::vector<T> B =
+          matrixTmatrixmul(C, nBasis, nKS, S, nBasis, nBasis);
+        std::vector<T> O = matrixmatrixmul(B, nKS, nBasis, C, nBasis, nKS);
+        profiler.leave(prefix + "O = C^H S C");
+        profiler.addFlops(
+          prefix + "O = C^H S C",
+          dftfe::populationProfiler::gemmFlops(nKS,
+                                               nBasis,
+                                               nBasis,
+                                               isComplex) +
+            dftfe::populationProfiler::gemmFlops(nKS,
+                                                 nKS,
+                                                 nBasis,
+                                                 isComplex));
+
+        std::vector<double> D_O(nKS, 0.0);
+        profiler.enter(prefix + "O diagonalization");
+        std::vector<T> U_O = diagonalization(O, nKS, D_O);
+        profiler.leave(prefix + "O diagonalization");
+
+        profiler.enter(prefix + "O^-1/2");
+        std::vector<T>       U_Ot       = TransposeMatrix(U_O, nKS);
+        const std::vector<T> Ominushalf =
+          powerOfMatrix(-0.5, D_O, U_Ot, nKS, U_Ot);
+        profiler.leave(prefix + "O^-1/2");
+        profiler.addFlops(prefix + "O^-1/2",
+                          dftfe::populationProfiler::gemmFlops(nKS,
+                                                               nKS,
+                                                               nKS,
+                                                               isComplex));
+
+        profiler.enter(prefix + "C_bar = C O^-1/2");
+        std::vector<T> C_bar =
+          matrixmatrixmul(C, nBasis, nKS, Ominushalf, nKS, nKS);
+        profiler.leave(prefix + "C_bar = C O^-1/2");
+        profiler.addFlops(prefix + "C_bar = C O^-1/2",
+                          dftfe::populationProfiler::gemmFlops(nBasis,
+                                                               nKS,
+                                                               nKS,
+                                                               isComplex));
+
+        profiler.enter(prefix + "C_hat = S^1/2 C_bar");
+        std::vector<T> C_hat =
+          matrixmatrixmul(Shalf, nBasis, nBasis, C_bar, nBasis, nKS);
+        profiler.leave(prefix + "C_hat = S^1/2 C_bar");
+        profiler.addFlops(prefix + "C_hat = S^1/2 C_bar",
+                          dftfe::populationProfiler::gemmFlops(
+                            nBasis, nKS, nBasis, isComplex));
+
+        profiler.enter(prefix + "Hproj");
+        const std::vector<T> Hproj =
+          computeHprojOrbital(C_hat, C_hat, nBasis, nKS, eigenValues);
+        profiler.leave(prefix + "Hproj");
+        profiler.addFlops(prefix + "Hproj",
+                          dftfe::populationProfiler::gemmFlops(
+                            nBasis, nBasis, nKS, isComplex));
+
+        profiler.enter(prefix + "canonical C_hat");
+        std::vector<T>     X, Uk;
+        const unsigned int reducedDim =
+          canonicalOrthogonalization(D, Ut, nBasis, 0.0, X, Uk);
+        const std::vector<T> reducedC =
+          matrixTmatrixmul(X, nBasis, reducedDim, PhiTPsi, nBasis, nKS);
+        std::vector<T> reducedO = matrixTmatrixmul(
+          reducedC, reducedDim, nKS, reducedC, reducedDim, nKS);
+        std::vector<double> reducedD_O(nKS, 0.0);
+        std::vector<T>      reducedU_O =
+          diagonalization(reducedO, nKS, reducedD_O);
+        std::vector<T>       reducedU_Ot = TransposeMatrix(reducedU_O, nKS);
+        const std::vector<T> reducedOminushalf =
+          powerOfMatrix(-0.5, reducedD_O, reducedU_Ot, nKS, reducedU_Ot);
+        const std::vector<T> reducedC_bar = matrixmatrixmul(
+          reducedC, reducedDim, nKS, reducedOminushalf, nKS, nKS);
+        const std::vector<T> canonicalC_hat = matrixmatrixmul(
+          Uk, nBasis, reducedDim, reducedC_bar, reducedDim, nKS);
+        profiler.leave(prefix + "canonical C_hat");
+        profiler.addFlops(
+          prefix + "canonical C_hat",
+          dftfe::populationProfiler::gemmFlops(reducedDim,
+                                               nKS,
+                                               nBasis,
+                                               isComplex) +
+            dftfe::populationProfiler::gemmFlops(nKS,
+                                                 nKS,
+                                                 reducedDim,
+                                                 isComplex) +
+            2 * dftfe::populationProfiler::gemmFlops(
+                  nBasis, nKS, reducedDim, isComplex));
+
+        profiler.enter(prefix + "spill factors");
+        const spillFactors spill = spillFactorsofProjectionwithCS(
+          C, Spacked, occupationNum, nBasis, nKS, nBasis, nBasis);
+        profiler.leave(prefix + "spill factors");
+
+        profiler.enter(prefix + "projectabilities");
+        const std::vector<double> projectabilities =
+          projectabilitiesOfProjection(C, PhiTPsi, nBasis, nKS, MPI_COMM_WORLD);
+        const spillFactors spillFromProjectabilities =
+          spillFactorsFromProjectabilities(projectabilities, occupationNum);
+        profiler.leave(prefix + "projectabilities");
+        profiler.addFlops(prefix + "projectabilities",
+                          (isComplex ? 8.0 : 2.0) * nBasis * nKS);
+
+        if (iRepeat > 0)
+          continue;
+
+        //
+        // checks against naive references and exact invariants, done once
+        //
+        checks.check(prefix + "S vs naive Phi^H Phi",
+                     sampledMatrixTmatrixError(
+                       Phi, nBasis, Phi, nBasis, nDofs, S, generator),
+                     1e-10,
+                     pcout);
+        checks.check(prefix + "Phi^H Psi vs naive",
+                     sampledMatrixTmatrixError(
+                       Phi, nBasis, Psi, nKS, nDofs, PhiTPsi, generator),
+                     1e-10,
+                     pcout);
+        checks.check(prefix + "S^-1 S = I",
+                     relativeMaxDifference(
+                       matrixmatrixmul(
+                         invS, nBasis, nBasis, S, nBasis, nBasis),
+                       identityMatrix<T>(nBasis)),
+                     1e-6,
+                     pcout);
+        checks.check(
+          prefix + "S^1/2 S^1/2 = S",
+          relativeMaxDifference(
+            matrixmatrixmul(Shalf, nBasis, nBasis, Shalf, nBasis, nBasis), S),
+          1e-8,
+          pcout);
+
+        const std::vector<T> SC_bar =
+          matrixmatrixmul(S, nBasis, nBasis, C_bar, nBasis, nKS);
+        checks.check(prefix + "C_bar^H S C_bar = I",
+                     relativeMaxDifference(
+                       matrixTmatrixmul(
+                         C_bar, nBasis, nKS, SC_bar, nBasis, nKS),
+                       identityMatrix<T>(nKS)),
+                     1e-6,
+                     pcout);
+        checks.check(prefix + "C_hat^H C_hat = I",
+                     relativeMaxDifference(
+                       matrixTmatrixmul(C_hat, nBasis, nKS, C_hat, nBasis, nKS),
+                       identityMatrix<T>(nKS)),
+                     1e-6,
+                     pcout);
+
+        double hprojError = 0.0, hprojMax = 1.0;
+        for (unsigned int a = 0; a < nBasis; ++a)
+          for (unsigned int b = 0; b < nBasis; ++b)
+            {
+              T reference = T(0.0);
+              for (unsigned int r = 0; r < nKS; ++r)
+                reference += C_hat[a * nKS + r] * eigenValues[r] *
+                             conjugate(C_hat[b * nKS + r]);
+              hprojError =
+                std::max(hprojError,
+                         std::abs(reference - Hproj[a * nBasis + b]));
+              hprojMax   = std::max(hprojMax, std::abs(reference));
+            }
+        checks.check(prefix + "Hproj vs naive C_hat E C_hat^H",
+                     hprojError / hprojMax,
+                     1e-10,
+                     pcout);
+
+        double spillError = 0.0;
+        for (unsigned int i = 0; i < nKS; ++i)
+          spillError = std::max(spillError,
+                                std::abs(spill.projectabilities[i] -
+                                         std::real(O[i * nKS + i])));
+        checks.check(prefix + "projectabilities = diag(C^H S C)",
+                     spillError,
+                     1e-10,
+                     pcout);
+
+        double projectabilitiesError = 0.0;
+        for (unsigned int i = 0; i < nKS; ++i)
+          projectabilitiesError =
+            std::max(projectabilitiesError,
+                     std::abs(projectabilities[i] -
+                              std::real(O[i * nKS + i])));
+        checks.check(prefix + "distributed projectabilities = diag(O)",
+                     projectabilitiesError,
+                     1e-10,
+                     pcout);
+        checks.check(prefix + "canonical C_hat = S^1/2 C O^-1/2",
+                     relativeMaxDifference(canonicalC_hat, C_hat),
+                     1e-8,
+                     pcout);
+
+        const std::vector<T> lowdinCoeffs =
+          matrixmatrixmul(Uk, nBasis, reducedDim, reducedC, reducedDim, nKS);
+        const std::vector<T> coeffsOfBasis =
+          matrixmatrixmul(X, nBasis, reducedDim, reducedC, reducedDim, nKS);
+        const std::vector<double> lowdinWeights =
+          orbitalWeightsOfProjection(lowdinCoeffs, lowdinCoeffs, nBasis, nKS);
+        const std::vector<T> SCoeffsOfBasis =
+          matrixmatrixmul(S, nBasis, nBasis, coeffsOfBasis, nBasis, nKS);
+        const std::vector<double> mullikenWeights =
+          orbitalWeightsOfProjection(coeffsOfBasis, SCoeffsOfBasis, nBasis, nKS);
+        double weightsError = 0.0;
+        for (unsigned int i = 0; i < nKS; ++i)
+          {
+            double lowdinSum = 0.0, mullikenSum = 0.0;
+            for (unsigned int a = 0; a < nBasis; ++a)
+              {
+                lowdinSum += lowdinWeights[a * nKS + i];
+                mullikenSum += mullikenWeights[a * nKS + i];
+              }
+            weightsError =
+              std::max(weightsError,
+                       std::max(std::abs(lowdinSum - projectabilities[i]),
+                                std::abs(mullikenSum - projectabilities[i])));
+          }
+        checks.check(prefix +
+                       "Loewdin/Mulliken weights sum to projectabilities",
+                     weightsError,
+                     1e-10,
+                     pcout);
+
+        //
+        // the broadened weights integrate to the weighted sum of the weights,
+        // the grid covers the truncated Lorentzians (100 widths) of all
+        // levels
+        //
+        const double sigma = 0.01, intervalSize = 0.001;
+        const double lowerBound =
+          *std::min_element(eigenValues.begin(), eigenValues.end()) - 1.5;
+        const unsigned int numIntervals =
+          std::ceil((*std::max_element(eigenValues.begin(), eigenValues.end()) +
+                     1.5 - lowerBound) /
+                    intervalSize);
+        const dftfe::dosBroadening broadening(
+          dftfe::dosBroadening::kernelType::lorentzian,
+          sigma,
+          0,
+          0.0,
+          lowerBound,
+          intervalSize,
+          numIntervals);
+        std::vector<double> pdos(nBasis * numIntervals, 0.0);
+        broadening.accumulate(eigenValues, lowdinWeights, nBasis, 0.5, pdos);
+        double pdosError = 0.0;
+        for (unsigned int a = 0; a < nBasis; ++a)
+          {
+            double integral = 0.0, reference = 0.0;
+            for (unsigned int e = 0; e < numIntervals; ++e)
+              integral += pdos[a * numIntervals + e] * intervalSize;
+            for (unsigned int i = 0; i < nKS; ++i)
+              reference += 0.5 * lowdinWeights[a * nKS + i];
+            pdosError = std::max(pdosError,
+                                 std::abs(integral - reference) /
+                                   std::max(reference, 1e-12));
+          }
+        checks.check(prefix + "broadened weights integrate to the weights",
+                     pdosError,
+                     1e-3,
+                     pcout);
+
+        checks.check(prefix + "spill factors from projectabilities",
+                     std::abs(spillFromProjectabilities.totalSpilling -
+                              spill.totalSpilling) +
+                       std::abs(spillFromProjectabilities.chargeSpilling -
+                                spill.chargeSpilling),
+                     1e-10,
+                     pcout);
+
+        //
+        // the atom pair populations sum to tr(P S) = sum_j f_j and the
+        // atom pair ICOHP to tr(P Hproj) = sum_j f_j e_j, for the basis
+        // functions distributed over a few synthetic atoms
+        //
+        const unsigned int        numAtoms = std::min(nBasis, 4u);
+        std::vector<unsigned int> atomOfBasis(nBasis);
+        for (unsigned int a = 0; a < nBasis; ++a)
+          atomOfBasis[a] = a * numAtoms / nBasis;
+        std::vector<double> pairPopulations(numAtoms * numAtoms, 0.0),
+          pairICOHP(numAtoms * numAtoms, 0.0);
+        accumulateAtomPairContractions(C_bar,
+                                       S,
+                                       occupationNum,
+                                       nBasis,
+                                       nKS,
+                                       atomOfBasis,
+                                       numAtoms,
+                                       2.0,
+                                       pairPopulations);
+        accumulateAtomPairContractions(C_hat,
+                                       Hproj,
+                                       occupationNum,
+                                       nBasis,
+                                       nKS,
+                                       atomOfBasis,
+                                       numAtoms,
+                                       2.0,
+                                       pairICOHP);
+        double numElectrons = 0.0, bandEnergy = 0.0, populationSum = 0.0,
+               icohpSum = 0.0, pairAsymmetry = 0.0;
+        for (unsigned int i = 0; i < nKS; ++i)
+          {
+            numElectrons += 2.0 * occupationNum[i];
+            bandEnergy += 2.0 * occupationNum[i] * eigenValues[i];
+          }
+        for (unsigned int A = 0; A < numAtoms; ++A)
+          for (unsigned int B = 0; B < numAtoms; ++B)
+            {
+              populationSum += pairPopulations[A * numAtoms + B];
+              icohpSum += pairICOHP[A * numAtoms + B];
+              pairAsymmetry =
+                std::max(pairAsymmetry,
+                         std::abs(pairPopulations[A * numAtoms + B] -
+                                  pairPopulations[B * numAtoms + A]));
+            }
+        checks.check(prefix + "atom pair populations sum to sum_j f_j",
+                     std::abs(populationSum - numElectrons) / numElectrons +
+                       pairAsymmetry,
+                     1e-8,
+                     pcout);
+        checks.check(prefix + "atom pair ICOHP sum to sum_j f_j e_j",
+                     std::abs(icohpSum - bandEnergy) /
+                       std::max(std::abs(bandEnergy), 1.0),
+                     1e-8,
+                     pcout);
+      }
+  }
+
+  //
+  // appends a near copy of the first basis function to Phi, which leaves an
+  // overlap eigenvalue of the order of the perturbation squared. With the
+  // canonical orthogonalization the offending direction is discarded and
+  // the projection is that of the well conditioned basis.
+  //
+  template <typename T>
+  void
+  runLinearDependenceCheck(const unsigned int          nDofs,
+                           const unsigned int          nBasis,
+                           const unsigned int          nKS,
+                           const double                sparsity,
+                           benchmarkChecks &           checks,
+                           dealii::ConditionalOStream &pcout)
+  {
+    const bool        isComplex = !std::is_same<T, double>::value;
+    const std::string prefix    = isComplex ? "complex " : "real ";
+    std::mt19937      generator(7);
+
+    const std::vector<T> Phi =
+      syntheticOrbitalMatrix<T>(nDofs, nBasis, sparsity, generator);
+    const std::vector<T> Psi = syntheticDenseMatrix<T>(nDofs, nKS, generator);
+
+    const unsigned int nBasisDependent = nBasis + 1;
+    std::vector<T>     PhiDependent(nDofs * nBasisDependent);
+    for (unsigned int dof = 0; dof < nDofs; ++dof)
+      {
+        for (unsigned int i = 0; i < nBasis; ++i)
+          PhiDependent[dof * nBasisDependent + i] = Phi[dof * nBasis + i];
+        T perturbation;
+        randomEntry(generator, perturbation);
+        PhiDependent[dof * nBasisDependent + nBasis] =
+          Phi[dof * nBasis] + 1e-9 * perturbation;
+      }
+
+    auto projectabilities = [&](const std::vector<T> &basis,
+                                const unsigned int    n,
+                                unsigned int &        reducedDim) {
+      std::vector<T> S =
+        fullOverlapMatrix(selfMatrixTmatrixmul(basis, nDofs, n), n);
+      const std::vector<T> PhiTPsi =
+        matrixTmatrixmul(basis, nDofs, n, Psi, nDofs, nKS);
+      std::vector<double> D(n, 0.0);
+      std::vector<T>      U  = diagonalization(S, n, D);
+      std::vector<T>      Ut = TransposeMatrix(U, n);
+      std::vector<T>      X, Uk;
+      reducedDim = canonicalOrthogonalization(D, Ut, n, 1e-8, X, Uk);
+      const std::vector<T> C =
+        matrixTmatrixmul(X, n, reducedDim, PhiTPsi, n, nKS);
+      return projectabilitiesOfProjection(
+        C, C, reducedDim, nKS, MPI_COMM_WORLD);
+    };
+
+    unsigned int              reducedDim, reducedDimDependent;
+    const std::vector<double> reference =
+      projectabilities(Phi, nBasis, reducedDim);
+    const std::vector<double> filtered =
+      projectabilities(PhiDependent, nBasisDependent, reducedDimDependent);
+
+    pcout << std::endl
+          << (isComplex ? "Complex" : "Real")
+          << " near linearly dependent basis: " << reducedDimDependent
+          << " of " << nBasisDependent << " directions retained" << std::endl;
+
+    checks.check(prefix + "near dependent direction discarded",
+                 std::abs((double)reducedDimDependent - (double)nBasis),
+                 0.0,
+                 pcout);
+    double error = 0.0;
+    for (unsigned int i = 0; i < nKS; ++i)
+      error = std::max(error, std::abs(filtered[i] - reference[i]));
+    checks.check(prefix + "filtered projectabilities",
+                 error,
+                 1e-6,
+                 pcout);
+  }
+
+  //
+  // appends the basis in blocks of columns to an incrementalProjection with
+  // the FE nodes split over the ranks and compares with the projection onto
+  // the full basis
+  //
+  template <typename T>
+  void
+  runIncrementalProjectionCheck(const unsigned int          nDofs,
+                                const unsigned int          nBasis,
+                                const unsigned int          nKS,
+                                const double                sparsity,
+                                dftfe::populationProfiler & profiler,
+                                benchmarkChecks &           checks,
+                                dealii::ConditionalOStream &pcout)
+  {
+    const bool        isComplex = !std::is_same<T, double>::value;
+    const std::string prefix    = isComplex ? "complex " : "real ";
+    std::mt19937      generator(11);
+
+    const std::vector<T> Phi =
+      syntheticOrbitalMatrix<T>(nDofs, nBasis, sparsity, generator);
+    const std::vector<T> Psi = syntheticDenseMatrix<T>(nDofs, nKS, generator);
+
+    std::vector<T> S =
+      fullOverlapMatrix(selfMatrixTmatrixmul(Phi, nDofs, nBasis), nBasis);
+    const std::vector<T> PhiTPsi =
+      matrixTmatrixmul(Phi, nDofs, nBasis, Psi, nDofs, nKS);
+    std::vector<double>  D(nBasis, 0.0);
+    std::vector<T>       U    = diagonalization(S, nBasis, D);
+    std::vector<T>       Ut   = TransposeMatrix(U, nBasis);
+    const std::vector<T> invS = powerOfMatrix(-1, D, Ut, nBasis, Ut);
+    const std::vector<T> C =
+      matrixmatrixmul(invS, nBasis, nBasis, PhiTPsi, nBasis, nKS);
+
+    int thisRank, numRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+    const unsigned int rowsPerRank = (nDofs + numRanks - 1) / numRanks;
+    const unsigned int rowStart    = std::min(thisRank * rowsPerRank, nDofs);
+    const unsigned int rowEnd      = std::min(rowStart + rowsPerRank, nDofs);
+    const unsigned int nLocalDofs  = rowEnd - rowStart;
+
+    const std::vector<T> localPsi(Psi.begin() + rowStart * nKS,
+                                  Psi.begin() + rowEnd * nKS);
+    dftfe::incrementalProjection<T> projection(
+      localPsi, nLocalDofs, nKS, 1e-8, MPI_COMM_WORLD);
+
+    const unsigned int blockSize = std::max(1u, nBasis / 4);
+    for (unsigned int start = 0; start < nBasis; start += blockSize)
+      {
+        const unsigned int m = std::min(blockSize, nBasis - start);
+        std::vector<T>     PhiBlock(nLocalDofs * m);
+        for (unsigned int dof = 0; dof < nLocalDofs; ++dof)
+          for (unsigned int j = 0; j < m; ++j)
+            PhiBlock[dof * m + j] = Phi[(rowStart + dof) * nBasis + start + j];
+
+        profiler.enter(prefix + "incremental basis append");
+        projection.appendBasis(PhiBlock, m);
+        profiler.leave(prefix + "incremental basis append");
+        profiler.addFlops(
+          prefix + "incremental basis append",
+          dftfe::populationProfiler::gemmFlops(start + m + nKS,
+                                               m,
+                                               nLocalDofs,
+                                               isComplex));
+      }
+
+    pcout << std::endl
+          << (isComplex ? "Complex" : "Real") << " incremental projection: "
+          << projection.retainedDimension() << " of "
+          << projection.basisDimension() << " directions retained in blocks of "
+          << blockSize << std::endl;
+
+    double projectabilitiesError = 0.0;
+    for (unsigned int i = 0; i < nKS; ++i)
+      {
+        T reference = T(0.0);
+        for (unsigned int a = 0; a < nBasis; ++a)
+          reference += conjugate(C[a * nKS + i]) * PhiTPsi[a * nKS + i];
+        projectabilitiesError =
+          std::max(projectabilitiesError,
+                   std::abs(projection.projectabilities()[i] -
+                            std::real(reference)));
+      }
+    checks.check(prefix + "incremental projectabilities",
+                 projectabilitiesError,
+                 1e-8,
+                 pcout);
+    checks.check(prefix + "incremental coefficients = S^-1 Phi^H Psi",
+                 relativeMaxDifference(projection.coefficients(), C),
+                 1e-8,
+                 pcout);
+  }
+
+  //
+  // S and Phi^H Psi from a pipelinedOverlapProjection fed with blocks of
+  // basis functions, the FE nodes split over the ranks, against the serial
+  // products on the full data
+  //
+  template <typename T>
+  void
+  runPipelinedProjectionCheck(const unsigned int          nDofs,
+                              const unsigned int          nBasis,
+                              const unsigned int          nKS,
+                              const double                sparsity,
+                              dftfe::populationProfiler & profiler,
+                              benchmarkChecks &           checks,
+                              dealii::ConditionalOStream &pcout)
+  {
+    const bool        isComplex = !std::is_same<T, double>::value;
+    const std::string prefix    = isComplex ? "complex " : "real ";
+    std::mt19937      generator(13);
+
+    const std::vector<T> Phi =
+      syntheticOrbitalMatrix<T>(nDofs, nBasis, sparsity, generator);
+    const std::vector<T> Psi = syntheticDenseMatrix<T>(nDofs, nKS, generator);
+
+    const std::vector<T> S =
+      fullOverlapMatrix(selfMatrixTmatrixmul(Phi, nDofs, nBasis), nBasis);
+    const std::vector<T> PhiTPsi =
+      matrixTmatrixmul(Phi, nDofs, nBasis, Psi, nDofs, nKS);
+
+    int thisRank, numRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+    const unsigned int rowsPerRank = (nDofs + numRanks - 1) / numRanks;
+    const unsigned int rowStart    = std::min(thisRank * rowsPerRank, nDofs);
+    const unsigned int rowEnd      = std::min(rowStart + rowsPerRank, nDofs);
+    const unsigned int nLocalDofs  = rowEnd - rowStart;
+
+    const std::vector<T> localPsi(Psi.begin() + rowStart * nKS,
+                                  Psi.begin() + rowEnd * nKS);
+    dftfe::pipelinedOverlapProjection<T> projection(localPsi,
+                                                    nLocalDofs,
+                                                    nKS,
+                                                    MPI_COMM_WORLD);
+
+    const unsigned int blockSize = std::max(1u, nBasis / 3);
+    profiler.enter(prefix + "pipelined S and Phi^H Psi");
+    for (unsigned int start = 0; start < nBasis; start += blockSize)
+      {
+        const unsigned int m = std::min(blockSize, nBasis - start);
+        std::vector<T>     PhiBlock(nLocalDofs * m);
+        for (unsigned int dof = 0; dof < nLocalDofs; ++dof)
+          for (unsigned int j = 0; j < m; ++j)
+            PhiBlock[dof * m + j] = Phi[(rowStart + dof) * nBasis + start + j];
+        projection.appendBasis(PhiBlock, m);
+      }
+    const std::vector<T> pipelinedS       = projection.overlapMatrix();
+    const std::vector<T> pipelinedPhiTPsi = projection.projections();
+    profiler.leave(prefix + "pipelined S and Phi^H Psi");
+
+    checks.check(prefix + "pipelined S",
+                 relativeMaxDifference(pipelinedS, S),
+                 1e-12,
+                 pcout);
+    checks.check(prefix + "pipelined Phi^H Psi",
+                 relativeMaxDifference(pipelinedPhiTPsi, PhiTPsi),
+                 1e-12,
+                 pcout);
+  }
+
+  //
+  // k-point pools of equal size as with NPKPT > 1: an odd number of
+  // k-points is split unevenly over the pools, every pool reduces its
+  // projections over its own FE domain and the weighted sums are then
+  // reduced over the pools. The pools run different numbers of domain
+  // reductions, which only completes if no reduction spans the pools.
+  //
+  template <typename T>
+  void
+  runKPointPoolCheck(const unsigned int          nDofs,
+                     const unsigned int          nBasis,
+                     const unsigned int          nKS,
+                     const double                sparsity,
+                     benchmarkChecks &           checks,
+                     dealii::ConditionalOStream &pcout)
+  {
+    const bool        isComplex = !std::is_same<T, double>::value;
+    const std::string prefix    = isComplex ? "complex " : "real ";
+    std::mt19937      generator(17);
+
+    int thisRank, numRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+    const unsigned int numPools   = numRanks % 2 == 0 ? 2 : numRanks;
+    const unsigned int thisPool   = thisRank % numPools;
+    const unsigned int numKPoints = 2 * numPools - 1;
+
+    const std::vector<T> Phi =
+      syntheticOrbitalMatrix<T>(nDofs, nBasis, sparsity, generator);
+    std::vector<std::vector<T>> Psi(numKPoints);
+    std::vector<T>              weightedPhiTPsi(nBasis * nKS, T(0.0));
+    for (unsigned int kPoint = 0; kPoint < numKPoints; ++kPoint)
+      {
+        Psi[kPoint] = syntheticDenseMatrix<T>(nDofs, nKS, generator);
+        const std::vector<T> PhiTPsi =
+          matrixTmatrixmul(Phi, nDofs, nBasis, Psi[kPoint], nDofs, nKS);
+        for (unsigned int i = 0; i < nBasis * nKS; ++i)
+          weightedPhiTPsi[i] += (kPoint + 1.0) * PhiTPsi[i];
+      }
+
+    MPI_Comm domainComm, interPoolComm;
+    MPI_Comm_split(MPI_COMM_WORLD, thisPool, thisRank, &domainComm);
+    int domainRank, domainSize;
+    MPI_Comm_rank(domainComm, &domainRank);
+    MPI_Comm_size(domainComm, &domainSize);
+    MPI_Comm_split(MPI_COMM_WORLD, domainRank, thisRank, &interPoolComm);
+
+    const unsigned int kPointsPerPool = (numKPoints + numPools - 1) / numPools;
+    const unsigned int kPointStart =
+      std::min(thisPool * kPointsPerPool, numKPoints);
+    const unsigned int kPointEnd =
+      std::min(kPointStart + kPointsPerPool, numKPoints);
+
+    const unsigned int rowsPerRank = (nDofs + domainSize - 1) / domainSize;
+    const unsigned int rowStart    = std::min(domainRank * rowsPerRank, nDofs);
+    const unsigned int rowEnd      = std::min(rowStart + rowsPerRank, nDofs);
+    const unsigned int nLocalDofs  = rowEnd - rowStart;
+
+    const std::vector<T> localPhi(Phi.begin() + rowStart * nBasis,
+                                  Phi.begin() + rowEnd * nBasis);
+
+    std::vector<T> poolPhiTPsi(nBasis * nKS, T(0.0));
+    for (unsigned int kPoint = kPointStart; kPoint < kPointEnd; ++kPoint)
+      {
+        const std::vector<T> localPsi(Psi[kPoint].begin() + rowStart * nKS,
+                                      Psi[kPoint].begin() + rowEnd * nKS);
+        dftfe::pipelinedOverlapProjection<T> projection(localPsi,
+                                                        nLocalDofs,
+                                                        nKS,
+                                                        domainComm);
+        std::vector<T> PhiBlock = localPhi;
+        projection.appendBasis(PhiBlock, nBasis);
+        const std::vector<T> PhiTPsi = projection.projections();
+        for (unsigned int i = 0; i < nBasis * nKS; ++i)
+          poolPhiTPsi[i] += (kPoint + 1.0) * PhiTPsi[i];
+      }
+    MPI_Allreduce(MPI_IN_PLACE,
+                  reinterpret_cast<double *>(&poolPhiTPsi[0]),
+                  (isComplex ? 2 : 1) * nBasis * nKS,
+                  MPI_DOUBLE,
+                  MPI_SUM,
+                  interPoolComm);
+
+    checks.check(prefix + "k-point pool sum of Phi^H Psi",
+                 relativeMaxDifference(poolPhiTPsi, weightedPhiTPsi),
+                 1e-12,
+                 pcout);
+
+    MPI_Comm_free(&interPoolComm);
+    MPI_Comm_free(&domainComm);
+  }
+
+  //
+  // S and Phi^H Psi with the cell quadrature: the cells are distributed over
+  // the ranks and added in batches, every basis function is non-zero on a
+  // subset of the cells only and a batch only carries the basis functions
+  // non-zero on one of its cells. The result is compared with naive loops
+  // over all cells and quadrature points.
+  //
+  template <typename T>
+  void
+  runCellQuadratureProjectionCheck(const unsigned int          nBasis,
+                                   const unsigned int          nKS,
+                                   dftfe::populationProfiler & profiler,
+                                   benchmarkChecks &           checks,
+                                   dealii::ConditionalOStream &pcout)
+  {
+    const bool         isComplex = !std::is_same<T, double>::value;
+    const std::string  prefix    = isComplex ? "complex " : "real ";
+    const unsigned int nCells = 61, nQuad = 27, nNodes = 8;
+    std::mt19937       generator(17);
+
+    std::vector<double> shapeValues(nQuad * nNodes);
+    for (double &value : shapeValues)
+      randomEntry(generator, value);
+    std::vector<T> nodalPsi(nCells * nNodes * nKS), scaling(nCells * nQuad),
+      Phi(nCells * nQuad * nBasis, T(0.0));
+    for (T &value : nodalPsi)
+      randomEntry(generator, value);
+    for (T &value : scaling)
+      randomEntry(generator, value);
+    // basis function i lives on the cells c with (c + i) % 4 != 0
+    for (unsigned int c = 0; c < nCells; ++c)
+      for (unsigned int q = 0; q < nQuad; ++q)
+        for (unsigned int i = 0; i < nBasis; ++i)
+          if ((c + i) % 4 != 0)
+            randomEntry(generator, Phi[(c * nQuad + q) * nBasis + i]);
+
+    std::vector<T> S(nBasis * nBasis, T(0.0)), PhiTPsi(nBasis * nKS, T(0.0));
+    for (unsigned int c = 0; c < nCells; ++c)
+      for (unsigned int q = 0; q < nQuad; ++q)
+        {
+          std::vector<T> psi(nKS, T(0.0));
+          for (unsigned int j = 0; j < nKS; ++j)
+            {
+              for (unsigned int n = 0; n < nNodes; ++n)
+                psi[j] += shapeValues[q * nNodes + n] *
+                          nodalPsi[(c * nNodes + n) * nKS + j];
+              psi[j] *= scaling[c * nQuad + q];
+            }
+          const T *phi = &Phi[(c * nQuad + q) * nBasis];
+          for (unsigned int a = 0; a < nBasis; ++a)
+            {
+              for (unsigned int b = 0; b < nBasis; ++b)
+                S[a * nBasis + b] += conjugate(phi[a]) * phi[b];
+              for (unsigned int j = 0; j < nKS; ++j)
+                PhiTPsi[a * nKS + j] += conjugate(phi[a]) * psi[j];
+            }
+        }
+
+    int thisRank, numRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+    const unsigned int cellsPerRank = (nCells + numRanks - 1) / numRanks;
+    const unsigned int cellStart = std::min(thisRank * cellsPerRank, nCells);
+    const unsigned int cellEnd   = std::min(cellStart + cellsPerRank, nCells);
+
+    dftfe::cellQuadratureOverlapProjection<T> projection(
+      nBasis, nKS, nQuad, nNodes, shapeValues, MPI_COMM_WORLD);
+    const unsigned int batchSize = 5;
+    profiler.enter(prefix + "cell quadrature S and Phi^H Psi");
+    for (unsigned int start = cellStart; start < cellEnd; start += batchSize)
+      {
+        const unsigned int nBatch = std::min(batchSize, cellEnd - start);
+        std::vector<unsigned int> basisIds;
+        for (unsigned int i = 0; i < nBasis; ++i)
+          for (unsigned int c = start; c < start + nBatch; ++c)
+            if ((c + i) % 4 != 0)
+              {
+                basisIds.push_back(i);
+                break;
+              }
+        const unsigned int m = basisIds.size();
+
+        std::vector<T> batchPsi(nNodes * nBatch * nKS),
+          batchScaling(nQuad * nBatch), batchPhi(nQuad * nBatch * m);
+        for (unsigned int c = 0; c < nBatch; ++c)
+          {
+            for (unsigned int n = 0; n < nNodes; ++n)
+              for (unsigned int j = 0; j < nKS; ++j)
+                batchPsi[(n * nBatch + c) * nKS + j] =
+                  nodalPsi[((start + c) * nNodes + n) * nKS + j];
+            for (unsigned int q = 0; q < nQuad; ++q)
+              {
+                const unsigned int row = q * nBatch + c;
+                batchScaling[row] = scaling[(start + c) * nQuad + q];
+                for (unsigned int a = 0; a < m; ++a)
+                  batchPhi[row * m + a] =
+                    Phi[((start + c) * nQuad + q) * nBasis + basisIds[a]];
+              }
+          }
+        projection.addCells(batchPsi, batchScaling, batchPhi, basisIds, nBatch);
+      }
+    const std::vector<T> quadratureS       = projection.overlapMatrix();
+    const std::vector<T> quadraturePhiTPsi = projection.projections();
+    profiler.leave(prefix + "cell quadrature S and Phi^H Psi");
+
+    checks.check(prefix + "cell quadrature S",
+                 relativeMaxDifference(quadratureS, S),
+                 1e-12,
+                 pcout);
+    checks.check(prefix + "cell quadrature Phi^H Psi",
+                 relativeMaxDifference(quadraturePhiTPsi, PhiTPsi),
+                 1e-12,
+                 pcout);
+  }
+
+  //
+  // atom populations of a sequence of Kohn-Sham orbitals projected onto a
+  // fixed basis, as along the SCF iterations: the cached S and X are reused
+  // for every set of orbitals and the Mulliken and Loewdin populations are
+  // compared with the chain C = S^{-1} Phi^H Psi, C O^{-1/2}, O = C^H S C.
+  // The orthonormalized projected orbitals carry exactly their occupations.
+  //
+  template <typename T>
+  void
+  runCachedPopulationCheck(const unsigned int          nDofs,
+                           const unsigned int          nBasis,
+                           const unsigned int          nKS,
+                           const double                sparsity,
+                           dftfe::populationProfiler & profiler,
+                           benchmarkChecks &           checks,
+                           dealii::ConditionalOStream &pcout)
+  {
+    const bool         isComplex = !std::is_same<T, double>::value;
+    const std::string  prefix    = isComplex ? "complex " : "real ";
+    const unsigned int basisPerAtom = 4, numIterations = 3;
+    std::mt19937       generator(23);
+
+    const std::vector<T> Phi =
+      syntheticOrbitalMatrix<T>(nDofs, nBasis, sparsity, generator);
+    const std::vector<T> S =
+      fullOverlapMatrix(selfMatrixTmatrixmul(Phi, nDofs, nBasis), nBasis);
+    std::vector<double>  D(nBasis, 0.0);
+    std::vector<T>       SCopy(S);
+    std::vector<T>       U     = diagonalization(SCopy, nBasis, D);
+    std::vector<T>       Ut    = TransposeMatrix(U, nBasis);
+    const std::vector<T> invS  = powerOfMatrix(-1, D, Ut, nBasis, Ut);
+    const std::vector<T> Shalf = powerOfMatrix(0.5, D, Ut, nBasis, Ut);
+
+    std::vector<unsigned int> atomBasisStart(1, 0);
+    while (atomBasisStart.back() < nBasis)
+      atomBasisStart.push_back(
+        std::min(atomBasisStart.back() + basisPerAtom, nBasis));
+    const unsigned int  numAtoms = atomBasisStart.size() - 1;
+    std::vector<double> occupations(nKS, 0.0);
+    double              numElectrons = 0.0;
+    for (unsigned int j = 0; j < nKS / 2; ++j)
+      {
+        occupations[j] = j + 1 == nKS / 2 ? 0.5 : 1.0;
+        numElectrons += occupations[j];
+      }
+
+    int thisRank, numRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+    const unsigned int rowsPerRank = (nDofs + numRanks - 1) / numRanks;
+    const unsigned int rowStart    = std::min(thisRank * rowsPerRank, nDofs);
+    const unsigned int rowEnd      = std::min(rowStart + rowsPerRank, nDofs);
+    const unsigned int nLocalDofs  = rowEnd - rowStart;
+
+    profiler.enter(prefix + "cached S factorization");
+    const dftfe::cachedPopulationProjection<T> projection(
+      std::vector<T>(Phi.begin() + rowStart * nBasis,
+                     Phi.begin() + rowEnd * nBasis),
+      nLocalDofs,
+      nBasis,
+      1e-10,
+      MPI_COMM_WORLD);
+    profiler.leave(prefix + "cached S factorization");
+
+    double mullikenError = 0.0, loewdinError = 0.0, chargeError = 0.0;
+    for (unsigned int iteration = 0; iteration < numIterations; ++iteration)
+      {
+        const std::vector<T> Psi =
+          syntheticDenseMatrix<T>(nDofs, nKS, generator);
+
+        std::vector<double> mulliken(numAtoms, 0.0), loewdin(numAtoms, 0.0);
+        profiler.enter(prefix + "cached atom populations");
+        projection.accumulateAtomPopulations(
+          std::vector<T>(Psi.begin() + rowStart * nKS,
+                         Psi.begin() + rowEnd * nKS),
+          nKS,
+          occupations,
+          atomBasisStart,
+          2.0,
+          mulliken,
+          loewdin);
+        profiler.leave(prefix + "cached atom populations");
+
+        const std::vector<T> PhiTPsi =
+          matrixTmatrixmul(Phi, nDofs, nBasis, Psi, nDofs, nKS);
+        const std::vector<T> C =
+          matrixmatrixmul(invS, nBasis, nBasis, PhiTPsi, nBasis, nKS);
+        const std::vector<T> SC =
+          matrixmatrixmul(S, nBasis, nBasis, C, nBasis, nKS);
+        std::vector<T> O = matrixTmatrixmul(C, nBasis, nKS, SC, nBasis, nKS);
+        std::vector<double>  D_O(nKS, 0.0);
+        std::vector<T>       U_O  = diagonalization(O, nKS, D_O);
+        std::vector<T>       U_Ot = TransposeMatrix(U_O, nKS);
+        const std::vector<T> Ominushalf =
+          powerOfMatrix(-0.5, D_O, U_Ot, nKS, U_Ot);
+        const std::vector<T> C_bar =
+          matrixmatrixmul(C, nBasis, nKS, Ominushalf, nKS, nKS);
+        const std::vector<T> SC_bar =
+          matrixmatrixmul(S, nBasis, nBasis, C_bar, nBasis, nKS);
+        const std::vector<T> C_hat =
+          matrixmatrixmul(Shalf, nBasis, nBasis, C_bar, nBasis, nKS);
+
+        std::vector<double> naiveMulliken(numAtoms, 0.0),
+          naiveLoewdin(numAtoms, 0.0);
+        for (unsigned int atom = 0; atom < numAtoms; ++atom)
+          for (unsigned int a = atomBasisStart[atom];
+               a < atomBasisStart[atom + 1];
+               ++a)
+            for (unsigned int j = 0; j < nKS; ++j)
+              {
+                naiveMulliken[atom] += 2.0 * occupations[j] *
+                                       std::real(conjugate(C_bar[a * nKS + j]) *
+                                                 SC_bar[a * nKS + j]);
+                naiveLoewdin[atom] +=
+                  2.0 * occupations[j] * std::norm(C_hat[a * nKS + j]);
+              }
+
+        double mullikenSum = 0.0, loewdinSum = 0.0;
+        for (unsigned int atom = 0; atom < numAtoms; ++atom)
+          {
+            mullikenSum += mulliken[atom];
+            loewdinSum += loewdin[atom];
+          }
+        mullikenError =
+          std::max(mullikenError,
+                   relativeMaxDifference(mulliken, naiveMulliken));
+        loewdinError = std::max(loewdinError,
+                                relativeMaxDifference(loewdin, naiveLoewdin));
+        chargeError =
+          std::max(chargeError,
+                   std::max(std::abs(mullikenSum - 2.0 * numElectrons),
+                            std::abs(loewdinSum - 2.0 * numElectrons)) /
+                     (2.0 * numElectrons));
+      }
+
+    checks.check(prefix + "cached Mulliken populations",
+                 mullikenError,
+                 1e-8,
+                 pcout);
+    checks.check(prefix + "cached Loewdin populations",
+                 loewdinError,
+                 1e-8,
+                 pcout);
+    checks.check(prefix + "cached population electron count",
+                 chargeError,
+                 1e-10,
+                 pcout);
+  }
+} // namespace
+
+
+
+
+int
+main(int argc, char *argv[])
+{
+  MPI_Init(&argc, &argv);
+  int thisRank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+  dealii::ConditionalOStream pcout(std::cout, thisRank == 0);
+
+  const unsigned int nDofs    = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const unsigned int nBasis   = argc > 2 ? std::atoi(argv[2]) : 200;
+  const unsigned int nKS      = argc > 3 ? std::atoi(argv[3]) : 100;
+  const double       sparsity = argc > 4 ? std::atof(argv[4]) : 0.8;
+  const unsigned int repeats  = argc > 5 ? std::atoi(argv[5]) : 3;
+
+  if (nKS > nBasis || nBasis > nDofs || sparsity < 0.0 || sparsity >= 1.0)
+    {
+      pcout << "Invalid sizes: require nKS <= nBasis <= nDofs and "
+               "0 <= sparsity < 1"
+            << std::endl;
+      MPI_Finalize();
+      return 1;
+    }
+
+  //
+  // every rank runs the serial kernels on its own data, the profile then
+  // reports the spread over the ranks of the node
+  //
+  dftfe::populationProfiler profiler(MPI_COMM_WORLD);
+  benchmarkChecks           checks;
+  runPopulationChain<double>(
+    nDofs, nBasis, nKS, sparsity, repeats, profiler, checks, pcout);
+  runPopulationChain<std::complex<double>>(
+    nDofs, nBasis, nKS, sparsity, repeats, profiler, checks, pcout);
+
+  runLinearDependenceCheck<double>(
+    nDofs, nBasis, nKS, sparsity, checks, pcout);
+  runLinearDependenceCheck<std::complex<double>>(
+    nDofs, nBasis, nKS, sparsity, checks, pcout);
+
+  runIncrementalProjectionCheck<double>(
+    nDofs, nBasis, nKS, sparsity, profiler, checks, pcout);
+  runIncrementalProjectionCheck<std::complex<double>>(
+    nDofs, nBasis, nKS, sparsity, profiler, checks, pcout);
+
+  runPipelinedProjectionCheck<double>(
+    nDofs, nBasis, nKS, sparsity, profiler, checks, pcout);
+  runPipelinedProjectionCheck<std::complex<double>>(
+    nDofs, nBasis, nKS, sparsity, profiler, checks, pcout);
+
+  runKPointPoolCheck<double>(nDofs, nBasis, nKS, sparsity, checks, pcout);
+  runKPointPoolCheck<std::complex<double>>(
+    nDofs, nBasis, nKS, sparsity, checks, pcout);
+
+  runCellQuadratureProjectionCheck<double>(
+    nBasis, nKS, profiler, checks, pcout);
+  runCellQuadratureProjectionCheck<std::complex<double>>(
+    nBasis, nKS, profiler, checks, pcout);
+
+  runCachedPopulationCheck<double>(
+    nDofs, nBasis, nKS, sparsity, profiler, checks, pcout);
+  runCachedPopulationCheck<std::complex<double>>(
+    nDofs, nBasis, nKS, sparsity, profiler, checks, pcout);
+
+  profiler.writeReport("populationKernelsBenchmark.json", pcout);
+
+  int failed = checks.passed ? 0 : 1;
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  pcout << std::endl
+        << (failed ? "Population kernel checks FAILED" :
+                     "Population kernel checks PASSED")
+        << std::endl;
+
+  MPI_Finalize();
+  return failed;
+}
@@ -0,0 +1,298 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022 The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+//
+// Regression check of the output of the population analysis: the binary
+// band file written by the leaders of the k-point pools with MPI-IO and the
+// broadening engine of the DOS and PDOS. No DFT input is required, the band
+// file check is meant to be run on several ranks.
+//
+// usage: populationOutputChecks
+//
+
+#include <bandFileWriter.h>
+#include <dosBroadening.h>
+#include <populationProfiler.h>
+
+#include <deal.II/base/conditional_ostream.h>
+
+#include "benchmarkChecks.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  //
+  // binary band file written by every rank as the leader of its own k-point
+  // pool: the k-points of a rank are handed over one at a time and written
+  // collectively by an explicit flush after the first and by the close, the
+  // first rank has one k-point more than the others so that the close pads
+  // the collective writes of the other ranks. The last record of the file is
+  // left out and has to read as zeros
+  //
+  void
+  runBandFileCheck(benchmarkChecks &           checks,
+                   dealii::ConditionalOStream &pcout)
+  {
+    int thisRank, numRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+
+    const unsigned int numSpins = 2, numBands = 7;
+    const unsigned int numKPointsOfRank = thisRank == 0 ? 3 : 2;
+    const unsigned int firstKPointOfRank = thisRank == 0 ? 0 : 2 * thisRank + 1;
+    const unsigned int numKPoints        = 2 * numRanks + 2;
+    const unsigned int numLevels  = numSpins * numBands;
+    auto               value      = [](const unsigned int kPoint,
+                        const unsigned int entry) {
+      return 1000.0 * kPoint + entry + 0.25;
+    };
+
+    const std::string fileName = "populationKernelsBands.bin";
+    {
+      dftfe::bandFileWriter writer(
+        fileName, MPI_COMM_WORLD, numKPoints, numSpins, numBands, -0.1, -0.2);
+      for (unsigned int i = 0; i < numKPointsOfRank; ++i)
+        {
+          const unsigned int  kPoint = firstKPointOfRank + i;
+          std::vector<double> coordinates(3), weights(1),
+            eigenValues(numLevels), occupations(numLevels);
+          for (unsigned int d = 0; d < 3; ++d)
+            coordinates[d] = value(kPoint, d);
+          weights[0] = value(kPoint, 3);
+          for (unsigned int spin = 0; spin < numSpins; ++spin)
+            for (unsigned int iWave = 0; iWave < numBands; ++iWave)
+              {
+                const unsigned int entry = 4 + 2 * spin * numBands + iWave;
+                eigenValues[spin * numBands + iWave] = value(kPoint, entry);
+                occupations[spin * numBands + iWave] =
+                  value(kPoint, entry + numBands);
+              }
+          writer.writeKPoints(
+            kPoint, 1, coordinates, weights, eigenValues, occupations);
+          if (i == 0)
+            writer.flush();
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    if (thisRank == 0)
+      {
+        std::ifstream file(fileName, std::ios::binary);
+        std::vector<char> header(dftfe::bandFileWriter::headerBytes());
+        file.read(&header[0], header.size());
+        std::int32_t sizes[4];
+        double       fermiEnergies[2];
+        std::memcpy(sizes, &header[8], sizeof(sizes));
+        std::memcpy(fermiEnergies, &header[8 + sizeof(sizes)], 16);
+        const bool headerMatches =
+          std::string(&header[0], 8) == "DFTFEBND" &&
+          sizes[0] == (std::int32_t)dftfe::bandFileWriter::version &&
+          sizes[1] == (std::int32_t)numSpins &&
+          sizes[2] == (std::int32_t)numBands &&
+          sizes[3] == (std::int32_t)numKPoints && fermiEnergies[0] == -0.1 &&
+          fermiEnergies[1] == -0.2;
+
+        const unsigned int  recordDoubles = 4 + 2 * numLevels;
+        std::vector<double> records(numKPoints * recordDoubles, -1.0);
+        file.read(reinterpret_cast<char *>(&records[0]),
+                  records.size() * sizeof(double));
+        double maxError = file.gcount() == (std::streamsize)(records.size() *
+                                                             sizeof(double)) ?
+                            0.0 :
+                            1.0;
+        for (unsigned int kPoint = 0; kPoint < numKPoints; ++kPoint)
+          for (unsigned int entry = 0; entry < recordDoubles; ++entry)
+            maxError =
+              std::max(maxError,
+                       std::abs(records[kPoint * recordDoubles + entry] -
+                                (kPoint + 1 < numKPoints ?
+                                   value(kPoint, entry) :
+                                   0.0)));
+        file.close();
+        std::remove(fileName.c_str());
+
+        pcout << std::endl
+              << "Band file: " << numKPoints << " k-points of " << numRanks
+              << " pools" << std::endl;
+        checks.check("band file header", headerMatches ? 0.0 : 1.0, 0.0, pcout);
+        checks.check("band file records", maxError, 0.0, pcout);
+      }
+  }
+
+  //
+  // broadening engine of the DOS: every kernel conserves the weight of the
+  // levels, the histogram convolution of many levels matches the levels
+  // scattered one by one, and the linear tetrahedron DOS of the free
+  // electron band |k|^2 on a cubic Monkhorst-Pack grid integrates to the
+  // volume of the Fermi sphere
+  //
+  void
+  runDosBroadeningCheck(dftfe::populationProfiler & profiler,
+                        benchmarkChecks &           checks,
+                        dealii::ConditionalOStream &pcout)
+  {
+    typedef dftfe::dosBroadening::kernelType kernelType;
+    std::mt19937                             generator(11);
+    std::uniform_real_distribution<double>   level(-1.0, 0.0);
+
+    const unsigned int  numLevels = 20000;
+    std::vector<double> energyLevels(numLevels), levelWeights(numLevels);
+    double              totalWeight = 0.0;
+    for (unsigned int j = 0; j < numLevels; ++j)
+      {
+        energyLevels[j] = level(generator);
+        levelWeights[j] = 1.0 + level(generator);
+        totalWeight += levelWeights[j];
+      }
+
+    const double       width = 0.01, intervalSize = 0.001;
+    const double       lowerBound   = -2.5;
+    const unsigned int numIntervals = 4000;
+    const kernelType   kernels[3]   = {kernelType::lorentzian,
+                                   kernelType::gaussian,
+                                   kernelType::methfesselPaxton};
+    const std::string  names[3]     = {"Lorentzian",
+                                  "Gaussian",
+                                  "Methfessel-Paxton"};
+    for (unsigned int k = 0; k < 3; ++k)
+      {
+        const dftfe::dosBroadening broadening(
+          kernels[k], width, 1, 0.0, lowerBound, intervalSize, numIntervals);
+        std::vector<double> dos(numIntervals, 0.0);
+
+        // one level at a time scatters to the grid points of its window
+        const std::string region = "DOS " + names[k] + " broadening";
+        profiler.enter(region);
+        for (unsigned int j = 0; j < numLevels; ++j)
+          broadening.accumulate(std::vector<double>(1, energyLevels[j]),
+                                std::vector<double>(1, levelWeights[j]),
+                                1,
+                                1.0,
+                                dos);
+        profiler.leave(region);
+
+        double integral = 0.0;
+        for (unsigned int e = 0; e < numIntervals; ++e)
+          integral += dos[e] * intervalSize;
+        checks.check(names[k] + " broadening conserves the weight",
+                     std::abs(integral - totalWeight) / totalWeight,
+                     1e-6,
+                     pcout);
+
+        // all levels at once go through the histogram
+        std::vector<double> histogramDos(numIntervals, 0.0);
+        profiler.enter(region + " (histogram)");
+        broadening.accumulate(energyLevels, levelWeights, 1, 1.0, histogramDos);
+        profiler.leave(region + " (histogram)");
+        checks.check(names[k] + " histogram convolution",
+                     relativeMaxDifference(histogramDos, dos),
+                     5e-3,
+                     pcout);
+      }
+
+    //
+    // free electrons e(k) = |k|^2 in the unit reciprocal cube, n^3 grid
+    //
+    const unsigned int                     n        = 32;
+    const std::array<unsigned int, 3>      gridSize = {n, n, n};
+    const std::vector<std::vector<double>> reciprocalLatticeVectors = {
+      {1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+    std::vector<double> gridEnergies(n * n * n);
+    for (unsigned int i = 0; i < n * n * n; ++i)
+      {
+        const unsigned int index[3] = {i / (n * n), (i / n) % n, i % n};
+        gridEnergies[i]             = 0.0;
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            const double k = index[d] < n / 2 ? double(index[d]) / n :
+                                                double(index[d]) / n - 1.0;
+            gridEnergies[i] += k * k;
+          }
+      }
+
+    const dftfe::dosBroadening tetrahedronGrid(
+      kernelType::gaussian, width, 0, 0.0, -0.05, intervalSize, 900);
+    profiler.enter("DOS tetrahedra");
+    const std::vector<std::array<unsigned int, 4>> tetrahedra =
+      dftfe::dosBroadening::monkhorstPackTetrahedra(gridSize,
+                                                    reciprocalLatticeVectors);
+    std::vector<double> dos(tetrahedronGrid.numIntervals(), 0.0);
+    tetrahedronGrid.accumulateTetrahedra(gridEnergies, 1, tetrahedra, 1.0, dos);
+    profiler.leave("DOS tetrahedra");
+
+    // states up to the upper end of the interval of the grid point at 0.1,
+    // the linear tetrahedra converge as 1 / n^2
+    double       total = 0.0, statesBelow = 0.0;
+    const double fermiEnergy = 0.1005;
+    for (unsigned int e = 0; e < tetrahedronGrid.numIntervals(); ++e)
+      {
+        total += dos[e] * intervalSize;
+        if (tetrahedronGrid.energy(e) < fermiEnergy)
+          statesBelow += dos[e] * intervalSize;
+      }
+    checks.check("tetrahedra hold all states",
+                 std::abs(total - 1.0),
+                 1e-10,
+                 pcout);
+    checks.check("tetrahedron states of the Fermi sphere",
+                 std::abs(statesBelow -
+                          4.0 / 3.0 * M_PI * std::pow(fermiEnergy, 1.5)) /
+                   (4.0 / 3.0 * M_PI * std::pow(fermiEnergy, 1.5)),
+                 1e-2,
+                 pcout);
+  }
+} // namespace
+
+
+
+int
+main(int argc, char *argv[])
+{
+  MPI_Init(&argc, &argv);
+  int thisRank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+  dealii::ConditionalOStream pcout(std::cout, thisRank == 0);
+
+  dftfe::populationProfiler profiler(MPI_COMM_WORLD);
+  benchmarkChecks           checks;
+  runBandFileCheck(checks, pcout);
+
+  runDosBroadeningCheck(profiler, checks, pcout);
+
+  profiler.writeReport("populationOutputChecks.json", pcout);
+
+  int failed = checks.passed ? 0 : 1;
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  pcout << std::endl
+        << (failed ? "Population output checks FAILED" :
+                     "Population output checks PASSED")
+        << std::endl;
+
+  MPI_Finalize();
+  return failed;
+}
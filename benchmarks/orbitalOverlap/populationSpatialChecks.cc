@@ -0,0 +1,564 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022 The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+//
+// Regression check of the spatial structures of the population analysis:
+// the neighbor lists of the periodic images, the atom spatial index, the
+// bounding box index of the FE cells and the atom pair symmetry of the
+// populations, on synthetic atoms. No DFT input is required.
+//
+// usage: populationSpatialChecks
+//
+
+#include <atomPairSymmetry.h>
+#include <atomSpatialIndex.h>
+#include <cellBoundingBoxIndex.h>
+#include <overlapPopulationAnalysis.h>
+#include <populationNeighborList.h>
+#include <populationProfiler.h>
+
+#include <deal.II/base/conditional_ostream.h>
+
+#include "benchmarkChecks.h"
+#include "syntheticOrbitals.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+  //
+  // neighbor lists of random charges around a unit box along a synthetic
+  // trajectory: the list has to contain every image within the cutoff of
+  // the box at every step, and is only rebuilt once the displacements since
+  // the last build exceed the skin
+  //
+  void
+  runNeighborListCheck(benchmarkChecks &           checks,
+                       dealii::ConditionalOStream &pcout)
+  {
+    std::mt19937                           generator(7);
+    std::uniform_real_distribution<double> position(-4.0, 5.0);
+    std::uniform_real_distribution<double> direction(-1.0, 1.0);
+
+    const unsigned int numAtoms = 20, imagesPerAtom = 8;
+    const double       skin = 0.5, stepLength = 0.04;
+    std::vector<std::array<double, 3>> charges(numAtoms * imagesPerAtom);
+    std::vector<std::vector<int>>      chargeIdsOfAtoms(numAtoms);
+    std::vector<double>                cutoffOfAtoms(numAtoms);
+    for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+      {
+        cutoffOfAtoms[iAtom] = iAtom == 0 ? -1.0 : 1.0 + 0.1 * (iAtom % 5);
+        for (unsigned int iImage = 0; iImage < imagesPerAtom; ++iImage)
+          {
+            // atoms first, then the images
+            const unsigned int chargeId =
+              iImage == 0 ? iAtom : numAtoms + iAtom * (imagesPerAtom - 1) +
+                                      iImage - 1;
+            chargeIdsOfAtoms[iAtom].push_back(chargeId);
+            for (unsigned int d = 0; d < 3; ++d)
+              charges[chargeId][d] = position(generator);
+          }
+      }
+    const std::array<double, 3> boxLower = {0.0, 0.0, 0.0};
+    std::array<double, 3>       boxUpper = {1.0, 1.0, 1.0};
+
+    dftfe::populationNeighborList neighborList;
+    unsigned int                  missingCharges = 0, numberOfRebuilds = 0;
+    const unsigned int            numSteps = 40;
+    for (unsigned int step = 0; step < numSteps; ++step)
+      {
+        if (neighborList.update(charges,
+                                chargeIdsOfAtoms,
+                                cutoffOfAtoms,
+                                boxLower,
+                                boxUpper,
+                                skin))
+          ++numberOfRebuilds;
+
+        for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+          {
+            const std::vector<int> &near =
+              neighborList.chargeIdsNearNodes(iAtom);
+            for (const int chargeId : chargeIdsOfAtoms[iAtom])
+              {
+                double distanceSquared = 0.0;
+                for (unsigned int d = 0; d < 3; ++d)
+                  {
+                    const double outside =
+                      std::max(0.0,
+                               std::max(boxLower[d] - charges[chargeId][d],
+                                        charges[chargeId][d] - boxUpper[d]));
+                    distanceSquared += outside * outside;
+                  }
+                const bool isNear = cutoffOfAtoms[iAtom] < 0.0 ||
+                                    std::sqrt(distanceSquared) <=
+                                      cutoffOfAtoms[iAtom];
+                if (isNear &&
+                    std::find(near.begin(), near.end(), chargeId) == near.end())
+                  ++missingCharges;
+              }
+          }
+
+        // every charge moves by stepLength, the box grows slowly
+        for (auto &charge : charges)
+          {
+            std::array<double, 3> v = {direction(generator),
+                                       direction(generator),
+                                       direction(generator)};
+            const double          norm =
+              std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            for (unsigned int d = 0; d < 3; ++d)
+              charge[d] += stepLength * v[d] / std::max(norm, 1e-12);
+          }
+        boxUpper[0] += 0.005;
+      }
+
+    pcout << std::endl
+          << "Neighbor list: " << numberOfRebuilds << " builds in " << numSteps
+          << " steps" << std::endl;
+    checks.check("neighbor list contains the images within the cutoff",
+                 missingCharges,
+                 0.0,
+                 pcout);
+    // a rebuild is needed at most every skin / (step + box shift) steps
+    const double maxRebuilds =
+      1.0 + numSteps / std::floor(skin / (stepLength + 0.005));
+    checks.check("neighbor list rebuilds beyond the expected count",
+                 std::max(0.0, numberOfRebuilds - maxRebuilds),
+                 0.0,
+                 pcout);
+  }
+
+  //
+  // spatial index of random atoms in a periodic cube and all their 26
+  // periodic images, and of a flat slab of atoms: the nearest atom of
+  // points inside and outside the charges and the charges within a radius
+  // match the scan over all charges, and inside the cube the nearest
+  // charge is the minimum image
+  //
+  void
+  runAtomSpatialIndexCheck(dftfe::populationProfiler & profiler,
+                           benchmarkChecks &           checks,
+                           dealii::ConditionalOStream &pcout)
+  {
+    std::mt19937                           generator(13);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    const unsigned int numAtoms = 200, numPoints = 2000;
+    const double       cubeLength = 12.0, radius = 2.5;
+    for (unsigned int geometry = 0; geometry < 2; ++geometry)
+      {
+        const bool isSlab = geometry == 1;
+
+        std::vector<std::array<double, 3>> atoms(numAtoms);
+        for (auto &atom : atoms)
+          for (unsigned int d = 0; d < 3; ++d)
+            atom[d] = isSlab && d == 2 ? 0.0 : cubeLength * unit(generator);
+
+        // atoms first, then the images of the slab (x, y) or the cube
+        std::vector<std::array<double, 3>> charges(atoms);
+        std::vector<unsigned int>          atomIdsOfCharges(numAtoms);
+        for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+          atomIdsOfCharges[iAtom] = iAtom;
+        for (int i = -1; i <= 1; ++i)
+          for (int j = -1; j <= 1; ++j)
+            for (int k = isSlab ? 0 : -1; k <= (isSlab ? 0 : 1); ++k)
+              if (i != 0 || j != 0 || k != 0)
+                for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+                  {
+                    charges.push_back({atoms[iAtom][0] + i * cubeLength,
+                                       atoms[iAtom][1] + j * cubeLength,
+                                       atoms[iAtom][2] + k * cubeLength});
+                    atomIdsOfCharges.push_back(iAtom);
+                  }
+
+        const std::string label = isSlab ? "slab" : "cube";
+        dftfe::atomSpatialIndex index;
+        profiler.enter("atom spatial index build (" + label + ")");
+        index.update(charges, atomIdsOfCharges);
+        profiler.leave("atom spatial index build (" + label + ")");
+        index.update(charges, atomIdsOfCharges);
+
+        std::vector<std::array<double, 3>> points(numPoints);
+        for (auto &point : points)
+          for (unsigned int d = 0; d < 3; ++d)
+            point[d] = cubeLength * (2.0 * unit(generator) - 0.5);
+
+        std::vector<unsigned int> nearestCharges(numPoints);
+        profiler.enter("atom spatial index queries (" + label + ")");
+        for (unsigned int p = 0; p < numPoints; ++p)
+          nearestCharges[p] = index.nearestCharge(points[p]);
+        profiler.leave("atom spatial index queries (" + label + ")");
+
+        auto distanceSquared = [](const std::array<double, 3> &x,
+                                  const std::array<double, 3> &y) {
+          return (x[0] - y[0]) * (x[0] - y[0]) +
+                 (x[1] - y[1]) * (x[1] - y[1]) +
+                 (x[2] - y[2]) * (x[2] - y[2]);
+        };
+        unsigned int wrongNearest = 0, wrongWithinRadius = 0,
+                     wrongMinimumImage = 0;
+        std::vector<unsigned int> within, scanWithin;
+        for (unsigned int p = 0; p < numPoints; ++p)
+          {
+            unsigned int scanNearest = 0;
+            scanWithin.clear();
+            for (unsigned int c = 0; c < charges.size(); ++c)
+              {
+                const double distance = distanceSquared(points[p], charges[c]);
+                if (distance < distanceSquared(points[p], charges[scanNearest]))
+                  scanNearest = c;
+                if (distance <= radius * radius)
+                  scanWithin.push_back(c);
+              }
+            if (nearestCharges[p] != scanNearest)
+              ++wrongNearest;
+            index.chargesWithinRadius(points[p], radius, within);
+            if (within != scanWithin)
+              ++wrongWithinRadius;
+
+            bool isInside = true;
+            for (unsigned int d = 0; d < (isSlab ? 2 : 3); ++d)
+              isInside = isInside && points[p][d] >= 0.0 &&
+                         points[p][d] <= cubeLength;
+            if (!isInside)
+              continue;
+            double minimumImage = std::numeric_limits<double>::max();
+            for (const auto &atom : atoms)
+              {
+                double distance = 0.0;
+                for (unsigned int d = 0; d < 3; ++d)
+                  {
+                    double x = points[p][d] - atom[d];
+                    if (!isSlab || d < 2)
+                      x -= cubeLength * std::round(x / cubeLength);
+                    distance += x * x;
+                  }
+                minimumImage = std::min(minimumImage, distance);
+              }
+            if (std::abs(distanceSquared(points[p],
+                                         charges[nearestCharges[p]]) -
+                         minimumImage) > 1e-10)
+              ++wrongMinimumImage;
+          }
+
+        // the second update with the same charges keeps the bins
+        checks.check("atom spatial index rebuilds (" + label + ")",
+                     std::abs(index.numberOfBuilds() - 1.0),
+                     0.0,
+                     pcout);
+        checks.check("atom spatial index nearest charges (" + label + ")",
+                     wrongNearest,
+                     0.0,
+                     pcout);
+        checks.check("atom spatial index charges within radius (" + label +
+                       ")",
+                     wrongWithinRadius,
+                     0.0,
+                     pcout);
+        checks.check("atom spatial index minimum images (" + label + ")",
+                     wrongMinimumImage,
+                     0.0,
+                     pcout);
+      }
+  }
+
+  //
+  // cell bounding box index of a graded tensor product mesh, fine cells
+  // around the origin and coarse cells towards the boundary as in the
+  // refined meshes around atoms: the candidate cells of points inside and
+  // outside the mesh match the scan over all boxes, and every point inside
+  // the mesh has a candidate
+  //
+  void
+  runCellBoundingBoxIndexCheck(dftfe::populationProfiler & profiler,
+                               benchmarkChecks &           checks,
+                               dealii::ConditionalOStream &pcout)
+  {
+    std::mt19937                           generator(17);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // graded nodes -10 ... 10 with spacings growing from 0.25 to 2
+    std::vector<double> nodes(1, 0.0);
+    for (double spacing = 0.25; nodes.back() < 10.0; spacing *= 1.2)
+      nodes.push_back(std::min(nodes.back() + std::min(spacing, 2.0), 10.0));
+    const unsigned int numHalf = nodes.size();
+    for (unsigned int i = 1; i < numHalf; ++i)
+      nodes.insert(nodes.begin(), -nodes[2 * i - 1]);
+    const unsigned int numCells1D = nodes.size() - 1;
+
+    std::vector<std::array<double, 3>> lowerCorners, upperCorners;
+    for (unsigned int i = 0; i < numCells1D; ++i)
+      for (unsigned int j = 0; j < numCells1D; ++j)
+        for (unsigned int k = 0; k < numCells1D; ++k)
+          {
+            lowerCorners.push_back({nodes[i], nodes[j], nodes[k]});
+            upperCorners.push_back({nodes[i + 1], nodes[j + 1], nodes[k + 1]});
+          }
+
+    const double                tolerance = 1e-8;
+    dftfe::cellBoundingBoxIndex index;
+    profiler.enter("cell bounding box index build");
+    index.build(lowerCorners, upperCorners, tolerance);
+    profiler.leave("cell bounding box index build");
+
+    // points mostly near the origin, some outside the mesh and some on nodes
+    const unsigned int                 numPoints = 4000;
+    std::vector<std::array<double, 3>> points(numPoints);
+    for (unsigned int p = 0; p < numPoints; ++p)
+      for (unsigned int d = 0; d < 3; ++d)
+        points[p][d] = p % 10 == 0 ?
+                         nodes[generator() % nodes.size()] :
+                         (p % 10 == 1 ? 24.0 : 6.0) * (unit(generator) - 0.5);
+
+    std::vector<std::vector<unsigned int>> candidates(numPoints);
+    profiler.enter("cell bounding box index queries");
+    for (unsigned int p = 0; p < numPoints; ++p)
+      index.candidateCells(points[p], candidates[p]);
+    profiler.leave("cell bounding box index queries");
+
+    unsigned int wrongCandidates = 0, missingCells = 0;
+    std::vector<unsigned int> scanCandidates;
+    for (unsigned int p = 0; p < numPoints; ++p)
+      {
+        scanCandidates.clear();
+        for (unsigned int cell = 0; cell < lowerCorners.size(); ++cell)
+          {
+            bool isInside = true;
+            for (unsigned int d = 0; d < 3; ++d)
+              isInside = isInside &&
+                         points[p][d] >= lowerCorners[cell][d] - tolerance &&
+                         points[p][d] <= upperCorners[cell][d] + tolerance;
+            if (isInside)
+              scanCandidates.push_back(cell);
+          }
+        if (candidates[p] != scanCandidates)
+          ++wrongCandidates;
+
+        bool isInsideMesh = true;
+        for (unsigned int d = 0; d < 3; ++d)
+          isInsideMesh = isInsideMesh && std::abs(points[p][d]) <= 10.0;
+        if (isInsideMesh && candidates[p].empty())
+          ++missingCells;
+      }
+
+    checks.check("cell bounding box index candidate cells",
+                 wrongCandidates,
+                 0.0,
+                 pcout);
+    checks.check("cell bounding box index points without cell",
+                 missingCells,
+                 0.0,
+                 pcout);
+  }
+
+  //
+  // atom pairs of a 2x2x2 supercell of CsCl reduced with the cubic space
+  // group: the contractions of the irreducible pairs mapped back to all
+  // pairs have to match the contractions of all pairs for a density
+  // matrix and M built from the distances and types of the atoms only
+  //
+  template <typename T>
+  void
+  runPairSymmetryCheck(benchmarkChecks &           checks,
+                       dealii::ConditionalOStream &pcout)
+  {
+    const bool        isComplex = !std::is_same<T, double>::value;
+    const std::string prefix    = isComplex ? "complex " : "real ";
+
+    std::vector<std::array<double, 3>> positions;
+    std::vector<unsigned int>          types;
+    for (unsigned int type = 0; type < 2; ++type)
+      for (unsigned int i = 0; i < 8; ++i)
+        {
+          positions.push_back({0.5 * (i % 2) + 0.25 * type,
+                               0.5 * ((i / 2) % 2) + 0.25 * type,
+                               0.5 * (i / 4) + 0.25 * type});
+          types.push_back(type == 0 ? 55 : 17);
+        }
+    const unsigned int numAtoms = positions.size();
+
+    // signed permutation matrices with the translations on a quarter grid,
+    // the ones moving Cs onto Cl are not symmetries
+    std::vector<std::array<std::array<int, 3>, 3>> pointGroup;
+    const unsigned int permutations[6][3] = {
+      {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+    for (unsigned int p = 0; p < 6; ++p)
+      for (unsigned int signs = 0; signs < 8; ++signs)
+        {
+          std::array<std::array<int, 3>, 3> R = {};
+          for (unsigned int d = 0; d < 3; ++d)
+            R[d][permutations[p][d]] = (signs >> d) & 1 ? -1 : 1;
+          pointGroup.push_back(R);
+        }
+    std::vector<std::array<std::array<int, 3>, 3>> rotations;
+    std::vector<std::array<double, 3>>             translations;
+    for (const auto &R : pointGroup)
+      for (unsigned int t = 0; t < 64; ++t)
+        {
+          rotations.push_back(R);
+          translations.push_back(
+            {0.25 * (t % 4), 0.25 * ((t / 4) % 4), 0.25 * (t / 16)});
+        }
+
+    dftfe::atomPairSymmetry pairSymmetry;
+    pairSymmetry.reinit(positions, types, rotations, translations, 1e-6);
+
+    // two functions per atom, M depends on the periodic distances only
+    const unsigned int        functionsPerAtom = 2;
+    const unsigned int        nBasis           = functionsPerAtom * numAtoms;
+    std::vector<unsigned int> atomOfBasis(nBasis), atomBasisStart;
+    for (unsigned int i = 0; i < nBasis; ++i)
+      atomOfBasis[i] = i / functionsPerAtom;
+    for (unsigned int iAtom = 0; iAtom <= numAtoms; ++iAtom)
+      atomBasisStart.push_back(functionsPerAtom * iAtom);
+    std::vector<T> M(nBasis * nBasis);
+    for (unsigned int a = 0; a < nBasis; ++a)
+      for (unsigned int b = 0; b < nBasis; ++b)
+        {
+          const unsigned int atomA = atomOfBasis[a], atomB = atomOfBasis[b];
+          double             distanceSquared = 0.0;
+          for (unsigned int d = 0; d < 3; ++d)
+            {
+              const double x = positions[atomA][d] - positions[atomB][d];
+              distanceSquared += std::pow(x - std::round(x), 2);
+            }
+          M[a * nBasis + b] =
+            std::exp(-4.0 * distanceSquared) *
+              (1.0 + 0.1 * (a % functionsPerAtom + b % functionsPerAtom)) +
+            0.05 * (types[atomA] == types[atomB]) + (a == b ? 2.0 : 0.0);
+        }
+    // C = M up to a random factor, with occupations of the bands (columns)
+    // by type
+    std::mt19937 generator(11);
+    T            phase;
+    randomEntry(generator, phase);
+    std::vector<T> C(nBasis * nBasis);
+    for (unsigned int i = 0; i < nBasis * nBasis; ++i)
+      C[i] = phase * M[i];
+    std::vector<double> occupations(nBasis);
+    for (unsigned int j = 0; j < nBasis; ++j)
+      occupations[j] = types[atomOfBasis[j]] == 55 ? 1.0 : 0.25;
+
+    std::vector<double> fullValues(numAtoms * numAtoms, 0.0),
+      reducedValues(numAtoms * numAtoms, 0.0),
+      representativeValues(pairSymmetry.representativePairs().size(), 0.0);
+    accumulateAtomPairContractions(C,
+                                   M,
+                                   occupations,
+                                   nBasis,
+                                   nBasis,
+                                   atomOfBasis,
+                                   numAtoms,
+                                   2.0,
+                                   fullValues);
+    accumulateSelectedAtomPairContractions(C,
+                                           M,
+                                           occupations,
+                                           nBasis,
+                                           nBasis,
+                                           atomBasisStart,
+                                           pairSymmetry.representativePairs(),
+                                           2.0,
+                                           representativeValues);
+    pairSymmetry.scatter(representativeValues, reducedValues);
+
+    double maxError = 0.0, maxValue = 0.0;
+    for (unsigned int i = 0; i < numAtoms * numAtoms; ++i)
+      {
+        maxError =
+          std::max(maxError, std::abs(fullValues[i] - reducedValues[i]));
+        maxValue = std::max(maxValue, std::abs(fullValues[i]));
+      }
+
+    pcout << std::endl
+          << (isComplex ? "Complex" : "Real") << " atom pair symmetry: "
+          << pairSymmetry.representativePairs().size() << " of "
+          << numAtoms * (numAtoms + 1) / 2 << " pairs with "
+          << pairSymmetry.numberOfOperations() << " operations" << std::endl;
+    checks.check(prefix + "symmetry operations of the supercell",
+                 std::abs(double(pairSymmetry.numberOfOperations()) - 384.0),
+                 0.0,
+                 pcout);
+    checks.check(prefix + "irreducible pair contractions mapped to all pairs",
+                 maxError / maxValue,
+                 1e-12,
+                 pcout);
+
+    // a Gamma centred 2x2x2 grid keeps the point group, a single k-point
+    // on the x axis the 16 operations mapping the axis onto itself
+    std::vector<std::array<double, 3>> grid;
+    for (unsigned int i = 0; i < 8; ++i)
+      grid.push_back({0.5 * (i % 2), 0.5 * ((i / 2) % 2), 0.5 * (i / 4)});
+    const unsigned int numGridOperations =
+      dftfe::kPointInvariantOperations(
+        pointGroup, grid, std::vector<double>(8, 0.125), true, 1e-8)
+        .size();
+    const unsigned int numAxisOperations =
+      dftfe::kPointInvariantOperations(
+        pointGroup, {{0.25, 0.0, 0.0}}, {1.0}, true, 1e-8)
+        .size();
+    checks.check(prefix + "k-point invariant operations",
+                 std::abs(double(numGridOperations) - 48.0) +
+                   std::abs(double(numAxisOperations) - 16.0),
+                 0.0,
+                 pcout);
+  }
+} // namespace
+
+
+
+int
+main(int argc, char *argv[])
+{
+  MPI_Init(&argc, &argv);
+  int thisRank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &thisRank);
+  dealii::ConditionalOStream pcout(std::cout, thisRank == 0);
+
+  dftfe::populationProfiler profiler(MPI_COMM_WORLD);
+  benchmarkChecks           checks;
+  runNeighborListCheck(checks, pcout);
+
+  runAtomSpatialIndexCheck(profiler, checks, pcout);
+
+  runCellBoundingBoxIndexCheck(profiler, checks, pcout);
+
+  runPairSymmetryCheck<double>(checks, pcout);
+  runPairSymmetryCheck<std::complex<double>>(checks, pcout);
+
+  profiler.writeReport("populationSpatialChecks.json", pcout);
+
+  int failed = checks.passed ? 0 : 1;
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  pcout << std::endl
+        << (failed ? "Population spatial checks FAILED" :
+                     "Population spatial checks PASSED")
+        << std::endl;
+
+  MPI_Finalize();
+  return failed;
+}
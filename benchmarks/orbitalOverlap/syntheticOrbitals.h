@@ -0,0 +1,192 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022 The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+//
+// synthetic atomic and Kohn-Sham orbitals and naive reference kernels
+// shared by the orbital overlap benchmarks
+//
+
+#ifndef syntheticOrbitals_H_
+#define syntheticOrbitals_H_
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+namespace
+{
+  inline double
+  conjugate(const double x)
+  {
+    return x;
+  }
+
+  inline std::complex<double>
+  conjugate(const std::complex<double> &x)
+  {
+    return std::conj(x);
+  }
+
+  inline void
+  randomEntry(std::mt19937 &generator, double &value)
+  {
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    value = distribution(generator);
+  }
+
+  inline void
+  randomEntry(std::mt19937 &generator, std::complex<double> &value)
+  {
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    const double                           re = distribution(generator);
+    const double                           im = distribution(generator);
+    value = std::complex<double>(re, im);
+  }
+
+  //
+  // Phi is nDofs x nBasis stored rowwise, each basis function is supported
+  // on a contiguous window of (1 - sparsity) * nDofs nodes
+  //
+  template <typename T>
+  std::vector<T>
+  syntheticOrbitalMatrix(const unsigned int nDofs,
+                         const unsigned int nBasis,
+                         const double       sparsity,
+                         std::mt19937 &     generator)
+  {
+    std::vector<T>     Phi(nDofs * nBasis, T(0.0));
+    const unsigned int supportSize =
+      std::max(1u, (unsigned int)std::ceil((1.0 - sparsity) * nDofs));
+    std::uniform_int_distribution<unsigned int> startDistribution(
+      0, nDofs - supportSize);
+    for (unsigned int i = 0; i < nBasis; ++i)
+      {
+        const unsigned int start = startDistribution(generator);
+        for (unsigned int dof = start; dof < start + supportSize; ++dof)
+          randomEntry(generator, Phi[dof * nBasis + i]);
+      }
+    return Phi;
+  }
+
+  template <typename T>
+  std::vector<T>
+  syntheticDenseMatrix(const unsigned int nRows,
+                       const unsigned int nCols,
+                       std::mt19937 &     generator)
+  {
+    std::vector<T> A(nRows * nCols);
+    for (auto &a : A)
+      randomEntry(generator, a);
+    return A;
+  }
+
+  //
+  // naive (A^H B)_{ij} for rowwise m x n1 A and m x n2 B
+  //
+  template <typename T>
+  T
+  naiveMatrixTmatrixEntry(const std::vector<T> &A,
+                          const unsigned int    n1,
+                          const std::vector<T> &B,
+                          const unsigned int    n2,
+                          const unsigned int    m,
+                          const unsigned int    i,
+                          const unsigned int    j)
+  {
+    T sum = T(0.0);
+    for (unsigned int k = 0; k < m; ++k)
+      sum += conjugate(A[k * n1 + i]) * B[k * n2 + j];
+    return sum;
+  }
+
+  //
+  // max_{ij} |(A^H B)_{ij} - C_{ij}| / max_{ij} |C_{ij}| over a random sample
+  // of entries of the n1 x n2 matrix C
+  //
+  template <typename T>
+  double
+  sampledMatrixTmatrixError(const std::vector<T> &A,
+                            const unsigned int    n1,
+                            const std::vector<T> &B,
+                            const unsigned int    n2,
+                            const unsigned int    m,
+                            const std::vector<T> &C,
+                            std::mt19937 &        generator)
+  {
+    const unsigned int numSamples = std::min(n1 * n2, 256u);
+    std::uniform_int_distribution<unsigned int> rowDistribution(0, n1 - 1);
+    std::uniform_int_distribution<unsigned int> colDistribution(0, n2 - 1);
+
+    double maxAbs = 0.0;
+    for (const auto &c : C)
+      maxAbs = std::max(maxAbs, std::abs(c));
+
+    double maxError = 0.0;
+    for (unsigned int iSample = 0; iSample < numSamples; ++iSample)
+      {
+        const bool         allEntries = numSamples == n1 * n2;
+        const unsigned int i =
+          allEntries ? iSample / n2 : rowDistribution(generator);
+        const unsigned int j =
+          allEntries ? iSample % n2 : colDistribution(generator);
+        maxError =
+          std::max(maxError,
+                   std::abs(naiveMatrixTmatrixEntry(A, n1, B, n2, m, i, j) -
+                            C[i * n2 + j]));
+      }
+    return maxError / std::max(maxAbs, 1e-300);
+  }
+
+  template <typename T>
+  std::vector<T>
+  identityMatrix(const unsigned int N)
+  {
+    std::vector<T> I(N * N, T(0.0));
+    for (unsigned int i = 0; i < N; ++i)
+      I[i * N + i] = T(1.0);
+    return I;
+  }
+
+  //
+  // the real overlap kernel returns the packed upper triangle, the complex
+  // one the full matrix
+  //
+  inline std::vector<double>
+  fullOverlapMatrix(const std::vector<double> &S, const unsigned int N)
+  {
+    std::vector<double> Sfull(N * N, 0.0);
+    unsigned int        count = 0;
+    for (unsigned int i = 0; i < N; ++i)
+      for (unsigned int j = i; j < N; ++j)
+        {
+          Sfull[i * N + j] = S[count];
+          Sfull[j * N + i] = S[count];
+          count++;
+        }
+    return Sfull;
+  }
+
+  inline std::vector<std::complex<double>>
+  fullOverlapMatrix(const std::vector<std::complex<double>> &S,
+                    const unsigned int)
+  {
+    return S;
+  }
+} // namespace
+#endif
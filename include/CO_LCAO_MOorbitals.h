@@ -26,6 +26,21 @@
 // in reality the above functions need not be in the
 // header files (interface) as not used individually
 
+// valence shell hydrogenic orbitals with the Slater-rule exponent zeta, the
+// basis of the molecular orbitals below, r and xrel, yrel, zrel relative to
+// the atom
+double
+hydrogenic2sOrbital(double zeta, double r);
+
+double
+hydrogenic2pxOrbital(double zeta, double r, double xrel);
+
+double
+hydrogenic2pyOrbital(double zeta, double r, double yrel);
+
+double
+hydrogenic2pzOrbital(double zeta, double r, double zrel);
+
 double
 MOCO1(const dealii::Point<3> &evalPoint);
 
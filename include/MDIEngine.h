@@ -143,6 +143,8 @@ namespace dftfe
     send_forces();
     void
     send_stress();
+    void
+    send_populations();
   };
 } // namespace dftfe
 #  endif
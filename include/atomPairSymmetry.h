@@ -0,0 +1,118 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef atomPairSymmetry_H_
+#define atomPairSymmetry_H_
+
+#include <array>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Reduction of the atom pairs of the population analysis to
+   * irreducible representatives under the space group operations.
+   *
+   * An operation {R|t} in fractional coordinates maps every atom onto an
+   * atom of the same type and the atom pair {A, B} onto {g(A), g(B)}. The
+   * atom pair contractions sum over complete l shells of both atoms and are
+   * invariant under the operations that leave the density matrix invariant,
+   * so they only need to be evaluated for one pair of every orbit and
+   * scatter() maps them back to all pairs. The contractions are symmetric in
+   * A and B, the orbits are those of the unordered pairs.
+   */
+  class atomPairSymmetry
+  {
+  public:
+    atomPairSymmetry();
+
+    /**
+     * @brief every unordered pair of numAtoms atoms is its own
+     * representative
+     */
+    void
+    reinit(const unsigned int numAtoms);
+
+    /**
+     * @brief orbits of the unordered atom pairs under the operations
+     * {rotations[i]|translations[i]} acting on the fractional positions of
+     * the atoms in a fully periodic cell. Operations that do not map every
+     * atom onto an atom of the same type within the tolerance (in fractional
+     * coordinates) are dropped.
+     */
+    void
+    reinit(const std::vector<std::array<double, 3>> &fractionalPositions,
+           const std::vector<unsigned int> &         atomTypes,
+           const std::vector<std::array<std::array<int, 3>, 3>> &rotations,
+           const std::vector<std::array<double, 3>> &translations,
+           const double                              tolerance);
+
+    unsigned int
+    numberOfAtoms() const;
+
+    /**
+     * @brief number of operations mapping the atoms onto themselves,
+     * including the identity
+     */
+    unsigned int
+    numberOfOperations() const;
+
+    /**
+     * @brief representative atom pairs {A, B}, A <= B
+     */
+    const std::vector<std::array<unsigned int, 2>> &
+    representativePairs() const;
+
+    /**
+     * @brief index in representativePairs() of the orbit of the pair {A, B}
+     */
+    unsigned int
+    representativeOfPair(const unsigned int atomA,
+                         const unsigned int atomB) const;
+
+    /**
+     * @brief adds the values of the representatives to both (A, B) and
+     * (B, A) of atomPairValues, numAtoms x numAtoms stored rowwise
+     */
+    void
+    scatter(const std::vector<double> &representativeValues,
+            std::vector<double> &      atomPairValues) const;
+
+  private:
+    unsigned int                             d_numAtoms;
+    unsigned int                             d_numOperations;
+    std::vector<unsigned int>                d_representativeOfPair;
+    std::vector<std::array<unsigned int, 2>> d_representativePairs;
+  };
+
+  /**
+   * @brief indices of the rotations (fractional, acting on the real space
+   * coordinates) that map the set of k-points (fractional coordinates) with
+   * their weights onto itself, up to reciprocal lattice vectors and up to
+   * the sign of k when timeReversal is set. Sums over such a set of
+   * k-points are invariant under the corresponding space group operations.
+   */
+  std::vector<unsigned int>
+  kPointInvariantOperations(
+    const std::vector<std::array<std::array<int, 3>, 3>> &rotations,
+    const std::vector<std::array<double, 3>> &             kPoints,
+    const std::vector<double> &                            kPointWeights,
+    const bool                                             timeReversal,
+    const double                                           tolerance);
+
+} // namespace dftfe
+#endif
@@ -0,0 +1,118 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef atomSpatialIndex_H_
+#define atomSpatialIndex_H_
+
+#include <array>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Uniform bins over the charges (atoms and their periodic images)
+   * for nearest atom and fixed radius queries at arbitrary points.
+   *
+   * The bins cover the bounding box of the charges with about one charge per
+   * bin. A nearest charge query visits the shells of bins around the bin of
+   * the point (clamped to the grid) until no unvisited bin can hold a closer
+   * charge, a radius query only visits the bins overlapping the box of the
+   * sphere. With the periodic images among the charges the nearest charge
+   * of a point of the domain is its minimum image, and the atom of a charge
+   * is kept with it.
+   *
+   * The index is rank local and needs no communication.
+   */
+  class atomSpatialIndex
+  {
+  public:
+    atomSpatialIndex();
+
+    /**
+     * @brief chargePositions are the positions of all charges, the atoms
+     * followed by the periodic images, and atomIdsOfCharges the atom of
+     * every charge. Returns true if the bins were rebuilt, i.e. if the
+     * charges changed since the last update.
+     */
+    bool
+    update(const std::vector<std::array<double, 3>> &chargePositions,
+           const std::vector<unsigned int> &         atomIdsOfCharges);
+
+    unsigned int
+    numberOfCharges() const;
+
+    const std::array<double, 3> &
+    chargePosition(const unsigned int chargeId) const;
+
+    unsigned int
+    atomIdOfCharge(const unsigned int chargeId) const;
+
+    /**
+     * @brief charge nearest to the point, the lowest charge id among equally
+     * distant charges
+     */
+    unsigned int
+    nearestCharge(const std::array<double, 3> &point) const;
+
+    /**
+     * @brief atom of the nearest charge
+     */
+    unsigned int
+    nearestAtom(const std::array<double, 3> &point) const;
+
+    /**
+     * @brief charges at most radius from the point in increasing order of
+     * their ids
+     */
+    void
+    chargesWithinRadius(const std::array<double, 3> &point,
+                        const double                 radius,
+                        std::vector<unsigned int> &  chargeIds) const;
+
+    /**
+     * @brief number of builds since construction
+     */
+    unsigned int
+    numberOfBuilds() const;
+
+  private:
+    void
+    build();
+
+    /// bin of the point along the direction d, clamped to the grid
+    unsigned int
+    binIndex(const double x, const unsigned int d) const;
+
+    std::vector<std::array<double, 3>> d_chargePositions;
+    std::vector<unsigned int>          d_atomIdsOfCharges;
+
+    /// lower corner and edge length of the bins, number of bins per
+    /// direction
+    std::array<double, 3>       d_lower;
+    double                      d_binSize;
+    std::array<unsigned int, 3> d_numBins;
+
+    /// charges of the bin (i_0 n_1 + i_1) n_2 + i_2 are
+    /// d_binCharges[d_binStart[bin]] to d_binCharges[d_binStart[bin+1]-1]
+    std::vector<unsigned int> d_binStart;
+    std::vector<unsigned int> d_binCharges;
+
+    unsigned int d_numberOfBuilds;
+  };
+
+} // namespace dftfe
+#endif
@@ -13,6 +13,7 @@
 #  include <iostream>
 #  include <sstream>
 #  include <functional>
+#  include <atomicOrbitalRadialTables.h>
 #  include <fileReaders.h>
 #  include <dftParameters.h>
 #  include <dftUtils.h>
@@ -32,6 +33,42 @@ struct OrbitalQuantumNumbers
   int          m;
 };
 
+/**
+ * @brief radial function sum_j c_j R_STO(n_j, zeta_j, r) given as a
+ * contraction of normalized Slater type orbitals
+ *
+ * The terms are sorted by n_j, terms with n_j = n are
+ * [nOffset[n - 1], nOffset[n]), and the STO normalizations are folded into
+ * the coefficients so that an evaluation only needs one exp per term.
+ */
+struct SlaterRadialExpansion
+{
+  std::vector<double>       zeta;
+  std::vector<double>       coefficient;
+  std::vector<unsigned int> nOffset;
+
+  bool
+  empty() const
+  {
+    return zeta.empty();
+  }
+
+  double
+  value(double r) const;
+
+  // values at the numPoints radii r
+  void
+  evaluate(const double *r, unsigned int numPoints, double *values) const;
+};
+
+// {n, zeta, contraction coefficient} of one STO in a contraction
+struct SlaterTerm
+{
+  unsigned int n;
+  double       zeta;
+  double       coefficient;
+};
+
 struct LocalAtomicBasisInfo
 {
   unsigned int atomID;     // required for atomPos
@@ -94,7 +131,6 @@ private:
   // functions do not need to be friend functions as the above
   // basisGeneratorFunc can access all members and the member functions
 
-  std::vector<std::function<double(double)>> ROfBungeBasisFunctions;
 
 
 public:
@@ -120,16 +156,25 @@ public:
   std::vector<int> n;
   std::vector<int> l;
   std::vector<int> m;
-  double           rmax, rmin;
   bool             PseudoAtomicOrbital = false;
   double maxRadialcutoff = -1.0;
+  // takes the radial parts of the PA_<Z>_<n>_<l>.txt files from radialTables,
+  // which are read once per job and shared with compute_pdos
   void
-  CreatePseudoAtomicOrbitalBasis();
-  std::map<unsigned int, std::map<unsigned int, alglib::spline1dinterpolant *>>
-    radialSplineObject;
-  std::map<unsigned int, std::map<unsigned int, std::function<double(double)>>>
-         ROfBungeBasisFunct;
-  double zeta;
+  CreatePseudoAtomicOrbitalBasis(
+    dftfe::atomicOrbitalRadialTables &radialTables);
+  // radial part of the orbitals (n, l) from a table of radialTables
+  void
+  setRadialTable(unsigned int                                         n,
+                 unsigned int                                         l,
+                 const dftfe::atomicOrbitalRadialTables::radialTable *radial);
+  std::map<unsigned int,
+           std::map<unsigned int,
+                    const dftfe::atomicOrbitalRadialTables::radialTable *>>
+    radialTableObject;
+  // Bunge radial functions indexed by n * (n - 1) / 2 + l
+  std::vector<SlaterRadialExpansion> bungeRadialExpansions;
+  double                             zeta;
   void
   setorbitalnums();
   int
@@ -161,6 +206,11 @@ public:
   void
   getRofBungeOrbitalBasisFuncs(unsigned int atomicNum);
 
+  void
+  setBungeOrbital(unsigned int                   n,
+                  unsigned int                   l,
+                  const std::vector<SlaterTerm> &terms);
+
   double
   radialPartofSlaterTypeOrbital(unsigned int n, double r);
 
@@ -173,6 +223,14 @@ public:
   double
   radialPartOfBungeOrbital(unsigned int n, unsigned int l, double r);
 
+  // radial part at a block of numPoints radii
+  void
+  radialPartOfBungeOrbital(unsigned int  n,
+                           unsigned int  l,
+                           const double *r,
+                           unsigned int  numPoints,
+                           double *      values);
+
 
   double
   realSphericalHarmonics(unsigned int l, short int m, double theta, double phi);
@@ -340,6 +398,14 @@ numOfOrbitalsForShellCount(unsigned int n)
   return n * n;
 }
 
+// radial part of the Slater type orbital of principal quantum number n and
+// exponent 1.3 of the atom at atomPos, the 1s basis of
+// hydrogenMoleculeBondingOrbital()
+double
+radialPartofSlaterTypeOrbitalTest(unsigned int                 n,
+                                  const dealii::Point<3> &     evalPoint,
+                                  const std::array<double, 3> &atomPos);
+
 double
 hydrogenMoleculeBondingOrbital(const dealii::Point<3> &evalPoint);
 
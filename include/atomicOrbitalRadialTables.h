@@ -0,0 +1,99 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef atomicOrbitalRadialTables_H_
+#define atomicOrbitalRadialTables_H_
+
+#include <interpolation.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace dftfe
+{
+  /**
+   * @brief Radial parts of the pseudo-atomic orbitals, splined once per
+   * atomic number and (n, l) and shared by compute_pdos and the population
+   * analysis.
+   *
+   * Two kinds of files are read: the single atom wavefunctions psi<n><l>.inp
+   * (the PP_PSWFC data of the pseudopotential, tabulating R(r)) used by
+   * compute_pdos, and the PA_<Z>_<n>_<l>.txt files of the population
+   * analysis (tabulating r R(r)). A table is read the first time it is
+   * requested and every later request, also of another consumer or another
+   * analysis of the same job, returns the same table. Missing single atom
+   * wavefunction files are remembered as well, so that probing the orbital
+   * filling order does not hit the file system again.
+   */
+  class atomicOrbitalRadialTables
+  {
+  public:
+    enum class source
+    {
+      singleAtomWavefunction,
+      pseudoAtomicOrbital
+    };
+
+    struct radialTable
+    {
+      /// spline of R(r)
+      alglib::spline1dinterpolant spline;
+
+      /// first and last radius of the data
+      double rmin, rmax;
+
+      /// largest radius at which |R(r)| exceeds 1e-8
+      double truncationRadius;
+    };
+
+    /**
+     * @brief table of (Z, n, l) read from fileName if it is not known yet,
+     * nullptr if the file can not be read. Files of pseudoAtomicOrbital are
+     * required and a missing one is an error.
+     */
+    const radialTable *
+    table(const source       fileSource,
+          const unsigned int Z,
+          const unsigned int n,
+          const unsigned int l,
+          const std::string &fileName);
+
+    /**
+     * @brief true if (Z, n, l) of fileSource was requested before, whether
+     * or not its file could be read
+     */
+    bool
+    isKnown(const source       fileSource,
+            const unsigned int Z,
+            const unsigned int n,
+            const unsigned int l) const;
+
+    /**
+     * @brief number of tables read so far
+     */
+    unsigned int
+    numberOfTables() const;
+
+  private:
+    std::map<std::array<unsigned int, 4>, std::unique_ptr<radialTable>>
+      d_tables;
+  };
+
+} // namespace dftfe
+#endif
@@ -0,0 +1,118 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef bandFileWriter_H_
+#define bandFileWriter_H_
+
+#include <mpi.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Binary band file written with MPI-IO by the leaders of the k-point
+   * pools, each at the fixed offsets of its own k-points.
+   *
+   * The file starts with a header of headerBytes bytes: the characters
+   * "DFTFEBND", the int32 values version, numSpins, numBands and numKPoints
+   * and the double Fermi energies of spin up and spin down. It is followed by
+   * numKPoints records of recordBytes bytes in the order of the global
+   * k-point index, each holding the doubles
+   *
+   *   k_x k_y k_z weight
+   *   eigenvalues of spin 0 (numBands), occupations of spin 0 (numBands)
+   *   ... the same for spin 1 in the spin-polarized case
+   *
+   * in the native byte order. The pool leaders hand over their records one
+   * batch of k-points at a time as soon as they are converged, and the
+   * buffered batches of all leaders are written with collective I/O by
+   * flush() and close(). A leader with fewer batches than the others takes
+   * part with zero-length writes. Records that are never written read as
+   * zeros.
+   */
+  class bandFileWriter
+  {
+  public:
+    static const unsigned int version = 1;
+
+    /**
+     * @brief opens the file on the ranks of leaderComm and writes the header,
+     * ranks that are not pool leaders pass MPI_COMM_NULL and write nothing.
+     * Collective over leaderComm.
+     */
+    bandFileWriter(const std::string &fileName,
+                   const MPI_Comm &   leaderComm,
+                   const unsigned int numKPoints,
+                   const unsigned int numSpins,
+                   const unsigned int numBands,
+                   const double       fermiEnergyUp,
+                   const double       fermiEnergyDown);
+
+    ~bandFileWriter();
+
+    static std::size_t
+    headerBytes();
+
+    std::size_t
+    recordBytes() const;
+
+    /**
+     * @brief writes the records of numKPoints k-points starting at the global
+     * index firstKPoint. kPointCoordinates holds 3 values per k-point, and
+     * eigenValues and occupations numSpins * numBands values per k-point,
+     * spin major. The records are buffered until the next flush() or
+     * close(), independent of the other ranks of leaderComm.
+     */
+    void
+    writeKPoints(const unsigned int         firstKPoint,
+                 const unsigned int         numKPoints,
+                 const std::vector<double> &kPointCoordinates,
+                 const std::vector<double> &kPointWeights,
+                 const std::vector<double> &eigenValues,
+                 const std::vector<double> &occupations);
+
+    /**
+     * @brief writes the buffered batches of all ranks of leaderComm, one
+     * MPI_File_write_at_all per batch. Collective over leaderComm.
+     */
+    void
+    flush();
+
+    /**
+     * @brief flushes and closes the file, collective over leaderComm. Also
+     * done by the destructor.
+     */
+    void
+    close();
+
+  private:
+    /// offsets and records of the batches not yet written
+    std::vector<std::pair<MPI_Offset, std::vector<double>>> d_pendingBatches;
+
+    /// duplicate of leaderComm, MPI_COMM_NULL on the other ranks
+    MPI_Comm     d_leaderComm;
+    MPI_File     d_file;
+    bool         d_isOpen;
+    unsigned int d_numKPoints;
+    unsigned int d_numSpins;
+    unsigned int d_numBands;
+  };
+
+} // namespace dftfe
+#endif
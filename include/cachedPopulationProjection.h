@@ -0,0 +1,101 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef cachedPopulationProjection_H_
+#define cachedPopulationProjection_H_
+
+#include <mpi.h>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Atomic orbital basis Phi of a k-point kept with its overlap
+   * matrix S = Phi^H Phi and canonical orthogonalization X, U_k = S^{1/2} X
+   * for repeated population analyses of changing Kohn-Sham orbitals at fixed
+   * atom positions and mesh, e.g. along the SCF iterations.
+   *
+   * An analysis only forms the projections Phi^H Psi (one GEMM over the FE
+   * nodes and one reduction) followed by the dense algebra of the full
+   * analysis on the small matrices: C = X^H Phi^H Psi, O = C^H C and the
+   * coefficients C O^{-1/2} of the orthonormalized projected orbitals, which
+   * give the Mulliken and the Loewdin populations of the atoms.
+   *
+   * Phi and Psi are distributed over the FE nodes (rows) of mpiComm, all
+   * other quantities are replicated.
+   */
+  template <typename T>
+  class cachedPopulationProjection
+  {
+  public:
+    /**
+     * @brief Phi holds the nBasis basis functions at the nDofs locally owned
+     * FE nodes (nDofs x nBasis stored rowwise), forms and factorizes S.
+     * Collective.
+     */
+    cachedPopulationProjection(const std::vector<T> &Phi,
+                               const unsigned int    nDofs,
+                               const unsigned int    nBasis,
+                               const double          overlapEigenvalueThreshold,
+                               const MPI_Comm &      mpiComm);
+
+    unsigned int
+    basisDimension() const;
+
+    /**
+     * @brief dimension of the orthonormal basis after discarding near
+     * linear dependencies
+     */
+    unsigned int
+    retainedDimension() const;
+
+    /**
+     * @brief adds weight * sum_j occupations[j] sum_{a in A} W_{aj} of the
+     * nKS Kohn-Sham orbitals Psi (nDofs x nKS stored rowwise, locally owned
+     * FE nodes) to the Mulliken and Loewdin populations of every atom A,
+     * whose basis functions are atomBasisStart[A] to atomBasisStart[A+1].
+     * Collective.
+     */
+    void
+    accumulateAtomPopulations(const std::vector<T> &           Psi,
+                              const unsigned int               nKS,
+                              const std::vector<double> &      occupations,
+                              const std::vector<unsigned int> &atomBasisStart,
+                              const double                     weight,
+                              std::vector<double> &mullikenPopulations,
+                              std::vector<double> &loewdinPopulations) const;
+
+  private:
+    const unsigned int d_nDofs;
+    const unsigned int d_nBasis;
+    const MPI_Comm     d_mpiComm;
+
+    /// local nodal values of the basis, nDofs x nBasis
+    std::vector<T> d_Phi;
+
+    /// reduced overlap matrix, nBasis x nBasis
+    std::vector<T> d_S;
+
+    /// canonical orthogonalization X and S^{1/2} X, nBasis x d_retainedDim
+    std::vector<T> d_X;
+    std::vector<T> d_Uk;
+
+    unsigned int d_retainedDim;
+  };
+
+} // namespace dftfe
+#endif
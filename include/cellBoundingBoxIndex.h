@@ -0,0 +1,85 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef cellBoundingBoxIndex_H_
+#define cellBoundingBoxIndex_H_
+
+#include <array>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Uniform bins over the bounding boxes of the locally owned cells
+   * for locating the cells around arbitrary points.
+   *
+   * The bin size is the median extent of the boxes, grown until there are
+   * not more than about two bins per cell, and every box is listed in all
+   * bins it overlaps. A query only visits the bin of the point and returns
+   * the cells whose (slightly enlarged) box contains the point, which are
+   * the candidates for the exact test in the reference cell.
+   *
+   * The index is rank local and needs no communication.
+   */
+  class cellBoundingBoxIndex
+  {
+  public:
+    cellBoundingBoxIndex();
+
+    /**
+     * @brief lowerCorners and upperCorners are the corners of the bounding
+     * boxes of the cells, which are enlarged by tolerance in all directions.
+     */
+    void
+    build(const std::vector<std::array<double, 3>> &lowerCorners,
+          const std::vector<std::array<double, 3>> &upperCorners,
+          const double                              tolerance);
+
+    unsigned int
+    numberOfCells() const;
+
+    /**
+     * @brief cells whose enlarged box contains the point in increasing order
+     * of their ids, none for points outside all boxes
+     */
+    void
+    candidateCells(const std::array<double, 3> &point,
+                   std::vector<unsigned int> &  cellIds) const;
+
+  private:
+    /// bin of the point along the direction d, clamped to the grid
+    unsigned int
+    binIndex(const double x, const unsigned int d) const;
+
+    std::vector<std::array<double, 3>> d_lowerCorners;
+    std::vector<std::array<double, 3>> d_upperCorners;
+
+    /// lower and upper corner of all boxes, edge length of the bins, number
+    /// of bins per direction
+    std::array<double, 3>       d_lower;
+    std::array<double, 3>       d_upper;
+    double                      d_binSize;
+    std::array<unsigned int, 3> d_numBins;
+
+    /// cells of the bin (i_0 n_1 + i_1) n_2 + i_2 are
+    /// d_binCells[d_binStart[bin]] to d_binCells[d_binStart[bin+1]-1]
+    std::vector<unsigned int> d_binStart;
+    std::vector<unsigned int> d_binCells;
+  };
+
+} // namespace dftfe
+#endif
@@ -0,0 +1,129 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef cellQuadratureOverlapProjection_H_
+#define cellQuadratureOverlapProjection_H_
+
+#include <mpi.h>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Overlap matrix S = Phi^H W Phi and projections Phi^H W Psi of an
+   * atomic orbital basis with the quadrature weights W of the cells instead
+   * of the lumped mass matrix at the FE nodes.
+   *
+   * The cells are added in batches. The Kohn-Sham orbitals of a batch are
+   * interpolated from the nodal values of its cells to the quadrature points
+   * with one GEMM against the shape function values, and the contributions
+   * of the batch are formed with two GEMMs over the basis functions that are
+   * non-zero in the batch only, which are then added to the local S and
+   * Phi^H Psi. The batches are meant to be sized with cellsPerBatch() so
+   * that the quadrature point values of a batch stay in cache.
+   *
+   * The quadrature points of a batch of nCells cells are ordered quadrature
+   * point major, the row of the quadrature point q of the cell c being
+   * q * nCells + c, which makes the interpolation of the batch a single GEMM.
+   * The reduced S and Phi^H Psi are replicated on all ranks of mpiComm.
+   */
+  template <typename T>
+  class cellQuadratureOverlapProjection
+  {
+  public:
+    /**
+     * @brief shapeFunctionValues holds the values of the nNodesPerCell shape
+     * functions at the nQuadPointsPerCell quadrature points of the reference
+     * cell (nQuadPointsPerCell x nNodesPerCell stored rowwise)
+     */
+    cellQuadratureOverlapProjection(
+      const unsigned int         nBasis,
+      const unsigned int         nKS,
+      const unsigned int         nQuadPointsPerCell,
+      const unsigned int         nNodesPerCell,
+      const std::vector<double> &shapeFunctionValues,
+      const MPI_Comm &           mpiComm);
+
+    /**
+     * @brief waits for the outstanding reduction
+     */
+    ~cellQuadratureOverlapProjection();
+
+    /**
+     * @brief number of cells of a batch whose nodal and quadrature point
+     * values of nColumns functions fit into cacheBytes, at least one
+     */
+    static unsigned int
+    cellsPerBatch(const unsigned int nQuadPointsPerCell,
+                  const unsigned int nNodesPerCell,
+                  const unsigned int nColumns,
+                  const std::size_t  cacheBytes);
+
+    /**
+     * @brief adds a batch of nCells cells. cellNodalPsi holds the Kohn-Sham
+     * orbitals at the nodes of the cells (nNodesPerCell x nCells x nKS
+     * stored rowwise), quadPointScaling the factor of every quadrature point
+     * of the batch applied to the interpolated orbitals (the square root of
+     * JxW times the Bloch phase), Phi the m basis functions basisIds at the
+     * quadrature points of the batch already scaled with the square root of
+     * JxW (nQuadPointsPerCell * nCells x m stored rowwise).
+     */
+    void
+    addCells(const std::vector<T> &           cellNodalPsi,
+             const std::vector<T> &           quadPointScaling,
+             const std::vector<T> &           Phi,
+             const std::vector<unsigned int> &basisIds,
+             const unsigned int               nCells);
+
+    /**
+     * @brief full overlap matrix S (nBasis x nBasis stored rowwise), reduces
+     * S and posts the reduction of Phi^H Psi. No cells can be added
+     * afterwards.
+     */
+    std::vector<T>
+    overlapMatrix();
+
+    /**
+     * @brief projections Phi^H Psi (nBasis x nKS stored rowwise), waits for
+     * their reduction
+     */
+    std::vector<T>
+    projections();
+
+  private:
+    void
+    postProjectionReduction();
+
+    const unsigned int d_nBasis;
+    const unsigned int d_nKS;
+    const unsigned int d_nQuadPointsPerCell;
+    const unsigned int d_nNodesPerCell;
+    const MPI_Comm     d_mpiComm;
+
+    /// shape function values at the quadrature points
+    std::vector<T> d_shapeFunctionValues;
+
+    /// local contributions of the cells added so far
+    std::vector<T> d_S;
+    std::vector<T> d_projections;
+
+    MPI_Request d_projectionRequest;
+    bool        d_isProjectionReductionPosted;
+  };
+
+} // namespace dftfe
+#endif
@@ -59,6 +59,14 @@
 #include <excManager.h>
 #include <dftd.h>
 #include "dftBase.h"
+#include <populationBasisCache.h>
+#include <atomSpatialIndex.h>
+#include <cellQuadratureOverlapProjection.h>
+#include <cachedPopulationProjection.h>
+#include <dosBroadening.h>
+#include <bandFileWriter.h>
+#include <cellBoundingBoxIndex.h>
+#include <populationProfiler.h>
 #ifdef USE_PETSC
 #  include <petsc.h>
 
@@ -66,7 +74,6 @@
 #endif
 
 
-
 namespace dftfe
 {
   //
@@ -396,6 +403,30 @@ namespace dftfe
     dftParameters &
     getParametersObject() const;
 
+    /**
+     * @brief population analysis (pFOP) of the current ground state for all
+     * k-points and spins, writes the projectabilities and, with POPULATION
+     * PDOS WEIGHTS, the orbital resolved pDOS and keeps the atom charges,
+     * atom pair populations, ICOHP and spill factors in memory
+     */
+    void
+    computePopulationAnalysis();
+
+    /**
+     * @brief results of the last computePopulationAnalysis()
+     */
+    const populationAnalysisResults &
+    getPopulationAnalysisResults() const;
+
+    /**
+     * @brief population analysis of the step of a molecular dynamics or
+     * relaxation trajectory if step is a multiple of POPULATION ANALYSIS
+     * FREQUENCY, appends the step to populationTimeSeries.bin (time in fs),
+     * step 0 starts a new file
+     */
+    void
+    trajectoryPopulationAnalysis(const unsigned int step, const double time);
+
   private:
     /**
      * @brief generate image charges and update k point cartesian coordinates based
@@ -964,9 +995,168 @@ namespace dftfe
     compute_pdos(const std::vector<std::vector<double>> &eigenValuesInput,
                  const std::string &                     fileName);
 
+    /**
+     * @brief evaluates the atomic orbitals of basisInfo, including the
+     * contributions of the periodic images, at the locally owned FE nodes
+     * scaled by the square root of the mass vector (n_dofs x basisInfo.size()
+     * stored rowwise). Returns the number of orbital evaluations within the
+     * radial cutoffs. With a neighborList only the images near the local
+     * nodes are visited.
+     */
+    int
+    evaluateAtomicOrbitalsAtNodes(
+      const std::vector<LocalAtomicBasisInfo> &basisInfo,
+      std::vector<AtomicOrbitalBasisManager> & atomTypewiseSTOvector,
+      const std::vector<IndexSet::size_type> & locallyOwnedDOFs,
+      const unsigned int                       kpoint,
+      std::vector<dataTypes::number> &         orbitalValues,
+      const populationNeighborList *           neighborList = nullptr);
+
+    /**
+     * @brief evaluates the atomic orbitals of basisInfo at the points scaled
+     * by pointWeights (points.size() x basisInfo.size() stored rowwise),
+     * summing over the charges chargeIdsOfAtoms of the atom of every basis
+     * function. Points with zero weight are skipped. Returns the number of
+     * orbital evaluations within the radial cutoffs.
+     */
+    int
+    evaluateAtomicOrbitalsAtPoints(
+      const std::vector<LocalAtomicBasisInfo> &basisInfo,
+      std::vector<AtomicOrbitalBasisManager> & atomTypewiseSTOvector,
+      const std::vector<Point<3>> &            points,
+      const std::vector<double> &              pointWeights,
+      const unsigned int                       kpoint,
+      const std::vector<std::vector<int>> &    chargeIdsOfAtoms,
+      std::vector<dataTypes::number> &         orbitalValues);
+
+    /**
+     * @brief adds the locally owned cells to the overlap matrix and the
+     * projections of the first numOfKSOrbitals Kohn-Sham orbitals
+     * eigenVectorsKS of a k-point, evaluated with the density quadrature in
+     * cache sized batches of cells. Returns the number of orbital
+     * evaluations within the radial cutoffs.
+     */
+    int
+    addPopulationQuadratureCells(
+      const std::vector<dataTypes::number> &              eigenVectorsKS,
+      const unsigned int                                  numOfKSOrbitals,
+      const unsigned int                                  kpoint,
+      cellQuadratureOverlapProjection<dataTypes::number> &projection,
+      populationProfiler &                                profiler);
+
+    /**
+     * @brief sets the radial parts of the pseudo-atomic orbitals of atomBasis
+     * from d_atomicOrbitalRadialTables, taken from the PA_<Z>_<n>_<l>.txt
+     * files or, with POPULATION PSP ORBITALS, from the single atom
+     * wavefunctions that compute_pdos projects onto
+     */
+    void
+    createPseudoAtomicOrbitalBasis(AtomicOrbitalBasisManager &atomBasis);
+
+    /**
+     * @brief builds the atomic orbital basis of BasisInfo.inp for the current
+     * atoms in d_populationBasisCache, returns false if the cached basis
+     * already matches the atomic numbers
+     */
+    bool
+    updatePopulationBasisCache();
+
+    /**
+     * @brief updates the neighbor list of d_populationBasisCache for the
+     * current atom and image positions and the bounding box of the local
+     * points, returns true if it was rebuilt on this processor
+     */
+    bool
+    updatePopulationNeighborList(const std::vector<Point<3>> &localPoints);
+
+    /**
+     * @brief updates d_atomSpatialIndex for the current atom and image
+     * positions, returns true if it was rebuilt
+     */
+    bool
+    updateAtomSpatialIndex();
+
+    /**
+     * @brief reduces the atom pairs of d_populationBasisCache to irreducible
+     * representatives under the space group operations of the current atoms
+     * that leave the k-points invariant
+     */
     void
+    updatePopulationPairSymmetry();
+
+    /**
+     * @brief projection of the Kohn-Sham orbitals of a k-point and spin onto
+     * the atomic orbital basis (pFOP), returns the per band projectabilities.
+     * If orbitalWeights is given it is filled with the POPULATION PDOS
+     * WEIGHTS of the bands (basis x bands stored rowwise).
+     */
+    std::vector<double>
     orbitalPopulationCompute(
-      const std::vector<std::vector<double>> &eigenValuesInput, unsigned int kpoint = 0);
+      const std::vector<std::vector<double>> &eigenValuesInput,
+      unsigned int                            kpoint         = 0,
+      unsigned int                            spinIndex      = 0,
+      std::vector<double> *                   orbitalWeights = nullptr);
+
+    /**
+     * @brief first numOfKSOrbitals Kohn-Sham orbitals eigenVectorsKS of a
+     * k-point at the locally owned FE nodes scaled by the square root of the
+     * mass vector and the Bloch phase, zero at the constrained nodes
+     * (n_dofs x numOfKSOrbitals stored rowwise)
+     */
+    std::vector<dataTypes::number>
+    scaledKohnShamOrbitalsAtNodes(
+      const std::vector<dataTypes::number> &  eigenVectorsKS,
+      const unsigned int                      numOfKSOrbitals,
+      const unsigned int                      kpoint,
+      const std::vector<IndexSet::size_type> &locallyOwnedDOFs);
+
+    /**
+     * @brief copies the eigenvectors of all k-points and spins from the
+     * device to d_eigenVectorsFlattenedSTL, nothing to do on the host
+     */
+    void
+    copyEigenVectorsToHost();
+
+    /**
+     * @brief prints the Mulliken and Loewdin charges of the atoms from the
+     * current Kohn-Sham orbitals of SCF iteration scfIter and the largest
+     * change since the last update. The atomic orbitals and the factorized
+     * overlap matrix of every k-point are kept in d_scfPopulationProjections
+     * until the next ground state solve.
+     */
+    void
+    scfPopulationCharges(const unsigned int scfIter);
+
+    /**
+     * @brief writes the per band projectabilities of all k-points to
+     * projectabilities.txt and prints the k-point weighted spill factors
+     */
+    void
+    writeProjectabilitiesAndSpillFactors(
+      const std::vector<std::vector<double>> &projectabilitiesOfKPoints,
+      const std::vector<std::vector<double>> &eigenValuesInput);
+
+    /**
+     * @brief orbital resolved projected density of states and fat bands
+     * from the orbital weights of orbitalPopulationCompute() of the local
+     * k-points and spins (index (1 + spinPolarized) * kPoint + spin), k-point
+     * weighted and reduced over the pools
+     */
+    void
+    writePopulationPdos(
+      const std::vector<std::vector<double>> &orbitalWeightsOfKPoints,
+      const std::vector<std::vector<double>> &eigenValuesInput);
+
+    /**
+     * @brief spill factors of a sequence of nested atomic orbital bases, the
+     * basis of BasisInfo.inp augmented one shell at a time by the lines of
+     * BASIS AUGMENTATION FILE, using block updates of the projection
+     * (incrementalProjection), for all local k-points. Writes
+     * basisAugmentationScan.txt with the global k-point indices.
+     */
+    void
+    basisAugmentationScan(
+      const std::vector<std::vector<double>> &eigenValuesInput);
 
     void
     hamiltonianPopulationCompute(
@@ -989,6 +1179,27 @@ namespace dftfe
     void
     compute_localizationLength(const std::string &locLengthFileName);
 
+    /**
+     *@brief values of the wavefunctions bandStart to bandStart + numBands - 1
+     * of all k-points and spins at arbitrary points, on all processors.
+     * values[((kPoint * numSpins + spin) * points.size() + point) * numBands
+     * + iWave] with the global k-point index, zero for points outside the
+     * domain. Collective over d_mpiCommParent.
+     */
+    void
+    evaluateWavefunctionsAtPoints(const std::vector<Point<3>> &    points,
+                                  const unsigned int               bandStart,
+                                  const unsigned int               numBands,
+                                  std::vector<dataTypes::number> &values);
+
+    /**
+     *@brief evaluate the wavefunctions of WFC PROBE BAND START and WFC PROBE
+     * NUMBER OF BANDS at the points of a file and write them into a file
+     */
+    void
+    writeWavefunctionsAtPoints(const std::string &pointsFileName,
+                               const std::string &outputFileName);
+
     /**
      *@brief write wavefunction solution fields
      */
@@ -1002,11 +1213,27 @@ namespace dftfe
     outputDensity();
 
     /**
-     *@brief write the KS eigen values for given BZ sampling/path
+     *@brief write the KS eigen values for given BZ sampling/path, as text
+     * (bands.out) or with BANDS FILE FORMAT=BINARY as binary band file
+     * (bands.bin)
      */
     void
     writeBands();
 
+    /**
+     *@brief opens d_bandFileWriter for the k-points of all pools
+     */
+    void
+    openBandFile();
+
+    /**
+     *@brief writes the band records of numKPoints local k-points starting at
+     * firstKPoint
+     */
+    void
+    writeBandFileKPoints(const unsigned int firstKPoint,
+                         const unsigned int numKPoints);
+
     /**
      *@brief Computes the volume of the domain
      */
@@ -1685,6 +1912,10 @@ namespace dftfe
 
     /// global k index of lower bound of the local k point set
     unsigned int lowerBoundKindex = 0;
+
+    /// global index of the irreducible k point of every point of the
+    /// Monkhorst-Pack grid, empty if the k points were read from file
+    std::vector<unsigned int> d_mpGridIrreducibleKPoints;
     /**
      * Recomputes the k point cartesian coordinates from the crystal k point
      * coordinates and the current lattice vectors, which can change in each
@@ -1700,6 +1931,32 @@ namespace dftfe
 
     double d_freeEnergy;
 
+    /// results of the last population analysis, accumulated over the local
+    /// k-points by orbitalPopulationCompute()
+    populationAnalysisResults d_populationAnalysisResults;
+
+    /// atomic orbital basis and neighbor list of the population analysis
+    populationBasisCache d_populationBasisCache;
+
+    /// binary band file, open while nscf streams its k-points
+    std::unique_ptr<bandFileWriter> d_bandFileWriter;
+
+    /// bins over the atoms and their periodic images for the cell to atom
+    /// assignment of the LDOS and the atoms near the cells of the PDOS
+    atomSpatialIndex d_atomSpatialIndex;
+
+    /// radial parts of the pseudo-atomic orbitals of compute_pdos and the
+    /// population analysis, read once per job
+    atomicOrbitalRadialTables d_atomicOrbitalRadialTables;
+
+    /// atomic orbitals and factorized overlap matrix of the local k-points
+    /// for the charges along the SCF iterations, cleared by solve()
+    std::vector<std::unique_ptr<cachedPopulationProjection<dataTypes::number>>>
+      d_scfPopulationProjections;
+
+    /// Mulliken charges of the last SCF population update
+    std::vector<double> d_scfMullikenCharges;
+
     /// entropic energy
     double d_entropicEnergy;
 
@@ -22,6 +22,7 @@
 #include <tuple>
 #include <deal.II/base/tensor_function.h>
 #include "dftParameters.h"
+#include "populationAnalysisResults.h"
 
 namespace dftfe
 {
@@ -159,6 +160,27 @@ namespace dftfe
     virtual dftParameters &
     getParametersObject() const = 0;
 
+    /**
+     * @brief population analysis (pFOP) of the current ground state, with
+     * the atomic orbital basis of BasisInfo.inp
+     */
+    virtual void
+    computePopulationAnalysis() = 0;
+
+    /**
+     * @brief results of the last computePopulationAnalysis()
+     */
+    virtual const populationAnalysisResults &
+    getPopulationAnalysisResults() const = 0;
+
+    /**
+     * @brief population analysis of a step of a trajectory, every
+     * POPULATION ANALYSIS FREQUENCY steps, appended to populationTimeSeries.bin
+     */
+    virtual void
+    trajectoryPopulationAnalysis(const unsigned int step,
+                                 const double       time) = 0;
+
     /**
      * @brief writes the current domain bounding vectors and atom coordinates to files, which are required for
      * geometry relaxation restart
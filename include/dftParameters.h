@@ -70,6 +70,9 @@ namespace dftfe
 
     std::string coordinatesGaussianDispFile;
 
+    /// TEXT (bands.out) or BINARY (bands.bin)
+    std::string bandsFileFormat;
+
     double      outerAtomBallRadius, innerAtomBallRadius, meshSizeOuterDomain;
     bool        autoAdaptBaseMeshSize;
     double      meshSizeInnerBall, meshSizeOuterBall;
@@ -96,6 +99,13 @@ namespace dftfe
 
     bool writeDensitySolutionFields;
 
+    /// VTU, PARALLEL VTU or HDF5, and the VTU compression level
+    std::string fieldOutputFormat, fieldOutputCompression;
+
+    /// energy window of WRITE WFC relative to the Fermi energy, used if
+    /// wfcOutputEnergyMin < wfcOutputEnergyMax
+    double wfcOutputEnergyMin, wfcOutputEnergyMax;
+
     std::string  startingWFCType;
     unsigned int numCoreWfcRR;
     unsigned int numCoreWfcXtHX;
@@ -130,6 +140,15 @@ namespace dftfe
     bool         overlapComputeCommunOrthoRR;
     bool         autoDeviceBlockSizes;
     bool         readWfcForPdosPspFile;
+    std::string  dosBroadeningType;
+    double       dosBroadeningWidth;
+    unsigned int dosMethfesselPaxtonOrder;
+    double       dosKernelCutoff;
+    double       dosEnergySpacing;
+    double       dosEnergyMin, dosEnergyMax;
+    bool         dosTetrahedron;
+    std::string  wfcProbePointsFile;
+    unsigned int wfcProbeBandStart, wfcProbeNumberBands;
     double       maxJacobianRatioFactorForMD;
     double       chebyshevFilterPolyDegreeFirstScfScalingFactor;
     int          extrapolateDensity;
@@ -185,6 +204,17 @@ namespace dftfe
     unsigned int NumofKSOrbitalsproj;
     bool         ComputePFOP, ComputePFHP;
     unsigned int AtomicOrbitalBasis;
+    double       overlapEigenvalueThreshold;
+    std::string  basisAugmentationFile;
+    std::string  populationPdosWeights;
+    bool         writePopulationFiles;
+    unsigned int populationAnalysisFrequency;
+    double       populationNeighborSkin;
+    double       populationEnergyWindowMin, populationEnergyWindowMax;
+    bool         populationPairSymmetry;
+    bool         populationProjectionQuadrature;
+    bool         populationPspOrbitals;
+    unsigned int populationScfFrequency;
     std::string  pseudoAtomicOrbitalsFile;
 
     dftParameters();
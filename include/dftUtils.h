@@ -243,6 +243,24 @@ namespace dftfe
                                      const std::string &folderName,
                                      const std::string &fileName);
 
+    /** @brief Writes all fields of dataOut into a single file per domain
+     * communicator, collective over mpiCommDomain
+     *
+     *  @param  dataOut  DataOut class object with the patches built
+     *  @param  mpiCommDomain mpi communicator of the processors writing the file
+     *  @param  format  PARALLEL VTU (fileName.vtu, single precision, MPI-IO) or
+     *  HDF5 (fileName.h5 and fileName.xdmf, double precision, parallel HDF5)
+     *  @param  compression  zlib level of the vtu file, NONE, SPEED, DEFAULT or
+     *  BEST
+     */
+    void
+    writeDataParallelSingleFile(dealii::DataOut<3> &dataOut,
+                                const MPI_Comm &    mpiCommDomain,
+                                const std::string & folderName,
+                                const std::string & fileName,
+                                const std::string & format,
+                                const std::string & compression);
+
     /** @brief Create index vector which is used for band parallelization
      *
      *  @[in]param  interBandGroupComm  mpi communicator across band groups
@@ -22,6 +22,8 @@
 #include <string>
 #include <vector>
 
+#include "populationAnalysisResults.h"
+
 namespace dftfe
 {
   class dftBase;
@@ -270,6 +272,17 @@ namespace dftfe
     std::vector<std::vector<double>>
     getCellStress() const;
 
+    /**
+     * @brief population analysis (pFOP) of the ground-state in the atomic
+     * orbital basis of BasisInfo.inp. This function can only be called after
+     * calling computeDFTFreeEnergy. The files of the analysis are only
+     * written with WRITE POPULATION FILES
+     *
+     * @return atom charges, atom pair populations, ICOHP and spill factors
+     */
+    populationAnalysisResults
+    computePopulationAnalysis();
+
     /**
      * @brief update atom positions and reinitialize all related  data-structures
      *
@@ -0,0 +1,158 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef dosBroadening_H_
+#define dosBroadening_H_
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Broadening of energy levels on the uniform energy grid of the
+   * density of states, shared by the total, local and projected DOS.
+   *
+   * The Lorentzian, Gaussian and Methfessel-Paxton kernels are truncated
+   * at cutoff widths from the level, so that a level only touches the
+   * grid points of its window, and the truncated Lorentzian and Gaussian
+   * are rescaled to unit weight. Rows with more levels than grid points
+   * are binned into a histogram first, with the weight of a level split
+   * linearly between its two neighbouring grid points, and the histogram
+   * is convolved with the tabulated kernel.
+   *
+   * Alternatively the linear tetrahedron method integrates bands given on
+   * a full Monkhorst-Pack grid without any broadening. The DOS of a grid
+   * point is then the average over its interval of width intervalSize
+   * centred at the grid point, which conserves the number of states.
+   */
+  class dosBroadening
+  {
+  public:
+    enum class kernelType
+    {
+      lorentzian,
+      gaussian,
+      methfesselPaxton
+    };
+
+    /**
+     * @brief width is the half width of the Lorentzian, the standard
+     * deviation of the Gaussian and the width sigma of exp(-(E/sigma)^2) of
+     * the Methfessel-Paxton kernel of order methfesselPaxtonOrder. The
+     * kernel is truncated at cutoffWidths times the width, 0 uses 100
+     * widths for the Lorentzian and 8 widths otherwise. The grid points are
+     * lowerBound + e * intervalSize for e < numIntervals.
+     */
+    dosBroadening(const kernelType   kernel,
+                  const double       width,
+                  const unsigned int methfesselPaxtonOrder,
+                  const double       cutoffWidths,
+                  const double       lowerBound,
+                  const double       intervalSize,
+                  const unsigned int numIntervals);
+
+    /**
+     * @brief kernel of the parameter DOS BROADENING TYPE
+     */
+    static kernelType
+    kernelFromString(const std::string &kernelName);
+
+    double
+    lowerBound() const;
+
+    double
+    intervalSize() const;
+
+    unsigned int
+    numIntervals() const;
+
+    double
+    energy(const unsigned int e) const;
+
+    /**
+     * @brief normalized kernel at the distance x from the level, zero
+     * beyond the cutoff
+     */
+    double
+    kernel(const double x) const;
+
+    /**
+     * @brief adds weight * sum_j levelWeights_{rj} K(E_e - energyLevels[j])
+     * to dos[r * numIntervals() + e] for the nRows rows of levelWeights
+     * (nRows x energyLevels.size() stored rowwise)
+     */
+    void
+    accumulate(const std::vector<double> &energyLevels,
+               const std::vector<double> &levelWeights,
+               const unsigned int         nRows,
+               const double               weight,
+               std::vector<double> &      dos) const;
+
+    /**
+     * @brief adds weight * sum_j K(E_e - energyLevels[j]) to dos[e]
+     */
+    void
+    accumulate(const std::vector<double> &energyLevels,
+               const double               weight,
+               std::vector<double> &      dos) const;
+
+    /**
+     * @brief the 6 n_1 n_2 n_3 tetrahedra of the Monkhorst-Pack grid of
+     * gridSize points (index (i_1 n_2 + i_2) n_3 + i_3, periodic), every
+     * subcell split along its shortest main diagonal in the reciprocal
+     * lattice of the rows of reciprocalLatticeVectors
+     */
+    static std::vector<std::array<unsigned int, 4>>
+    monkhorstPackTetrahedra(
+      const std::array<unsigned int, 3> &     gridSize,
+      const std::vector<std::vector<double>> &reciprocalLatticeVectors);
+
+    /**
+     * @brief adds weight times the linear tetrahedron DOS of the nBands
+     * bands with the energies gridEnergies (grid points x nBands stored
+     * rowwise) to dos, each tetrahedron carrying 1 / tetrahedra.size() of
+     * the weight
+     */
+    void
+    accumulateTetrahedra(
+      const std::vector<double> &                     gridEnergies,
+      const unsigned int                              nBands,
+      const std::vector<std::array<unsigned int, 4>> &tetrahedra,
+      const double                                    weight,
+      std::vector<double> &                           dos) const;
+
+  private:
+    const kernelType   d_kernel;
+    const double       d_width;
+    const unsigned int d_methfesselPaxtonOrder;
+    const double       d_lowerBound;
+    const double       d_intervalSize;
+    const unsigned int d_numIntervals;
+
+    /// truncation distance of the kernel and the rescaling of its weight
+    double d_cutoff;
+    double d_normalization;
+
+    /// kernel at the distances d * intervalSize, |d| <= d_windowIntervals
+    unsigned int        d_windowIntervals;
+    std::vector<double> d_kernelTable;
+  };
+
+} // namespace dftfe
+#endif
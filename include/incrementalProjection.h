@@ -0,0 +1,121 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef incrementalProjection_H_
+#define incrementalProjection_H_
+
+#include <mpi.h>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Projection of the Kohn-Sham orbitals onto an atomic orbital basis
+   * that grows by appending blocks of basis functions.
+   *
+   * The basis Phi (n functions) is kept together with a whitening matrix W
+   * (n x k) satisfying W^H S W = I, S = Phi^H Phi, and the coefficients
+   * C = W^H Phi^H Psi (k x nKS) of the projected Kohn-Sham orbitals in the
+   * orthonormal basis Phi W, so that the projectabilities are the squared
+   * column norms of C. Appending m functions Phi_2 only requires the new
+   * overlap blocks S_12 = Phi^H Phi_2, S_22 = Phi_2^H Phi_2 and the new rows
+   * Phi_2^H Psi (one reduction over the FE nodes). With Q = W^H S_12 the part
+   * of Phi_2 orthogonal to the current span has the overlap S_22 - Q^H Q,
+   * which is canonically orthogonalized (see canonicalOrthogonalization())
+   * into Y (m x k'), discarding directions whose eigenvalues are not above
+   * the threshold. W is extended by the block column [-W Q Y; Y] and C by
+   * the rows Y^H (Phi_2^H Psi - Q^H C).
+   *
+   * The cost of an append is O(nDofs m (n + m + nKS)) for the new blocks
+   * instead of O(nDofs (n + m) (n + m + nKS)) for the whole projection, so a
+   * scan over nested basis sets reuses all previous work.
+   *
+   * Phi and Psi are distributed over the FE nodes (rows) of mpiComm, all
+   * other quantities are replicated.
+   */
+  template <typename T>
+  class incrementalProjection
+  {
+  public:
+    /**
+     * @brief Psi holds the nKS Kohn-Sham orbitals at the nDofs locally owned
+     * FE nodes (nDofs x nKS stored rowwise) and has to outlive the object
+     */
+    incrementalProjection(const std::vector<T> &Psi,
+                          const unsigned int    nDofs,
+                          const unsigned int    nKS,
+                          const double          overlapEigenvalueThreshold,
+                          const MPI_Comm &      mpiComm);
+
+    /**
+     * @brief appends the m basis functions PhiNew (nDofs x m stored rowwise,
+     * locally owned FE nodes) and returns the number of retained directions
+     * among them. Collective.
+     */
+    unsigned int
+    appendBasis(const std::vector<T> &PhiNew, const unsigned int m);
+
+    /**
+     * @brief number of appended basis functions
+     */
+    unsigned int
+    basisDimension() const;
+
+    /**
+     * @brief dimension of the orthonormal basis after discarding near
+     * linear dependencies
+     */
+    unsigned int
+    retainedDimension() const;
+
+    /**
+     * @brief projectabilities (C^H C)_{ii} of the nKS Kohn-Sham orbitals
+     */
+    const std::vector<double> &
+    projectabilities() const;
+
+    /**
+     * @brief coefficients W C (basisDimension() x nKS stored rowwise) of the
+     * projected Kohn-Sham orbitals in the atomic orbital basis
+     */
+    std::vector<T>
+    coefficients() const;
+
+  private:
+    const std::vector<T> &d_Psi;
+    const unsigned int    d_nDofs;
+    const unsigned int    d_nKS;
+    const double          d_overlapEigenvalueThreshold;
+    const MPI_Comm        d_mpiComm;
+
+    /// local nodal values of the basis, nDofs x d_basisDim
+    std::vector<T> d_Phi;
+
+    /// whitening matrix, d_basisDim x d_retainedDim
+    std::vector<T> d_W;
+
+    /// coefficients in the orthonormal basis, d_retainedDim x nKS
+    std::vector<T> d_C;
+
+    std::vector<double> d_projectabilities;
+
+    unsigned int d_basisDim;
+    unsigned int d_retainedDim;
+  };
+
+} // namespace dftfe
+#endif
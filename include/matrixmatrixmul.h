@@ -199,4 +199,28 @@ TransposeMatrix(std::vector<double> &A, int N);
 std::vector<std::complex<double>> 
 TransposeMatrix(std::vector<std::complex<double>> &A, int N);
 
+// canonical orthogonalization of the N x N overlap matrix S = V D V^H given
+// the eigenvalues D and Ut = TransposeMatrix(U) from diagonalization(), i.e.
+// the eigenvectors stored as the columns of a rowwise matrix. Eigenvectors
+// with eigenvalues below or equal to threshold are discarded and the k
+// retained ones give X = V_k D_k^{-1/2} (N x k), spanning the reduced
+// orthonormal basis Phi X, and V_k (N x k) = S^{1/2} X which maps
+// coefficients in that basis to Loewdin orthogonalized orbitals. Both are
+// stored rowwise and k is returned.
+unsigned int
+canonicalOrthogonalization(const std::vector<double> &D,
+                           const std::vector<double> &Ut,
+                           const unsigned int         N,
+                           const double               threshold,
+                           std::vector<double> &      X,
+                           std::vector<double> &      Uk);
+
+unsigned int
+canonicalOrthogonalization(const std::vector<double> &              D,
+                           const std::vector<std::complex<double>> &Ut,
+                           const unsigned int                       N,
+                           const double                             threshold,
+                           std::vector<std::complex<double>> &      X,
+                           std::vector<std::complex<double>> &      Uk);
+
 #endif
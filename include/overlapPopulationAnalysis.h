@@ -163,7 +163,111 @@ spillFactorsOfProjection(const std::vector<double> &coeffMatrixVecOfProj,
                          const std::vector<double> &arrayVecOfProj,
                          const std::vector<double> &occupationNum);
 
+// projectabilities p_i = (C^H S C)_{ii} of the nKS projected Kohn-Sham
+// orbitals evaluated as column-wise dot products of C = S^{-1} Phi^H Psi and
+// Phi^H Psi (both nBasis x nKS stored rowwise) in O(nBasis nKS) without
+// forming S C. The bands are split over the ranks of mpiComm and assembled
+// with a single reduction, the result is available on all ranks.
+std::vector<double>
+projectabilitiesOfProjection(const std::vector<double> &C,
+                             const std::vector<double> &PhiTPsi,
+                             const unsigned int         nBasis,
+                             const unsigned int         nKS,
+                             const MPI_Comm &           mpiComm);
+
+std::vector<double>
+projectabilitiesOfProjection(const std::vector<std::complex<double>> &C,
+                             const std::vector<std::complex<double>> &PhiTPsi,
+                             const unsigned int                       nBasis,
+                             const unsigned int                       nKS,
+                             const MPI_Comm &                         mpiComm);
+
+// orbital resolved weights Re(conj(A_{aj}) B_{aj}) (nBasis x nKS stored
+// rowwise) of the projected Kohn-Sham orbitals, the Mulliken weights for
+// A = C, B = S C and the Loewdin weights for A = B = S^{1/2} C with
+// C = S^{-1} Phi^H Psi. Both sum over the basis to the projectabilities.
+std::vector<double>
+orbitalWeightsOfProjection(const std::vector<double> &A,
+                           const std::vector<double> &B,
+                           const unsigned int         nBasis,
+                           const unsigned int         nKS);
+
+std::vector<double>
+orbitalWeightsOfProjection(const std::vector<std::complex<double>> &A,
+                           const std::vector<std::complex<double>> &B,
+                           const unsigned int                       nBasis,
+                           const unsigned int                       nKS);
+
+// adds weight * sum_{a in A, b in B} Re(P_{ab} M_{ba}) to
+// atomPairValues[A * numAtoms + B] (numAtoms x numAtoms stored rowwise) for
+// the density matrix P = C f C^H of the coefficients C (nBasis x nKS) and
+// occupations f of the bands, M being nBasis x nBasis Hermitian and
+// atomOfBasis the atom of every basis function. With M = S and C the
+// orthonormalized projections these are the Mulliken atom pair populations
+// (integrated pCOOP), with M = Hproj and C the Loewdin coefficients the
+// integrated pCOHP
+void
+accumulateAtomPairContractions(const std::vector<double> &      C,
+                               const std::vector<double> &      M,
+                               const std::vector<double> &      occupationNum,
+                               const unsigned int               nBasis,
+                               const unsigned int               nKS,
+                               const std::vector<unsigned int> &atomOfBasis,
+                               const unsigned int               numAtoms,
+                               const double                     weight,
+                               std::vector<double> &            atomPairValues);
+
 void
+accumulateAtomPairContractions(
+  const std::vector<std::complex<double>> &C,
+  const std::vector<std::complex<double>> &M,
+  const std::vector<double> &              occupationNum,
+  const unsigned int                       nBasis,
+  const unsigned int                       nKS,
+  const std::vector<unsigned int> &        atomOfBasis,
+  const unsigned int                       numAtoms,
+  const double                             weight,
+  std::vector<double> &                    atomPairValues);
+
+// same contraction for the atom pairs (A, B) = atomPairs[p] only, added
+// to pairValues[p], the basis functions of atom A being atomBasisStart[A]
+// to atomBasisStart[A + 1] - 1. The blocks of the density matrix are
+// formed for these pairs only, with one GEMM per first atom
+void
+accumulateSelectedAtomPairContractions(
+  const std::vector<double> &                     C,
+  const std::vector<double> &                     M,
+  const std::vector<double> &                     occupationNum,
+  const unsigned int                              nBasis,
+  const unsigned int                              nKS,
+  const std::vector<unsigned int> &               atomBasisStart,
+  const std::vector<std::array<unsigned int, 2>> &atomPairs,
+  const double                                    weight,
+  std::vector<double> &                           pairValues);
+
+void
+accumulateSelectedAtomPairContractions(
+  const std::vector<std::complex<double>> &       C,
+  const std::vector<std::complex<double>> &       M,
+  const std::vector<double> &                     occupationNum,
+  const unsigned int                              nBasis,
+  const unsigned int                              nKS,
+  const std::vector<unsigned int> &               atomBasisStart,
+  const std::vector<std::array<unsigned int, 2>> &atomPairs,
+  const double                                    weight,
+  std::vector<double> &                           pairValues);
+
+// spill factors from the projectabilities of the first
+// projectabilities.size() bands and their occupations
+spillFactors
+spillFactorsFromProjectabilities(const std::vector<double> &projectabilities,
+                                 const std::vector<double> &occupationNum);
+
+// C is the m1 x n1 (basis x KS orbitals) coefficient matrix and S the
+// m2 x n2 overlap matrix, real S is passed as its packed upper triangle.
+// Prints and returns the spill factors along with the projectabilities
+// diag(C^T S C)
+spillFactors
 spillFactorsofProjectionwithCS(const std::vector<double> &C,
                                const std::vector<double> &Sold,
                                const std::vector<double> &occupationNum,
@@ -171,7 +275,7 @@ spillFactorsofProjectionwithCS(const std::vector<double> &C,
                                int                        n1,
                                int                        m2,
                                int                        n2);
-void
+spillFactors
 spillFactorsofProjectionwithCS(const std::vector<std::complex<double>> &C,
                                const std::vector<std::complex<double>> &Sold,
                                const std::vector<double> &occupationNum,
@@ -0,0 +1,116 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef pipelinedOverlapProjection_H_
+#define pipelinedOverlapProjection_H_
+
+#include <mpi.h>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Overlap matrix S = Phi^H Phi and projections Phi^H Psi of an atomic
+   * orbital basis that is evaluated in blocks of basis functions, with the
+   * reductions over the FE nodes pipelined behind the evaluation.
+   *
+   * Appending the block Phi_j (m functions) computes the column block
+   * [Phi_1 ... Phi_j]^H Phi_j of the upper triangle of S and the rows
+   * Phi_j^H Psi, which are final up to the sum over the FE nodes, and posts
+   * one MPI_Iallreduce for each of them before returning. The reductions
+   * then proceed while the next block of Phi is evaluated; appendBasis()
+   * drives their progress with MPI_Testall. overlapMatrix() only waits for
+   * the S reductions, so the eigendecomposition of S can run while the
+   * Phi^H Psi reductions are still in flight, and projections() waits for
+   * the rest.
+   *
+   * Phi and Psi are distributed over the FE nodes (rows) of mpiComm, the
+   * reduced S and Phi^H Psi are replicated. All member functions except the
+   * accessors of the dimensions are collective and have to be called in the
+   * same order on all ranks.
+   */
+  template <typename T>
+  class pipelinedOverlapProjection
+  {
+  public:
+    /**
+     * @brief Psi holds the nKS Kohn-Sham orbitals at the nDofs locally owned
+     * FE nodes (nDofs x nKS stored rowwise) and has to outlive the object
+     */
+    pipelinedOverlapProjection(const std::vector<T> &Psi,
+                               const unsigned int    nDofs,
+                               const unsigned int    nKS,
+                               const MPI_Comm &      mpiComm);
+
+    /**
+     * @brief waits for outstanding reductions
+     */
+    ~pipelinedOverlapProjection();
+
+    /**
+     * @brief appends the m basis functions PhiNew (nDofs x m stored rowwise,
+     * locally owned FE nodes) and posts the reductions of their overlap and
+     * projection blocks. PhiNew is moved into the object.
+     */
+    void
+    appendBasis(std::vector<T> &PhiNew, const unsigned int m);
+
+    /**
+     * @brief number of appended basis functions
+     */
+    unsigned int
+    basisDimension() const;
+
+    /**
+     * @brief full overlap matrix S (basisDimension() x basisDimension()
+     * stored rowwise), waits for the overlap reductions only
+     */
+    std::vector<T>
+    overlapMatrix();
+
+    /**
+     * @brief projections Phi^H Psi (basisDimension() x nKS stored rowwise),
+     * waits for the remaining reductions
+     */
+    std::vector<T>
+    projections();
+
+  private:
+    const std::vector<T> &d_Psi;
+    const unsigned int    d_nDofs;
+    const unsigned int    d_nKS;
+    const MPI_Comm        d_mpiComm;
+
+    /// local nodal values of the basis blocks, nDofs x d_blockSizes[j] each
+    std::vector<std::vector<T>> d_PhiBlocks;
+    std::vector<unsigned int>   d_blockSizes;
+    std::vector<unsigned int>   d_blockStarts;
+
+    /// column blocks of the upper triangle of S, (start_j + m_j) x m_j each
+    std::vector<std::vector<T>> d_overlapBlocks;
+
+    /// row blocks of Phi^H Psi, m_j x nKS each
+    std::vector<std::vector<T>> d_projectionBlocks;
+
+    std::vector<MPI_Request> d_overlapRequests;
+    std::vector<MPI_Request> d_projectionRequests;
+
+    unsigned int d_basisDim;
+  };
+
+} // namespace dftfe
+#endif
@@ -0,0 +1,61 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef populationAnalysisResults_H_
+#define populationAnalysisResults_H_
+
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief results of the population analysis (pFOP) of the projected
+   * Kohn-Sham orbitals, k-point weighted and summed over the spins.
+   *
+   * The atom pair quantities are numAtoms x numAtoms matrices stored
+   * rowwise, with the entry (A, B) the sum over the basis functions a of
+   * atom A and b of atom B of Re(P_ab M_ba) for the density matrix P of the
+   * projected occupied bands. The row sums of atomPairPopulations (M = S)
+   * are the Mulliken gross populations of the atoms and twice its off
+   * diagonal entries the overlap populations (bond orders) of the atom
+   * pairs. For atomPairICOHP, M is the projected Hamiltonian and twice the
+   * off diagonal entries are the integrated pCOHP of the bonds in Hartree.
+   */
+  struct populationAnalysisResults
+  {
+    unsigned int numAtoms = 0;
+
+    /// valence charge minus the gross population of every atom
+    std::vector<double> atomCharges;
+
+    /// Mulliken gross populations of the atoms
+    std::vector<double> grossPopulations;
+
+    /// atom pair populations from the orthonormalized projections (FePOP)
+    std::vector<double> atomPairPopulations;
+
+    /// atom pair contractions with the projected Hamiltonian (FePHP)
+    std::vector<double> atomPairICOHP;
+
+    /// k-point weighted spill factors (TSF, CSF and fCSF)
+    double totalSpilling         = 0.0;
+    double occupiedBandsSpilling = 0.0;
+    double chargeSpilling        = 0.0;
+  };
+
+} // namespace dftfe
+#endif
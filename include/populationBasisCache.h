@@ -0,0 +1,68 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef populationBasisCache_H_
+#define populationBasisCache_H_
+
+#include <atomPairSymmetry.h>
+#include <atomicOrbitalBasisManager.h>
+#include <populationNeighborList.h>
+
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief atomic orbital basis of the population analysis kept across the
+   * k-points, spins and the steps of a trajectory.
+   *
+   * The basis objects (with the radial tables of the pseudo-atomic orbitals
+   * and the Bunge contractions) and the basis metadata only depend on the
+   * atomic numbers and BasisInfo.inp and are rebuilt when the atomic
+   * numbers change. The neighbor list depends on the positions and is
+   * updated with its own skin criterion, the atom pair symmetry is
+   * recomputed for every analysis.
+   */
+  struct populationBasisCache
+  {
+    /// atomic numbers of the atoms the basis was built for
+    std::vector<unsigned int> atomicNumbers;
+
+    /// index of the basis object of every atom
+    std::vector<unsigned int> atomTypeIDs;
+
+    /// one basis object per atom type, ordered by atomic number
+    std::vector<AtomicOrbitalBasisManager> atomTypewiseSTOvector;
+
+    /// {n, l, m} of the orbitals of all atom types, as in BasisInfo.inp
+    std::vector<std::vector<int>> atomTypewiseOrbitalist;
+
+    /// first orbital (one based) of every atom type in atomTypewiseOrbitalist
+    std::vector<int> atomTypeOrbitalStart;
+
+    /// cumulative number of basis functions of the atoms
+    std::vector<unsigned int> atomwiseGlobalbasisNum;
+
+    std::vector<LocalAtomicBasisInfo> globalBasisInfo;
+
+    populationNeighborList neighborList;
+
+    atomPairSymmetry pairSymmetry;
+  };
+
+} // namespace dftfe
+#endif
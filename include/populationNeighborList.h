@@ -0,0 +1,97 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef populationNeighborList_H_
+#define populationNeighborList_H_
+
+#include <array>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Charges (atoms and their periodic images) whose atomic orbitals
+   * can be non-zero at the locally owned FE nodes, kept across the steps of
+   * a trajectory with a Verlet skin.
+   *
+   * The list of an atom holds the charge ids among its images whose
+   * distance to the bounding box of the local nodes is at most the radial
+   * cutoff of the atom plus the skin. A charge outside the list moves closer
+   * to the box by at most its displacement plus the Hausdorff distance
+   * between the old and the new box, so the list stays exact as long as the
+   * largest displacement plus the box shift since the last build does not
+   * exceed the skin. update() only rebuilds the list when this fails, when
+   * the cutoffs change or when the images of an atom are renumbered.
+   *
+   * The list is rank local and needs no communication.
+   */
+  class populationNeighborList
+  {
+  public:
+    populationNeighborList();
+
+    /**
+     * @brief chargePositions are the positions of all charges, the atoms
+     * followed by the periodic images, chargeIdsOfAtoms the charge ids of
+     * every atom and its images and cutoffOfAtoms the radial cutoff of the
+     * orbitals of every atom (negative for no cutoff). boxLower and boxUpper
+     * bound the locally owned FE nodes. Returns true if the list was rebuilt.
+     */
+    bool
+    update(const std::vector<std::array<double, 3>> &chargePositions,
+           const std::vector<std::vector<int>> &     chargeIdsOfAtoms,
+           const std::vector<double> &               cutoffOfAtoms,
+           const std::array<double, 3> &             boxLower,
+           const std::array<double, 3> &             boxUpper,
+           const double                              skin);
+
+    /**
+     * @brief charge ids of the atom and its images near the local nodes
+     */
+    const std::vector<int> &
+    chargeIdsNearNodes(const unsigned int atomId) const;
+
+    /**
+     * @brief number of builds since construction
+     */
+    unsigned int
+    numberOfBuilds() const;
+
+  private:
+    void
+    build(const std::vector<std::array<double, 3>> &chargePositions,
+          const std::vector<std::vector<int>> &     chargeIdsOfAtoms,
+          const std::vector<double> &               cutoffOfAtoms,
+          const std::array<double, 3> &             boxLower,
+          const std::array<double, 3> &             boxUpper,
+          const double                              skin);
+
+    std::vector<std::vector<int>> d_chargeIdsNearNodes;
+
+    /// state of the last build
+    std::vector<std::array<double, 3>> d_referencePositions;
+    std::vector<std::vector<int>>      d_referenceChargeIds;
+    std::vector<double>                d_referenceCutoffs;
+    std::array<double, 3>              d_referenceBoxLower;
+    std::array<double, 3>              d_referenceBoxUpper;
+    double                             d_skin;
+
+    unsigned int d_numberOfBuilds;
+  };
+
+} // namespace dftfe
+#endif
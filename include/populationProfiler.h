@@ -0,0 +1,147 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#ifndef populationProfiler_H_
+#define populationProfiler_H_
+
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/timer.h>
+
+#include <mpi.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dftfe
+{
+  /**
+   * @brief Named-region profiler for the population analysis (pFOP/pFHP)
+   * pipeline.
+   *
+   * Each region records the local wall time (MPI_Wtime, no barrier), the
+   * number of calls, user supplied FLOP and byte counters and the peak
+   * resident set size sampled at region entry and exit. No communication
+   * happens until writeReport(), which reduces the per-rank data once
+   * (min/max/avg wall time, summed counters, max peak memory) and writes a
+   * JSON report from rank zero.
+   *
+   * Stages are not forwarded to computing_timer one by one since the MPI
+   * aware deal.II timers synchronize on every section entry; instead the
+   * caller wraps the whole pipeline in a single computing_timer section and
+   * the reduced per-stage table is printed through the same output stream.
+   */
+  class populationProfiler
+  {
+  public:
+    populationProfiler(const MPI_Comm &mpiComm);
+
+    /**
+     * @brief start timing of a region, regions may be nested but a region
+     * must not be entered twice without leaving it first
+     */
+    void
+    enter(const std::string &regionName);
+
+    /**
+     * @brief stop timing of a region
+     */
+    void
+    leave(const std::string &regionName);
+
+    /**
+     * @brief add floating point operations performed inside a region
+     */
+    void
+    addFlops(const std::string &regionName, const double flops);
+
+    /**
+     * @brief add bytes moved (read, written or communicated) inside a region
+     */
+    void
+    addBytes(const std::string &regionName, const double bytes);
+
+    /**
+     * @brief reduce the region data over the communicator, print a summary
+     * table to pcout and write the JSON report on rank zero. Collective.
+     */
+    void
+    writeReport(const std::string &         fileName,
+                dealii::ConditionalOStream &pcout) const;
+
+    /**
+     * @brief FLOP count of a dense m x n x k matrix-matrix product
+     */
+    static double
+    gemmFlops(const double m,
+              const double n,
+              const double k,
+              const bool   isComplex = false);
+
+    /**
+     * @brief bytes touched by a dense m x n x k matrix-matrix product
+     */
+    static double
+    gemmBytes(const double m,
+              const double n,
+              const double k,
+              const bool   isComplex = false);
+
+  private:
+    struct regionData
+    {
+      double       startTime    = 0.0;
+      double       wallTime     = 0.0;
+      unsigned int numCalls     = 0;
+      double       flops        = 0.0;
+      double       bytes        = 0.0;
+      double       peakMemoryMB = 0.0;
+      bool         isActive     = false;
+    };
+
+    regionData &
+    getRegion(const std::string &regionName);
+
+    static double
+    currentResidentMemoryMB();
+
+    const MPI_Comm d_mpiComm;
+
+    /// regions in the order of their first entry
+    std::vector<std::string> d_regionNames;
+
+    std::map<std::string, regionData> d_regions;
+  };
+
+  /**
+   * @brief RAII helper entering a populationProfiler region on construction
+   * and leaving it on destruction, analogous to dealii::TimerOutput::Scope
+   */
+  class populationProfilerScope
+  {
+  public:
+    populationProfilerScope(populationProfiler &profiler,
+                            const std::string & regionName);
+
+    ~populationProfilerScope();
+
+  private:
+    populationProfiler &d_profiler;
+    const std::string   d_regionName;
+  };
+
+} // namespace dftfe
+#endif
@@ -610,6 +610,22 @@ namespace dftfe
       const std::pair<unsigned int, unsigned int> &index_limits,
       const bool                                   compute_eigenvectors);
 
+    /**
+     * Computing selected eigenvalues and, optionally, the eigenvectors of the
+     * real hermitian matrix $\mathbf{A} \in \mathbb{R}^{M \times M}$.
+     *
+     * The eigenvalues/eigenvectors are selected by prescribing a range of values @p value_limits for the eigenvalues.
+     *
+     * If successful, the computed eigenvalues are arranged in ascending order.
+     * The eigenvectors are stored in the first columns of the matrix, thereby
+     * overwriting the original content of the matrix. The number of selected
+     * eigenpairs is the size of the returned vector.
+     */
+    std::vector<double>
+    eigenpairs_hermitian_by_value(
+      const std::pair<double, double> &value_limits,
+      const bool                       compute_eigenvectors);
+
   private:
     /**
      * Computing selected eigenvalues and, optionally, the eigenvectors.
@@ -0,0 +1,206 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <bandFileWriter.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace dftfe
+{
+  bandFileWriter::bandFileWriter(const std::string &fileName,
+                                 const MPI_Comm &   leaderComm,
+                                 const unsigned int numKPoints,
+                                 const unsigned int numSpins,
+                                 const unsigned int numBands,
+                                 const double       fermiEnergyUp,
+                                 const double       fermiEnergyDown)
+    : d_leaderComm(MPI_COMM_NULL)
+    , d_isOpen(false)
+    , d_numKPoints(numKPoints)
+    , d_numSpins(numSpins)
+    , d_numBands(numBands)
+  {
+    AssertThrow(numSpins == 1 || numSpins == 2,
+                dealii::ExcMessage(
+                  "DFT-FE Error: band file needs one or two spins."));
+    if (leaderComm == MPI_COMM_NULL)
+      return;
+
+    MPI_Comm_dup(leaderComm, &d_leaderComm);
+    const int error = MPI_File_open(d_leaderComm,
+                                    fileName.c_str(),
+                                    MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                                    MPI_INFO_NULL,
+                                    &d_file);
+    AssertThrow(error == MPI_SUCCESS,
+                dealii::ExcMessage("DFT-FE Error: could not open " + fileName +
+                                   " for writing."));
+    d_isOpen = true;
+    // no records of a previous file survive, unwritten records are zeros
+    MPI_File_set_size(d_file, 0);
+    MPI_File_set_size(d_file,
+                      headerBytes() + (MPI_Offset)numKPoints * recordBytes());
+
+    int thisRank;
+    MPI_Comm_rank(d_leaderComm, &thisRank);
+    if (thisRank == 0)
+      {
+        std::vector<char>  header(headerBytes(), 0);
+        const std::int32_t sizes[4] = {(std::int32_t)version,
+                                       (std::int32_t)numSpins,
+                                       (std::int32_t)numBands,
+                                       (std::int32_t)numKPoints};
+        const double       fermiEnergies[2] = {fermiEnergyUp, fermiEnergyDown};
+        std::memcpy(&header[0], "DFTFEBND", 8);
+        std::memcpy(&header[8], sizes, sizeof(sizes));
+        std::memcpy(&header[8 + sizeof(sizes)],
+                    fermiEnergies,
+                    sizeof(fermiEnergies));
+        MPI_File_write_at(d_file,
+                          0,
+                          &header[0],
+                          header.size(),
+                          MPI_CHAR,
+                          MPI_STATUS_IGNORE);
+      }
+  }
+
+
+  bandFileWriter::~bandFileWriter()
+  {
+    close();
+  }
+
+
+  std::size_t
+  bandFileWriter::headerBytes()
+  {
+    return 8 + 4 * sizeof(std::int32_t) + 2 * sizeof(double);
+  }
+
+
+  std::size_t
+  bandFileWriter::recordBytes() const
+  {
+    return (4 + 2 * (std::size_t)d_numSpins * d_numBands) * sizeof(double);
+  }
+
+
+  void
+  bandFileWriter::writeKPoints(const unsigned int         firstKPoint,
+                               const unsigned int         numKPoints,
+                               const std::vector<double> &kPointCoordinates,
+                               const std::vector<double> &kPointWeights,
+                               const std::vector<double> &eigenValues,
+                               const std::vector<double> &occupations)
+  {
+    if (!d_isOpen)
+      return;
+    const unsigned int numLevels = d_numSpins * d_numBands;
+    AssertThrow(firstKPoint + numKPoints <= d_numKPoints &&
+                  kPointCoordinates.size() >= 3 * numKPoints &&
+                  kPointWeights.size() >= numKPoints &&
+                  eigenValues.size() >= (std::size_t)numKPoints * numLevels &&
+                  occupations.size() >= (std::size_t)numKPoints * numLevels,
+                dealii::ExcMessage(
+                  "DFT-FE Error: band records do not match the band file."));
+
+    //
+    // the records of consecutive k-points are contiguous in the file
+    //
+    const std::size_t   recordDoubles = recordBytes() / sizeof(double);
+    std::vector<double> records(numKPoints * recordDoubles);
+    for (unsigned int kPoint = 0; kPoint < numKPoints; ++kPoint)
+      {
+        double *record = &records[0] + kPoint * recordDoubles;
+        for (unsigned int d = 0; d < 3; ++d)
+          record[d] = kPointCoordinates[3 * kPoint + d];
+        record[3] = kPointWeights[kPoint];
+        for (unsigned int spin = 0; spin < d_numSpins; ++spin)
+          for (unsigned int iWave = 0; iWave < d_numBands; ++iWave)
+            {
+              const std::size_t level =
+                (std::size_t)kPoint * numLevels + spin * d_numBands + iWave;
+              record[4 + 2 * spin * d_numBands + iWave] = eigenValues[level];
+              record[4 + (2 * spin + 1) * d_numBands + iWave] =
+                occupations[level];
+            }
+      }
+
+    if (!records.empty())
+      d_pendingBatches.emplace_back(
+        headerBytes() + (MPI_Offset)firstKPoint * recordBytes(),
+        std::move(records));
+  }
+
+
+  void
+  bandFileWriter::flush()
+  {
+    if (!d_isOpen)
+      return;
+
+    //
+    // every rank takes part in as many collective writes as the rank with
+    // the most batches, the ranks out of batches with zero-length writes
+    //
+    const unsigned int numBatches = d_pendingBatches.size();
+    unsigned int       maxNumBatches;
+    MPI_Allreduce(&numBatches,
+                  &maxNumBatches,
+                  1,
+                  MPI_UNSIGNED,
+                  MPI_MAX,
+                  d_leaderComm);
+    for (unsigned int iBatch = 0; iBatch < maxNumBatches; ++iBatch)
+      {
+        if (iBatch < numBatches)
+          {
+            const std::vector<double> &records =
+              d_pendingBatches[iBatch].second;
+            MPI_File_write_at_all(d_file,
+                                  d_pendingBatches[iBatch].first,
+                                  &records[0],
+                                  records.size(),
+                                  MPI_DOUBLE,
+                                  MPI_STATUS_IGNORE);
+          }
+        else
+          MPI_File_write_at_all(
+            d_file, 0, nullptr, 0, MPI_DOUBLE, MPI_STATUS_IGNORE);
+      }
+    d_pendingBatches.clear();
+  }
+
+
+  void
+  bandFileWriter::close()
+  {
+    if (d_isOpen)
+      {
+        flush();
+        MPI_File_close(&d_file);
+      }
+    if (d_leaderComm != MPI_COMM_NULL)
+      MPI_Comm_free(&d_leaderComm);
+    d_isOpen = false;
+  }
+
+} // namespace dftfe
@@ -0,0 +1,228 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+//
+// basis functions (in the order of the atoms) of all shells in shellList,
+// lines of atomic number, n and l as in BasisInfo.inp, belonging to the
+// atoms of the given atomic number or of all atoms if it is zero
+//
+std::vector<LocalAtomicBasisInfo>
+shellBasisInfo(const std::vector<std::vector<int>> &   shellList,
+               const std::vector<std::vector<double>> &atomLocations,
+               const std::vector<unsigned int> &       atomTypesVec,
+               const unsigned int                      atomicNumber)
+{
+  std::vector<LocalAtomicBasisInfo> basisInfo;
+  for (unsigned int iAtom = 0; iAtom < atomLocations.size(); ++iAtom)
+    {
+      const unsigned int atomZ = (unsigned int)atomLocations[iAtom][0];
+      if (atomicNumber != 0 && atomZ != atomicNumber)
+        continue;
+      const unsigned int atomTypeID =
+        std::distance(atomTypesVec.begin(),
+                      std::find(atomTypesVec.begin(),
+                                atomTypesVec.end(),
+                                atomZ));
+      for (const auto &shell : shellList)
+        if ((unsigned int)shell[0] == atomZ)
+          for (int m = -shell[2]; m <= shell[2]; ++m)
+            {
+              LocalAtomicBasisInfo temp;
+              temp.atomID     = iAtom;
+              temp.atomTypeID = atomTypeID;
+              temp.n          = shell[1];
+              temp.l          = shell[2];
+              temp.m          = m;
+              basisInfo.push_back(temp);
+            }
+    }
+  return basisInfo;
+}
+
+
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::basisAugmentationScan(
+  const std::vector<std::vector<double>> &eigenValuesInput)
+{
+  populationProfiler profiler(mpi_communicator);
+  TimerOutput::Scope scope(computing_timer, "basis augmentation scan");
+  copyEigenVectorsToHost();
+
+  AssertThrow(
+    d_dftParamsPtr->spinPolarized == 0,
+    ExcMessage(
+      "DFT-FE Error: BASIS AUGMENTATION FILE is not implemented for spin polarized calculations."));
+
+  //
+  // the base basis is read from BasisInfo.inp and every line of the
+  // augmentation file appends one shell to all atoms of that atomic number
+  //
+  std::vector<std::vector<int>> baseShells, augmentationShells;
+  readBasisFile(3, baseShells, "BasisInfo.inp");
+  readBasisFile(3, augmentationShells, d_dftParamsPtr->basisAugmentationFile);
+
+  const std::vector<unsigned int> atomTypesVec(atomTypes.begin(),
+                                               atomTypes.end());
+  std::vector<AtomicOrbitalBasisManager> atomTypewiseSTOvector;
+  for (unsigned int iType = 0; iType < atomTypesVec.size(); ++iType)
+    {
+      atomTypewiseSTOvector.push_back(
+        AtomicOrbitalBasisManager(atomTypesVec[iType],
+                                  d_dftParamsPtr->AtomicOrbitalBasis,
+                                  true));
+      for (const auto *shellList : {&baseShells, &augmentationShells})
+        for (const auto &shell : *shellList)
+          if ((unsigned int)shell[0] == atomTypesVec[iType])
+            for (int m = -shell[2]; m <= shell[2]; ++m)
+              {
+                atomTypewiseSTOvector[iType].n.push_back(shell[1]);
+                atomTypewiseSTOvector[iType].l.push_back(shell[2]);
+                atomTypewiseSTOvector[iType].m.push_back(m);
+              }
+      createPseudoAtomicOrbitalBasis(atomTypewiseSTOvector[iType]);
+    }
+
+  const unsigned int numOfKSOrbitals = d_dftParamsPtr->NumofKSOrbitalsproj;
+  const IndexSet &   locallyOwnedSet = dofHandler.locally_owned_dofs();
+  std::vector<IndexSet::size_type> locallyOwnedDOFs;
+  locallyOwnedSet.fill_index_vector(locallyOwnedDOFs);
+  const unsigned int n_dofs = locallyOwnedDOFs.size();
+
+  //
+  // the local k-points of every pool are scanned with reductions over the
+  // FE domain of the pool, the rows of the scan file are collected by the
+  // pool leaders
+  //
+  const bool isPoolWriter =
+    this_mpi_process == 0 &&
+    Utilities::MPI::this_mpi_process(interBandGroupComm) == 0;
+  std::ostringstream scanRows;
+  scanRows << std::setprecision(10);
+  for (unsigned int kpoint = 0; kpoint < d_kPointWeights.size(); ++kpoint)
+    {
+      d_kohnShamDFTOperatorPtr->reinitkPointSpinIndex(kpoint, 0);
+      std::vector<double> occupationNum(numOfKSOrbitals, 0.0);
+      for (unsigned int iEigen = 0; iEigen < numOfKSOrbitals; ++iEigen)
+        occupationNum[iEigen] =
+          dftUtils::getPartialOccupancy(eigenValuesInput[kpoint][iEigen],
+                                        fermiEnergy,
+                                        C_kb,
+                                        d_dftParamsPtr->TVal);
+
+      profiler.enter("Psi evaluation");
+      const std::vector<dataTypes::number> scaledKSOrbitalValues_FEnodes =
+        scaledKohnShamOrbitalsAtNodes(d_eigenVectorsFlattenedSTL[kpoint],
+                                      numOfKSOrbitals,
+                                      kpoint,
+                                      locallyOwnedDOFs);
+      profiler.leave("Psi evaluation");
+
+      incrementalProjection<dataTypes::number> projection(
+        scaledKSOrbitalValues_FEnodes,
+        n_dofs,
+        numOfKSOrbitals,
+        d_dftParamsPtr->overlapEigenvalueThreshold,
+        mpi_communicator);
+
+      pcout << "Basis augmentation scan at k-point "
+            << lowerBoundKindex + kpoint << std::endl;
+      pcout << std::setw(6) << "step" << std::setw(12) << "shell (Z n l)"
+            << std::setw(10) << "dim" << std::setw(10) << "retained"
+            << std::setw(16) << "TSF" << std::setw(16) << "CSF"
+            << std::setw(16) << "fCSF" << std::endl;
+
+      for (unsigned int step = 0; step <= augmentationShells.size(); ++step)
+        {
+          const std::vector<int> shell =
+            step == 0 ? std::vector<int>(3, 0) : augmentationShells[step - 1];
+          const std::vector<LocalAtomicBasisInfo> basisInfo =
+            step == 0 ?
+              shellBasisInfo(baseShells, atomLocations, atomTypesVec, 0) :
+              shellBasisInfo(std::vector<std::vector<int>>(1, shell),
+                             atomLocations,
+                             atomTypesVec,
+                             shell[0]);
+
+          std::vector<dataTypes::number> orbitalValues;
+          profiler.enter("Phi evaluation");
+          evaluateAtomicOrbitalsAtNodes(basisInfo,
+                                        atomTypewiseSTOvector,
+                                        locallyOwnedDOFs,
+                                        kpoint,
+                                        orbitalValues);
+          profiler.leave("Phi evaluation");
+
+          profiler.enter("Incremental projection");
+          projection.appendBasis(orbitalValues, basisInfo.size());
+          profiler.leave("Incremental projection");
+          profiler.addFlops("Incremental projection",
+                            populationProfiler::gemmFlops(
+                              projection.basisDimension() + numOfKSOrbitals,
+                              basisInfo.size(),
+                              n_dofs,
+                              std::is_same<dataTypes::number,
+                                           std::complex<double>>::value));
+
+          const spillFactors spill =
+            spillFactorsFromProjectabilities(projection.projectabilities(),
+                                             occupationNum);
+
+          pcout << std::setw(6) << step << std::setw(4) << shell[0]
+                << std::setw(4) << shell[1] << std::setw(4) << shell[2]
+                << std::setw(10) << projection.basisDimension()
+                << std::setw(10) << projection.retainedDimension()
+                << std::setw(16) << spill.totalSpilling << std::setw(16)
+                << spill.occupiedBandsSpilling << std::setw(16)
+                << spill.chargeSpilling << std::endl;
+          if (isPoolWriter)
+            scanRows << lowerBoundKindex + kpoint << " " << step << " "
+                     << shell[0] << " " << shell[1] << " " << shell[2] << " "
+                     << projection.basisDimension() << " "
+                     << projection.retainedDimension() << " "
+                     << spill.totalSpilling << " "
+                     << spill.occupiedBandsSpilling << " "
+                     << spill.chargeSpilling << '\n';
+        }
+    }
+
+  //
+  // the pools append their k-points one after the other
+  //
+  const unsigned int thisPool = Utilities::MPI::this_mpi_process(interpoolcomm);
+  for (unsigned int ipool = 0;
+       ipool < Utilities::MPI::n_mpi_processes(interpoolcomm);
+       ++ipool)
+    {
+      if (isPoolWriter && ipool == thisPool)
+        {
+          std::ofstream scanFile("basisAugmentationScan.txt",
+                                 ipool == 0 ? std::ofstream::out :
+                                              std::ofstream::app);
+          if (ipool == 0)
+            scanFile << "# kPoint step atomicNumber n l basisDimension "
+                        "retainedDimension TSF CSF fCSF\n";
+          scanFile << scanRows.str();
+        }
+      MPI_Barrier(interpoolcomm);
+    }
+
+  // one profile of all k-points of the first pool and band group
+  if (thisPool == 0 &&
+      Utilities::MPI::this_mpi_process(interBandGroupComm) == 0)
+    profiler.writeReport("basisAugmentationProfile.json", pcout);
+}
@@ -0,0 +1,185 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <cellBoundingBoxIndex.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace dftfe
+{
+  cellBoundingBoxIndex::cellBoundingBoxIndex()
+    : d_lower({0.0, 0.0, 0.0})
+    , d_upper({0.0, 0.0, 0.0})
+    , d_binSize(1.0)
+    , d_numBins({1, 1, 1})
+    , d_binStart(2, 0)
+  {}
+
+
+  void
+  cellBoundingBoxIndex::build(
+    const std::vector<std::array<double, 3>> &lowerCorners,
+    const std::vector<std::array<double, 3>> &upperCorners,
+    const double                              tolerance)
+  {
+    AssertThrow(lowerCorners.size() == upperCorners.size(),
+                dealii::ExcMessage(
+                  "DFT-FE Error: lower and upper corners of the cell bounding "
+                  "boxes do not match."));
+    const unsigned int numCells = lowerCorners.size();
+    d_lowerCorners              = lowerCorners;
+    d_upperCorners              = upperCorners;
+    for (unsigned int cell = 0; cell < numCells; ++cell)
+      for (unsigned int d = 0; d < 3; ++d)
+        {
+          d_lowerCorners[cell][d] -= tolerance;
+          d_upperCorners[cell][d] += tolerance;
+        }
+
+    d_lower.fill(0.0);
+    d_upper.fill(0.0);
+    if (numCells > 0)
+      {
+        d_lower = d_lowerCorners[0];
+        d_upper = d_upperCorners[0];
+      }
+    std::vector<double> cellExtents(numCells, 0.0);
+    for (unsigned int cell = 0; cell < numCells; ++cell)
+      for (unsigned int d = 0; d < 3; ++d)
+        {
+          d_lower[d] = std::min(d_lower[d], d_lowerCorners[cell][d]);
+          d_upper[d] = std::max(d_upper[d], d_upperCorners[cell][d]);
+          cellExtents[cell] =
+            std::max(cellExtents[cell],
+                     d_upperCorners[cell][d] - d_lowerCorners[cell][d]);
+        }
+
+    //
+    // bins of the size of a typical cell, which in adaptively refined meshes
+    // is the size of the many small cells, the few large cells are listed in
+    // several bins
+    //
+    d_binSize = 1.0;
+    if (numCells > 0)
+      {
+        std::nth_element(cellExtents.begin(),
+                         cellExtents.begin() + numCells / 2,
+                         cellExtents.end());
+        d_binSize = std::max(cellExtents[numCells / 2], 1e-8);
+      }
+
+    double numBins = 0.0;
+    do
+      {
+        numBins = 1.0;
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            d_numBins[d] =
+              (unsigned int)std::floor((d_upper[d] - d_lower[d]) / d_binSize) +
+              1;
+            numBins *= d_numBins[d];
+          }
+        if (numBins > 2.0 * numCells + 1.0)
+          d_binSize *= 1.25;
+      }
+    while (numBins > 2.0 * numCells + 1.0);
+
+    //
+    // cells sorted by bin, in increasing order of their ids within a bin
+    //
+    d_binStart.assign((std::size_t)numBins + 1, 0);
+    for (unsigned int pass = 0; pass < 2; ++pass)
+      {
+        std::vector<unsigned int> binFill(d_binStart.begin(),
+                                          d_binStart.end() - 1);
+        for (unsigned int cell = 0; cell < numCells; ++cell)
+          for (unsigned int i = binIndex(d_lowerCorners[cell][0], 0);
+               i <= binIndex(d_upperCorners[cell][0], 0);
+               ++i)
+            for (unsigned int j = binIndex(d_lowerCorners[cell][1], 1);
+                 j <= binIndex(d_upperCorners[cell][1], 1);
+                 ++j)
+              for (unsigned int k = binIndex(d_lowerCorners[cell][2], 2);
+                   k <= binIndex(d_upperCorners[cell][2], 2);
+                   ++k)
+                {
+                  const unsigned int bin =
+                    (i * d_numBins[1] + j) * d_numBins[2] + k;
+                  if (pass == 0)
+                    ++d_binStart[bin + 1];
+                  else
+                    d_binCells[binFill[bin]++] = cell;
+                }
+
+        if (pass == 0)
+          {
+            for (unsigned int bin = 0; bin + 1 < d_binStart.size(); ++bin)
+              d_binStart[bin + 1] += d_binStart[bin];
+            d_binCells.resize(d_binStart.back());
+          }
+      }
+  }
+
+
+  unsigned int
+  cellBoundingBoxIndex::binIndex(const double x, const unsigned int d) const
+  {
+    const double bin = std::floor((x - d_lower[d]) / d_binSize);
+    if (bin <= 0.0)
+      return 0;
+    return (unsigned int)std::min(bin, (double)(d_numBins[d] - 1));
+  }
+
+
+  unsigned int
+  cellBoundingBoxIndex::numberOfCells() const
+  {
+    return d_lowerCorners.size();
+  }
+
+
+  void
+  cellBoundingBoxIndex::candidateCells(const std::array<double, 3> &point,
+                                       std::vector<unsigned int> &cellIds) const
+  {
+    cellIds.clear();
+    if (d_lowerCorners.empty())
+      return;
+    for (unsigned int d = 0; d < 3; ++d)
+      if (point[d] < d_lower[d] || point[d] > d_upper[d])
+        return;
+
+    const unsigned int bin =
+      (binIndex(point[0], 0) * d_numBins[1] + binIndex(point[1], 1)) *
+        d_numBins[2] +
+      binIndex(point[2], 2);
+    for (unsigned int c = d_binStart[bin]; c < d_binStart[bin + 1]; ++c)
+      {
+        const unsigned int cell     = d_binCells[c];
+        bool               isInside = true;
+        for (unsigned int d = 0; d < 3; ++d)
+          isInside = isInside && point[d] >= d_lowerCorners[cell][d] &&
+                     point[d] <= d_upperCorners[cell][d];
+        if (isInside)
+          cellIds.push_back(cell);
+      }
+  }
+
+} // namespace dftfe
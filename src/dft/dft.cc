@@ -46,6 +46,10 @@
 #include <overlapPopulationAnalysis.h>
 #include <mathUtils.h>
 #include <matrixmatrixmul.h>
+#include <populationProfiler.h>
+#include <incrementalProjection.h>
+#include <pipelinedOverlapProjection.h>
+#include <cellQuadratureOverlapProjection.h>
 #include <MemoryTransfer.h>
 
 #include <algorithm>
@@ -110,10 +114,13 @@ namespace dftfe
 #include "nscf.cc"
 #include "orbitalPopulation.cc"
 #include "hamiltonianPopulation.cc"
+#include "basisAugmentation.cc"
+#include "populationPdos.cc"
 #include "pRefinedDoFHandler.cc"
 #include "psiInitialGuess.cc"
 #include "publicMethods.cc"
 #include "restart.cc"
+#include "wavefunctionPointEvaluation.cc"
 #include "lowrankApproxScfDielectricMatrixInv.cc"
 #include "lowrankApproxScfDielectricMatrixInvSpinPolarized.cc"
 #include "computeOutputDensityDirectionalDerivative.cc"
@@ -1770,20 +1777,16 @@ namespace dftfe
 
     if (d_dftParamsPtr->writeLocalizationLengths)
       compute_localizationLength("localizationLengths.out");
+
+    if (d_dftParamsPtr->wfcProbePointsFile != "")
+      writeWavefunctionsAtPoints(d_dftParamsPtr->wfcProbePointsFile,
+                                 "wfcProbes.out");
   
-#ifdef USE_COMPLEX
-    if (d_dftParamsPtr->ComputePFOP)
-    for(int kpt = 0; kpt < d_kPointWeights.size(); kpt++)
-   {
-    d_kohnShamDFTOperatorPtr->reinitkPointSpinIndex(kpt, 0);
-    orbitalPopulationCompute(eigenValues,kpt);
-   } 
-    
-      
-  
-#else
     if (d_dftParamsPtr->ComputePFOP)
-      orbitalPopulationCompute(eigenValues);
+      computePopulationAnalysis();
+    if (!d_dftParamsPtr->basisAugmentationFile.empty())
+      basisAugmentationScan(eigenValues);
+#ifndef USE_COMPLEX
     if (d_dftParamsPtr->ComputePFHP)
       hamiltonianPopulationCompute(eigenValues);      
 #endif
@@ -2193,6 +2196,10 @@ namespace dftfe
     const double adaptiveChebysevFilterPassesTol =
       d_dftParamsPtr->chebyshevTolerance;
     bool scfConverged = false;
+    // the atomic orbitals of the SCF charges are evaluated for the current
+    // atoms and mesh
+    d_scfPopulationProjections.clear();
+    d_scfMullikenCharges.clear();
     pcout << std::endl;
     if (d_dftParamsPtr->verbosity == 0)
       pcout << "Starting SCF iterations...." << std::endl;
@@ -3358,6 +3365,10 @@ namespace dftfe
                 << std::endl;
           }
 
+        if (d_dftParamsPtr->populationScfFrequency > 0 &&
+            (scfIter + 1) % d_dftParamsPtr->populationScfFrequency == 0)
+          scfPopulationCharges(scfIter);
+
         if (d_dftParamsPtr->verbosity >= 1)
           pcout << "***********************Self-Consistent-Field Iteration: "
                 << std::setw(2) << scfIter + 1
@@ -3956,61 +3967,68 @@ namespace dftfe
   void
   dftClass<FEOrder, FEOrderElectro>::outputWfc()
   {
+    const unsigned int numSpins = 1 + d_dftParamsPtr->spinPolarized;
+
     //
-    // identify the index which is close to Fermi Energy
+    // range of wavefunction indices with an eigenvalue of any k-point and
+    // spin inside the energy window around the Fermi energy, all
+    // wavefunctions without a window
     //
-    int indexFermiEnergy = -1.0;
-    for (int spinType = 0; spinType < 1 + d_dftParamsPtr->spinPolarized;
-         ++spinType)
+    unsigned int startingRange = 0;
+    unsigned int endingRange   = d_numEigenValues;
+    if (d_dftParamsPtr->wfcOutputEnergyMin < d_dftParamsPtr->wfcOutputEnergyMax)
       {
-        for (int i = 0; i < d_numEigenValues; ++i)
+        startingRange = d_numEigenValues;
+        endingRange   = 0;
+        for (unsigned int k = 0; k < d_kPointWeights.size(); ++k)
+          for (unsigned int s = 0; s < numSpins; ++s)
+            {
+              const double fermiEnergySpin =
+                !d_dftParamsPtr->constraintMagnetization ?
+                  fermiEnergy :
+                  (s == 0 ? fermiEnergyUp : fermiEnergyDown);
+              for (unsigned int i = 0; i < d_numEigenValues; ++i)
+                {
+                  const double eigenValue =
+                    eigenValues[k][s * d_numEigenValues + i] - fermiEnergySpin;
+                  if (eigenValue >= d_dftParamsPtr->wfcOutputEnergyMin &&
+                      eigenValue <= d_dftParamsPtr->wfcOutputEnergyMax)
+                    {
+                      startingRange = std::min(startingRange, i);
+                      endingRange   = std::max(endingRange, i + 1);
+                    }
+                }
+            }
+        startingRange = Utilities::MPI::min(startingRange, interpoolcomm);
+        endingRange   = Utilities::MPI::max(endingRange, interpoolcomm);
+        if (endingRange <= startingRange)
           {
-            if (eigenValues[0][spinType * d_numEigenValues + i] >= fermiEnergy)
-              {
-                if (i > indexFermiEnergy)
-                  {
-                    indexFermiEnergy = i;
-                    break;
-                  }
-              }
+            pcout << "No wavefunction in the energy window of WRITE WFC"
+                  << std::endl;
+            return;
           }
       }
 
     //
-    // create a range of wavefunctions to output the wavefunction files
+    // with a single file per output the band groups split the range between
+    // them and every pool contributes its own k-points to the file,
+    // otherwise the lowest pool and band group write all of the range
     //
-    int startingRange = 0;
-    int endingRange   = d_numEigenValues;
-
-    /*
-    int startingRange = indexFermiEnergy - 4;
-    int endingRange   = indexFermiEnergy + 4;
-
-    int startingRangeSpin = startingRange;
-
-    for (int spinType = 0; spinType < 1 + d_dftParamsPtr->spinPolarized;
-         ++spinType)
+    const bool isSingleFile = d_dftParamsPtr->fieldOutputFormat != "VTU";
+    const unsigned int numberBandGroups =
+      Utilities::MPI::n_mpi_processes(interBandGroupComm);
+    const unsigned int bandGroupTaskId =
+      Utilities::MPI::this_mpi_process(interBandGroupComm);
+    if (isSingleFile)
       {
-        for (int i = indexFermiEnergy - 5; i > 0; --i)
-          {
-            if (std::abs(eigenValues[0][spinType * d_numEigenValues +
-                                        (indexFermiEnergy - 4)] -
-                         eigenValues[0][spinType * d_numEigenValues + i]) <=
-                5e-04)
-              {
-                if (spinType == 0)
-                  startingRange -= 1;
-                else
-                  startingRangeSpin -= 1;
-              }
-          }
+        const unsigned int numStates = endingRange - startingRange;
+        const unsigned int bandGroupStart =
+          startingRange + numStates * bandGroupTaskId / numberBandGroups;
+        endingRange =
+          startingRange + numStates * (bandGroupTaskId + 1) / numberBandGroups;
+        startingRange = bandGroupStart;
       }
-
-
-    if (startingRangeSpin < startingRange)
-      startingRange = startingRangeSpin;
-    */
-    int numStatesOutput = (endingRange - startingRange) + 1;
+    const unsigned int numStatesOutput = endingRange - startingRange;
 
 
     DataOut<3> data_outEigen;
@@ -4020,19 +4038,16 @@ namespace dftfe
     tempVec[0].reinit(d_tempEigenVec);
 
     std::vector<distributedCPUVec<double>> visualizeWaveFunctions(
-      d_kPointWeights.size() * (1 + d_dftParamsPtr->spinPolarized) *
-      numStatesOutput);
+      d_kPointWeights.size() * numSpins * numStatesOutput);
 
     unsigned int count = 0;
-    for (unsigned int s = 0; s < 1 + d_dftParamsPtr->spinPolarized; ++s)
+    for (unsigned int s = 0; s < numSpins; ++s)
       for (unsigned int k = 0; k < d_kPointWeights.size(); ++k)
         for (unsigned int i = startingRange; i < endingRange; ++i)
           {
 #ifdef USE_COMPLEX
             vectorTools::copyFlattenedSTLVecToSingleCompVec(
-              d_eigenVectorsFlattenedSTL[k *
-                                           (1 + d_dftParamsPtr->spinPolarized) +
-                                         s],
+              d_eigenVectorsFlattenedSTL[k * numSpins + s],
               d_numEigenValues,
               std::make_pair(i, i + 1),
               localProc_dof_indicesReal,
@@ -4040,9 +4055,7 @@ namespace dftfe
               tempVec);
 #else
             vectorTools::copyFlattenedSTLVecToSingleCompVec(
-              d_eigenVectorsFlattenedSTL[k *
-                                           (1 + d_dftParamsPtr->spinPolarized) +
-                                         s],
+              d_eigenVectorsFlattenedSTL[k * numSpins + s],
               d_numEigenValues,
               std::make_pair(i, i + 1),
               tempVec);
@@ -4051,24 +4064,145 @@ namespace dftfe
             constraintsNoneEigenDataInfo.distribute(tempVec[0]);
             visualizeWaveFunctions[count] = tempVec[0];
 
-            if (d_dftParamsPtr->spinPolarized == 1)
-              data_outEigen.add_data_vector(visualizeWaveFunctions[count],
-                                            "wfc_spin" + std::to_string(s) +
-                                              "_kpoint" + std::to_string(k) +
-                                              "_" + std::to_string(i));
-            else
-              data_outEigen.add_data_vector(visualizeWaveFunctions[count],
-                                            "wfc_kpoint" + std::to_string(k) +
-                                              "_" + std::to_string(i));
+            // the single file is assembled on the first pool and band group
+            if (!isSingleFile)
+              {
+                if (d_dftParamsPtr->spinPolarized == 1)
+                  data_outEigen.add_data_vector(
+                    visualizeWaveFunctions[count],
+                    "wfc_spin" + std::to_string(s) + "_kpoint" +
+                      std::to_string(k) + "_" + std::to_string(i));
+                else
+                  data_outEigen.add_data_vector(visualizeWaveFunctions[count],
+                                                "wfc_kpoint" +
+                                                  std::to_string(k) + "_" +
+                                                  std::to_string(i));
+              }
 
             count += 1;
           }
 
-    data_outEigen.build_patches(FEOrder);
-
     std::string tempFolder = "waveFunctionOutputFolder";
     mkdir(tempFolder.c_str(), ACCESSPERMS);
 
+    if (isSingleFile)
+      {
+        //
+        // the pools and band groups share the partitioning of the domain, so
+        // the processors of the same domain rank gather their locally owned
+        // values on the first pool and band group, which writes the
+        // k-points of all pools and the bands of all band groups into one
+        // file
+        //
+        MPI_Comm outputComm;
+        MPI_Comm_split(d_mpiCommParent,
+                       Utilities::MPI::this_mpi_process(mpi_communicator),
+                       Utilities::MPI::this_mpi_process(interpoolcomm) *
+                           numberBandGroups +
+                         bandGroupTaskId,
+                       &outputComm);
+        const unsigned int numOutputProcesses =
+          Utilities::MPI::n_mpi_processes(outputComm);
+        const bool isOutputRoot =
+          Utilities::MPI::this_mpi_process(outputComm) == 0;
+
+        // number of k-points, first global k-point and band range
+        const unsigned int outputRange[4] = {(unsigned int)
+                                               d_kPointWeights.size(),
+                                             lowerBoundKindex,
+                                             startingRange,
+                                             endingRange};
+        std::vector<unsigned int> outputRanges(4 * numOutputProcesses);
+        MPI_Gather(outputRange,
+                   4,
+                   MPI_UNSIGNED,
+                   &outputRanges[0],
+                   4,
+                   MPI_UNSIGNED,
+                   0,
+                   outputComm);
+
+        const unsigned int  localSize = tempVec[0].local_size();
+        std::vector<double> localValues(visualizeWaveFunctions.size() *
+                                        localSize);
+        for (unsigned int j = 0; j < visualizeWaveFunctions.size(); ++j)
+          for (unsigned int iNode = 0; iNode < localSize; ++iNode)
+            localValues[j * localSize + iNode] =
+              visualizeWaveFunctions[j].local_element(iNode);
+
+        std::vector<int> receiveCounts(numOutputProcesses, 0),
+          displacements(numOutputProcesses, 0);
+        unsigned int numVectorsAll = 0;
+        if (isOutputRoot)
+          for (unsigned int iProc = 0; iProc < numOutputProcesses; ++iProc)
+            {
+              const unsigned int numVectors =
+                numSpins * outputRanges[4 * iProc] *
+                (outputRanges[4 * iProc + 3] - outputRanges[4 * iProc + 2]);
+              receiveCounts[iProc] = numVectors * localSize;
+              displacements[iProc] = numVectorsAll * localSize;
+              numVectorsAll += numVectors;
+            }
+        std::vector<double> valuesAll(numVectorsAll * localSize);
+        MPI_Gatherv(localValues.data(),
+                    localValues.size(),
+                    MPI_DOUBLE,
+                    valuesAll.data(),
+                    &receiveCounts[0],
+                    &displacements[0],
+                    MPI_DOUBLE,
+                    0,
+                    outputComm);
+        MPI_Comm_free(&outputComm);
+
+        if (!isOutputRoot || numVectorsAll == 0)
+          return;
+
+        DataOut<3> data_outAll;
+        data_outAll.attach_dof_handler(dofHandlerEigen);
+        std::vector<distributedCPUVec<double>> waveFunctionsAll(numVectorsAll);
+        unsigned int                           j = 0;
+        for (unsigned int iProc = 0; iProc < numOutputProcesses; ++iProc)
+          for (unsigned int s = 0; s < numSpins; ++s)
+            for (unsigned int k = 0; k < outputRanges[4 * iProc]; ++k)
+              for (unsigned int i = outputRanges[4 * iProc + 2];
+                   i < outputRanges[4 * iProc + 3];
+                   ++i)
+                {
+                  waveFunctionsAll[j].reinit(d_tempEigenVec);
+                  for (unsigned int iNode = 0; iNode < localSize; ++iNode)
+                    waveFunctionsAll[j].local_element(iNode) =
+                      valuesAll[j * localSize + iNode];
+                  waveFunctionsAll[j].update_ghost_values();
+
+                  const unsigned int kPointIndex =
+                    outputRanges[4 * iProc + 1] + k;
+                  if (d_dftParamsPtr->spinPolarized == 1)
+                    data_outAll.add_data_vector(
+                      waveFunctionsAll[j],
+                      "wfc_spin" + std::to_string(s) + "_kpoint" +
+                        std::to_string(kPointIndex) + "_" + std::to_string(i));
+                  else
+                    data_outAll.add_data_vector(
+                      waveFunctionsAll[j],
+                      "wfc_kpoint" + std::to_string(kPointIndex) + "_" +
+                        std::to_string(i));
+                  ++j;
+                }
+        data_outAll.build_patches(FEOrder);
+
+        dftUtils::writeDataParallelSingleFile(
+          data_outAll,
+          mpi_communicator,
+          tempFolder,
+          "wfcOutput",
+          d_dftParamsPtr->fieldOutputFormat,
+          d_dftParamsPtr->fieldOutputCompression);
+        return;
+      }
+
+    data_outEigen.build_patches(FEOrder);
+
     dftUtils::writeDataVTUParallelLowestPoolId(dofHandlerEigen,
                                                data_outEigen,
                                                d_mpiCommParent,
@@ -4077,7 +4211,6 @@ namespace dftfe
                                                interBandGroupComm,
                                                tempFolder,
                                                "wfcOutput");
-    //"wfcOutput_"+std::to_string(k)+"_"+std::to_string(i));
   }
 
 
@@ -4175,6 +4308,22 @@ namespace dftfe
     std::string tempFolder = "densityOutputFolder";
     mkdir(tempFolder.c_str(), ACCESSPERMS);
 
+    if (d_dftParamsPtr->fieldOutputFormat != "VTU")
+      {
+        // the density is the same on all pools and band groups
+        if (Utilities::MPI::this_mpi_process(interpoolcomm) == 0 &&
+            Utilities::MPI::this_mpi_process(interBandGroupComm) == 0)
+          dftUtils::writeDataParallelSingleFile(
+            dataOutRho,
+            mpi_communicator,
+            tempFolder,
+            "densityOutput",
+            d_dftParamsPtr->fieldOutputFormat,
+            d_dftParamsPtr->fieldOutputCompression);
+        MPI_Barrier(d_mpiCommParent);
+        return;
+      }
+
     dftUtils::writeDataVTUParallelLowestPoolId(d_dofHandlerRhoNodal,
                                                dataOutRho,
                                                d_mpiCommParent,
@@ -4189,6 +4338,15 @@ namespace dftfe
   void
   dftClass<FEOrder, FEOrderElectro>::writeBands()
   {
+    if (d_dftParamsPtr->bandsFileFormat == "BINARY")
+      {
+        // nscf has streamed the k-points, closing the writer flushes the
+        // buffered records of all pools collectively and completes the file
+        d_bandFileWriter.reset();
+        MPI_Barrier(d_mpiCommParent);
+        return;
+      }
+
     int numkPoints =
       (1 + d_dftParamsPtr->spinPolarized) * d_kPointWeights.size();
     std::vector<double> eigenValuesFlattened;
@@ -4269,6 +4427,80 @@ namespace dftfe
     //
   }
 
+  template <unsigned int FEOrder, unsigned int FEOrderElectro>
+  void
+  dftClass<FEOrder, FEOrderElectro>::openBandFile()
+  {
+    //
+    // one writer per k-point pool, the first processor of the domain
+    // decomposition in the first band group
+    //
+    const bool isPoolLeader =
+      Utilities::MPI::this_mpi_process(mpi_communicator) == 0 &&
+      Utilities::MPI::this_mpi_process(interBandGroupComm) == 0;
+    MPI_Comm leaderComm;
+    MPI_Comm_split(d_mpiCommParent,
+                   isPoolLeader ? 0 : MPI_UNDEFINED,
+                   Utilities::MPI::this_mpi_process(d_mpiCommParent),
+                   &leaderComm);
+
+    const unsigned int numKPointsGlobal =
+      Utilities::MPI::sum((unsigned int)d_kPointWeights.size(), interpoolcomm);
+    const bool isConstrained = d_dftParamsPtr->constraintMagnetization;
+    d_bandFileWriter         = std::make_unique<bandFileWriter>(
+      "bands.bin",
+      leaderComm,
+      numKPointsGlobal,
+      1 + d_dftParamsPtr->spinPolarized,
+      d_numEigenValues,
+      isConstrained ? fermiEnergyUp : fermiEnergy,
+      isConstrained ? fermiEnergyDown : fermiEnergy);
+    if (leaderComm != MPI_COMM_NULL)
+      MPI_Comm_free(&leaderComm);
+  }
+
+  template <unsigned int FEOrder, unsigned int FEOrderElectro>
+  void
+  dftClass<FEOrder, FEOrderElectro>::writeBandFileKPoints(
+    const unsigned int firstKPoint,
+    const unsigned int numKPoints)
+  {
+    const unsigned int numSpins  = 1 + d_dftParamsPtr->spinPolarized;
+    const unsigned int numLevels = numSpins * d_numEigenValues;
+    std::vector<double> kPointCoordinates(3 * numKPoints),
+      kPointWeights(numKPoints), eigenValuesFlattened(numKPoints * numLevels),
+      occupations(numKPoints * numLevels);
+    const double fermiEnergySpin[2] = {
+      d_dftParamsPtr->constraintMagnetization ? fermiEnergyUp : fermiEnergy,
+      d_dftParamsPtr->constraintMagnetization ? fermiEnergyDown : fermiEnergy};
+    for (unsigned int i = 0; i < numKPoints; ++i)
+      {
+        const unsigned int kPoint = firstKPoint + i;
+        for (unsigned int d = 0; d < 3; ++d)
+          kPointCoordinates[3 * i + d] = d_kPointCoordinates[3 * kPoint + d];
+        kPointWeights[i] = d_kPointWeights[kPoint];
+        for (unsigned int spin = 0; spin < numSpins; ++spin)
+          for (unsigned int iWave = 0; iWave < d_numEigenValues; ++iWave)
+            {
+              const unsigned int level = spin * d_numEigenValues + iWave;
+              const double       eigenValue = eigenValues[kPoint][level];
+              eigenValuesFlattened[i * numLevels + level] = eigenValue;
+              occupations[i * numLevels + level] =
+                dftUtils::getPartialOccupancy(eigenValue,
+                                              fermiEnergySpin[spin],
+                                              C_kb,
+                                              d_dftParamsPtr->TVal);
+            }
+      }
+
+    d_bandFileWriter->writeKPoints(lowerBoundKindex + firstKPoint,
+                                   numKPoints,
+                                   kPointCoordinates,
+                                   kPointWeights,
+                                   eigenValuesFlattened,
+                                   occupations);
+  }
+
   template <unsigned int FEOrder, unsigned int FEOrderElectro>
   std::vector<std::vector<double>>
   dftClass<FEOrder, FEOrderElectro>::getAtomLocationsCart() const
@@ -4326,6 +4558,13 @@ namespace dftfe
     return (*d_dftParamsPtr);
   }
 
+  template <unsigned int FEOrder, unsigned int FEOrderElectro>
+  const populationAnalysisResults &
+  dftClass<FEOrder, FEOrderElectro>::getPopulationAnalysisResults() const
+  {
+    return d_populationAnalysisResults;
+  }
+
   template <unsigned int FEOrder, unsigned int FEOrderElectro>
   double
   dftClass<FEOrder, FEOrderElectro>::getInternalEnergy() const
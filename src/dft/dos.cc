@@ -17,25 +17,23 @@
 // @author Phani Motamarri
 //
 
-void
-loadSingleAtomPSIFiles(
-  unsigned int  Z,
-  unsigned int  n,
-  unsigned int  l,
-  unsigned int &fileReadFlag,
-  double &      wfcInitTruncation,
-  std::map<
-    unsigned int,
-    std::map<unsigned int, std::map<unsigned int, alglib::spline1dinterpolant>>>
-    &                  radValues,
-  const MPI_Comm &     mpiCommParent,
-  const dftParameters &dftParams)
+//
+// radial part of the single atom wavefunction (n, l) of the atomic number Z
+// from the shared tables, read from the single atom data the first time,
+// nullptr if there is no data
+//
+const atomicOrbitalRadialTables::radialTable *
+loadSingleAtomPSIFiles(unsigned int               Z,
+                       unsigned int               n,
+                       unsigned int               l,
+                       atomicOrbitalRadialTables &radialTables,
+                       const MPI_Comm &           mpiCommParent,
+                       const dftParameters &      dftParams)
 {
-  if (radValues[Z][n].count(l) > 0)
-    {
-      fileReadFlag = 1;
-      return;
-    }
+  const atomicOrbitalRadialTables::source fileSource =
+    atomicOrbitalRadialTables::source::singleAtomWavefunction;
+  if (radialTables.isKnown(fileSource, Z, n, l))
+    return radialTables.table(fileSource, Z, n, l, "");
 
   //
   // set the paths for the Single-Atom wavefunction data
@@ -74,64 +72,81 @@ loadSingleAtomPSIFiles(
       n,
       l);
 
-  std::vector<std::vector<double>> values;
+  const atomicOrbitalRadialTables::radialTable *radial =
+    radialTables.table(fileSource, Z, n, l, psiFile);
+  if (radial != nullptr && !dftParams.reproducible_output &&
+      Utilities::MPI::this_mpi_process(mpiCommParent) == 0)
+    std::cout << "reading data from file: " << psiFile << std::endl;
+  return radial;
+}
 
-  const double truncationTol = 1e-8;
-  fileReadFlag               = dftUtils::readPsiFile(2, values, psiFile);
 
-  //
-  // spline fitting for single-atom wavefunctions
-  //
-  if (fileReadFlag > 0)
-    {
-      double       maxTruncationRadius = 0.0;
-      unsigned int truncRowId          = 0;
-      if (!dftParams.reproducible_output)
-        {
-          if (Utilities::MPI::this_mpi_process(mpiCommParent) == 0)
-            std::cout << "reading data from file: " << psiFile << std::endl;
-        }
 
-      int                 numRows = values.size() - 1;
-      std::vector<double> xData(numRows), yData(numRows);
+//
+// width of the DOS broadening, kB T unless DOS BROADENING WIDTH is set
+//
+double
+dosBroadeningWidth(const dftParameters &dftParams)
+{
+  return dftParams.dosBroadeningWidth > 0.0 ? dftParams.dosBroadeningWidth :
+                                              C_kb * dftParams.TVal;
+}
 
-      // x
-      for (int irow = 0; irow < numRows; ++irow)
-        {
-          xData[irow] = values[irow][0];
-        }
-      alglib::real_1d_array x;
-      x.setcontent(numRows, &xData[0]);
 
-      // y
-      for (int irow = 0; irow < numRows; ++irow)
-        {
-          yData[irow] = values[irow][1];
 
-          if (std::fabs(yData[irow]) > truncationTol)
-            truncRowId = irow;
-        }
-      alglib::real_1d_array y;
-      y.setcontent(numRows, &yData[0]);
-      alglib::ae_int_t natural_bound_type = 0;
-      alglib::spline1dbuildcubic(x,
-                                 y,
-                                 numRows,
-                                 natural_bound_type,
-                                 0.0,
-                                 natural_bound_type,
-                                 0.0,
-                                 radValues[Z][n][l]);
-
-      maxTruncationRadius = xData[truncRowId];
-      if (maxTruncationRadius > wfcInitTruncation)
-        wfcInitTruncation = maxTruncationRadius;
+//
+// broadening engine of the DOS variants on the energy grid of the DOS
+// parameters, spanning lowerBound to upperBound unless DOS ENERGY MIN and
+// DOS ENERGY MAX are set
+//
+dosBroadening
+createDosBroadening(const dftParameters &dftParams,
+                    double               lowerBound,
+                    double               upperBound)
+{
+  if (dftParams.dosEnergyMin < dftParams.dosEnergyMax)
+    {
+      lowerBound = dftParams.dosEnergyMin;
+      upperBound = dftParams.dosEnergyMax;
     }
+  const unsigned int numIntervals =
+    std::ceil((upperBound - lowerBound) / dftParams.dosEnergySpacing);
+  return dosBroadening(dosBroadening::kernelFromString(
+                         dftParams.dosBroadeningType),
+                       dosBroadeningWidth(dftParams),
+                       dftParams.dosMethfesselPaxtonOrder,
+                       dftParams.dosKernelCutoff,
+                       lowerBound,
+                       dftParams.dosEnergySpacing,
+                       numIntervals);
 }
 
 
 
-// compute fermi energy
+//
+// single atom wavefunction dataOrb with the radial part R in the direction
+// theta, phi from the atom, with real spherical harmonics
+//
+inline double
+singleAtomWaveFunctionValue(const orbital &dataOrb,
+                            const double   R,
+                            const double   theta,
+                            const double   phi)
+{
+  if (dataOrb.m > 0)
+    return R * std::sqrt(2) *
+           boost::math::spherical_harmonic_r(dataOrb.l, dataOrb.m, theta, phi);
+  else if (dataOrb.m == 0)
+    return R *
+           boost::math::spherical_harmonic_r(dataOrb.l, dataOrb.m, theta, phi);
+  else
+    return R * std::sqrt(2) *
+           boost::math::spherical_harmonic_i(dataOrb.l, -dataOrb.m, theta, phi);
+}
+
+
+
+// compute density of states
 template <unsigned int FEOrder, unsigned int FEOrderElectro>
 void
 dftClass<FEOrder, FEOrderElectro>::compute_tdos(
@@ -139,83 +154,169 @@ dftClass<FEOrder, FEOrderElectro>::compute_tdos(
   const std::string &                     dosFileName)
 {
   computing_timer.enter_subsection("DOS computation");
-  std::vector<double> eigenValuesAllkPoints;
-  for (int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
+  //
+  // energy grid spanning the levels of all pools, so that the pools
+  // accumulate on the same grid
+  //
+  double minEigenValue = std::numeric_limits<double>::max();
+  double maxEigenValue = -std::numeric_limits<double>::max();
+  for (unsigned int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
+    for (const double eigenValue : eigenValuesInput[kPoint])
+      {
+        minEigenValue = std::min(minEigenValue, eigenValue);
+        maxEigenValue = std::max(maxEigenValue, eigenValue);
+      }
+  minEigenValue = Utilities::MPI::min(minEigenValue, interpoolcomm);
+  maxEigenValue = Utilities::MPI::max(maxEigenValue, interpoolcomm);
+
+  double lowerBoundEpsilon = 1.5 * minEigenValue;
+  double upperBoundEpsilon = maxEigenValue * 1.5;
+  const dosBroadening broadening =
+    createDosBroadening(*d_dftParamsPtr, lowerBoundEpsilon, upperBoundEpsilon);
+  const unsigned int numberIntervals = broadening.numIntervals();
+
+  const unsigned int numSpins   = 1 + d_dftParamsPtr->spinPolarized;
+  const double       spinFactor = numSpins == 1 ? 2.0 : 1.0;
+  // [spinType * numberIntervals + epsInt]
+  std::vector<double> densityOfStates(numSpins * numberIntervals, 0.0);
+  std::vector<double> spinDensityOfStates(numberIntervals);
+
+  if (d_dftParamsPtr->dosTetrahedron)
     {
-      for (int statesIter = 0; statesIter < eigenValuesInput[0].size();
-           ++statesIter)
+      //
+      // bands of the irreducible k-points of all pools on the full
+      // Monkhorst-Pack grid
+      //
+      AssertThrow(
+        !d_mpGridIrreducibleKPoints.empty(),
+        ExcMessage(
+          "DFT-FE Error: DOS TETRAHEDRON requires the k-points of the Monkhorst-Pack grid."));
+      const unsigned int numKPointsGlobal =
+        Utilities::MPI::sum((unsigned int)d_kPointWeights.size(),
+                            interpoolcomm);
+      const unsigned int  numLevels = numSpins * d_numEigenValues;
+      std::vector<double> eigenValuesGlobal(numKPointsGlobal * numLevels, 0.0);
+      for (unsigned int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
+        std::copy(eigenValuesInput[kPoint].begin(),
+                  eigenValuesInput[kPoint].begin() + numLevels,
+                  eigenValuesGlobal.begin() +
+                    (lowerBoundKindex + kPoint) * numLevels);
+      Utilities::MPI::sum(eigenValuesGlobal, interpoolcomm, eigenValuesGlobal);
+
+      const std::array<unsigned int, 3> gridSize = {d_dftParamsPtr->nkx,
+                                                    d_dftParamsPtr->nky,
+                                                    d_dftParamsPtr->nkz};
+      const std::vector<std::array<unsigned int, 4>> tetrahedra =
+        dosBroadening::monkhorstPackTetrahedra(gridSize,
+                                               d_reciprocalLatticeVectors);
+      const unsigned int numGridPoints = d_mpGridIrreducibleKPoints.size();
+      std::vector<double> gridEnergies(numGridPoints * d_numEigenValues);
+      for (unsigned int spinType = 0; spinType < numSpins; ++spinType)
         {
-          eigenValuesAllkPoints.push_back(eigenValuesInput[kPoint][statesIter]);
+          for (unsigned int i = 0; i < numGridPoints; ++i)
+            std::copy(eigenValuesGlobal.begin() +
+                        d_mpGridIrreducibleKPoints[i] * numLevels +
+                        spinType * d_numEigenValues,
+                      eigenValuesGlobal.begin() +
+                        d_mpGridIrreducibleKPoints[i] * numLevels +
+                        (spinType + 1) * d_numEigenValues,
+                      gridEnergies.begin() + i * d_numEigenValues);
+          std::fill(spinDensityOfStates.begin(),
+                    spinDensityOfStates.end(),
+                    0.0);
+          broadening.accumulateTetrahedra(gridEnergies,
+                                          d_numEigenValues,
+                                          tetrahedra,
+                                          spinFactor,
+                                          spinDensityOfStates);
+          std::copy(spinDensityOfStates.begin(),
+                    spinDensityOfStates.end(),
+                    densityOfStates.begin() + spinType * numberIntervals);
         }
     }
-
-  std::sort(eigenValuesAllkPoints.begin(), eigenValuesAllkPoints.end());
-
-  double totalEigenValues  = eigenValuesAllkPoints.size();
-  double intervalSize      = 0.001;
-  double sigma             = C_kb * d_dftParamsPtr->TVal;
-  double lowerBoundEpsilon = 1.5 * eigenValuesAllkPoints[0];
-  double upperBoundEpsilon = eigenValuesAllkPoints[totalEigenValues - 1] * 1.5;
-  unsigned int numberIntervals =
-    std::ceil((upperBoundEpsilon - lowerBoundEpsilon) / intervalSize);
-
-  std::vector<double> densityOfStates, densityOfStatesUp, densityOfStatesDown;
-
-
-  if (d_dftParamsPtr->spinPolarized == 1)
+  else
     {
-      densityOfStatesUp.resize(numberIntervals, 0.0);
-      densityOfStatesDown.resize(numberIntervals, 0.0);
-      for (int epsInt = 0; epsInt < numberIntervals; ++epsInt)
+      //
+      // k-point weighted levels of the local k-points, the pools are summed
+      // with one reduction
+      //
+      std::vector<double> energyLevels(d_kPointWeights.size() *
+                                       d_numEigenValues);
+      std::vector<double> levelWeights(energyLevels.size());
+      for (unsigned int spinType = 0; spinType < numSpins; ++spinType)
         {
-          double epsValue = lowerBoundEpsilon + epsInt * intervalSize;
-          for (int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
-            {
-              for (unsigned int spinType = 0;
-                   spinType < 1 + d_dftParamsPtr->spinPolarized;
-                   ++spinType)
-                {
-                  for (unsigned int statesIter = 0;
-                       statesIter < d_numEigenValues;
-                       ++statesIter)
-                    {
-                      double term1 =
-                        (epsValue -
-                         eigenValuesInput[kPoint][spinType * d_numEigenValues +
-                                                  statesIter]);
-                      double denom = term1 * term1 + sigma * sigma;
-                      if (spinType == 0)
-                        densityOfStatesUp[epsInt] +=
-                          (sigma / M_PI) * (1.0 / denom);
-                      else
-                        densityOfStatesDown[epsInt] +=
-                          (sigma / M_PI) * (1.0 / denom);
-                    }
-                }
-            }
+          for (unsigned int kPoint = 0; kPoint < d_kPointWeights.size();
+               ++kPoint)
+            for (unsigned int statesIter = 0; statesIter < d_numEigenValues;
+                 ++statesIter)
+              {
+                energyLevels[kPoint * d_numEigenValues + statesIter] =
+                  eigenValuesInput[kPoint]
+                                  [spinType * d_numEigenValues + statesIter];
+                levelWeights[kPoint * d_numEigenValues + statesIter] =
+                  d_kPointWeights[kPoint];
+              }
+          std::fill(spinDensityOfStates.begin(),
+                    spinDensityOfStates.end(),
+                    0.0);
+          broadening.accumulate(energyLevels,
+                                levelWeights,
+                                1,
+                                spinFactor,
+                                spinDensityOfStates);
+          std::copy(spinDensityOfStates.begin(),
+                    spinDensityOfStates.end(),
+                    densityOfStates.begin() + spinType * numberIntervals);
         }
+      Utilities::MPI::sum(densityOfStates, interpoolcomm, densityOfStates);
     }
-  else
+
+  //
+  // integrated DOS, the number of states up to the energy. The DOS of a grid
+  // point covers the interval centred at it, so that the states up to the
+  // grid point are the intervals below it and half of its own interval.
+  //
+  std::vector<double> integratedDensityOfStates(numSpins * numberIntervals,
+                                                0.0);
+  for (unsigned int spinType = 0; spinType < numSpins; ++spinType)
     {
-      densityOfStates.resize(numberIntervals, 0.0);
-      for (int epsInt = 0; epsInt < numberIntervals; ++epsInt)
+      double numberOfStates = 0.0;
+      for (unsigned int epsInt = 0; epsInt < numberIntervals; ++epsInt)
         {
-          double epsValue = lowerBoundEpsilon + epsInt * intervalSize;
-          for (int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
-            {
-              for (unsigned int statesIter = 0; statesIter < d_numEigenValues;
-                   ++statesIter)
-                {
-                  double term1 =
-                    (epsValue - eigenValuesInput[kPoint][statesIter]);
-                  double denom = term1 * term1 + sigma * sigma;
-                  densityOfStates[epsInt] +=
-                    2.0 * (sigma / M_PI) * (1.0 / denom);
-                }
-            }
+          const double intervalStates =
+            densityOfStates[spinType * numberIntervals + epsInt] *
+            broadening.intervalSize();
+          integratedDensityOfStates[spinType * numberIntervals + epsInt] =
+            numberOfStates + 0.5 * intervalStates;
+          numberOfStates += intervalStates;
         }
     }
 
+  // number of states up to the Fermi energy (of the spin)
+  for (unsigned int spinType = 0; spinType < numSpins; ++spinType)
+    {
+      const double fermiEnergySpin =
+        !d_dftParamsPtr->constraintMagnetization ?
+          fermiEnergy :
+          (spinType == 0 ? fermiEnergyUp : fermiEnergyDown);
+      const double position = (fermiEnergySpin - broadening.lowerBound()) /
+                              broadening.intervalSize();
+      if (numberIntervals < 2 || position < 0.0 ||
+          position > numberIntervals - 1.0)
+        continue;
+      const unsigned int epsInt =
+        std::min((unsigned int)position, numberIntervals - 2);
+      const double  t = position - epsInt;
+      const double *spinIntegratedDensityOfStates =
+        &integratedDensityOfStates[spinType * numberIntervals];
+      const std::string spinLabel =
+        numSpins == 1 ? "" : (spinType == 0 ? " (spin up)" : " (spin down)");
+      pcout << "Integrated DOS at the Fermi energy" << spinLabel << ": "
+            << (1.0 - t) * spinIntegratedDensityOfStates[epsInt] +
+                 t * spinIntegratedDensityOfStates[epsInt + 1]
+            << std::endl;
+    }
+
   if (dealii::Utilities::MPI::this_mpi_process(d_mpiCommParent) == 0)
     {
       std::ofstream outFile(dosFileName.c_str());
@@ -223,24 +324,38 @@ dftClass<FEOrder, FEOrderElectro>::compute_tdos(
 
       if (outFile.is_open())
         {
-          if (d_dftParamsPtr->spinPolarized == 1)
+          for (unsigned int epsInt = 0; epsInt < numberIntervals; ++epsInt)
             {
-              for (unsigned int epsInt = 0; epsInt < numberIntervals; ++epsInt)
-                {
-                  double epsValue = lowerBoundEpsilon + epsInt * intervalSize;
-                  outFile << std::setprecision(18) << epsValue * 27.21138602
-                          << "  " << densityOfStatesUp[epsInt] << " "
-                          << densityOfStatesDown[epsInt] << std::endl;
-                }
+              outFile << std::setprecision(18)
+                      << broadening.energy(epsInt) * 27.21138602;
+              for (unsigned int spinType = 0; spinType < numSpins; ++spinType)
+                outFile << (spinType == 0 ? "  " : " ")
+                        << densityOfStates[spinType * numberIntervals + epsInt];
+              outFile << std::endl;
             }
-          else
+        }
+
+      //
+      // integrated DOS next to the DOS file, with the energy relative to the
+      // Fermi energy as second column
+      //
+      std::ofstream integratedOutFile(("integrated_" + dosFileName).c_str());
+      integratedOutFile.setf(std::ios_base::fixed);
+
+      if (integratedOutFile.is_open())
+        {
+          for (unsigned int epsInt = 0; epsInt < numberIntervals; ++epsInt)
             {
-              for (unsigned int epsInt = 0; epsInt < numberIntervals; ++epsInt)
-                {
-                  double epsValue = lowerBoundEpsilon + epsInt * intervalSize;
-                  outFile << std::setprecision(18) << epsValue * 27.21138602
-                          << "  " << densityOfStates[epsInt] << std::endl;
-                }
+              integratedOutFile
+                << std::setprecision(18)
+                << broadening.energy(epsInt) * 27.21138602 << " "
+                << (broadening.energy(epsInt) - fermiEnergy) * 27.21138602;
+              for (unsigned int spinType = 0; spinType < numSpins; ++spinType)
+                integratedOutFile
+                  << (spinType == 0 ? "  " : " ")
+                  << integratedDensityOfStates[spinType * numberIntervals +
+                                               epsInt];
+              integratedOutFile << std::endl;
             }
         }
     }
@@ -274,15 +389,16 @@ dftClass<FEOrder, FEOrderElectro>::compute_ldos(
   std::sort(eigenValuesAllkPoints.begin(), eigenValuesAllkPoints.end());
 
   double totalEigenValues  = eigenValuesAllkPoints.size();
-  double intervalSize      = 0.001;
-  double sigma             = C_kb * d_dftParamsPtr->TVal;
   double lowerBoundEpsilon = 1.5 * eigenValuesAllkPoints[0];
   double upperBoundEpsilon = eigenValuesAllkPoints[totalEigenValues - 1] * 1.5;
-  unsigned int numberIntervals =
-    std::ceil((upperBoundEpsilon - lowerBoundEpsilon) / intervalSize);
-  unsigned int numberGlobalAtoms = atomLocations.size();
-
-  // map each cell to an atom based on closest atom to the centroid of each cell
+  const dosBroadening broadening =
+    createDosBroadening(*d_dftParamsPtr, lowerBoundEpsilon, upperBoundEpsilon);
+  const unsigned int numberIntervals   = broadening.numIntervals();
+  unsigned int       numberGlobalAtoms = atomLocations.size();
+
+  // map each cell to the atom of the charge (atom or periodic image) closest
+  // to the centroid of the cell
+  updateAtomSpatialIndex();
   typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(),
                                                endc = dofHandler.end();
   std::map<dealii::CellId, unsigned int> cellToAtomIdMap;
@@ -291,24 +407,8 @@ dftClass<FEOrder, FEOrderElectro>::compute_ldos(
       if (cell->is_locally_owned())
         {
           const dealii::Point<3> center(cell->center());
-
-          // loop over all atoms
-          double       distanceToClosestAtom = 1e8;
-          Point<3>     closestAtom;
-          unsigned int closestAtomId;
-          for (unsigned int n = 0; n < atomLocations.size(); n++)
-            {
-              Point<3> atom(atomLocations[n][2],
-                            atomLocations[n][3],
-                            atomLocations[n][4]);
-              if (center.distance(atom) < distanceToClosestAtom)
-                {
-                  distanceToClosestAtom = center.distance(atom);
-                  closestAtom           = atom;
-                  closestAtomId         = n;
-                }
-            }
-          cellToAtomIdMap[cell->id()] = closestAtomId;
+          cellToAtomIdMap[cell->id()] =
+            d_atomSpatialIndex.nearestAtom({center[0], center[1], center[2]});
         }
     }
 
@@ -435,10 +535,16 @@ dftClass<FEOrder, FEOrderElectro>::compute_ldos(
 #endif
         }
 
+      // integrals of |psi|^2 over the cells of every atom, broadened once per
+      // block
+      std::vector<double> atomContribution(numberGlobalAtoms *
+                                             currentBlockSize,
+                                           0.0);
       if (d_dftParamsPtr->spinPolarized == 1)
         {
           for (unsigned int spinType = 0; spinType < 2; ++spinType)
             {
+              std::fill(atomContribution.begin(), atomContribution.end(), 0.0);
               typename DoFHandler<3>::active_cell_iterator
                 cellN = dofHandler.begin_active(),
                 endcN = dofHandler.end();
@@ -472,35 +578,22 @@ dftClass<FEOrder, FEOrderElectro>::compute_ldos(
                       for (unsigned int iEigenVec = 0;
                            iEigenVec < currentBlockSize;
                            ++iEigenVec)
-                        for (unsigned int epsInt = 0; epsInt < numberIntervals;
-                             ++epsInt)
-                          {
-                            double epsValue =
-                              lowerBoundEpsilon + epsInt * intervalSize;
-                            double term1 =
-                              (epsValue -
-                               blockedEigenValues[0]
-                                                 [spinType * currentBlockSize +
-                                                  iEigenVec]);
-                            double smearedEnergyLevel =
-                              (sigma / M_PI) *
-                              (1.0 / (term1 * term1 + sigma * sigma));
-
-                            if (spinType == 0)
-                              localDensityOfStatesUp[numberIntervals *
-                                                       globalAtomId +
-                                                     epsInt] +=
-                                tempContribution[iEigenVec] *
-                                smearedEnergyLevel;
-                            else
-                              localDensityOfStatesDown[numberIntervals *
-                                                         globalAtomId +
-                                                       epsInt] +=
-                                tempContribution[iEigenVec] *
-                                smearedEnergyLevel;
-                          }
+                        atomContribution[currentBlockSize * globalAtomId +
+                                         iEigenVec] +=
+                          tempContribution[iEigenVec];
                     }
                 }
+
+              const std::vector<double> energyLevels(
+                blockedEigenValues[0].begin() + spinType * currentBlockSize,
+                blockedEigenValues[0].begin() +
+                  (spinType + 1) * currentBlockSize);
+              broadening.accumulate(energyLevels,
+                                    atomContribution,
+                                    numberGlobalAtoms,
+                                    1.0,
+                                    spinType == 0 ? localDensityOfStatesUp :
+                                                    localDensityOfStatesDown);
             }
         }
       else
@@ -536,23 +629,19 @@ dftClass<FEOrder, FEOrderElectro>::compute_ldos(
 
                   for (unsigned int iEigenVec = 0; iEigenVec < currentBlockSize;
                        ++iEigenVec)
-                    for (unsigned int epsInt = 0; epsInt < numberIntervals;
-                         ++epsInt)
-                      {
-                        double epsValue =
-                          lowerBoundEpsilon + epsInt * intervalSize;
-                        double term1 =
-                          (epsValue - blockedEigenValues[0][iEigenVec]);
-                        double smearedEnergyLevel =
-                          (sigma / M_PI) *
-                          (1.0 / (term1 * term1 + sigma * sigma));
-                        localDensityOfStates[numberIntervals * globalAtomId +
-                                             epsInt] +=
-                          2.0 * tempContribution[iEigenVec] *
-                          smearedEnergyLevel;
-                      }
+                    atomContribution[currentBlockSize * globalAtomId +
+                                     iEigenVec] += tempContribution[iEigenVec];
                 }
             }
+
+          const std::vector<double> energyLevels(
+            blockedEigenValues[0].begin(),
+            blockedEigenValues[0].begin() + currentBlockSize);
+          broadening.accumulate(energyLevels,
+                                atomContribution,
+                                numberGlobalAtoms,
+                                2.0,
+                                localDensityOfStates);
         }
     } // ivec loop
 
@@ -585,7 +674,7 @@ dftClass<FEOrder, FEOrderElectro>::compute_ldos(
             {
               for (unsigned int epsInt = 0; epsInt < numberIntervals; ++epsInt)
                 {
-                  double epsValue = lowerBoundEpsilon + epsInt * intervalSize;
+                  double epsValue = broadening.energy(epsInt);
                   outFile << std::setprecision(18) << epsValue * 27.21138602
                           << " ";
                   for (unsigned int iAtom = 0; iAtom < numberGlobalAtoms;
@@ -615,7 +704,7 @@ dftClass<FEOrder, FEOrderElectro>::compute_ldos(
             {
               for (unsigned int epsInt = 0; epsInt < numberIntervals; ++epsInt)
                 {
-                  double epsValue = lowerBoundEpsilon + epsInt * intervalSize;
+                  double epsValue = broadening.energy(epsInt);
                   outFile << std::setprecision(18) << epsValue * 27.21138602
                           << " ";
                   for (unsigned int iAtom = 0; iAtom < numberGlobalAtoms;
@@ -646,6 +735,7 @@ dftClass<FEOrder, FEOrderElectro>::compute_pdos(
   const std::string &                     pdosFileName)
 {
   computing_timer.enter_subsection("PDOS computation");
+  updateAtomSpatialIndex();
 
   //
   // create a stencil following orbital filling order
@@ -762,13 +852,13 @@ dftClass<FEOrder, FEOrderElectro>::compute_pdos(
   unsigned int errorReadFile = 0;
   unsigned int fileReadFlag  = 0;
 
-  std::map<
-    unsigned int,
-    std::map<unsigned int, std::map<unsigned int, alglib::spline1dinterpolant>>>
-                                    radValues;
+  // the radial parts are shared by all atoms of an atomic number and all m,
+  // and with the population analysis
   std::vector<std::vector<orbital>> singleAtomInfo;
+  std::vector<std::vector<const atomicOrbitalRadialTables::radialTable *>>
+    singleAtomRadialTables(numberGlobalAtoms);
   singleAtomInfo.resize(numberGlobalAtoms);
-  double wfcInitTruncation;
+  double wfcInitTruncation = 0.0;
 
   for (std::vector<std::vector<unsigned int>>::iterator it = stencil.begin();
        it < stencil.end();
@@ -785,14 +875,14 @@ dftClass<FEOrder, FEOrderElectro>::compute_pdos(
               //
               // load PSI files
               //
-              loadSingleAtomPSIFiles(Z,
-                                     n,
-                                     l,
-                                     fileReadFlag,
-                                     wfcInitTruncation,
-                                     radValues,
-                                     d_mpiCommParent,
-                                     *d_dftParamsPtr);
+              const atomicOrbitalRadialTables::radialTable *radial =
+                loadSingleAtomPSIFiles(Z,
+                                       n,
+                                       l,
+                                       d_atomicOrbitalRadialTables,
+                                       d_mpiCommParent,
+                                       *d_dftParamsPtr);
+              fileReadFlag = radial != nullptr ? 1 : 0;
 
               if (fileReadFlag > 0)
                 {
@@ -802,8 +892,10 @@ dftClass<FEOrder, FEOrderElectro>::compute_pdos(
                   temp.n      = n;
                   temp.l      = l;
                   temp.m      = m;
-                  temp.psi    = radValues[Z][n][l];
                   singleAtomInfo[iAtom].push_back(temp);
+                  singleAtomRadialTables[iAtom].push_back(radial);
+                  wfcInitTruncation =
+                    std::max(wfcInitTruncation, radial->truncationRadius);
                   // pcout << "Atom Id: "<<iAtom<<" Z: "<<Z<<" n: "<<n<<" l:
                   // "<<l<<" m: "<<m<<std::endl;
                 }
@@ -825,87 +917,101 @@ dftClass<FEOrder, FEOrderElectro>::compute_pdos(
         }
     }
 
-  // loop over elements
-  std::vector<double> eigenValuesAllkPoints;
-  for (int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
-    {
-      for (int statesIter = 0; statesIter < eigenValuesInput[0].size();
-           ++statesIter)
-        {
-          eigenValuesAllkPoints.push_back(eigenValuesInput[kPoint][statesIter]);
-        }
-    }
-
-  std::sort(eigenValuesAllkPoints.begin(), eigenValuesAllkPoints.end());
-
-  double totalEigenValues  = eigenValuesAllkPoints.size();
-  double intervalSize      = 0.001;
-  double sigma             = C_kb * d_dftParamsPtr->TVal;
-  double lowerBoundEpsilon = 1.5 * eigenValuesAllkPoints[0];
-  double upperBoundEpsilon = eigenValuesAllkPoints[totalEigenValues - 1] * 1.5;
+  //
+  // energy grid spanning the levels of all pools, so that the pools
+  // accumulate on the same grid
+  //
+  double minEigenValue = std::numeric_limits<double>::max();
+  double maxEigenValue = -std::numeric_limits<double>::max();
+  for (unsigned int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
+    for (const double eigenValue : eigenValuesInput[kPoint])
+      {
+        minEigenValue = std::min(minEigenValue, eigenValue);
+        maxEigenValue = std::max(maxEigenValue, eigenValue);
+      }
+  minEigenValue = Utilities::MPI::min(minEigenValue, interpoolcomm);
+  maxEigenValue = Utilities::MPI::max(maxEigenValue, interpoolcomm);
+
+  double lowerBoundEpsilon = 1.5 * minEigenValue;
+  double upperBoundEpsilon = maxEigenValue * 1.5;
+  const dosBroadening broadening =
+    createDosBroadening(*d_dftParamsPtr, lowerBoundEpsilon, upperBoundEpsilon);
+
+  const unsigned int numberIntervals = broadening.numIntervals();
+  const unsigned int numSpins        = 1 + d_dftParamsPtr->spinPolarized;
+  const unsigned int numKPointSpins  = numSpins * d_kPointWeights.size();
+  const double       spinFactor      = numSpins == 1 ? 2.0 : 1.0;
 
-  unsigned int numberIntervals =
-    std::ceil((upperBoundEpsilon - lowerBoundEpsilon) / intervalSize);
+  //
+  // rows (spin, single atom wavefunction), k-point weighted
+  //
   std::vector<double> partialDensityOfStates;
-  partialDensityOfStates.resize(totalAtomicData * numberIntervals, 0.0);
+  partialDensityOfStates.resize(numSpins * totalAtomicData * numberIntervals,
+                                0.0);
 
-  // access finite-element data
-  QGauss<3>          quadrature_formula(C_num1DQuad<FEOrder>());
+  //
+  // a block of bands of all k-points and spins is interpolated to the
+  // quadrature points of a cell with one GEMM of its cell-local nodal values
+  // and the shape functions, in the cell order of the density calculator
+  //
+  kohnShamDFTOperatorClass<FEOrder, FEOrderElectro> &kohnShamDFTEigenOperator =
+    *d_kohnShamDFTOperatorPtr;
+  const Quadrature<3> &quadrature_formula =
+    matrix_free_data.get_quadrature(d_densityQuadratureId);
   FEValues<3>        fe_values(dofHandler.get_fe(),
                         quadrature_formula,
-                        update_values | update_JxW_values |
-                          update_quadrature_points);
-  const unsigned int dofs_per_cell = dofHandler.get_fe().dofs_per_cell;
-  const unsigned int n_q_points    = quadrature_formula.size();
+                        update_JxW_values | update_quadrature_points);
+  const unsigned int n_q_points = quadrature_formula.size();
+  const unsigned int numNodesPerElement =
+    matrix_free_data.get_dofs_per_cell(d_densityDofHandlerIndex);
+  const unsigned int localVectorSize =
+    d_eigenVectorsFlattenedSTL[0].size() / d_numEigenValues;
 
+  std::vector<dataTypes::number> shapeFunctionValues(n_q_points *
+                                                     numNodesPerElement);
+  for (unsigned int i = 0; i < n_q_points * numNodesPerElement; ++i)
+    shapeFunctionValues[i] = dataTypes::number(
+      kohnShamDFTEigenOperator.getShapeFunctionValuesDensityGaussQuad()[i]);
 
   const unsigned int blockSize =
     std::min(d_dftParamsPtr->wfcBlockSize, d_numEigenValues);
 
-  std::vector<std::vector<double>> tempQuadPointValuesForWaveFunctions(
-    blockSize);
-  std::vector<double> tempQuadPointValues(n_q_points);
-
-  const unsigned int localVectorSize =
-    d_eigenVectorsFlattenedSTL[0].size() / d_numEigenValues;
-  std::vector<std::vector<distributedCPUVec<double>>> eigenVectors(
-    (1 + d_dftParamsPtr->spinPolarized) * d_kPointWeights.size());
-  std::vector<distributedCPUVec<dataTypes::number>> eigenVectorsFlattenedBlock(
-    (1 + d_dftParamsPtr->spinPolarized) * d_kPointWeights.size());
-  // std::vector<double>
-  // innerProductWaveFunctionSingAtom(d_numEigenValues*5,0.0);
-  // std::vector<double> tempContribution(blockSize*,0.0);
+  std::vector<dataTypes::number> orbitalQuadValues;
+  std::vector<dataTypes::number> waveFunctionQuadValues;
+  std::vector<dataTypes::number> cellWaveFunctionMatrix(numNodesPerElement *
+                                                        blockSize);
+  std::vector<dataTypes::number> wfcQuads(n_q_points * blockSize);
+  std::vector<double>            chargeOrbitalQuadValues;
+  std::vector<unsigned int>      nearCharges, nearAtoms, nearAtomColumns,
+    nearOrbitalRows, chargeOrbitalOffsets;
+  std::vector<distributedCPUVec<dataTypes::number>> flattenedArrayBlocks(
+    numKPointSpins);
 
   for (unsigned int ivec = 0; ivec < d_numEigenValues; ivec += blockSize)
     {
       const unsigned int currentBlockSize =
         std::min(blockSize, d_numEigenValues - ivec);
-      std::vector<double> tempContribution(currentBlockSize * totalAtomicData,
-                                           0.0);
+      //
+      // projections of the block on the single atom wavefunctions for all
+      // k-points and spins, [(kPointSpin * totalAtomicData + row) *
+      // currentBlockSize + iEigenVec] with kPointSpin = numSpins * kPoint +
+      // spin as in d_eigenVectorsFlattenedSTL
+      //
+      const unsigned int numColumns = numKPointSpins * currentBlockSize;
+      std::vector<dataTypes::number> tempContribution(numColumns *
+                                                        totalAtomicData,
+                                                      dataTypes::number(0.0));
+      const unsigned int numSpinColumns = numSpins * currentBlockSize;
+      waveFunctionQuadValues.resize(n_q_points * numSpinColumns);
 
       if (currentBlockSize != blockSize || ivec == 0)
         {
-          for (unsigned int kPoint = 0;
-               kPoint <
-               (1 + d_dftParamsPtr->spinPolarized) * d_kPointWeights.size();
-               ++kPoint)
-            {
-              eigenVectors[kPoint].resize(currentBlockSize);
-              for (unsigned int i = 0; i < currentBlockSize; ++i)
-                eigenVectors[kPoint][i].reinit(d_tempEigenVec);
-
-
-              vectorTools::createDealiiVector<dataTypes::number>(
-                matrix_free_data.get_vector_partitioner(),
-                currentBlockSize,
-                eigenVectorsFlattenedBlock[kPoint]);
-              eigenVectorsFlattenedBlock[kPoint] = dataTypes::number(0.0);
-            }
-
-          constraintsNoneDataInfo.precomputeMaps(
-            matrix_free_data.get_vector_partitioner(),
-            eigenVectorsFlattenedBlock[0].get_partitioner(),
-            currentBlockSize);
+          kohnShamDFTEigenOperator.reinit(currentBlockSize,
+                                          flattenedArrayBlocks[0],
+                                          true);
+          for (unsigned int kPointSpin = 1; kPointSpin < numKPointSpins;
+               ++kPointSpin)
+            flattenedArrayBlocks[kPointSpin].reinit(flattenedArrayBlocks[0]);
         }
 
 
@@ -926,202 +1032,312 @@ dftClass<FEOrder, FEOrderElectro>::compute_pdos(
           }
 
 
-      for (unsigned int kPoint = 0;
-           kPoint <
-           (1 + d_dftParamsPtr->spinPolarized) * d_kPointWeights.size();
-           ++kPoint)
+      for (unsigned int kPointSpin = 0; kPointSpin < numKPointSpins;
+           ++kPointSpin)
         {
           for (unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
             for (unsigned int iWave = 0; iWave < currentBlockSize; ++iWave)
-              eigenVectorsFlattenedBlock[kPoint].local_element(
+              flattenedArrayBlocks[kPointSpin].local_element(
                 iNode * currentBlockSize + iWave) =
-                d_eigenVectorsFlattenedSTL[kPoint][iNode * d_numEigenValues +
-                                                   ivec + iWave];
-
-          constraintsNoneDataInfo.distribute(eigenVectorsFlattenedBlock[kPoint],
-                                             currentBlockSize);
-          eigenVectorsFlattenedBlock[kPoint].update_ghost_values();
-
-#ifdef USE_COMPLEX
-          vectorTools::copyFlattenedDealiiVecToSingleCompVec(
-            eigenVectorsFlattenedBlock[kPoint],
-            currentBlockSize,
-            std::make_pair(0, currentBlockSize),
-            localProc_dof_indicesReal,
-            localProc_dof_indicesImag,
-            eigenVectors[kPoint],
-            false);
+                d_eigenVectorsFlattenedSTL[kPointSpin]
+                                          [iNode * d_numEigenValues + ivec +
+                                           iWave];
 
-          // FIXME: The underlying call to update_ghost_values
-          // is required because currently localProc_dof_indicesReal
-          // and localProc_dof_indicesImag are only available for
-          // locally owned nodes. Once they are also made available
-          // for ghost nodes- use true for the last argument in
-          // copyFlattenedDealiiVecToSingleCompVec(..) above and supress
-          // underlying call.
-          for (unsigned int i = 0; i < currentBlockSize; ++i)
-            eigenVectors[kPoint][i].update_ghost_values();
-#else
-          vectorTools::copyFlattenedDealiiVecToSingleCompVec(
-            eigenVectorsFlattenedBlock[kPoint],
-            currentBlockSize,
-            std::make_pair(0, currentBlockSize),
-            eigenVectors[kPoint],
-            true);
-#endif
+          (kohnShamDFTEigenOperator.getOverloadedConstraintMatrix())
+            ->distribute(flattenedArrayBlocks[kPointSpin], currentBlockSize);
         }
 
-      if (d_dftParamsPtr->spinPolarized == 1)
+      typename DoFHandler<3>::active_cell_iterator
+                   cellN = dofHandler.begin_active(),
+                   endcN = dofHandler.end();
+      unsigned int icell = 0;
+      for (; cellN != endcN; ++cellN)
         {
-          AssertThrow(false,
-                      ExcMessage(
-                        "PDOS is not implemented for spin-polarized problems"));
-        }
-      else
-        {
-          typename DoFHandler<3>::active_cell_iterator cellN =
-                                                         dofHandler
-                                                           .begin_active(),
-                                                       endcN = dofHandler.end();
-          for (; cellN != endcN; ++cellN)
+          if (cellN->is_locally_owned())
             {
-              if (cellN->is_locally_owned())
-                {
-                  fe_values.reinit(cellN);
-
-                  for (unsigned int iEigenVec = 0; iEigenVec < currentBlockSize;
-                       ++iEigenVec)
-                    {
-                      tempQuadPointValuesForWaveFunctions[iEigenVec].resize(
-                        n_q_points);
-                      fe_values.get_function_values(eigenVectors[0][iEigenVec],
-                                                    tempQuadPointValues);
-                      tempQuadPointValuesForWaveFunctions[iEigenVec] =
-                        tempQuadPointValues;
-                    }
-
+              const unsigned int iElem = icell++;
+              fe_values.reinit(cellN);
 
+              //
+              // atoms with a charge, the atom itself or one of its periodic
+              // images, within the truncation radius of the cell
+              //
+              const Point<3> cellCenter = cellN->center();
+              const double   cellRadius = 0.5 * cellN->diameter();
+              d_atomSpatialIndex.chargesWithinRadius(
+                {cellCenter[0], cellCenter[1], cellCenter[2]},
+                wfcInitTruncation + cellRadius,
+                nearCharges);
+              nearAtoms.clear();
+              for (const unsigned int iCharge : nearCharges)
+                nearAtoms.push_back(d_atomSpatialIndex.atomIdOfCharge(iCharge));
+              std::sort(nearAtoms.begin(), nearAtoms.end());
+              nearAtoms.erase(std::unique(nearAtoms.begin(), nearAtoms.end()),
+                              nearAtoms.end());
+              nearOrbitalRows.clear();
+              nearAtomColumns.clear();
+              for (const unsigned int iAtom : nearAtoms)
+                {
+                  nearAtomColumns.push_back(nearOrbitalRows.size());
+                  for (unsigned int iSingAtomData = 0;
+                       iSingAtomData < singleAtomInfo[iAtom].size();
+                       ++iSingAtomData)
+                    nearOrbitalRows.push_back(
+                      singleAtomInfo[iAtom].size() * iAtom +
+                      iSingAtomData);
+                }
+              const unsigned int numNearOrbitals = nearOrbitalRows.size();
+              if (numNearOrbitals == 0)
+                continue;
 
-                  for (unsigned int iAtom = 0; iAtom < numberGlobalAtoms;
-                       ++iAtom)
+              //
+              // single atom wavefunctions centered at each charge at the
+              // quadrature points, scaled by JxW (n_q x number of single
+              // atom wavefunctions of the atom of the charge)
+              //
+              chargeOrbitalOffsets.clear();
+              unsigned int numChargeOrbitalValues = 0;
+              for (const unsigned int iCharge : nearCharges)
+                {
+                  chargeOrbitalOffsets.push_back(numChargeOrbitalValues);
+                  numChargeOrbitalValues +=
+                    n_q_points *
+                    singleAtomInfo[d_atomSpatialIndex.atomIdOfCharge(iCharge)]
+                      .size();
+                }
+              chargeOrbitalQuadValues.assign(numChargeOrbitalValues, 0.0);
+              for (unsigned int i = 0; i < nearCharges.size(); ++i)
+                {
+                  const unsigned int iAtom =
+                    d_atomSpatialIndex.atomIdOfCharge(nearCharges[i]);
+                  const std::array<double, 3> &chargePosition =
+                    d_atomSpatialIndex.chargePosition(nearCharges[i]);
+                  const unsigned int numOrbitals =
+                    singleAtomInfo[iAtom].size();
+                  double *chargeOrbitalValues =
+                    &chargeOrbitalQuadValues[chargeOrbitalOffsets[i]];
+                  for (unsigned int q = 0; q < n_q_points; ++q)
                     {
+                      const Point<3> &quadPoint =
+                        fe_values.quadrature_point(q);
+                      double x = quadPoint[0] - chargePosition[0];
+                      double y = quadPoint[1] - chargePosition[1];
+                      double z = quadPoint[2] - chargePosition[2];
+
+                      double r = sqrt(x * x + y * y + z * z);
+                      if (r > wfcInitTruncation)
+                        continue;
+                      double theta = r == 0 ? 0.0 : acos(z / r);
+                      double phi   = r == 0 ? 0.0 : atan2(y, x);
+
+                      // the m of a shell share the radial part
+                      double R = 0.0;
+
+                      const atomicOrbitalRadialTables::radialTable
+                        *lastRadial = nullptr;
                       for (unsigned int iSingAtomData = 0;
-                           iSingAtomData < singleAtomInfo[iAtom].size();
+                           iSingAtomData < numOrbitals;
                            ++iSingAtomData)
                         {
-                          for (unsigned int q = 0; q < n_q_points; ++q)
+                          const atomicOrbitalRadialTables::radialTable
+                            *radial =
+                              singleAtomRadialTables[iAtom][iSingAtomData];
+                          if (radial != lastRadial)
                             {
-                              const Point<3> &quadPoint =
-                                fe_values.quadrature_point(q);
-                              double x = quadPoint[0] - atomLocations[iAtom][2];
-                              double y = quadPoint[1] - atomLocations[iAtom][3];
-                              double z = quadPoint[2] - atomLocations[iAtom][4];
-
-                              double r     = sqrt(x * x + y * y + z * z);
-                              double theta = acos(z / r);
-                              double phi   = atan2(y, x);
-
-                              if (r == 0)
-                                {
-                                  theta = 0;
-                                  phi   = 0;
-                                }
-
-                              orbital dataOrb =
-                                singleAtomInfo[iAtom][iSingAtomData];
-
-                              double R = 0.0;
-                              double singleAtomWaveFunctionQuadValue;
-
-                              if (r <= wfcInitTruncation)
-                                {
-                                  R = alglib::spline1dcalc(dataOrb.psi, r);
-                                  if (dataOrb.m > 0)
-                                    singleAtomWaveFunctionQuadValue =
-                                      R * std::sqrt(2) *
-                                      boost::math::spherical_harmonic_r(
-                                        dataOrb.l, dataOrb.m, theta, phi);
-                                  else if (dataOrb.m == 0)
-                                    singleAtomWaveFunctionQuadValue =
-                                      R * boost::math::spherical_harmonic_r(
-                                            dataOrb.l, dataOrb.m, theta, phi);
-                                  else
-                                    singleAtomWaveFunctionQuadValue =
-                                      R * std::sqrt(2) *
-                                      boost::math::spherical_harmonic_i(
-                                        dataOrb.l, -dataOrb.m, theta, phi);
-                                }
-                              else
-                                singleAtomWaveFunctionQuadValue = 0.0;
-
-                              for (unsigned int iEigenVec = 0;
-                                   iEigenVec < currentBlockSize;
-                                   ++iEigenVec)
-                                {
-                                  tempContribution
-                                    [currentBlockSize *
-                                       singleAtomInfo[iAtom].size() * iAtom +
-                                     currentBlockSize * iSingAtomData +
-                                     iEigenVec] +=
-                                    tempQuadPointValuesForWaveFunctions
-                                      [iEigenVec][q] *
-                                    singleAtomWaveFunctionQuadValue *
-                                    fe_values.JxW(q);
-                                }
-                            } // quad loop
-
-                        } // single atom wavefunction data
-
-                    } // iAtom data
-
-                } // if cell
-
-            } // cell loop
-
-          dealii::Utilities::MPI::sum(tempContribution,
-                                      mpi_communicator,
-                                      tempContribution);
-        } // if-else loop
-
+                              R = alglib::spline1dcalc(radial->spline, r);
+                              lastRadial = radial;
+                            }
+                          chargeOrbitalValues[q * numOrbitals +
+                                              iSingAtomData] =
+                            fe_values.JxW(q) *
+                            singleAtomWaveFunctionValue(
+                              singleAtomInfo[iAtom][iSingAtomData],
+                              R,
+                              theta,
+                              phi);
+                        }
+                    }
+                }
 
-      for (unsigned int iAtom = 0; iAtom < numberGlobalAtoms; ++iAtom)
-        {
-          for (unsigned int iSingAtomData = 0;
-               iSingAtomData < singleAtomInfo[iAtom].size();
-               ++iSingAtomData)
-            {
-              for (unsigned int iEigenVec = 0; iEigenVec < currentBlockSize;
-                   ++iEigenVec)
+              for (unsigned int kPoint = 0; kPoint < d_kPointWeights.size();
+                   ++kPoint)
                 {
-                  for (unsigned int epsInt = 0; epsInt < numberIntervals;
-                       ++epsInt)
+                  //
+                  // Bloch sums of the single atom wavefunctions over the
+                  // charges of each atom (n_q x numNearOrbitals), the image
+                  // at R contributing with the phase e^{-ik.(r - R)} so that
+                  // the conjugate transpose acts on the periodic part of
+                  // the wavefunctions. Without k-points all phases are one.
+                  //
+                  orbitalQuadValues.assign(n_q_points * numNearOrbitals,
+                                           dataTypes::number(0.0));
+                  for (unsigned int i = 0; i < nearCharges.size(); ++i)
                     {
-                      double epsValue =
-                        lowerBoundEpsilon + epsInt * intervalSize;
-                      double term1 =
-                        (epsValue - blockedEigenValues[0][iEigenVec]);
-                      double smearedEnergyLevel =
-                        (sigma / M_PI) *
-                        (1.0 / (term1 * term1 + sigma * sigma));
-                      double tempValue =
-                        tempContribution[currentBlockSize *
-                                           singleAtomInfo[iAtom].size() *
-                                           iAtom +
-                                         currentBlockSize * iSingAtomData +
-                                         iEigenVec];
-                      partialDensityOfStates[numberIntervals *
-                                               singleAtomInfo[iAtom].size() *
-                                               iAtom +
-                                             numberIntervals * iSingAtomData +
-                                             epsInt] +=
-                        2.0 * tempValue * tempValue * smearedEnergyLevel;
+                      const unsigned int iAtom =
+                        d_atomSpatialIndex.atomIdOfCharge(nearCharges[i]);
+                      const unsigned int numOrbitals =
+                        singleAtomInfo[iAtom].size();
+                      const unsigned int column =
+                        nearAtomColumns[std::lower_bound(nearAtoms.begin(),
+                                                         nearAtoms.end(),
+                                                         iAtom) -
+                                        nearAtoms.begin()];
+                      const double *chargeOrbitalValues =
+                        &chargeOrbitalQuadValues[chargeOrbitalOffsets[i]];
+#ifdef USE_COMPLEX
+                      const std::array<double, 3> &chargePosition =
+                        d_atomSpatialIndex.chargePosition(nearCharges[i]);
+#endif
+                      for (unsigned int q = 0; q < n_q_points; ++q)
+                        {
+#ifdef USE_COMPLEX
+                          const Point<3> &quadPoint =
+                            fe_values.quadrature_point(q);
+                          double angle = 0.0;
+                          for (unsigned int d = 0; d < 3; ++d)
+                            angle += d_kPointCoordinates[3 * kPoint + d] *
+                                     (quadPoint[d] - chargePosition[d]);
+                          const dataTypes::number phase(cos(angle),
+                                                        -sin(angle));
+#else
+                          const dataTypes::number phase = 1.0;
+#endif
+                          for (unsigned int iSingAtomData = 0;
+                               iSingAtomData < numOrbitals;
+                               ++iSingAtomData)
+                            orbitalQuadValues[q * numNearOrbitals + column +
+                                              iSingAtomData] +=
+                              phase * chargeOrbitalValues[q * numOrbitals +
+                                                          iSingAtomData];
+                        }
                     }
+
+                  //
+                  // wavefunctions of the block of both spins of the k-point
+                  // at the quadrature points (n_q x numSpinColumns), one
+                  // GEMM over the quadrature points shares the Bloch sums
+                  // between the spins
+                  //
+                  for (unsigned int spin = 0; spin < numSpins; ++spin)
+                    {
+                      const unsigned int kPointSpin = numSpins * kPoint + spin;
+                      const unsigned int inc        = 1;
+                      for (unsigned int iNode = 0; iNode < numNodesPerElement;
+                           ++iNode)
+                        xcopy(&currentBlockSize,
+                              flattenedArrayBlocks[kPointSpin].begin() +
+                                kohnShamDFTEigenOperator
+                                  .getFlattenedArrayCellLocalProcIndexIdMap()
+                                    [iElem * numNodesPerElement + iNode],
+                              &inc,
+                              &cellWaveFunctionMatrix[currentBlockSize *
+                                                      iNode],
+                              &inc);
+
+                      const dataTypes::number scalarCoeffAlpha =
+                                                dataTypes::number(1.0),
+                                              scalarCoeffBeta =
+                                                dataTypes::number(0.0);
+                      const char transA = 'N', transB = 'N';
+                      xgemm(&transA,
+                            &transB,
+                            &currentBlockSize,
+                            &n_q_points,
+                            &numNodesPerElement,
+                            &scalarCoeffAlpha,
+                            &cellWaveFunctionMatrix[0],
+                            &currentBlockSize,
+                            &shapeFunctionValues[0],
+                            &numNodesPerElement,
+                            &scalarCoeffBeta,
+                            &wfcQuads[0],
+                            &currentBlockSize);
+
+                      for (unsigned int q = 0; q < n_q_points; ++q)
+                        std::copy(wfcQuads.begin() + q * currentBlockSize,
+                                  wfcQuads.begin() +
+                                    (q + 1) * currentBlockSize,
+                                  waveFunctionQuadValues.begin() +
+                                    q * numSpinColumns +
+                                    spin * currentBlockSize);
+                    }
+
+                  const std::vector<dataTypes::number> cellProjections =
+                    matrixTmatrixmul(orbitalQuadValues,
+                                     n_q_points,
+                                     numNearOrbitals,
+                                     waveFunctionQuadValues,
+                                     n_q_points,
+                                     numSpinColumns);
+                  for (unsigned int row = 0; row < numNearOrbitals; ++row)
+                    for (unsigned int spin = 0; spin < numSpins; ++spin)
+                      for (unsigned int iEigenVec = 0;
+                           iEigenVec < currentBlockSize;
+                           ++iEigenVec)
+                        tempContribution[((numSpins * kPoint + spin) *
+                                            totalAtomicData +
+                                          nearOrbitalRows[row]) *
+                                           currentBlockSize +
+                                         iEigenVec] +=
+                          cellProjections[row * numSpinColumns +
+                                          spin * currentBlockSize +
+                                          iEigenVec];
                 }
-            }
-        }
+            } // if cell
+
+        } // cell loop
+
+      dealii::Utilities::MPI::sum(tempContribution,
+                                  mpi_communicator,
+                                  tempContribution);
+
+
+      //
+      // squared projections of the block for each k-point and spin, rows
+      // the single atom wavefunctions of all atoms in the order of
+      // tempContribution
+      //
+      std::vector<double> squaredProjections(totalAtomicData *
+                                             currentBlockSize);
+      std::vector<double> spinDensityOfStates(totalAtomicData *
+                                              numberIntervals);
+      for (unsigned int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
+        for (unsigned int spin = 0; spin < numSpins; ++spin)
+          {
+            const unsigned int offset =
+              (numSpins * kPoint + spin) * totalAtomicData * currentBlockSize;
+            for (unsigned int i = 0; i < squaredProjections.size(); ++i)
+              squaredProjections[i] = std::norm(tempContribution[offset + i]);
+            const std::vector<double> energyLevels(
+              blockedEigenValues[kPoint].begin() + spin * currentBlockSize,
+              blockedEigenValues[kPoint].begin() +
+                (spin + 1) * currentBlockSize);
+            std::fill(spinDensityOfStates.begin(),
+                      spinDensityOfStates.end(),
+                      0.0);
+            broadening.accumulate(energyLevels,
+                                  squaredProjections,
+                                  totalAtomicData,
+                                  spinFactor * d_kPointWeights[kPoint],
+                                  spinDensityOfStates);
+            std::transform(spinDensityOfStates.begin(),
+                           spinDensityOfStates.end(),
+                           partialDensityOfStates.begin() +
+                             spin * totalAtomicData * numberIntervals,
+                           partialDensityOfStates.begin() +
+                             spin * totalAtomicData * numberIntervals,
+                           std::plus<double>());
+          }
 
     } // ivec block loop
 
+  //
+  // k-points of the other pools
+  //
+  dealii::Utilities::MPI::sum(partialDensityOfStates,
+                              interpoolcomm,
+                              partialDensityOfStates);
+
   pcout << "Following is the Single atom data used for PDOS computation: "
         << std::endl;
 
@@ -1151,36 +1367,32 @@ dftClass<FEOrder, FEOrderElectro>::compute_pdos(
           outputFile.setf(std::ios_base::fixed);
           if (outputFile.is_open())
             {
-              if (d_dftParamsPtr->spinPolarized == 1)
-                {
-                  AssertThrow(
-                    false,
-                    ExcMessage(
-                      "PDOS is not implemented for spin-polarized problems"));
-                }
-              else
+              //
+              // energy followed by the PDOS of the single atom
+              // wavefunctions of the atom, all spin up columns before the
+              // spin down columns in the spin-polarized case
+              //
+              for (unsigned int epsInt = 0; epsInt < numberIntervals; ++epsInt)
                 {
-                  for (unsigned int epsInt = 0; epsInt < numberIntervals;
-                       ++epsInt)
-                    {
-                      double epsValue =
-                        lowerBoundEpsilon + epsInt * intervalSize;
-                      outputFile << std::setprecision(18)
-                                 << epsValue * 27.21138602 << " ";
-                      for (unsigned int iSingAtomData = 0;
-                           iSingAtomData < singleAtomInfo[iAtom].size();
-                           ++iSingAtomData)
-                        {
-                          outputFile
-                            << std::setprecision(18)
-                            << partialDensityOfStates
-                                 [numberIntervals *
-                                    singleAtomInfo[iAtom].size() * iAtom +
-                                  numberIntervals * iSingAtomData + epsInt]
-                            << " ";
-                        }
-                      outputFile << std::endl;
-                    }
+                  double epsValue = broadening.energy(epsInt);
+                  outputFile << std::setprecision(18)
+                             << epsValue * 27.21138602 << " ";
+                  for (unsigned int spin = 0; spin < numSpins; ++spin)
+                    for (unsigned int iSingAtomData = 0;
+                         iSingAtomData < singleAtomInfo[iAtom].size();
+                         ++iSingAtomData)
+                      {
+                        outputFile
+                          << std::setprecision(18)
+                          << partialDensityOfStates
+                               [numberIntervals *
+                                  (spin * totalAtomicData +
+                                   singleAtomInfo[iAtom].size() * iAtom +
+                                   iSingAtomData) +
+                                epsInt]
+                          << " ";
+                      }
+                  outputFile << std::endl;
                 }
             }
         }
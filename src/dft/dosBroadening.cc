@@ -0,0 +1,382 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <dosBroadening.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace dftfe
+{
+  namespace
+  {
+    //
+    // number of states below E of a tetrahedron with the sorted corner
+    // energies e, one for E above all corners (Bloechl, PRB 49, 16223)
+    //
+    double
+    tetrahedronStatesBelow(const std::array<double, 4> &e, const double E)
+    {
+      if (E < e[0])
+        return 0.0;
+      if (E >= e[3])
+        return 1.0;
+
+      if (E < e[1])
+        {
+          const double x = E - e[0];
+          return x * x * x / ((e[1] - e[0]) * (e[2] - e[0]) * (e[3] - e[0]));
+        }
+      if (E < e[2])
+        {
+          const double e21 = e[1] - e[0], e31 = e[2] - e[0];
+          const double e41 = e[3] - e[0], e32 = e[2] - e[1];
+          const double e42 = e[3] - e[1];
+          const double x   = E - e[1];
+          return (e21 * e21 + 3.0 * e21 * x + 3.0 * x * x -
+                  (e31 + e42) / (e32 * e42) * x * x * x) /
+                 (e31 * e41);
+        }
+      const double x = e[3] - E;
+      return 1.0 -
+             x * x * x / ((e[3] - e[0]) * (e[3] - e[1]) * (e[3] - e[2]));
+    }
+  } // namespace
+
+
+  dosBroadening::dosBroadening(const kernelType   kernel,
+                               const double       width,
+                               const unsigned int methfesselPaxtonOrder,
+                               const double       cutoffWidths,
+                               const double       lowerBound,
+                               const double       intervalSize,
+                               const unsigned int numIntervals)
+    : d_kernel(kernel)
+    , d_width(width)
+    , d_methfesselPaxtonOrder(methfesselPaxtonOrder)
+    , d_lowerBound(lowerBound)
+    , d_intervalSize(intervalSize)
+    , d_numIntervals(numIntervals)
+  {
+    AssertThrow(width > 0.0 && intervalSize > 0.0,
+                dealii::ExcMessage(
+                  "DFT-FE Error: the DOS broadening width and energy spacing "
+                  "must be positive."));
+
+    const double c =
+      cutoffWidths > 0.0 ? cutoffWidths :
+                           (kernel == kernelType::lorentzian ? 100.0 : 8.0);
+    d_cutoff = c * width;
+
+    // weight of the kernel inside the cutoff
+    if (kernel == kernelType::lorentzian)
+      d_normalization = 1.0 / (2.0 * M_1_PI * std::atan(c));
+    else if (kernel == kernelType::gaussian)
+      d_normalization = 1.0 / std::erf(c * M_SQRT1_2);
+    else
+      d_normalization = 1.0;
+
+    d_windowIntervals = std::floor(d_cutoff / intervalSize);
+    d_kernelTable.resize(2 * d_windowIntervals + 1);
+    for (int d = -(int)d_windowIntervals; d <= (int)d_windowIntervals; ++d)
+      d_kernelTable[d + d_windowIntervals] = this->kernel(d * intervalSize);
+  }
+
+
+  dosBroadening::kernelType
+  dosBroadening::kernelFromString(const std::string &kernelName)
+  {
+    if (kernelName == "GAUSSIAN")
+      return kernelType::gaussian;
+    else if (kernelName == "METHFESSEL-PAXTON")
+      return kernelType::methfesselPaxton;
+    AssertThrow(kernelName == "LORENTZIAN",
+                dealii::ExcMessage("DFT-FE Error: unknown DOS broadening " +
+                                   kernelName + "."));
+    return kernelType::lorentzian;
+  }
+
+
+  double
+  dosBroadening::lowerBound() const
+  {
+    return d_lowerBound;
+  }
+
+
+  double
+  dosBroadening::intervalSize() const
+  {
+    return d_intervalSize;
+  }
+
+
+  unsigned int
+  dosBroadening::numIntervals() const
+  {
+    return d_numIntervals;
+  }
+
+
+  double
+  dosBroadening::energy(const unsigned int e) const
+  {
+    return d_lowerBound + e * d_intervalSize;
+  }
+
+
+  double
+  dosBroadening::kernel(const double x) const
+  {
+    if (std::fabs(x) > d_cutoff)
+      return 0.0;
+
+    if (d_kernel == kernelType::lorentzian)
+      return d_normalization * M_1_PI * d_width /
+             (x * x + d_width * d_width);
+
+    if (d_kernel == kernelType::gaussian)
+      {
+        const double y = x / d_width;
+        return d_normalization * std::exp(-0.5 * y * y) /
+               (d_width * std::sqrt(2.0 * M_PI));
+      }
+
+    //
+    // Methfessel-Paxton: sum_n A_n H_2n(y) exp(-y^2) / width with
+    // A_n = (-1)^n / (n! 4^n sqrt(pi))
+    //
+    const double y        = x / d_width;
+    double       hermite0 = 1.0, hermite1 = 2.0 * y;
+    double       A        = 1.0 / std::sqrt(M_PI);
+    double       sum      = A;
+    for (unsigned int n = 1; n <= d_methfesselPaxtonOrder; ++n)
+      {
+        // H_{2n-1} -> H_{2n} -> H_{2n+1}
+        const double hermite2 =
+          2.0 * y * hermite1 - 2.0 * (2 * n - 1) * hermite0;
+        const double hermite3 = 2.0 * y * hermite2 - 4.0 * n * hermite1;
+        A *= -1.0 / (4.0 * n);
+        sum += A * hermite2;
+        hermite0 = hermite2;
+        hermite1 = hermite3;
+      }
+    return sum * std::exp(-y * y) / d_width;
+  }
+
+
+  void
+  dosBroadening::accumulate(const std::vector<double> &energyLevels,
+                            const std::vector<double> &levelWeights,
+                            const unsigned int         nRows,
+                            const double               weight,
+                            std::vector<double> &      dos) const
+  {
+    const unsigned int nLevels = energyLevels.size();
+    const unsigned int N       = d_numIntervals;
+    AssertThrow(levelWeights.size() == (std::size_t)nRows * nLevels &&
+                  dos.size() >= (std::size_t)nRows * N,
+                dealii::ExcMessage(
+                  "DFT-FE Error: level weights do not match the energy "
+                  "levels and the DOS grid."));
+    if (nLevels == 0 || N == 0)
+      return;
+
+    const unsigned int W = d_windowIntervals;
+    if (nLevels > N)
+      {
+        //
+        // histogram on the grid extended by the window on both sides,
+        // convolved with the tabulated kernel
+        //
+        std::vector<double> histogram(N + 2 * W + 1);
+        for (unsigned int r = 0; r < nRows; ++r)
+          {
+            std::fill(histogram.begin(), histogram.end(), 0.0);
+            for (unsigned int j = 0; j < nLevels; ++j)
+              {
+                const double p =
+                  (energyLevels[j] - d_lowerBound) / d_intervalSize + W;
+                if (p < 0.0 || p >= N + 2 * W)
+                  continue;
+                const unsigned int i = p;
+                const double       f = p - i;
+                histogram[i] += (1.0 - f) * levelWeights[r * nLevels + j];
+                histogram[i + 1] += f * levelWeights[r * nLevels + j];
+              }
+
+            for (unsigned int e = 0; e < N; ++e)
+              {
+                double value = 0.0;
+                for (unsigned int d = 0; d <= 2 * W; ++d)
+                  value += histogram[e + 2 * W - d] * d_kernelTable[d];
+                dos[r * N + e] += weight * value;
+              }
+          }
+        return;
+      }
+
+    //
+    // every level scatters to the grid points within the cutoff
+    //
+    for (unsigned int j = 0; j < nLevels; ++j)
+      {
+        const double first =
+          std::ceil((energyLevels[j] - d_cutoff - d_lowerBound) /
+                    d_intervalSize);
+        const double last =
+          std::floor((energyLevels[j] + d_cutoff - d_lowerBound) /
+                     d_intervalSize);
+        if (last < 0.0 || first > N - 1.0)
+          continue;
+        const unsigned int eBegin = std::max(first, 0.0);
+        const unsigned int eEnd   = std::min(last, N - 1.0) + 1;
+        for (unsigned int e = eBegin; e < eEnd; ++e)
+          {
+            const double K = weight * kernel(energy(e) - energyLevels[j]);
+            for (unsigned int r = 0; r < nRows; ++r)
+              dos[r * N + e] += levelWeights[r * nLevels + j] * K;
+          }
+      }
+  }
+
+
+  void
+  dosBroadening::accumulate(const std::vector<double> &energyLevels,
+                            const double               weight,
+                            std::vector<double> &      dos) const
+  {
+    accumulate(energyLevels,
+               std::vector<double>(energyLevels.size(), 1.0),
+               1,
+               weight,
+               dos);
+  }
+
+
+  std::vector<std::array<unsigned int, 4>>
+  dosBroadening::monkhorstPackTetrahedra(
+    const std::array<unsigned int, 3> &     gridSize,
+    const std::vector<std::vector<double>> &reciprocalLatticeVectors)
+  {
+    //
+    // corner c of a subcell is offset by bit d of c along direction d, the
+    // main diagonals join c and 7 - c
+    //
+    unsigned int diagonalStart = 0;
+    double       shortest      = -1.0;
+    for (unsigned int c = 0; c < 4; ++c)
+      {
+        double length2 = 0.0;
+        for (unsigned int x = 0; x < 3; ++x)
+          {
+            double component = 0.0;
+            for (unsigned int d = 0; d < 3; ++d)
+              {
+                const double sign = ((c >> d) & 1) ? -1.0 : 1.0;
+                component +=
+                  sign * reciprocalLatticeVectors[d][x] / gridSize[d];
+              }
+            length2 += component * component;
+          }
+        if (shortest < 0.0 || length2 < shortest - 1e-12)
+          {
+            shortest      = length2;
+            diagonalStart = c;
+          }
+      }
+
+    // the 6 paths along the edges from one end of the diagonal to the other
+    const unsigned int paths[6][2] = {
+      {1, 2}, {1, 4}, {2, 1}, {2, 4}, {4, 1}, {4, 2}};
+
+    std::vector<std::array<unsigned int, 4>> tetrahedra;
+    tetrahedra.reserve(6 * gridSize[0] * gridSize[1] * gridSize[2]);
+    for (unsigned int i0 = 0; i0 < gridSize[0]; ++i0)
+      for (unsigned int i1 = 0; i1 < gridSize[1]; ++i1)
+        for (unsigned int i2 = 0; i2 < gridSize[2]; ++i2)
+          {
+            unsigned int corners[8];
+            for (unsigned int c = 0; c < 8; ++c)
+              corners[c] =
+                (((i0 + (c & 1)) % gridSize[0]) * gridSize[1] +
+                 (i1 + ((c >> 1) & 1)) % gridSize[1]) *
+                  gridSize[2] +
+                (i2 + ((c >> 2) & 1)) % gridSize[2];
+
+            const unsigned int c0 = diagonalStart;
+            for (unsigned int p = 0; p < 6; ++p)
+              tetrahedra.push_back(
+                {{corners[c0],
+                  corners[c0 ^ paths[p][0]],
+                  corners[c0 ^ (paths[p][0] | paths[p][1])],
+                  corners[c0 ^ 7]}});
+          }
+    return tetrahedra;
+  }
+
+
+  void
+  dosBroadening::accumulateTetrahedra(
+    const std::vector<double> &                     gridEnergies,
+    const unsigned int                              nBands,
+    const std::vector<std::array<unsigned int, 4>> &tetrahedra,
+    const double                                    weight,
+    std::vector<double> &                           dos) const
+  {
+    const unsigned int N = d_numIntervals;
+    AssertThrow(dos.size() >= N,
+                dealii::ExcMessage(
+                  "DFT-FE Error: DOS does not match the energy grid."));
+    if (tetrahedra.empty() || N == 0)
+      return;
+
+    const double tetrahedronWeight =
+      weight / (tetrahedra.size() * d_intervalSize);
+    std::array<double, 4> e;
+    for (const std::array<unsigned int, 4> &tetrahedron : tetrahedra)
+      for (unsigned int band = 0; band < nBands; ++band)
+        {
+          for (unsigned int c = 0; c < 4; ++c)
+            e[c] = gridEnergies[tetrahedron[c] * nBands + band];
+          std::sort(e.begin(), e.end());
+
+          // grid points whose intervals overlap [e_1, e_4]
+          const double first =
+            std::ceil((e[0] - d_lowerBound) / d_intervalSize - 0.5);
+          const double last =
+            std::floor((e[3] - d_lowerBound) / d_intervalSize + 0.5);
+          if (last < 0.0 || first > N - 1.0)
+            continue;
+          const unsigned int eBegin = std::max(first, 0.0);
+          const unsigned int eEnd   = std::min(last, N - 1.0) + 1;
+
+          double statesBelow =
+            tetrahedronStatesBelow(e, energy(eBegin) - 0.5 * d_intervalSize);
+          for (unsigned int g = eBegin; g < eEnd; ++g)
+            {
+              const double statesAbove =
+                tetrahedronStatesBelow(e, energy(g) + 0.5 * d_intervalSize);
+              dos[g] += tetrahedronWeight * (statesAbove - statesBelow);
+              statesBelow = statesAbove;
+            }
+        }
+  }
+
+} // namespace dftfe
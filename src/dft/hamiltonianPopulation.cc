@@ -4,9 +4,19 @@ void
 dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
   const std::vector<std::vector<double>> &eigenValuesInput)
 {
+  populationProfiler profiler(mpi_communicator);
+  TimerOutput::Scope scope(computing_timer,
+                           "hamiltonian population analysis");
+
+  // the pools and band groups repeat the analysis, the first processor of
+  // the first pool and band group writes the files
+  const bool isPopulationWriter =
+    this_mpi_process == 0 &&
+    Utilities::MPI::this_mpi_process(interpoolcomm) == 0 &&
+    Utilities::MPI::this_mpi_process(interBandGroupComm) == 0;
+
   pcout << std::fixed;
   pcout << std::setprecision(8);
-  MPI_Barrier(MPI_COMM_WORLD);
   pcout
     << "Started post-processing DFT results to obtain Bonding information..\n";
 
@@ -182,16 +192,18 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
 
   for (int j = 0; j < atomTypewiseSTOvector.size(); j++)
     {
-      atomTypewiseSTOvector[j].CreatePseudoAtomicOrbitalBasis();
+      createPseudoAtomicOrbitalBasis(atomTypewiseSTOvector[j]);
     }
 
   pcout << "vector of objects constructed!\n";
 
 
 
-  std::ofstream atomWiseAtomicOrbitalInfoFile("atomWiseAtomicOrbitalInfo.txt");
+  std::ofstream atomWiseAtomicOrbitalInfoFile;
+  if (isPopulationWriter)
+    atomWiseAtomicOrbitalInfoFile.open("atomWiseAtomicOrbitalInfo.txt");
 
-  if (!atomWiseAtomicOrbitalInfoFile.is_open())
+  if (isPopulationWriter && !atomWiseAtomicOrbitalInfoFile.is_open())
     {
       std::cerr << "Couldn't open "
                 << "atomWiseAtomicOrbitalInfo.txt"
@@ -245,9 +257,10 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
       // nstart = atomTypetoNstart[ atomicNum ];
       // basisNstart = numOfOrbitalsForShellCount(1, nstart - 1);
 
-      atomWiseAtomicOrbitalInfoFile << atomicNum << " " << tmp2 + 1 << " "
-                                    << tmp3 << " " << atomTypeoritalstart[tmp1]
-                                    << '\n';
+      if (isPopulationWriter)
+        atomWiseAtomicOrbitalInfoFile << atomicNum << " " << tmp2 + 1 << " "
+                                      << tmp3 << " "
+                                      << atomTypeoritalstart[tmp1] << '\n';
 
       for (unsigned int j = tmp2; j < tmp3; ++j)
         {
@@ -277,7 +290,47 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
 
 
 
+  unsigned int numEigenValues =
+    eigenValuesInput[0].size() / (1 + d_dftParamsPtr->spinPolarized);
+  pcout << "Number of Eigenvalues " << numEigenValues << std::endl;
+
+  //
+  // with an energy window the Kohn-Sham orbitals with an eigenvalue of any
+  // spin in the window are used instead of the first
+  // NUMBER OF PROJECTED KS ORBITALS
+  //
+  const bool useEnergyWindow = d_dftParamsPtr->populationEnergyWindowMin <
+                               d_dftParamsPtr->populationEnergyWindowMax;
+  const double windowLower =
+    fermiEnergy + d_dftParamsPtr->populationEnergyWindowMin;
+  const double windowUpper =
+    fermiEnergy + d_dftParamsPtr->populationEnergyWindowMax;
+  unsigned int ksOrbitalStart  = 0;
   unsigned int numOfKSOrbitals = d_dftParamsPtr->NumofKSOrbitalsproj;
+  if (useEnergyWindow)
+    {
+      unsigned int ksOrbitalEnd = 0;
+      ksOrbitalStart            = numEigenValues;
+      for (unsigned int spin = 0; spin < 1 + d_dftParamsPtr->spinPolarized;
+           ++spin)
+        for (unsigned int iEigen = 0; iEigen < numEigenValues; ++iEigen)
+          {
+            const double eigenValue =
+              eigenValuesInput[0][spin * numEigenValues + iEigen];
+            if (eigenValue >= windowLower && eigenValue <= windowUpper)
+              {
+                ksOrbitalStart = std::min(ksOrbitalStart, iEigen);
+                ksOrbitalEnd   = std::max(ksOrbitalEnd, iEigen + 1);
+              }
+          }
+      AssertThrow(
+        ksOrbitalEnd > ksOrbitalStart,
+        dealii::ExcMessage(
+          "DFT-FE Error: no Kohn-Sham eigenvalue in the population energy window."));
+      numOfKSOrbitals = ksOrbitalEnd - ksOrbitalStart;
+      pcout << "Kohn-Sham orbitals in the energy window: " << ksOrbitalStart
+            << " to " << ksOrbitalEnd - 1 << '\n';
+    }
 
 
 
@@ -293,30 +346,27 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
                        (d_dftParamsPtr->spinPolarized == 1 ? 2 : 1));
   pcout << "Size of Occupance vector" << occupationNum.size() << std::endl;
 
-  unsigned int numEigenValues =
-    eigenValuesInput[0].size() / (1 + d_dftParamsPtr->spinPolarized);
-  pcout << "Number of Eigenvalues " << numEigenValues << std::endl;
   for (unsigned int iEigen = 0; iEigen < numOfKSOrbitals; ++iEigen)
     {
       if (d_dftParamsPtr->spinPolarized == 0)
         {
-          occupationNum[iEigen] =
-            dftUtils::getPartialOccupancy(eigenValuesInput[0][iEigen],
-                                          fermiEnergy,
-                                          C_kb,
-                                          d_dftParamsPtr->TVal);
+          occupationNum[iEigen] = dftUtils::getPartialOccupancy(
+            eigenValuesInput[0][ksOrbitalStart + iEigen],
+            fermiEnergy,
+            C_kb,
+            d_dftParamsPtr->TVal);
           // pcout<<occupationNum[iEigen]<<std::endl;
         }
       else
         {
-          occupationNum[iEigen] =
-            dftUtils::getPartialOccupancy(eigenValuesInput[0][iEigen],
-                                          fermiEnergy,
-                                          C_kb,
-                                          d_dftParamsPtr->TVal);
+          occupationNum[iEigen] = dftUtils::getPartialOccupancy(
+            eigenValuesInput[0][ksOrbitalStart + iEigen],
+            fermiEnergy,
+            C_kb,
+            d_dftParamsPtr->TVal);
           occupationNum[iEigen + numOfKSOrbitals] =
             dftUtils::getPartialOccupancy(
-              eigenValuesInput[0][iEigen + numEigenValues],
+              eigenValuesInput[0][ksOrbitalStart + iEigen + numEigenValues],
               fermiEnergy,
               C_kb,
               d_dftParamsPtr->TVal);
@@ -330,7 +380,6 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
   std::vector<IndexSet::size_type> locallyOwnedDOFs;
   locallyOwnedSet.fill_index_vector(locallyOwnedDOFs);
   unsigned int n_dofs = locallyOwnedDOFs.size();
-  MPI_Barrier(MPI_COMM_WORLD);
   // std::cout<<"Processor ID: "<<this_mpi_process<<" has dofs total:
   // "<<n_dofs<<std::endl;
   std::vector<double> scaledOrbitalValues_FEnodes(n_dofs * totalDimOfBasis,
@@ -341,7 +390,7 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
     (n_dofs * numOfKSOrbitals) * (d_dftParamsPtr->spinPolarized ? 1 : 0), 0.0);
   std::vector<double> scaledKSOrbitalValues_FEnodes_spindown(
     (n_dofs * numOfKSOrbitals) * (d_dftParamsPtr->spinPolarized ? 1 : 0), 0.0);
-  if (this_mpi_process == 0)
+  if (isPopulationWriter)
     {
       // and writing the high level basis information
 
@@ -360,8 +409,7 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
       else
         pcout << "couldn't open highLevelBasisInfo.txt file!\n";
     }
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerCreatingMatrices = MPI_Wtime();
+  profiler.enter("Phi and Psi evaluation");
   double r,theta,phi;
   int SumCounter=0;
 
@@ -457,35 +505,32 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
             {
               scaledKSOrbitalValues_FEnodes_spinup[count2 + j] =
                 d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[0][dof * d_numEigenValues + j];
+                d_eigenVectorsFlattenedSTL[0][dof * d_numEigenValues +
+                                           ksOrbitalStart + j];
               // pcout<<"Accessing spin down"<<std::endl;
               scaledKSOrbitalValues_FEnodes_spindown[count2 + j] =
                 d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[1][dof * d_numEigenValues + j];
+                d_eigenVectorsFlattenedSTL[1][dof * d_numEigenValues +
+                                           ksOrbitalStart + j];
             }
           else
             {
               scaledKSOrbitalValues_FEnodes[count2 + j] =
                 d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[0][dof * d_numEigenValues + j];
+                d_eigenVectorsFlattenedSTL[0][dof * d_numEigenValues +
+                                           ksOrbitalStart + j];
             }
         }
     }
 
 
 #endif
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerCreatingMatrices = MPI_Wtime() - timerCreatingMatrices;
-  pcout<<" Creating PHI and PSI matrices: "<<timerCreatingMatrices<<std::endl;
-    MPI_Allreduce(&SumCounter,
-                &SumCounter,
-                1,
-                MPI_INT,
-                MPI_SUM,
-                MPI_COMM_WORLD);  
-  pcout<<"Sum of Counter: "<<SumCounter;
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerScompute = MPI_Wtime();  
+  profiler.leave("Phi and Psi evaluation");
+  MPI_Allreduce(
+    MPI_IN_PLACE, &SumCounter, 1, MPI_INT, MPI_SUM, mpi_communicator);
+  pcout << "Sum of Counter: " << SumCounter << std::endl;
+
+  profiler.enter("S computation");
   auto upperTriaOfSserial =
     selfMatrixTmatrixmul(scaledOrbitalValues_FEnodes, n_dofs, totalDimOfBasis);
   std::vector<double> upperTriaOfS((totalDimOfBasis * (totalDimOfBasis + 1) /
@@ -496,195 +541,206 @@ dftClass<FEOrder, FEOrderElectro>::hamiltonianPopulationCompute(
                 (totalDimOfBasis * (totalDimOfBasis + 1) / 2),
                 MPI_DOUBLE,
                 MPI_SUM,
-                MPI_COMM_WORLD);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerScompute = MPI_Wtime() - timerScompute;
-  pcout<<" Computing S matrix: "<<timerScompute<<std::endl;
-  if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+                mpi_communicator);
+  profiler.leave("S computation");
+  profiler.addFlops("S computation",
+                    populationProfiler::gemmFlops(totalDimOfBasis,
+                                                  totalDimOfBasis,
+                                                  n_dofs));
+  profiler.addBytes("S computation",
+                    populationProfiler::gemmBytes(totalDimOfBasis,
+                                                  totalDimOfBasis,
+                                                  n_dofs));
+  if (isPopulationWriter)
     {
       writeVectorToFile(upperTriaOfS, "overlapMatrix.txt");
-      // printVector(upperTriaOfS);
     }
-   std::vector<double> S(totalDimOfBasis*totalDimOfBasis,0.0);
-   int Scount=0;
-   for(int i = 0; i < totalDimOfBasis; i++)
-   {
-    for (int j=0; j < totalDimOfBasis; j++)
+  std::vector<double> S(totalDimOfBasis * totalDimOfBasis, 0.0);
+  int                 Scount = 0;
+  for (int i = 0; i < totalDimOfBasis; i++)
     {
-      if(j >=i)
-      {
-        S[i*totalDimOfBasis+j] = upperTriaOfS[Scount];
-        S[j*totalDimOfBasis +i] = S[i*totalDimOfBasis+j];
-        Scount++;
-      }
+      for (int j = i; j < totalDimOfBasis; j++)
+        {
+          S[i * totalDimOfBasis + j] = upperTriaOfS[Scount];
+          S[j * totalDimOfBasis + i] = S[i * totalDimOfBasis + j];
+          Scount++;
+        }
     }
-   }
-  std::vector<double> D(totalDimOfBasis,0.0);
-  std::vector<double> U(totalDimOfBasis*totalDimOfBasis,0.0);
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerSdiagonalization = MPI_Wtime();
-  if(this_mpi_process == 0)
-    U = diagonalization(S,totalDimOfBasis,D);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSdiagonalization = MPI_Wtime() - timerSdiagonalization;
-  pcout<<"Diagonalization of S: "<<timerSdiagonalization<<std::endl;
-    MPI_Bcast(
-      &(D[0]), totalDimOfBasis, MPI_DOUBLE, 0, MPI_COMM_WORLD); 
-    MPI_Bcast(
-      &(U[0]), totalDimOfBasis*totalDimOfBasis, MPI_DOUBLE, 0, MPI_COMM_WORLD);       
-
-
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerUStranspose = MPI_Wtime();
-  auto Ut = TransposeMatrix(U,totalDimOfBasis);
-   MPI_Barrier(MPI_COMM_WORLD);
-   timerUStranspose = MPI_Wtime()-timerUStranspose;
-
-
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerSinverse = MPI_Wtime();   
-  auto invS = powerOfMatrix(-1,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSinverse = MPI_Wtime()-timerSinverse;
-  pcout<<" Computing S^-1: "<<timerSinverse<<std::endl;
-
-
-
-
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerSminushalf = MPI_Wtime();
-  auto Sminushalf = powerOfMatrix(-0.5,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSminushalf = MPI_Wtime() - timerSminushalf;
-  
-
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerShalf = MPI_Wtime();
-  auto Shalf = powerOfMatrix(0.5,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerShalf = MPI_Wtime() - timerShalf;  
-  pcout<<" Computing S^0.5: "<<timerShalf<<std::endl;
 
-      MPI_Barrier(MPI_COMM_WORLD);
-
-      const unsigned int N = totalDimOfBasis;
-
-
-double timerHprojnormal,timerSinvHproj,timerHprojScalapack,timerChat2,timerCbar2;
+  std::vector<double> D(totalDimOfBasis, 0.0);
+  std::vector<double> U(totalDimOfBasis * totalDimOfBasis, 0.0);
+  profiler.enter("S diagonalization");
+  if (this_mpi_process == 0)
+    U = diagonalization(S, totalDimOfBasis, D);
+  MPI_Bcast(&(D[0]), totalDimOfBasis, MPI_DOUBLE, 0, mpi_communicator);
+  MPI_Bcast(&(U[0]),
+            totalDimOfBasis * totalDimOfBasis,
+            MPI_DOUBLE,
+            0,
+            mpi_communicator);
+  profiler.leave("S diagonalization");
+
+  profiler.enter("S powers");
+  auto Ut         = TransposeMatrix(U, totalDimOfBasis);
+  auto Sminushalf = powerOfMatrix(-0.5, D, Ut, totalDimOfBasis, Ut);
+  profiler.leave("S powers");
+  profiler.addFlops("S powers",
+                    populationProfiler::gemmFlops(totalDimOfBasis,
+                                                  totalDimOfBasis,
+                                                  totalDimOfBasis));
+
+  const unsigned int N = totalDimOfBasis;
 
 #ifdef USE_COMPLEX
 
 #else
-      //std::vector<dataTypes::number> CoeffNew(N * N, 0.0);
-       
-      std::vector<dataTypes::number> ProjHam1;
-
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerHprojnormal = MPI_Wtime();  
-      d_kohnShamDFTOperatorPtr->XtHX(scaledOrbitalValues_FEnodes,
-                                     totalDimOfBasis,
-                                     ProjHam1);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerHprojnormal = MPI_Wtime()-timerHprojnormal;
-       pcout<<" Computing H projected: "<<timerHprojnormal<<std::endl;
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerSinvHproj = MPI_Wtime();
-      auto ProjHam2 = matrixmatrixmul(Sminushalf,N,N,ProjHam1,N,N);
-      auto ProjHam = matrixmatrixmul(ProjHam2,N,N,Sminushalf,N,N);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerSinvHproj = MPI_Wtime()-timerSinvHproj;
-      pcout<<" Compute Sinv Hproj: "<<timerSinvHproj<<std::endl;
-      const unsigned int rowsBlockSize = d_elpaScala->getScalapackBlockSize();
-      std::shared_ptr<const dftfe::ProcessGrid> processGrid =
-        d_elpaScala->getProcessGridDftfeScalaWrapper();
-      dftfe::ScaLAPACKMatrix<dataTypes::number> projHamPar(totalDimOfBasis,
-                                                           processGrid,
-                                                           rowsBlockSize);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerHprojScalapack = MPI_Wtime();
-      d_kohnShamDFTOperatorPtr->XtHX(scaledOrbitalValues_FEnodes,
-                                     totalDimOfBasis,
-                                     processGrid,
-                                     projHamPar);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerHprojScalapack =MPI_Wtime()-timerHprojScalapack;
-      pcout<<" Compute H projected SCALAPACK: "<<timerHprojScalapack<<std::endl;
+  std::vector<dataTypes::number> ProjHam1;
+
+  profiler.enter("Hproj computation");
+  d_kohnShamDFTOperatorPtr->XtHX(scaledOrbitalValues_FEnodes,
+                                 totalDimOfBasis,
+                                 ProjHam1);
+  profiler.leave("Hproj computation");
+  profiler.addFlops("Hproj computation",
+                    populationProfiler::gemmFlops(N, N, n_dofs));
+
+  profiler.enter("S^-1/2 Hproj S^-1/2");
+  auto ProjHam2 = matrixmatrixmul(Sminushalf, N, N, ProjHam1, N, N);
+  auto ProjHam  = matrixmatrixmul(ProjHam2, N, N, Sminushalf, N, N);
+  profiler.leave("S^-1/2 Hproj S^-1/2");
+  profiler.addFlops("S^-1/2 Hproj S^-1/2",
+                    2 * populationProfiler::gemmFlops(N, N, N));
+
+  const unsigned int rowsBlockSize = d_elpaScala->getScalapackBlockSize();
+  std::shared_ptr<const dftfe::ProcessGrid> processGrid =
+    d_elpaScala->getProcessGridDftfeScalaWrapper();
+  dftfe::ScaLAPACKMatrix<dataTypes::number> projHamPar(totalDimOfBasis,
+                                                       processGrid,
+                                                       rowsBlockSize);
+  profiler.enter("Hproj computation ScaLAPACK");
+  d_kohnShamDFTOperatorPtr->XtHX(scaledOrbitalValues_FEnodes,
+                                 totalDimOfBasis,
+                                 processGrid,
+                                 projHamPar);
+  profiler.leave("Hproj computation ScaLAPACK");
+  profiler.addFlops("Hproj computation ScaLAPACK",
+                    populationProfiler::gemmFlops(N, N, n_dofs));
+
+  if (isPopulationWriter)
+    {
+      writeVectorAs2DMatrix(ProjHam,
+                            totalDimOfBasis,
+                            totalDimOfBasis,
+                            "ProjectedHamilton.txt");
+    }
 
-      if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+  if (useEnergyWindow)
+    {
+      //
+      // only the eigenpairs of the projected Hamiltonian in the energy
+      // window, from the subset eigensolver on the process grid of the
+      // Rayleigh-Ritz step. The eigenvectors are gathered rowwise (one
+      // eigenvector per row) as the ones of the full diagonalization.
+      //
+      profiler.enter("Hproj partial diagonalization");
+      dftfe::ScaLAPACKMatrix<double> projHamWindow(N,
+                                                   processGrid,
+                                                   rowsBlockSize);
+      std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+      std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
+      linearAlgebraOperations::internal::createGlobalToLocalIdMapsScaLAPACKMat(
+        processGrid,
+        projHamWindow,
+        globalToLocalRowIdMap,
+        globalToLocalColumnIdMap);
+      for (const auto &row : globalToLocalRowIdMap)
+        for (const auto &column : globalToLocalColumnIdMap)
+          projHamWindow.local_el(row.second, column.second) =
+            ProjHam[row.first * N + column.first];
+
+      const std::vector<double> projEnergy =
+        projHamWindow.eigenpairs_hermitian_by_value(
+          std::make_pair(windowLower, windowUpper), true);
+      const unsigned int numWindowStates = projEnergy.size();
+
+      std::vector<double> CoeffNew(numWindowStates * N, 0.0);
+      for (const auto &row : globalToLocalRowIdMap)
+        for (const auto &column : globalToLocalColumnIdMap)
+          if (column.first < numWindowStates)
+            CoeffNew[column.first * N + row.first] =
+              projHamWindow.local_el(row.second, column.second);
+      MPI_Allreduce(MPI_IN_PLACE,
+                    CoeffNew.data(),
+                    CoeffNew.size(),
+                    MPI_DOUBLE,
+                    MPI_SUM,
+                    mpi_communicator);
+      profiler.leave("Hproj partial diagonalization");
+      pcout << "Projected Hamiltonian eigenpairs in the energy window: "
+            << numWindowStates << '\n';
+
+      if (isPopulationWriter)
         {
-          writeVectorAs2DMatrix(ProjHam,
-                                totalDimOfBasis,
+          writeVectorToFile(projEnergy, "FePHP_v2_energies.txt");
+          writeVectorAs2DMatrix(CoeffNew,
+                                numWindowStates,
                                 totalDimOfBasis,
-                                "ProjectedHamilton.txt");
-          // printVector(ProjHam);
-          pcout << std::endl;
+                                "FePHP_v2.txt");
         }
-      
-	std::vector<double> projEnergy(N,0.0);
-	std::vector<double> CoeffNew(N*N,0.0);
-	MPI_Barrier(MPI_COMM_WORLD);
-  timerChat2 = MPI_Wtime();
-       if(this_mpi_process == 0)
-        CoeffNew = diagonalization(ProjHam,N,projEnergy);
-        MPI_Barrier(MPI_COMM_WORLD);
-      timerChat2 = MPI_Wtime() - timerChat2;    
-      pcout<<" Computing Chat (Diagonlaization of Hp): "<<timerChat2<<std::endl;
-     MPI_Bcast(
-      &(projEnergy[0]), N, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-    MPI_Bcast(
-      &(CoeffNew[0]), N*N, MPI_DOUBLE, 0, MPI_COMM_WORLD);     
-	//MPI_Barrier(MPI_COMM_WORLD);
-    //  timerChat2 = MPI_Wtime() - timerChat2;
+
+      profiler.enter("C_bar computation");
+      auto C_bar2 = matrixmatrixTmul(Sminushalf,
+                                     totalDimOfBasis,
+                                     totalDimOfBasis,
+                                     CoeffNew,
+                                     numWindowStates,
+                                     totalDimOfBasis);
+      profiler.leave("C_bar computation");
+      profiler.addFlops("C_bar computation",
+                        populationProfiler::gemmFlops(N, numWindowStates, N));
+      if (isPopulationWriter)
+        writeVectorAs2DMatrix(C_bar2,
+                              totalDimOfBasis,
+                              numWindowStates,
+                              "FePOP_v2.txt");
+    }
+  else
+    {
+      std::vector<double> projEnergy(N, 0.0);
+      std::vector<double> CoeffNew(N * N, 0.0);
+      profiler.enter("Hproj diagonalization");
       if (this_mpi_process == 0)
+        CoeffNew = diagonalization(ProjHam, N, projEnergy);
+      MPI_Bcast(&(projEnergy[0]), N, MPI_DOUBLE, 0, mpi_communicator);
+      MPI_Bcast(&(CoeffNew[0]), N * N, MPI_DOUBLE, 0, mpi_communicator);
+      profiler.leave("Hproj diagonalization");
+      if (isPopulationWriter)
         writeVectorAs2DMatrix(CoeffNew,
                               totalDimOfBasis,
                               totalDimOfBasis,
                               "FePHP_v2.txt");
-      
-     
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerCbar2 = MPI_Wtime();
+
+      profiler.enter("C_bar computation");
       auto C_bar2 = matrixmatrixTmul(Sminushalf,
                                      totalDimOfBasis,
                                      totalDimOfBasis,
                                      CoeffNew,
                                      totalDimOfBasis,
                                      numOfKSOrbitals);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerCbar2 = MPI_Wtime()- timerCbar2;     
-      pcout<<" Computing Cbar: "<<timerCbar2<<std::endl;
-      if (this_mpi_process == 0)
+      profiler.leave("C_bar computation");
+      profiler.addFlops("C_bar computation",
+                        populationProfiler::gemmFlops(N, numOfKSOrbitals, N));
+      if (isPopulationWriter)
         {
           writeVectorAs2DMatrix(C_bar2,
                                 totalDimOfBasis,
                                 numOfKSOrbitals,
                                 "FePOP_v2.txt");
-          pcout << std::endl;
         }
+    }
 #endif
 
-
-  pcout<<std::endl;
-   pcout<<"----------------------------------------------------------"<<std::endl;
-  pcout<<"------------------- NEW METHOD ----------------------------"<<std::endl;
-  pcout<<" Creating PHI and PSI matrices: "<<timerCreatingMatrices<<std::endl;
-  pcout<<" Computing S matrix: "<<timerScompute<<std::endl;
-  pcout<<"Diagonalization of S: "<<timerSdiagonalization<<std::endl; 
-  pcout<<"Computing S^-0.5: "<<timerSminushalf<<std::endl;
-  pcout<<" Computing H projected: "<<timerHprojnormal<<std::endl;
-  pcout<<" Compute H projected SCALAPACK: "<<timerHprojScalapack<<std::endl;
-  pcout<<" Compute Sinv Hproj: "<<timerSinvHproj<<std::endl;
-  pcout<<" Computing Chat (Diagonlaization of Hp): "<<timerChat2<<std::endl;
-  pcout<<" Computing Cbar: "<<timerCbar2<<std::endl;
-  pcout<<" Compute U transpose: "<<timerUStranspose<<std::endl ;
-  pcout<<" TOTAL TIME in sec: "<<timerScompute+timerSdiagonalization+timerHprojnormal+timerSinvHproj+
-  timerCbar2+timerSminushalf+timerChat2<<std::endl;
-  pcout<<" TOTAL TIME in sec: "<<timerScompute+timerSdiagonalization+timerHprojScalapack+timerSinvHproj+
-  timerCbar2+timerSminushalf+timerChat2<<std::endl;
-
-	
-
-
-  
-    
+  if (Utilities::MPI::this_mpi_process(interpoolcomm) == 0 &&
+      Utilities::MPI::this_mpi_process(interBandGroupComm) == 0)
+    profiler.writeReport("hamiltonianPopulationProfile.json", pcout);
 }
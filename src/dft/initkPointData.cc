@@ -168,6 +168,7 @@ dftClass<FEOrder, FEOrderElectro>::readkPointData()
   dftUtils::readFile(numberColumnskPointDataFile, kPointData, kPointRuleFile);
   d_kPointCoordinates.clear();
   d_kPointWeights.clear();
+  d_mpGridIrreducibleKPoints.clear();
   unsigned int maxkPoints = kPointData.size();
   d_kPointCoordinates.resize(maxkPoints * 3, 0.0);
   d_kPointWeights.resize(maxkPoints, 0.0);
@@ -396,6 +397,9 @@ dftClass<FEOrder, FEOrderElectro>::generateMPGrid()
         }
       d_kPointWeights[i] = 1.0 / maxkPoints;
     }
+  d_mpGridIrreducibleKPoints.resize(maxkPoints);
+  for (unsigned int i = 0; i < maxkPoints; ++i)
+    d_mpGridIrreducibleKPoints[i] = i;
   //
   const std::array<unsigned int, 3> periodic = {d_dftParamsPtr->periodicX,
                                                 d_dftParamsPtr->periodicY,
@@ -567,7 +571,8 @@ dftClass<FEOrder, FEOrderElectro>::generateMPGrid()
           for (unsigned int d = 0; d < 3; ++d)
             kPointReducedCoordinates[3 * maxkPoints + d] =
               kPointAllCoordinates[3 * ik + d];
-          maxkPoints = maxkPoints + 1;
+          d_mpGridIrreducibleKPoints[ik] = maxkPoints;
+          maxkPoints                     = maxkPoints + 1;
           //
           for (unsigned int iSymm = 1; iSymm < symmetryPtr->numSymm;
                ++iSymm) // iSymm begins from 1. because identity is always
@@ -618,7 +623,8 @@ dftClass<FEOrder, FEOrderElectro>::generateMPGrid()
                 {
                   d_kPointWeights[maxkPoints - 1] =
                     d_kPointWeights[maxkPoints - 1] + 1.0 / nk;
-                  discard[jk] = 1;
+                  discard[jk]                    = 1;
+                  d_mpGridIrreducibleKPoints[jk] = maxkPoints - 1;
                   if (countedSymm[iSymm] == 0)
                     {
                       usedSymmNum[iSymm]               = usedSymm;
@@ -18,109 +18,219 @@
 //
 
 
-// compute localization lengths currently implemented for spin unpolarized case
+// compute localization lengths of all bands of all k-points and spins
 template <unsigned int FEOrder, unsigned int FEOrderElectro>
 void
 dftClass<FEOrder, FEOrderElectro>::compute_localizationLength(
   const std::string &locLengthFileName)
 {
-  QGauss<3>           quadrature_formula(C_num1DQuad<FEOrder>());
-  FEValues<3>         fe_values(dofHandler.get_fe(),
+  kohnShamDFTOperatorClass<FEOrder, FEOrderElectro> &kohnShamDFTEigenOperator =
+    *d_kohnShamDFTOperatorPtr;
+
+  const Quadrature<3> &quadrature_formula =
+    matrix_free_data.get_quadrature(d_densityQuadratureId);
+  FEValues<3>        fe_values(dofHandler.get_fe(),
                         quadrature_formula,
-                        update_values | update_JxW_values |
-                          update_quadrature_points);
-  const unsigned int  dofs_per_cell = dofHandler.get_fe().dofs_per_cell;
-  const unsigned int  n_q_points    = quadrature_formula.size();
-  std::vector<double> tempQuadPointValues(n_q_points);
-  std::vector<double> localizationLength, secondMoment, firstMomentX,
-    firstMomentY, firstMomentZ;
-
-  localizationLength.resize(d_numEigenValues);
-  secondMoment.resize(d_numEigenValues);
-  firstMomentX.resize(d_numEigenValues);
-  firstMomentY.resize(d_numEigenValues);
-  firstMomentZ.resize(d_numEigenValues);
-
-  std::vector<distributedCPUVec<double>> tempVec(1);
-  tempVec[0].reinit(d_tempEigenVec);
+                        update_JxW_values | update_quadrature_points);
+  const unsigned int numQuadPoints = quadrature_formula.size();
+  const unsigned int numNodesPerElement =
+    matrix_free_data.get_dofs_per_cell(d_densityDofHandlerIndex);
+  const unsigned int totalLocallyOwnedCells =
+    matrix_free_data.n_physical_cells();
+  const unsigned int numLocalDofs =
+    d_eigenVectorsFlattenedSTL[0].size() / d_numEigenValues;
+  const unsigned int numSpins       = 1 + d_dftParamsPtr->spinPolarized;
+  const unsigned int numKPointSpins = numSpins * d_kPointWeights.size();
+  const unsigned int numMoments     = 4;
 
   //
-  // compute integral(psi_i*(x^2 + y^2 + z^2)*psi_i), integral(psi_i*x*psi_i),
-  // integral(psi_i*y*psi_i), integral(psi_i*z*psi_i)
+  // JxW times (x^2 + y^2 + z^2), x, y and z at the quadrature points of every
+  // cell (numQuadPoints x numMoments stored columnwise), in the cell order of
+  // the density calculator
   //
-  for (unsigned int iWave = 0; iWave < d_numEigenValues; ++iWave)
-    {
-      vectorTools::copyFlattenedSTLVecToSingleCompVec(
-        d_eigenVectorsFlattenedSTL[0],
-        d_numEigenValues,
-        std::make_pair(iWave, iWave + 1),
-        tempVec);
-
-      constraintsNoneEigenDataInfo.distribute(tempVec[0]);
-
-      typename DoFHandler<3>::active_cell_iterator cellN =
-                                                     dofHandler.begin_active(),
-                                                   endcN = dofHandler.end();
+  std::vector<double> cellMomentWeights(totalLocallyOwnedCells * numMoments *
+                                          numQuadPoints,
+                                        0.0);
+  typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(),
+                                               endc = dofHandler.end();
+  unsigned int                                 iElem = 0;
+  for (; cell != endc; ++cell)
+    if (cell->is_locally_owned())
+      {
+        fe_values.reinit(cell);
+        double *momentWeights =
+          &cellMomentWeights[iElem * numMoments * numQuadPoints];
+        for (unsigned int q_point = 0; q_point < numQuadPoints; ++q_point)
+          {
+            const Point<3> &quadPointCoor = fe_values.quadrature_point(q_point);
+            const double    JxW           = fe_values.JxW(q_point);
+            momentWeights[q_point] = quadPointCoor.norm_square() * JxW;
+            for (unsigned int d = 0; d < 3; ++d)
+              momentWeights[(d + 1) * numQuadPoints + q_point] =
+                quadPointCoor[d] * JxW;
+          }
+        ++iElem;
+      }
+
+  std::vector<dataTypes::number> shapeFunctionValues(numQuadPoints *
+                                                     numNodesPerElement);
+  for (unsigned int i = 0; i < numQuadPoints * numNodesPerElement; ++i)
+    shapeFunctionValues[i] = dataTypes::number(
+      kohnShamDFTEigenOperator.getShapeFunctionValuesDensityGaussQuad()[i]);
+
+  // band group parallelization data structures
+  const unsigned int bandGroupTaskId =
+    dealii::Utilities::MPI::this_mpi_process(interBandGroupComm);
+  std::vector<unsigned int> bandGroupLowHighPlusOneIndices;
+  dftUtils::createBandParallelizationIndices(interBandGroupComm,
+                                             d_numEigenValues,
+                                             bandGroupLowHighPlusOneIndices);
+  const unsigned int BVec = std::min(d_dftParamsPtr->chebyWfcBlockSize,
+                                     bandGroupLowHighPlusOneIndices[1]);
 
-      for (; cellN != endcN; ++cellN)
+  //
+  // integral(psi_i*(x^2 + y^2 + z^2)*psi_i), integral(psi_i*x*psi_i),
+  // integral(psi_i*y*psi_i) and integral(psi_i*z*psi_i) of all bands of the
+  // global k-points, [((lowerBoundKindex + kPoint) * numSpins + spin) *
+  // numMoments + moment] * d_numEigenValues + iWave. A block of bands is
+  // interpolated to the quadrature points of a cell with one GEMM and its
+  // moments follow from a second GEMM with the moment weights of the cell,
+  // so that every block needs one pass over the cells.
+  //
+  const unsigned int numKPointsGlobal =
+    Utilities::MPI::sum((unsigned int)d_kPointWeights.size(), interpoolcomm);
+  std::vector<double> moments(numKPointsGlobal * numSpins * numMoments *
+                                d_numEigenValues,
+                              0.0);
+
+  distributedCPUVec<dataTypes::number> flattenedArrayBlock;
+  std::vector<dataTypes::number>       cellWaveFunctionMatrix(
+    numNodesPerElement * BVec);
+  std::vector<dataTypes::number> wfcQuads(numQuadPoints * BVec);
+  std::vector<double>            densityQuads(numQuadPoints * BVec);
+  std::vector<double>            blockMoments(numMoments * BVec);
+
+  for (unsigned int jvec = 0; jvec < d_numEigenValues; jvec += BVec)
+    {
+      const unsigned int currentBlockSize =
+        std::min(BVec, d_numEigenValues - jvec);
+
+      if (currentBlockSize != BVec || jvec == 0)
+        kohnShamDFTEigenOperator.reinit(currentBlockSize,
+                                        flattenedArrayBlock,
+                                        true);
+
+      if ((jvec + currentBlockSize) >
+            bandGroupLowHighPlusOneIndices[2 * bandGroupTaskId + 1] ||
+          (jvec + currentBlockSize) <=
+            bandGroupLowHighPlusOneIndices[2 * bandGroupTaskId])
+        continue;
+
+      for (unsigned int kPointSpin = 0; kPointSpin < numKPointSpins;
+           ++kPointSpin)
         {
-          if (cellN->is_locally_owned())
+          const std::vector<dataTypes::number> &XCurrentKPoint =
+            d_eigenVectorsFlattenedSTL[kPointSpin];
+          for (unsigned int iNode = 0; iNode < numLocalDofs; ++iNode)
+            for (unsigned int iWave = 0; iWave < currentBlockSize; ++iWave)
+              flattenedArrayBlock.local_element(iNode * currentBlockSize +
+                                                iWave) =
+                XCurrentKPoint[iNode * d_numEigenValues + jvec + iWave];
+
+          (kohnShamDFTEigenOperator.getOverloadedConstraintMatrix())
+            ->distribute(flattenedArrayBlock, currentBlockSize);
+
+          std::fill(blockMoments.begin(), blockMoments.end(), 0.0);
+          for (unsigned int icell = 0; icell < totalLocallyOwnedCells; ++icell)
             {
-              fe_values.reinit(cellN);
-              fe_values.get_function_values(tempVec[0], tempQuadPointValues);
-
-              for (unsigned int q_point = 0; q_point < n_q_points; ++q_point)
-                {
-                  Point<3> quadPointCoor = fe_values.quadrature_point(q_point);
-                  double   distanceFromOriginSquare =
-                    quadPointCoor[0] * quadPointCoor[0] +
-                    quadPointCoor[1] * quadPointCoor[1] +
-                    quadPointCoor[2] * quadPointCoor[2];
-                  secondMoment[iWave] += tempQuadPointValues[q_point] *
-                                         tempQuadPointValues[q_point] *
-                                         distanceFromOriginSquare *
-                                         fe_values.JxW(q_point);
-                  firstMomentX[iWave] += tempQuadPointValues[q_point] *
-                                         tempQuadPointValues[q_point] *
-                                         quadPointCoor[0] *
-                                         fe_values.JxW(q_point);
-                  firstMomentY[iWave] += tempQuadPointValues[q_point] *
-                                         tempQuadPointValues[q_point] *
-                                         quadPointCoor[1] *
-                                         fe_values.JxW(q_point);
-                  firstMomentZ[iWave] += tempQuadPointValues[q_point] *
-                                         tempQuadPointValues[q_point] *
-                                         quadPointCoor[2] *
-                                         fe_values.JxW(q_point);
-                }
+              const unsigned int inc = 1;
+              for (unsigned int iNode = 0; iNode < numNodesPerElement; ++iNode)
+                xcopy(&currentBlockSize,
+                      flattenedArrayBlock.begin() +
+                        kohnShamDFTEigenOperator
+                          .getFlattenedArrayCellLocalProcIndexIdMap()
+                            [icell * numNodesPerElement + iNode],
+                      &inc,
+                      &cellWaveFunctionMatrix[currentBlockSize * iNode],
+                      &inc);
+
+              const dataTypes::number scalarCoeffAlpha =
+                                        dataTypes::number(1.0),
+                                      scalarCoeffBeta = dataTypes::number(0.0);
+              const char transA = 'N', transB = 'N';
+              xgemm(&transA,
+                    &transB,
+                    &currentBlockSize,
+                    &numQuadPoints,
+                    &numNodesPerElement,
+                    &scalarCoeffAlpha,
+                    &cellWaveFunctionMatrix[0],
+                    &currentBlockSize,
+                    &shapeFunctionValues[0],
+                    &numNodesPerElement,
+                    &scalarCoeffBeta,
+                    &wfcQuads[0],
+                    &currentBlockSize);
+
+              for (unsigned int i = 0; i < numQuadPoints * currentBlockSize;
+                   ++i)
+                densityQuads[i] = std::abs(wfcQuads[i]) * std::abs(wfcQuads[i]);
+
+              const double one = 1.0;
+              xgemm(&transA,
+                    &transB,
+                    &currentBlockSize,
+                    &numMoments,
+                    &numQuadPoints,
+                    &one,
+                    &densityQuads[0],
+                    &currentBlockSize,
+                    &cellMomentWeights[icell * numMoments * numQuadPoints],
+                    &numQuadPoints,
+                    &one,
+                    &blockMoments[0],
+                    &currentBlockSize);
             }
+
+          const unsigned int kPointSpinGlobal =
+            lowerBoundKindex * numSpins + kPointSpin;
+          for (unsigned int moment = 0; moment < numMoments; ++moment)
+            for (unsigned int iWave = 0; iWave < currentBlockSize; ++iWave)
+              moments[(kPointSpinGlobal * numMoments + moment) *
+                        d_numEigenValues +
+                      jvec + iWave] =
+                blockMoments[moment * currentBlockSize + iWave];
         }
     }
 
-  dealii::Utilities::MPI::sum(secondMoment, mpi_communicator, secondMoment);
-
-
-  dealii::Utilities::MPI::sum(firstMomentX, mpi_communicator, firstMomentX);
-
-
-  dealii::Utilities::MPI::sum(firstMomentY, mpi_communicator, firstMomentY);
-
-  dealii::Utilities::MPI::sum(firstMomentZ, mpi_communicator, firstMomentZ);
+  dealii::Utilities::MPI::sum(moments, mpi_communicator, moments);
+  dealii::Utilities::MPI::sum(moments, interBandGroupComm, moments);
+  dealii::Utilities::MPI::sum(moments, interpoolcomm, moments);
 
   //
   // compute localization length using above computed integrals
   //
-  for (unsigned int iWave = 0; iWave < d_numEigenValues; ++iWave)
+  std::vector<double> localizationLength(numKPointsGlobal * numSpins *
+                                         d_numEigenValues);
+  for (unsigned int kPointSpin = 0; kPointSpin < numKPointsGlobal * numSpins;
+       ++kPointSpin)
     {
-      localizationLength[iWave] =
-        2.0 * std::sqrt(secondMoment[iWave] -
-                        (firstMomentX[iWave] * firstMomentX[iWave] +
-                         firstMomentY[iWave] * firstMomentY[iWave] +
-                         firstMomentZ[iWave] * firstMomentZ[iWave]));
+      const double *secondMoment =
+        &moments[kPointSpin * numMoments * d_numEigenValues];
+      const double *firstMomentX = secondMoment + d_numEigenValues;
+      const double *firstMomentY = firstMomentX + d_numEigenValues;
+      const double *firstMomentZ = firstMomentY + d_numEigenValues;
+      for (unsigned int iWave = 0; iWave < d_numEigenValues; ++iWave)
+        localizationLength[kPointSpin * d_numEigenValues + iWave] =
+          2.0 * std::sqrt(secondMoment[iWave] -
+                          (firstMomentX[iWave] * firstMomentX[iWave] +
+                           firstMomentY[iWave] * firstMomentY[iWave] +
+                           firstMomentZ[iWave] * firstMomentZ[iWave]));
     }
 
   //
-  // output the localization lengths in a file
+  // output the localization lengths in a file, one column per k-point and
+  // spin
   //
   if (dealii::Utilities::MPI::this_mpi_process(d_mpiCommParent) == 0)
     {
@@ -131,8 +241,14 @@ dftClass<FEOrder, FEOrderElectro>::compute_localizationLength(
         {
           for (unsigned int iWave = 0; iWave < d_numEigenValues; ++iWave)
             {
-              outFile << std::setprecision(18) << iWave << " "
-                      << localizationLength[iWave] << std::endl;
+              outFile << std::setprecision(18) << iWave;
+              for (unsigned int kPointSpin = 0;
+                   kPointSpin < numKPointsGlobal * numSpins;
+                   ++kPointSpin)
+                outFile
+                  << " "
+                  << localizationLength[kPointSpin * d_numEigenValues + iWave];
+              outFile << std::endl;
             }
         }
     }
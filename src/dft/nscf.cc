@@ -160,6 +160,10 @@ dftClass<FEOrder, FEOrderElectro>::nscf(
 {
   std::vector<double> residualNormWaveFunctions;
   residualNormWaveFunctions.resize(d_numEigenValues);
+
+  // the binary band file receives every k-point as soon as it is converged
+  if (d_dftParamsPtr->bandsFileFormat == "BINARY")
+    openBandFile();
   //
   // if the residual norm is greater than adaptiveChebysevFilterPassesTol (a
   // heuristic value)
@@ -200,6 +204,9 @@ dftClass<FEOrder, FEOrderElectro>::nscf(
           count++;
         }
       computing_timer.leave_subsection("nscf: kohnShamEigenSpaceCompute");
+
+      if (d_bandFileWriter)
+        writeBandFileKPoints(kPoint, 1);
     }
 
   // writeBands() ;
@@ -213,285 +213,812 @@ dftClass<FEOrder, FEOrderElectro>::newRhoSpillFactorspin(
           sqrt(Utilities::MPI::sum(Denominator, mpi_communicator)));
 }
 template <unsigned int FEOrder, unsigned int FEOrderElectro>
-void
-dftClass<FEOrder, FEOrderElectro>::orbitalPopulationCompute(
-  const std::vector<std::vector<double>> &eigenValuesInput, unsigned int kpoint)
+int
+dftClass<FEOrder, FEOrderElectro>::evaluateAtomicOrbitalsAtNodes(
+  const std::vector<LocalAtomicBasisInfo> &basisInfo,
+  std::vector<AtomicOrbitalBasisManager> & atomTypewiseSTOvector,
+  const std::vector<IndexSet::size_type> & locallyOwnedDOFs,
+  const unsigned int                       kpoint,
+  std::vector<dataTypes::number> &         orbitalValues,
+  const populationNeighborList *           neighborList)
 {
-  
-  double timerUOtranspose,timerUStranspose,timerHprojOrbital,timerChatcompute,
-    timerShalf,timerCbarcompute,timerOminushalf,timerOdiagnolaization,timerOcompute,
-    timerCcompute,timerSinverse,timerSdiagonalization,timerPhiTPsi,timerScompute;
-  pcout << std::fixed;
-  pcout << std::setprecision(8);
-  MPI_Barrier(MPI_COMM_WORLD);
-  pcout
-    << "Started post-processing DFT results to obtain Bonding information..\n";
+  const unsigned int numOfAtoms = atomLocations.size();
+  const unsigned int n_dofs     = locallyOwnedDOFs.size();
 
-  // would it be good to replace (unsigned) int with (unsigned) short int?
-  // would it be better to replace unsigned short int with uint16_t?
+  // the nodes weighted with the square root of the mass vector, the
+  // constrained nodes do not contribute
+  std::vector<Point<3>> nodes(n_dofs);
+  std::vector<double>   sqrtMass(n_dofs, 0.0);
+  for (unsigned int dof = 0; dof < n_dofs; ++dof)
+    {
+      nodes[dof] = d_supportPoints[locallyOwnedDOFs[dof]];
+      if (!constraintsNone.is_constrained(locallyOwnedDOFs[dof]))
+        sqrtMass[dof] =
+          d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof);
+    }
 
-  //**************** Forming data structures of atom info ****************//
+  std::vector<std::vector<int>> chargeIdsOfAtoms(numOfAtoms);
+  for (unsigned int iAtom = 0; iAtom < numOfAtoms; ++iAtom)
+    if (neighborList != nullptr)
+      chargeIdsOfAtoms[iAtom] = neighborList->chargeIdsNearNodes(iAtom);
+    else if (d_dftParamsPtr->periodicX || d_dftParamsPtr->periodicY ||
+             d_dftParamsPtr->periodicZ)
+      chargeIdsOfAtoms[iAtom] = d_globalChargeIdToImageIdMap[iAtom];
+    else
+      chargeIdsOfAtoms[iAtom].push_back(iAtom);
+
+  return evaluateAtomicOrbitalsAtPoints(basisInfo,
+                                        atomTypewiseSTOvector,
+                                        nodes,
+                                        sqrtMass,
+                                        kpoint,
+                                        chargeIdsOfAtoms,
+                                        orbitalValues);
+}
 
-  pcout << "reading input files..\n";
 
-  const unsigned int numOfAtoms     = atomLocations.size();
-  const unsigned int numOfAtomTypes = atomTypes.size(); // is not more than 120
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+int
+dftClass<FEOrder, FEOrderElectro>::evaluateAtomicOrbitalsAtPoints(
+  const std::vector<LocalAtomicBasisInfo> &basisInfo,
+  std::vector<AtomicOrbitalBasisManager> & atomTypewiseSTOvector,
+  const std::vector<Point<3>> &            points,
+  const std::vector<double> &              pointWeights,
+  const unsigned int                       kpoint,
+  const std::vector<std::vector<int>> &    chargeIdsOfAtoms,
+  std::vector<dataTypes::number> &         orbitalValues)
+{
+  const unsigned int numOfAtoms  = atomLocations.size();
+  const unsigned int numOfBasis  = basisInfo.size();
+  const unsigned int numOfPoints = points.size();
+  orbitalValues.assign(numOfPoints * numOfBasis, dataTypes::number(0.0));
 
-  // above numOfAtoms and numOfAtomTypes would be taken from DFT-FE run
-  // actually even the contents of the coordinates files would be taken from
-  // DFT-FE run
+  //
+  // the points are processed in blocks so that the radial parts of the Bunge
+  // orbitals are evaluated for a whole block of radii at once
+  //
+  const unsigned int        blockSize = 256;
+  std::vector<unsigned int> blockPoints;
+  std::vector<double>       rBlock(blockSize), thetaBlock(blockSize),
+    phiBlock(blockSize), radialBlock(blockSize);
+  blockPoints.reserve(blockSize);
+
+  int numOfEvaluations = 0;
+  for (unsigned int blockStart = 0; blockStart < numOfPoints;
+       blockStart += blockSize)
+    {
+      blockPoints.clear();
+      for (unsigned int point = blockStart;
+           point < std::min(blockStart + blockSize, numOfPoints);
+           ++point)
+        if (pointWeights[point] != 0.0)
+          blockPoints.push_back(point);
+      const unsigned int numPoints = blockPoints.size();
+      if (numPoints == 0)
+        continue;
+
+      for (unsigned int i = 0; i < numOfBasis; ++i)
+        {
+          const unsigned int atomTypeID   = basisInfo[i].atomTypeID;
+          const unsigned int atomChargeID = basisInfo[i].atomID;
+          AtomicOrbitalBasisManager &atomBasis =
+            atomTypewiseSTOvector[atomTypeID];
 
-  std::vector<unsigned int>
-    atomicNumVec; // vector of atomic numbers of all atoms
-  atomicNumVec.reserve(numOfAtoms);
+          const std::vector<int> &imageIdsList =
+            chargeIdsOfAtoms[atomChargeID];
 
-  // this is not used in the overlap-population-analysis
-  std::vector<unsigned int>
-    valenceElectronsVec; // valence electrons for all atoms
-  valenceElectronsVec.reserve(numOfAtoms);
+          OrbitalQuantumNumbers orbital = {basisInfo[i].n,
+                                           basisInfo[i].l,
+                                           basisInfo[i].m};
 
-  // can have std::array here!
-  // as all the coordinates are of fixed length
-  // std::vector<std::vector<double>> atomCoordinates(0, std::vector<double>(3,
-  // double{})); we could also try a single std::vector, and exxtract
-  // coordinates from it by copying into a std::array or use something like span
-  // (but need C++20)
+          for (unsigned int imageID = 0; imageID < imageIdsList.size();
+               ++imageID)
+            {
+              const int           chargeId = imageIdsList[imageID];
+              std::vector<double> atomPos(3, 0.0);
+              if (chargeId < numOfAtoms)
+                {
+                  atomPos[0] = atomLocations[chargeId][2];
+                  atomPos[1] = atomLocations[chargeId][3];
+                  atomPos[2] = atomLocations[chargeId][4];
+                }
+              else
+                {
+                  atomPos[0] = d_imagePositions[chargeId - numOfAtoms][0];
+                  atomPos[1] = d_imagePositions[chargeId - numOfAtoms][1];
+                  atomPos[2] = d_imagePositions[chargeId - numOfAtoms][2];
+                }
 
-  std::vector<std::array<double, 3>> atomCoordinates(0,
-                                                     std::array<double, 3>{});
-  atomCoordinates.reserve(numOfAtoms);
+              // spherical coordinates of the points
+              for (unsigned int p = 0; p < numPoints; ++p)
+                {
+                  auto relativeEvalPoint =
+                    relativeVector3d(points[blockPoints[p]], atomPos);
+                  convertCartesianToSpherical(relativeEvalPoint,
+                                              rBlock[p],
+                                              thetaBlock[p],
+                                              phiBlock[p]);
+                }
 
-  std::set<unsigned int> atomTypesSet; // only atom types are stored
-  // this is used since they will be repetition of atom types
-  // we assume that the basis required is unique for each atom type
+              if (d_dftParamsPtr->AtomicOrbitalBasis == 1)
+                atomBasis.radialPartOfBungeOrbital(
+                  orbital.n, orbital.l, &rBlock[0], numPoints, &radialBlock[0]);
 
-  unsigned int a, b;
-  double       x, y, z, zeta;
-  unsigned int count = 0;
+#ifdef USE_COMPLEX
+              // Bloch phase of the periodic image
+              const double kdotRm =
+                atomPos[0] * d_kPointCoordinates[kpoint * 3 + 0] +
+                atomPos[1] * d_kPointCoordinates[kpoint * 3 + 1] +
+                atomPos[2] * d_kPointCoordinates[kpoint * 3 + 2];
+              const std::complex<double> phase(std::cos(kdotRm),
+                                               std::sin(kdotRm));
+#endif
+
+              for (unsigned int p = 0; p < numPoints; ++p)
+                {
+                  if (atomBasis.maxRadialcutoff >= 0 &&
+                      rBlock[p] > atomBasis.maxRadialcutoff)
+                    continue;
 
-  std::string coordinatesFile = "coordinates.inp"; // In DFT-FE format
+                  numOfEvaluations++;
+                  const unsigned int point  = blockPoints[p];
+                  const double       weight = pointWeights[point];
+                  if (d_dftParamsPtr->AtomicOrbitalBasis == 1)
+                    orbitalValues[point * numOfBasis + i] +=
+                      weight * radialBlock[p] *
+                      atomBasis.realSphericalHarmonics(orbital.l,
+                                                       orbital.m,
+                                                       thetaBlock[p],
+                                                       phiBlock[p]);
+                  if (d_dftParamsPtr->AtomicOrbitalBasis == 0)
+                    {
+                      const double value =
+                        weight *
+                        atomBasis.PseudoAtomicOrbitalvalue(orbital,
+                                                           points[point],
+                                                           atomPos,
+                                                           rBlock[p],
+                                                           thetaBlock[p],
+                                                           phiBlock[p]);
+#ifdef USE_COMPLEX
+                      orbitalValues[point * numOfBasis + i] += value * phase;
+#else
+                      orbitalValues[point * numOfBasis + i] += value;
+#endif
+                    }
+                }
+            }
+        }
+    }
+
+  return numOfEvaluations;
+}
+
+
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+int
+dftClass<FEOrder, FEOrderElectro>::addPopulationQuadratureCells(
+  const std::vector<dataTypes::number> &              eigenVectorsKS,
+  const unsigned int                                  numOfKSOrbitals,
+  const unsigned int                                  kpoint,
+  cellQuadratureOverlapProjection<dataTypes::number> &projection,
+  populationProfiler &                                profiler)
+{
+  const unsigned int numOfAtoms = atomLocations.size();
+  std::vector<AtomicOrbitalBasisManager> &atomTypewiseSTOvector =
+    d_populationBasisCache.atomTypewiseSTOvector;
+  const std::vector<LocalAtomicBasisInfo> &globalBasisInfo =
+    d_populationBasisCache.globalBasisInfo;
+  const std::vector<unsigned int> &atomwiseGlobalbasisNum =
+    d_populationBasisCache.atomwiseGlobalbasisNum;
+  const bool isComplex =
+    std::is_same<dataTypes::number, std::complex<double>>::value;
+
+  const Quadrature<3> &quadrature =
+    matrix_free_data.get_quadrature(d_densityQuadratureId);
+  FEValues<3>        fe_values(dofHandler.get_fe(),
+                        quadrature,
+                        update_quadrature_points | update_JxW_values);
+  const unsigned int numQuadPoints      = quadrature.size();
+  const unsigned int numNodesPerElement = dofHandler.get_fe().dofs_per_cell;
+
+  //
+  // Kohn-Sham orbitals with the constraints distributed, the values of all
+  // orbitals at a node are contiguous in the flattened array
+  //
+  profiler.enter("Psi evaluation");
+  distributedCPUVec<dataTypes::number> flattenedArray;
+  d_kohnShamDFTOperatorPtr->reinit(numOfKSOrbitals, flattenedArray, true);
+  const unsigned int numLocalDofs = dofHandler.n_locally_owned_dofs();
+  for (unsigned int iNode = 0; iNode < numLocalDofs; ++iNode)
+    for (unsigned int j = 0; j < numOfKSOrbitals; ++j)
+      flattenedArray.local_element(iNode * numOfKSOrbitals + j) =
+        eigenVectorsKS[iNode * d_numEigenValues + j];
+  (d_kohnShamDFTOperatorPtr->getOverloadedConstraintMatrix())
+    ->distribute(flattenedArray, numOfKSOrbitals);
+  const std::vector<dealii::types::global_dof_index> &cellLocalProcIndexIdMap =
+    d_kohnShamDFTOperatorPtr->getFlattenedArrayCellLocalProcIndexIdMap();
+  profiler.leave("Psi evaluation");
+
+  std::vector<typename DoFHandler<3>::active_cell_iterator> cells;
+  typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(),
+                                               endc = dofHandler.end();
+  for (; cell != endc; ++cell)
+    if (cell->is_locally_owned())
+      cells.push_back(cell);
 
-  std::ifstream atomCoordinatesFile(coordinatesFile);
-  if (atomCoordinatesFile.is_open())
+  //
+  // the cells are processed in batches whose nodal and quadrature point
+  // values of the Kohn-Sham orbitals stay in cache, only the atomic orbitals
+  // of the atoms within their radial cutoff of a batch enter its products
+  //
+  const unsigned int cellsPerBatch =
+    cellQuadratureOverlapProjection<dataTypes::number>::cellsPerBatch(
+      numQuadPoints, numNodesPerElement, numOfKSOrbitals, 1 << 20);
+  std::vector<dataTypes::number> cellNodalPsi, quadPointScaling, orbitalValues;
+  std::vector<Point<3>>          quadPoints;
+  std::vector<double>            sqrtJxW;
+  int                            numOfEvaluations = 0;
+  for (unsigned int batchStart = 0; batchStart < cells.size();
+       batchStart += cellsPerBatch)
     {
-      while (atomCoordinatesFile >> a >> b >> x >> y >> z)
+      const unsigned int numCells =
+        std::min<unsigned int>(cellsPerBatch, cells.size() - batchStart);
+      const unsigned int numPoints = numQuadPoints * numCells;
+
+      profiler.enter("Psi evaluation");
+      cellNodalPsi.resize(numNodesPerElement * numCells * numOfKSOrbitals);
+      for (unsigned int iNode = 0; iNode < numNodesPerElement; ++iNode)
+        for (unsigned int iCell = 0; iCell < numCells; ++iCell)
+          {
+            const dataTypes::number *nodalValues =
+              flattenedArray.begin() +
+              cellLocalProcIndexIdMap[(batchStart + iCell) *
+                                        numNodesPerElement +
+                                      iNode];
+            std::copy(nodalValues,
+                      nodalValues + numOfKSOrbitals,
+                      &cellNodalPsi[(iNode * numCells + iCell) *
+                                    numOfKSOrbitals]);
+          }
+
+      quadPoints.resize(numPoints);
+      sqrtJxW.resize(numPoints);
+      quadPointScaling.resize(numPoints);
+      std::array<double, 3> boxLower, boxUpper;
+      boxLower.fill(std::numeric_limits<double>::max());
+      boxUpper.fill(-std::numeric_limits<double>::max());
+      for (unsigned int iCell = 0; iCell < numCells; ++iCell)
         {
-          atomicNumVec.push_back(a); // Atom Number of each globalCharge
-          atomTypesSet.insert(
-            a); // atom type is determined by the Atomic number
-          valenceElectronsVec.push_back(b);
-          atomCoordinates.push_back({x, y, z});
+          fe_values.reinit(cells[batchStart + iCell]);
+          for (unsigned int q = 0; q < numQuadPoints; ++q)
+            {
+              const unsigned int point = q * numCells + iCell;
+              quadPoints[point]        = fe_values.quadrature_point(q);
+              sqrtJxW[point]           = std::sqrt(fe_values.JxW(q));
+#ifdef USE_COMPLEX
+              const double kdotx =
+                d_kPointCoordinates[kpoint * 3 + 0] * quadPoints[point][0] +
+                d_kPointCoordinates[kpoint * 3 + 1] * quadPoints[point][1] +
+                d_kPointCoordinates[kpoint * 3 + 2] * quadPoints[point][2];
+              quadPointScaling[point] =
+                sqrtJxW[point] *
+                std::complex<double>(std::cos(kdotx), std::sin(kdotx));
+#else
+              quadPointScaling[point] = sqrtJxW[point];
+#endif
+              for (unsigned int d = 0; d < 3; ++d)
+                {
+                  boxLower[d] = std::min(boxLower[d], quadPoints[point][d]);
+                  boxUpper[d] = std::max(boxUpper[d], quadPoints[point][d]);
+                }
+            }
+        }
+      profiler.leave("Psi evaluation");
 
-          ++count;
+      profiler.enter("Phi evaluation");
+      std::vector<std::vector<int>>     chargeIdsOfAtoms(numOfAtoms);
+      std::vector<LocalAtomicBasisInfo> batchBasisInfo;
+      std::vector<unsigned int>         basisIds;
+      for (unsigned int iAtom = 0; iAtom < numOfAtoms; ++iAtom)
+        {
+          const double cutoff =
+            atomTypewiseSTOvector[d_populationBasisCache.atomTypeIDs[iAtom]]
+              .maxRadialcutoff;
+          for (const int chargeId :
+               d_populationBasisCache.neighborList.chargeIdsNearNodes(iAtom))
+            {
+              double distanceSquared = 0.0;
+              for (unsigned int d = 0; d < 3; ++d)
+                {
+                  const double x =
+                    chargeId < numOfAtoms ?
+                      atomLocations[chargeId][2 + d] :
+                      d_imagePositions[chargeId - numOfAtoms][d];
+                  const double gap =
+                    std::max(0.0,
+                             std::max(boxLower[d] - x, x - boxUpper[d]));
+                  distanceSquared += gap * gap;
+                }
+              if (cutoff < 0 || distanceSquared <= cutoff * cutoff)
+                chargeIdsOfAtoms[iAtom].push_back(chargeId);
+            }
+          if (chargeIdsOfAtoms[iAtom].empty())
+            continue;
+          for (unsigned int i = atomwiseGlobalbasisNum[iAtom];
+               i < atomwiseGlobalbasisNum[iAtom + 1];
+               ++i)
+            {
+              basisIds.push_back(i);
+              batchBasisInfo.push_back(globalBasisInfo[i]);
+            }
         }
+      numOfEvaluations += evaluateAtomicOrbitalsAtPoints(batchBasisInfo,
+                                                         atomTypewiseSTOvector,
+                                                         quadPoints,
+                                                         sqrtJxW,
+                                                         kpoint,
+                                                         chargeIdsOfAtoms,
+                                                         orbitalValues);
+      profiler.leave("Phi evaluation");
+
+      const unsigned int m = basisIds.size();
+      profiler.enter("S and Phi^T Psi blocks");
+      projection.addCells(
+        cellNodalPsi, quadPointScaling, orbitalValues, basisIds, numCells);
+      profiler.leave("S and Phi^T Psi blocks");
+      profiler.addFlops(
+        "S and Phi^T Psi blocks",
+        populationProfiler::gemmFlops(numQuadPoints,
+                                      numCells * numOfKSOrbitals,
+                                      numNodesPerElement,
+                                      isComplex) +
+          populationProfiler::gemmFlops(m, m, numPoints, isComplex) +
+          populationProfiler::gemmFlops(
+            m, numOfKSOrbitals, numPoints, isComplex));
+      profiler.addBytes(
+        "S and Phi^T Psi blocks",
+        populationProfiler::gemmBytes(numQuadPoints,
+                                      numCells * numOfKSOrbitals,
+                                      numNodesPerElement,
+                                      isComplex) +
+          populationProfiler::gemmBytes(m, m, numPoints, isComplex) +
+          populationProfiler::gemmBytes(
+            m, numOfKSOrbitals, numPoints, isComplex));
     }
 
-  else
+  return numOfEvaluations;
+}
+
+
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::createPseudoAtomicOrbitalBasis(
+  AtomicOrbitalBasisManager &atomBasis)
+{
+  if (!atomBasis.PseudoAtomicOrbital)
+    return;
+  if (!d_dftParamsPtr->populationPspOrbitals)
     {
-      std::cerr << "Couldn't open " << coordinatesFile << " file!!"
-                << std::endl;
-      exit(0);
+      atomBasis.CreatePseudoAtomicOrbitalBasis(d_atomicOrbitalRadialTables);
+      return;
     }
 
-  atomCoordinatesFile.close();
+  for (unsigned int i = 0; i < atomBasis.n.size(); ++i)
+    if (atomBasis.m[i] == 0)
+      {
+        const atomicOrbitalRadialTables::radialTable *radial =
+          loadSingleAtomPSIFiles(atomBasis.atomType,
+                                 atomBasis.n[i],
+                                 atomBasis.l[i],
+                                 d_atomicOrbitalRadialTables,
+                                 d_mpiCommParent,
+                                 *d_dftParamsPtr);
+        AssertThrow(radial != nullptr,
+                    ExcMessage(
+                      "DFT-FE Error: no single atom wavefunction for Z = " +
+                      std::to_string(atomBasis.atomType) +
+                      ", n = " + std::to_string(atomBasis.n[i]) +
+                      ", l = " + std::to_string(atomBasis.l[i]) +
+                      " of the population analysis basis."));
+        atomBasis.setRadialTable(atomBasis.n[i], atomBasis.l[i], radial);
+      }
+}
 
-  pcout << "reading " << coordinatesFile << " complete!\n";
 
-  assert(count == numOfAtoms); // we can add an assert message later
-  assert(numOfAtomTypes == atomTypesSet.size());
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+bool
+dftClass<FEOrder, FEOrderElectro>::updatePopulationBasisCache()
+{
+  const unsigned int        numOfAtoms = atomLocations.size();
+  std::vector<unsigned int> atomicNumVec(numOfAtoms);
+  for (unsigned int iAtom = 0; iAtom < numOfAtoms; ++iAtom)
+    atomicNumVec[iAtom] = (unsigned int)atomLocations[iAtom][0];
+
+  populationBasisCache &cache = d_populationBasisCache;
+  if (!cache.globalBasisInfo.empty() && cache.atomicNumbers == atomicNumVec)
+    return false;
+
+  // atom types ordered by atomic number, the basis objects are indexed by
+  // atomTypeID
+  const std::set<unsigned int>    atomTypesSet(atomicNumVec.begin(),
+                                            atomicNumVec.end());
+  const std::vector<unsigned int> atomTypesVec(atomTypesSet.begin(),
+                                               atomTypesSet.end());
+  std::map<unsigned int, unsigned int> atomTypetoAtomTypeID;
+  for (unsigned int i = 0; i < atomTypesVec.size(); ++i)
+    atomTypetoAtomTypeID[atomTypesVec[i]] = i;
 
-  std::vector<unsigned int> atomTypesVec{
-    atomTypesSet.begin(), atomTypesSet.end()}; // Converting set to vector
+  std::vector<std::vector<int>> atomTypesorbitals;
+  readBasisFile(3, atomTypesorbitals, "BasisInfo.inp");
 
-  // we can delete the atomTypesSet using clear() if needed, later after diff!
+  cache.atomTypewiseSTOvector.clear();
+  for (unsigned int i = 0; i < atomTypesVec.size(); ++i)
+    cache.atomTypewiseSTOvector.push_back(AtomicOrbitalBasisManager(
+      atomTypesVec[i], d_dftParamsPtr->AtomicOrbitalBasis, true));
+
+  // {n, l, m} hierarchy of every atom type in the order of BasisInfo.inp
+  cache.atomTypewiseOrbitalist.clear();
+  cache.atomTypeOrbitalStart.assign(atomTypesVec.size(), 0);
+  std::vector<bool> atomTypeflag(atomTypesVec.size(), false);
+  int               counter = 1;
+  for (unsigned int i = 0; i < atomTypesorbitals.size(); ++i)
+    for (unsigned int j = 0; j < cache.atomTypewiseSTOvector.size(); ++j)
+      {
+        AtomicOrbitalBasisManager &atomBasis = cache.atomTypewiseSTOvector[j];
+        if (atomBasis.atomType != atomTypesorbitals[i][0])
+          continue;
+        if (!atomTypeflag[j])
+          {
+            cache.atomTypeOrbitalStart[j] = counter;
+            atomTypeflag[j]               = true;
+          }
+        const int n = atomTypesorbitals[i][1];
+        const int l = atomTypesorbitals[i][2];
+        for (int m = -l; m <= l; m++)
+          {
+            atomBasis.n.push_back(n);
+            atomBasis.l.push_back(l);
+            atomBasis.m.push_back(m);
+            cache.atomTypewiseOrbitalist.push_back({n, l, m});
+            counter++;
+          }
+      }
 
-  // atomType to atomTypeID for reference to the basis objects vector
-  // observe that atomID and atomTypeID are different
+  for (unsigned int j = 0; j < cache.atomTypewiseSTOvector.size(); ++j)
+    createPseudoAtomicOrbitalBasis(cache.atomTypewiseSTOvector[j]);
 
-  count = 0;
-  std::map<unsigned int, unsigned int>
-    atomTypetoAtomTypeID; // a reverse mapping
-  for (auto i : atomTypesVec)
+  cache.atomTypeIDs.resize(numOfAtoms);
+  cache.atomwiseGlobalbasisNum.assign(1, 0);
+  cache.globalBasisInfo.clear();
+  for (unsigned int i = 0; i < numOfAtoms; ++i)
     {
-      atomTypetoAtomTypeID.insert({i, count});
-      ++count;
+      const unsigned int atomTypeID = atomTypetoAtomTypeID[atomicNumVec[i]];
+      cache.atomTypeIDs[i]          = atomTypeID;
+      AtomicOrbitalBasisManager &atomBasis =
+        cache.atomTypewiseSTOvector[atomTypeID];
+      for (int j = 0; j < atomBasis.sizeofbasis(); ++j)
+        {
+          LocalAtomicBasisInfo temp;
+          temp.atomID     = i;
+          temp.atomTypeID = atomTypeID;
+          temp.n          = atomBasis.n[j];
+          temp.l          = atomBasis.l[j];
+          temp.m          = atomBasis.m[j];
+          cache.globalBasisInfo.push_back(temp);
+        }
+      cache.atomwiseGlobalbasisNum.push_back(cache.globalBasisInfo.size());
     }
+  cache.atomicNumbers = atomicNumVec;
 
-  // extracting the num of basis for each atomType and the corresponding zeta
-  // values
+  if (d_dftParamsPtr->writePopulationFiles && this_mpi_process == 0)
+    {
+      writeOrbitalDataIntoFile(cache.atomTypewiseOrbitalist,
+                               "atomTypeWiseOrbitalNums.txt");
 
-  count = 0;
-  std::map<unsigned int, unsigned int> atomTypetoBasisDim;
-  std::map<unsigned int, unsigned int> atomTypetoNstart;
-  std::map<unsigned int, unsigned int> atomTypetoNend;
-  std::map<unsigned int, double>       atomTypetoZeta;
-  std::set<unsigned int>               atomTypeswithBasisInfo;
-  std::set<unsigned int>
-                                       diff; // to check if the required data is provided or not
-  std::map<unsigned int, unsigned int> atomTypeToBasisInfoStartNum;
+      std::ofstream atomWiseAtomicOrbitalInfoFile(
+        "atomWiseAtomicOrbitalInfo.txt");
+      AssertThrow(atomWiseAtomicOrbitalInfoFile.is_open(),
+                  ExcMessage("DFT-FE Error: couldn't open "
+                             "atomWiseAtomicOrbitalInfo.txt."));
+      for (unsigned int i = 0; i < numOfAtoms; ++i)
+        atomWiseAtomicOrbitalInfoFile
+          << atomicNumVec[i] << " " << cache.atomwiseGlobalbasisNum[i] + 1
+          << " " << cache.atomwiseGlobalbasisNum[i + 1] << " "
+          << cache.atomTypeOrbitalStart[cache.atomTypeIDs[i]]
+          << '\n';
+    }
 
-  unsigned int maxBasisShell = 0; // some lower unreachable value
-  // unsigned int minBasisShell = 10; // some unreachable value
+  return true;
+}
 
-  unsigned int tmpBasisDim, b1, b2;
 
-  // b1 and b2 are the range of principal quantum numbers, ends inclusive
-  // where the slater type basis are constructed based on n, l, m values or each
-  // orbital
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+bool
+dftClass<FEOrder, FEOrderElectro>::updatePopulationNeighborList(
+  const std::vector<Point<3>> &localPoints)
+{
+  const unsigned int numOfAtoms = atomLocations.size();
+  const bool         isPeriodic = d_dftParamsPtr->periodicX ||
+                          d_dftParamsPtr->periodicY ||
+                          d_dftParamsPtr->periodicZ;
+
+  std::vector<std::array<double, 3>> chargePositions;
+  chargePositions.reserve(numOfAtoms + d_imagePositions.size());
+  for (unsigned int iAtom = 0; iAtom < numOfAtoms; ++iAtom)
+    chargePositions.push_back({atomLocations[iAtom][2],
+                               atomLocations[iAtom][3],
+                               atomLocations[iAtom][4]});
+  for (unsigned int iImage = 0; iImage < d_imagePositions.size(); ++iImage)
+    chargePositions.push_back({d_imagePositions[iImage][0],
+                               d_imagePositions[iImage][1],
+                               d_imagePositions[iImage][2]});
+
+  std::vector<std::vector<int>> chargeIdsOfAtoms(numOfAtoms);
+  std::vector<double>           cutoffOfAtoms(numOfAtoms);
+  for (unsigned int iAtom = 0; iAtom < numOfAtoms; ++iAtom)
+    {
+      if (isPeriodic)
+        chargeIdsOfAtoms[iAtom] = d_globalChargeIdToImageIdMap[iAtom];
+      else
+        chargeIdsOfAtoms[iAtom].push_back(iAtom);
+      const unsigned int atomTypeID =
+        d_populationBasisCache.atomTypeIDs[iAtom];
+      cutoffOfAtoms[iAtom] =
+        d_populationBasisCache.atomTypewiseSTOvector[atomTypeID]
+          .maxRadialcutoff;
+    }
 
+  // bounding box of the local points, empty boxes are placed far away so
+  // that no charge is near them
+  std::array<double, 3> boxLower, boxUpper;
+  boxLower.fill(std::numeric_limits<double>::max());
+  boxUpper.fill(-std::numeric_limits<double>::max());
+  for (const Point<3> &point : localPoints)
+    for (unsigned int d = 0; d < 3; ++d)
+      {
+        boxLower[d] = std::min(boxLower[d], point[d]);
+        boxUpper[d] = std::max(boxUpper[d], point[d]);
+      }
+  if (localPoints.empty())
+    {
+      boxLower.fill(1e+10);
+      boxUpper.fill(1e+10);
+    }
 
-  unsigned int basisHierarchyStart, basisHierarchyEnd, basisCount = 1;
+  return d_populationBasisCache.neighborList.update(
+    chargePositions,
+    chargeIdsOfAtoms,
+    cutoffOfAtoms,
+    boxLower,
+    boxUpper,
+    d_dftParamsPtr->populationNeighborSkin);
+}
 
-  std::string basisInfoFile = "BasisInfo.inp";
 
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+bool
+dftClass<FEOrder, FEOrderElectro>::updateAtomSpatialIndex()
+{
+  const unsigned int numOfAtoms = atomLocations.size();
 
+  std::vector<std::array<double, 3>> chargePositions;
+  std::vector<unsigned int>          atomIdsOfCharges;
+  chargePositions.reserve(numOfAtoms + d_imagePositions.size());
+  atomIdsOfCharges.reserve(numOfAtoms + d_imagePositions.size());
+  for (unsigned int iAtom = 0; iAtom < numOfAtoms; ++iAtom)
+    {
+      chargePositions.push_back({atomLocations[iAtom][2],
+                                 atomLocations[iAtom][3],
+                                 atomLocations[iAtom][4]});
+      atomIdsOfCharges.push_back(iAtom);
+    }
+  for (unsigned int iImage = 0; iImage < d_imagePositions.size(); ++iImage)
+    {
+      chargePositions.push_back({d_imagePositions[iImage][0],
+                                 d_imagePositions[iImage][1],
+                                 d_imagePositions[iImage][2]});
+      atomIdsOfCharges.push_back(d_imageIds[iImage]);
+    }
 
-  std::vector<AtomicOrbitalBasisManager> atomTypewiseSTOvector;
-  // atomTypewiseSTOvector.reserve(numOfAtomTypes);
-  int                           atomType;
-  std::vector<std::vector<int>> atomTypesorbitals;
-  readBasisFile(3, atomTypesorbitals, "BasisInfo.inp");
+  return d_atomSpatialIndex.update(chargePositions, atomIdsOfCharges);
+}
 
 
-  for (unsigned int i = 0; i < numOfAtomTypes; ++i)
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::updatePopulationPairSymmetry()
+{
+  const unsigned int numOfAtoms   = atomLocations.size();
+  atomPairSymmetry & pairSymmetry = d_populationBasisCache.pairSymmetry;
+  if (!d_dftParamsPtr->populationPairSymmetry || !d_dftParamsPtr->periodicX ||
+      !d_dftParamsPtr->periodicY || !d_dftParamsPtr->periodicZ ||
+      d_dftParamsPtr->spinPolarized == 1)
     {
-      atomType = atomTypesVec[i];
-      atomTypewiseSTOvector.push_back(AtomicOrbitalBasisManager(
-        atomType, d_dftParamsPtr->AtomicOrbitalBasis, true));
+      pairSymmetry.reinit(numOfAtoms);
+      return;
     }
-  /*** constructQuantumNumbersHierarchy */
-  std::vector<std::vector<int>> atomTypewiseOrbitalist;
-  std::vector<bool>             atomTypeflag(numOfAtomTypes, false);
-  std::vector<int>              atomTypeoritalstart(numOfAtomTypes, 0);
-  int                           counter = 1;
-  for (int i = 0; i < atomTypesorbitals.size(); i++)
+
+  //
+  // space group of the current atoms with the tolerance of the k-point
+  // reduction in initkPointData, the operations of symmetryClass are
+  // restricted to the ones used to reduce the k-points and to the initial
+  // positions. The number of operations is bounded by 48 times the number
+  // of pure translations of the cell.
+  //
+  const int           maxNumOperations = 48 * numOfAtoms;
+  std::vector<int>    rotationData(9 * maxNumOperations);
+  std::vector<double> translationData(3 * maxNumOperations);
+  std::vector<double> positionData(3 * numOfAtoms);
+  std::vector<int>    types(numOfAtoms);
+  double              lattice[3][3];
+  // spglib takes the lattice vectors as columns
+  for (unsigned int i = 0; i < 3; ++i)
+    for (unsigned int j = 0; j < 3; ++j)
+      lattice[j][i] = d_domainBoundingVectors[i][j];
+  std::vector<std::array<double, 3>> fractionalPositions(numOfAtoms);
+  std::vector<unsigned int>          atomicNumbers(numOfAtoms);
+  for (unsigned int iAtom = 0; iAtom < numOfAtoms; ++iAtom)
     {
-      for (int j = 0; j < atomTypewiseSTOvector.size(); j++)
+      atomicNumbers[iAtom] = atomLocationsFractional[iAtom][0];
+      types[iAtom]         = atomicNumbers[iAtom];
+      for (unsigned int d = 0; d < 3; ++d)
         {
-          if (atomTypewiseSTOvector[j].atomType == atomTypesorbitals[i][0])
-            {
-              if (atomTypeflag[j] == false)
-                {
-                  atomTypeoritalstart[j] = counter;
-                  atomTypeflag[j]        = true;
-                }
-              int n, l, m;
-              n = atomTypesorbitals[i][1];
-              l = atomTypesorbitals[i][2];
-
-              for (m = -l; m <= l; m++)
-                {
-                  std::vector<int> tempvec(3, 0);
-                  atomTypewiseSTOvector[j].n.push_back(n);
-                  atomTypewiseSTOvector[j].l.push_back(l);
-                  atomTypewiseSTOvector[j].m.push_back(m);
-                  tempvec[0] = n;
-                  tempvec[1] = l;
-                  tempvec[2] = m;
-                  atomTypewiseOrbitalist.push_back(tempvec);
-                  counter++;
-                }
-            }
+          fractionalPositions[iAtom][d] = atomLocationsFractional[iAtom][d + 2];
+          positionData[3 * iAtom + d]   = fractionalPositions[iAtom][d];
         }
-      writeOrbitalDataIntoFile(atomTypewiseOrbitalist,
-                               "atomTypeWiseOrbitalNums.txt");
     }
+  const int numOperations =
+    spg_get_symmetry(reinterpret_cast<int(*)[3][3]>(rotationData.data()),
+                     reinterpret_cast<double(*)[3]>(translationData.data()),
+                     maxNumOperations,
+                     lattice,
+                     reinterpret_cast<double(*)[3]>(positionData.data()),
+                     types.data(),
+                     numOfAtoms,
+                     1e-5);
+
+  std::vector<std::array<std::array<int, 3>, 3>> rotations(
+    std::max(numOperations, 0));
+  std::vector<std::array<double, 3>> translations(std::max(numOperations, 0));
+  for (int iOp = 0; iOp < numOperations; ++iOp)
+    for (unsigned int i = 0; i < 3; ++i)
+      {
+        for (unsigned int j = 0; j < 3; ++j)
+          rotations[iOp][i][j] = rotationData[9 * iOp + 3 * i + j];
+        translations[iOp][i] = translationData[3 * iOp + i];
+      }
 
-  for (int j = 0; j < atomTypewiseSTOvector.size(); j++)
+  //
+  // the sums over the k-points of all pools are only invariant under the
+  // operations that map the weighted k-points onto themselves
+  //
+  std::vector<double> localKPoints(kPointReducedCoordinates.begin(),
+                                   kPointReducedCoordinates.begin() +
+                                     3 * d_kPointWeights.size());
+  const std::vector<std::vector<double>> kPointsOfPools =
+    Utilities::MPI::all_gather(interpoolcomm, localKPoints);
+  const std::vector<std::vector<double>> kPointWeightsOfPools =
+    Utilities::MPI::all_gather(interpoolcomm, d_kPointWeights);
+  std::vector<std::array<double, 3>> kPoints;
+  std::vector<double>                kPointWeights;
+  for (unsigned int iPool = 0; iPool < kPointsOfPools.size(); ++iPool)
+    for (unsigned int ik = 0; ik < kPointWeightsOfPools[iPool].size(); ++ik)
+      {
+        kPoints.push_back({kPointsOfPools[iPool][3 * ik + 0],
+                           kPointsOfPools[iPool][3 * ik + 1],
+                           kPointsOfPools[iPool][3 * ik + 2]});
+        kPointWeights.push_back(kPointWeightsOfPools[iPool][ik]);
+      }
+  const std::vector<unsigned int> invariantOperations =
+    kPointInvariantOperations(rotations, kPoints, kPointWeights, true, 1e-5);
+
+  std::vector<std::array<std::array<int, 3>, 3>> invariantRotations;
+  std::vector<std::array<double, 3>>             invariantTranslations;
+  for (const unsigned int iOp : invariantOperations)
     {
-      atomTypewiseSTOvector[j].CreatePseudoAtomicOrbitalBasis();
+      invariantRotations.push_back(rotations[iOp]);
+      invariantTranslations.push_back(translations[iOp]);
     }
+  pairSymmetry.reinit(fractionalPositions,
+                      atomicNumbers,
+                      invariantRotations,
+                      invariantTranslations,
+                      1e-4);
+
+  if (d_dftParamsPtr->verbosity >= 1)
+    pcout << "atom pairs of the population analysis reduced to "
+          << pairSymmetry.representativePairs().size()
+          << " irreducible pairs with " << pairSymmetry.numberOfOperations()
+          << " of " << std::max(numOperations, 1)
+          << " space group operations" << std::endl;
+}
 
-  pcout << "vector of objects constructed!\n";
-
-
-
-  std::ofstream atomWiseAtomicOrbitalInfoFile("atomWiseAtomicOrbitalInfo.txt");
 
-  if (!atomWiseAtomicOrbitalInfoFile.is_open())
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+std::vector<dataTypes::number>
+dftClass<FEOrder, FEOrderElectro>::scaledKohnShamOrbitalsAtNodes(
+  const std::vector<dataTypes::number> &  eigenVectorsKS,
+  const unsigned int                      numOfKSOrbitals,
+  const unsigned int                      kpoint,
+  const std::vector<IndexSet::size_type> &locallyOwnedDOFs)
+{
+  const unsigned int             n_dofs = locallyOwnedDOFs.size();
+  std::vector<dataTypes::number> scaledKSOrbitalValues(
+    n_dofs * numOfKSOrbitals, dataTypes::number(0.0));
+  for (unsigned int dof = 0; dof < n_dofs; ++dof)
     {
-      std::cerr << "Couldn't open "
-                << "atomWiseAtomicOrbitalInfo.txt"
-                << " file!!" << std::endl;
-      exit(0);
+      const dealii::types::global_dof_index dofID = locallyOwnedDOFs[dof];
+      if (constraintsNone.is_constrained(dofID))
+        continue;
+      const double sqrtMass =
+        d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof);
+#ifdef USE_COMPLEX
+      const Point<3> node  = d_supportPoints[dofID];
+      const double   kdotx = d_kPointCoordinates[kpoint * 3 + 0] * node[0] +
+                           d_kPointCoordinates[kpoint * 3 + 1] * node[1] +
+                           d_kPointCoordinates[kpoint * 3 + 2] * node[2];
+      const std::complex<double> phase(std::cos(kdotx), std::sin(kdotx));
+#else
+      const double phase = 1.0;
+#endif
+      for (unsigned int j = 0; j < numOfKSOrbitals; ++j)
+        scaledKSOrbitalValues[dof * numOfKSOrbitals + j] =
+          sqrtMass * phase * eigenVectorsKS[dof * d_numEigenValues + j];
     }
+  return scaledKSOrbitalValues;
+}
 
-  unsigned int atomicNum;
-
-  count = 0;
-  std::vector<unsigned int> atomwiseGlobalbasisNum; // cumulative vector
-  atomwiseGlobalbasisNum.reserve(numOfAtoms + 1);
-
-  atomwiseGlobalbasisNum.push_back(count); // first entry is zero
-
-
-  /* Change the above loop to: */
-  for (int i = 0; i < atomicNumVec.size(); i++)
-    {
-      for (int j = 0; j < atomTypewiseSTOvector.size(); j++)
-        {
-          if (atomicNumVec[i] == atomTypewiseSTOvector[j].atomType)
-            {
-              count += atomTypewiseSTOvector[j].sizeofbasis();
-              atomwiseGlobalbasisNum.push_back(count);
 
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+std::vector<double>
+dftClass<FEOrder, FEOrderElectro>::orbitalPopulationCompute(
+  const std::vector<std::vector<double>> &eigenValuesInput,
+  unsigned int                            kpoint,
+  unsigned int                            spinIndex,
+  std::vector<double> *                   orbitalWeights)
+{
+  populationProfiler profiler(mpi_communicator);
+  TimerOutput::Scope scope(computing_timer, "population analysis");
+  //
+  // the reductions and broadcasts below are over the FE domain of the local
+  // k-point pool, the matrix files are written by the first pool and band
+  // group only
+  //
+  const bool writePopulationFiles =
+    d_dftParamsPtr->writePopulationFiles &&
+    Utilities::MPI::this_mpi_process(interpoolcomm) == 0 &&
+    Utilities::MPI::this_mpi_process(interBandGroupComm) == 0;
 
+  pcout << std::fixed;
+  pcout << std::setprecision(8);
+  pcout
+    << "Started post-processing DFT results to obtain Bonding information..\n";
 
-              break;
-            }
-        }
-    }
+  // would it be good to replace (unsigned) int with (unsigned) short int?
+  // would it be better to replace unsigned short int with uint16_t?
 
+  //
+  // atomic orbital basis of the current atoms, the basis objects and the
+  // basis metadata are kept across calls
+  //
+  if (updatePopulationBasisCache())
+    pcout << "atomic orbital basis constructed from BasisInfo.inp\n";
 
-  unsigned int totalDimOfBasis = count;
+  const unsigned int numOfAtoms     = atomLocations.size();
+  const unsigned int numOfAtomTypes = atomTypes.size();
+  std::vector<AtomicOrbitalBasisManager> &atomTypewiseSTOvector =
+    d_populationBasisCache.atomTypewiseSTOvector;
+  const std::vector<LocalAtomicBasisInfo> &globalBasisInfo =
+    d_populationBasisCache.globalBasisInfo;
+  const std::vector<unsigned int> &atomwiseGlobalbasisNum =
+    d_populationBasisCache.atomwiseGlobalbasisNum;
+  const unsigned int totalDimOfBasis = globalBasisInfo.size();
 
   pcout << "total basis dimension: " << totalDimOfBasis << '\n'
         << "total number of atoms: " << numOfAtoms << '\n'
         << "number of atoms types: " << numOfAtomTypes << '\n';
 
-  std::vector<LocalAtomicBasisInfo> globalBasisInfo;
-  globalBasisInfo.reserve(totalDimOfBasis);
-  unsigned int tmp1, tmp2, tmp3, nstart, basisNstart;
-
-  for (unsigned int i = 0; i < numOfAtoms; ++i)
-    {
-      atomicNum = atomicNumVec[i];
-      tmp1      = atomTypetoAtomTypeID[atomicNum];
-      tmp2      = atomwiseGlobalbasisNum[i];
-      tmp3      = atomwiseGlobalbasisNum[i + 1];
-      // nstart = atomTypetoNstart[ atomicNum ];
-      // basisNstart = numOfOrbitalsForShellCount(1, nstart - 1);
-
-      atomWiseAtomicOrbitalInfoFile << atomicNum << " " << tmp2 + 1 << " "
-                                    << tmp3 << " " << atomTypeoritalstart[tmp1]
-                                    << '\n';
-
-      for (unsigned int j = tmp2; j < tmp3; ++j)
-        {
-          // globalBasisInfo.push_back({i, tmp1, basisNstart + j - tmp2});
-          // globalBasisInfo.push_back({i, tmp1,atomTypewiseSTOvector[tmp1].n
-          // ,atomTypewiseSTOvector[tmp1].l ,atomTypewiseSTOvector[tmp1].m});
-          LocalAtomicBasisInfo temp;
-          temp.atomID     = i;
-          temp.atomTypeID = tmp1;
-          temp.n          = atomTypewiseSTOvector[tmp1].n[j - tmp2];
-          temp.l          = atomTypewiseSTOvector[tmp1].l[j - tmp2];
-          temp.m          = atomTypewiseSTOvector[tmp1].m[j - tmp2];
-          globalBasisInfo.push_back(temp);
-          //  globalBasisInfo.push_back({i, tmp1,atomTypewiseSTOvector[tmp1].n[j
-          //  - tmp2] ,atomTypewiseSTOvector[tmp1].l[j - tmp2]
-          //  ,atomTypewiseSTOvector[tmp1].m[j - tmp2]});
-          // globalBasisInfo.push_back({i, tmp1,atomTypewiseSTOvector[tmp1].n[j
-          // - tmp2] ,atomTypewiseSTOvector[tmp1].l[j - tmp2]
-          // ,atomTypewiseSTOvector[tmp1].m[j - tmp2]});
-          // i required to get atom position coordinates
-          // atomTypeID is required to construct the basis
-          // basisNum in the quantumNumHierarchy
-        }
-    }
-
-  pcout << "global basis info constructed!\n";
-
 
 
   unsigned int numOfKSOrbitals = d_dftParamsPtr->NumofKSOrbitalsproj;
@@ -506,39 +1033,30 @@ dftClass<FEOrder, FEOrderElectro>::orbitalPopulationCompute(
 
 
 
-  occupationNum.resize(numOfKSOrbitals *
-                       (d_dftParamsPtr->spinPolarized == 1 ? 2 : 1));
-  pcout << "Size of Occupance vector" << occupationNum.size() << std::endl;
+  occupationNum.resize(numOfKSOrbitals);
 
   unsigned int numEigenValues =
     eigenValuesInput[kpoint].size() / (1 + d_dftParamsPtr->spinPolarized);
   pcout << "Number of Eigenvalues " << numEigenValues << std::endl;
+  energyLevelsKS.assign(eigenValuesInput[kpoint].begin() +
+                          spinIndex * numEigenValues,
+                        eigenValuesInput[kpoint].begin() +
+                          (spinIndex + 1) * numEigenValues);
+  const double fermiEnergySpin =
+    !d_dftParamsPtr->constraintMagnetization ?
+      fermiEnergy :
+      (spinIndex == 0 ? fermiEnergyUp : fermiEnergyDown);
   for (unsigned int iEigen = 0; iEigen < numOfKSOrbitals; ++iEigen)
-    {
-      if (d_dftParamsPtr->spinPolarized == 0)
-        {
-          occupationNum[iEigen] =
-            dftUtils::getPartialOccupancy(eigenValuesInput[kpoint][iEigen],
-                                          fermiEnergy,
-                                          C_kb,
-                                          d_dftParamsPtr->TVal);
-          // pcout<<occupationNum[iEigen]<<std::endl;
-        }
-      else
-        {
-          occupationNum[iEigen] =
-            dftUtils::getPartialOccupancy(eigenValuesInput[kpoint][iEigen],
-                                          fermiEnergy,
-                                          C_kb,
-                                          d_dftParamsPtr->TVal);
-          occupationNum[iEigen + numOfKSOrbitals] =
-            dftUtils::getPartialOccupancy(
-              eigenValuesInput[kpoint][iEigen + numEigenValues],
-              fermiEnergy,
-              C_kb,
-              d_dftParamsPtr->TVal);
-        }
-    }
+    occupationNum[iEigen] =
+      dftUtils::getPartialOccupancy(energyLevelsKS[iEigen],
+                                    fermiEnergySpin,
+                                    C_kb,
+                                    d_dftParamsPtr->TVal);
+
+  // Kohn-Sham orbitals of this k-point and spin
+  const std::vector<dataTypes::number> &eigenVectorsKS =
+    d_eigenVectorsFlattenedSTL[(1 + d_dftParamsPtr->spinPolarized) * kpoint +
+                               spinIndex];
 
 
   // Loop over atomic orbitals to evaluate at all nodal points
@@ -548,35 +1066,38 @@ dftClass<FEOrder, FEOrderElectro>::orbitalPopulationCompute(
   locallyOwnedSet.fill_index_vector(locallyOwnedDOFs);
   unsigned int n_dofs = locallyOwnedDOFs.size();
   pcout<<"Total DOFs: "<<n_dofs<<std::endl;
-  MPI_Barrier(MPI_COMM_WORLD);
-  // std::cout<<"Processor ID: "<<this_mpi_process<<" has dofs total:
-  // "<<n_dofs<<std::endl;
-#ifdef USE_COMPLEX
-  
-  const std::complex<double> iota(0, 1);
-  pcout<<"Imaginary No: "<<iota<<std::endl;
-  std::vector<std::complex<double>> scaledOrbitalValues_FEnodes(n_dofs * totalDimOfBasis,
-                                                  std::complex<double> (0,0));
-  std::vector<std::complex<double>> scaledKSOrbitalValues_FEnodes(
-    (n_dofs * numOfKSOrbitals) * (d_dftParamsPtr->spinPolarized ? 0 : 1), std::complex<double> (0,0));
-  std::vector<std::complex<double>> scaledKSOrbitalValues_FEnodes_spinup(
-    (n_dofs * numOfKSOrbitals) * (d_dftParamsPtr->spinPolarized ? 1 : 0), std::complex<double> (0,0));
-  std::vector<std::complex<double>> scaledKSOrbitalValues_FEnodes_spindown(
-    (n_dofs * numOfKSOrbitals) * (d_dftParamsPtr->spinPolarized ? 1 : 0), std::complex<double> (0,0));
-#else
 
+  // with the quadrature the overlap and projections are formed on the
+  // locally owned cells instead of the locally owned nodes
+  const bool useQuadrature = d_dftParamsPtr->populationProjectionQuadrature;
 
-  std::vector<double> scaledOrbitalValues_FEnodes(n_dofs * totalDimOfBasis,
-                                                  0.0);
-  std::vector<double> scaledKSOrbitalValues_FEnodes(
-    (n_dofs * numOfKSOrbitals) * (d_dftParamsPtr->spinPolarized ? 0 : 1), 0.0);
-  std::vector<double> scaledKSOrbitalValues_FEnodes_spinup(
-    (n_dofs * numOfKSOrbitals) * (d_dftParamsPtr->spinPolarized ? 1 : 0), 0.0);
-  std::vector<double> scaledKSOrbitalValues_FEnodes_spindown(
-    (n_dofs * numOfKSOrbitals) * (d_dftParamsPtr->spinPolarized ? 1 : 0), 0.0);
-  
-#endif  
-  if (this_mpi_process == 0)
+  // images near the local nodes or cells, kept while the atoms stay within
+  // the skin
+  profiler.enter("Neighbor list");
+  std::vector<Point<3>> localPoints;
+  if (useQuadrature)
+    {
+      typename DoFHandler<3>::active_cell_iterator cell =
+                                                     dofHandler.begin_active(),
+                                                   endc = dofHandler.end();
+      for (; cell != endc; ++cell)
+        if (cell->is_locally_owned())
+          for (unsigned int v = 0; v < GeometryInfo<3>::vertices_per_cell; ++v)
+            localPoints.push_back(cell->vertex(v));
+    }
+  else
+    for (unsigned int dof = 0; dof < n_dofs; ++dof)
+      localPoints.push_back(d_supportPoints[locallyOwnedDOFs[dof]]);
+  const unsigned int numberOfRebuilds = Utilities::MPI::sum(
+    updatePopulationNeighborList(localPoints) ? 1u : 0u, mpi_communicator);
+  profiler.leave("Neighbor list");
+  if (d_dftParamsPtr->verbosity >= 2)
+    pcout << "atom neighbor lists rebuilt on " << numberOfRebuilds << " of "
+          << Utilities::MPI::n_mpi_processes(mpi_communicator)
+          << " processors" << std::endl;
+  // std::cout<<"Processor ID: "<<this_mpi_process<<" has dofs total:
+  // "<<n_dofs<<std::endl;
+  if (writePopulationFiles && this_mpi_process == 0)
     {
       // and writing the high level basis information
 
@@ -596,994 +1117,1147 @@ dftClass<FEOrder, FEOrderElectro>::orbitalPopulationCompute(
         pcout << "couldn't open highLevelBasisInfo.txt file!\n";
     }
 
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerCreatingMatrices = MPI_Wtime();
-  double r,theta,phi;
-  int SumCounter=0;
-#ifdef USE_COMPLEX
-pcout<<"K-point coordinate: "<<d_kPointCoordinates[kpoint*3+0]<<" "<<d_kPointCoordinates[kpoint*3+1]<<" "<<d_kPointCoordinates[kpoint*3+2]<<std::endl;
-  for (unsigned int dof = 0; dof < n_dofs; ++dof)
+  // weight of this k-point and spin in the in-memory results
+  const double populationWeight =
+    (d_dftParamsPtr->spinPolarized == 1 ? 1.0 : 2.0) *
+    d_kPointWeights[kpoint];
+  if (d_populationAnalysisResults.atomPairPopulations.size() !=
+      numOfAtoms * numOfAtoms)
     {
-      //pcout<<"Node no: "<<dof<<std::endl;
-      // get nodeID
-      const dealii::types::global_dof_index dofID = locallyOwnedDOFs[dof];
-          
-          double kdotx,kdotRm; 
-         //pcout<<"kdotx at DOF:" <<dofID<<" :"<<kdotx<<" "<<exp(iota*kdotx)<<std::endl;               
+      d_populationAnalysisResults.numAtoms = numOfAtoms;
+      d_populationAnalysisResults.atomPairPopulations.assign(
+        numOfAtoms * numOfAtoms, 0.0);
+      d_populationAnalysisResults.atomPairICOHP.assign(numOfAtoms * numOfAtoms,
+                                                       0.0);
+    }
+  std::vector<double> &pairPopulations =
+    d_populationAnalysisResults.atomPairPopulations;
+  std::vector<double> &pairICOHP = d_populationAnalysisResults.atomPairICOHP;
+  atomPairSymmetry &   pairSymmetry = d_populationBasisCache.pairSymmetry;
+  if (pairSymmetry.numberOfAtoms() != numOfAtoms)
+    pairSymmetry.reinit(numOfAtoms);
+  const std::vector<std::array<unsigned int, 2>> &representativePairs =
+    pairSymmetry.representativePairs();
+  std::vector<double> representativePopulations(representativePairs.size(),
+                                                0.0);
+  std::vector<double> representativeICOHP(representativePairs.size(), 0.0);
 
-      if (!constraintsNone.is_constrained(dofID))
+  //
+  // the atomic orbitals are evaluated in blocks of basis functions and the
+  // reductions over the FE nodes of the overlap and projection blocks of one
+  // block proceed while the next one is evaluated, only the part of the
+  // communication that is not hidden shows up in the "S reduction" and
+  // "Phi^T Psi reduction" waits below. With the quadrature the cells are
+  // added in batches instead and the projections are reduced while S is
+  // diagonalized.
+  //
+  const unsigned int basisBlockSize = 64;
+  const bool         isComplex =
+    std::is_same<dataTypes::number, std::complex<double>>::value;
+  std::unique_ptr<pipelinedOverlapProjection<dataTypes::number>>
+    overlapProjection;
+  std::unique_ptr<cellQuadratureOverlapProjection<dataTypes::number>>
+    quadratureProjection;
+  int SumCounter = 0;
+  if (useQuadrature)
+    {
+      const unsigned int numNodesPerElement =
+        dofHandler.get_fe().dofs_per_cell;
+      quadratureProjection = std::make_unique<
+        cellQuadratureOverlapProjection<dataTypes::number>>(
+        totalDimOfBasis,
+        numOfKSOrbitals,
+        matrix_free_data.get_quadrature(d_densityQuadratureId).size(),
+        numNodesPerElement,
+        d_kohnShamDFTOperatorPtr->getShapeFunctionValuesDensityGaussQuad(),
+        mpi_communicator);
+      SumCounter = addPopulationQuadratureCells(eigenVectorsKS,
+                                                numOfKSOrbitals,
+                                                kpoint,
+                                                *quadratureProjection,
+                                                profiler);
+    }
+  else
+    {
+      profiler.enter("Psi evaluation");
+      const std::vector<dataTypes::number> scaledKSOrbitalValues_FEnodes =
+        scaledKohnShamOrbitalsAtNodes(eigenVectorsKS,
+                                      numOfKSOrbitals,
+                                      kpoint,
+                                      locallyOwnedDOFs);
+      profiler.leave("Psi evaluation");
+
+      overlapProjection =
+        std::make_unique<pipelinedOverlapProjection<dataTypes::number>>(
+          scaledKSOrbitalValues_FEnodes,
+          n_dofs,
+          numOfKSOrbitals,
+          mpi_communicator);
+      for (unsigned int blockStart = 0; blockStart < totalDimOfBasis;
+           blockStart += basisBlockSize)
         {
-          // get coordinates of the finite-element node
-          Point<3> node = d_supportPoints[dofID];
+          const unsigned int blockEnd =
+            std::min(blockStart + basisBlockSize, totalDimOfBasis);
+          const std::vector<LocalAtomicBasisInfo> blockBasisInfo(
+            globalBasisInfo.begin() + blockStart,
+            globalBasisInfo.begin() + blockEnd);
+
+          std::vector<dataTypes::number> orbitalValues;
+          profiler.enter("Phi evaluation");
+          SumCounter += evaluateAtomicOrbitalsAtNodes(
+            blockBasisInfo,
+            atomTypewiseSTOvector,
+            locallyOwnedDOFs,
+            kpoint,
+            orbitalValues,
+            &d_populationBasisCache.neighborList);
+          profiler.leave("Phi evaluation");
+
+          profiler.enter("S and Phi^T Psi blocks");
+          overlapProjection->appendBasis(orbitalValues, blockEnd - blockStart);
+          profiler.leave("S and Phi^T Psi blocks");
+          profiler.addFlops(
+            "S and Phi^T Psi blocks",
+            populationProfiler::gemmFlops(blockEnd,
+                                          blockEnd - blockStart,
+                                          n_dofs,
+                                          isComplex) +
+              populationProfiler::gemmFlops(blockEnd - blockStart,
+                                            numOfKSOrbitals,
+                                            n_dofs,
+                                            isComplex));
+          profiler.addBytes(
+            "S and Phi^T Psi blocks",
+            populationProfiler::gemmBytes(blockEnd,
+                                          blockEnd - blockStart,
+                                          n_dofs,
+                                          isComplex) +
+              populationProfiler::gemmBytes(blockEnd - blockStart,
+                                            numOfKSOrbitals,
+                                            n_dofs,
+                                            isComplex));
+        }
+    }
+  MPI_Allreduce(
+    MPI_IN_PLACE, &SumCounter, 1, MPI_INT, MPI_SUM, mpi_communicator);
+  pcout << "Sum of Counter: " << SumCounter << std::endl;
 
+#ifdef USE_COMPLEX
+  profiler.enter("S reduction");
+  std::vector<std::complex<double>> S =
+    useQuadrature ? quadratureProjection->overlapMatrix() :
+                    overlapProjection->overlapMatrix();
+  profiler.leave("S reduction");
+  if (writePopulationFiles && this_mpi_process == 0)
+    {
+      writeVectorAs2DMatrix(S,
+                            totalDimOfBasis,
+                            totalDimOfBasis,
+                            "overlapMatrixComplex.txt");
+    }
 
-          kdotx = d_kPointCoordinates[kpoint*3+0]*node[0]+
-                        d_kPointCoordinates[kpoint*3+1]*node[1] +
-                         d_kPointCoordinates[kpoint*3+2]*node[2];
-          auto count1 = totalDimOfBasis * dof;
+  std::vector<double>               D(totalDimOfBasis, 0.0);
+  std::vector<std::complex<double>> U(totalDimOfBasis * totalDimOfBasis,
+                                      std::complex<double>(0, 0));
+  // the Phi^T Psi reductions are still in flight
+  profiler.enter("S diagonalization");
+  if (this_mpi_process == 0)
+    U = diagonalization(S, totalDimOfBasis, D);
+  MPI_Bcast(&(D[0]),
+            totalDimOfBasis,
+            dataTypes::mpi_type_id(&D[0]),
+            0,
+            mpi_communicator);
+  MPI_Bcast(&(U[0]),
+            totalDimOfBasis * totalDimOfBasis,
+            dataTypes::mpi_type_id(&U[0]),
+            0,
+            mpi_communicator);
+  profiler.leave("S diagonalization");
+
+  profiler.enter("Canonical orthogonalization");
+  std::vector<std::complex<double>> Ut = TransposeMatrix(U, totalDimOfBasis);
+  std::vector<std::complex<double>> X, Uk;
+  const unsigned int                reducedDimOfBasis =
+    canonicalOrthogonalization(D,
+                               Ut,
+                               totalDimOfBasis,
+                               d_dftParamsPtr->overlapEigenvalueThreshold,
+                               X,
+                               Uk);
+  profiler.leave("Canonical orthogonalization");
+  AssertThrow(reducedDimOfBasis > 0,
+              dealii::ExcMessage(
+                "DFT-FE Error: all eigenvalues of the atomic orbital overlap "
+                "matrix are below OVERLAP EIGENVALUE THRESHOLD."));
+  pcout << "Overlap matrix eigenvalues in [" << D[0] << ", "
+        << D[totalDimOfBasis - 1] << "], "
+        << totalDimOfBasis - reducedDimOfBasis << " of " << totalDimOfBasis
+        << " basis directions discarded" << std::endl;
+
+  profiler.enter("Phi^T Psi reduction");
+  std::vector<std::complex<double>> arrayVecOfProj =
+    useQuadrature ? quadratureProjection->projections() :
+                    overlapProjection->projections();
+  profiler.leave("Phi^T Psi reduction");
 
-          for (unsigned int i = 0; i < totalDimOfBasis; ++i)
-            {
-              auto atomTypeID   = globalBasisInfo[i].atomTypeID;
-              auto atomChargeID = globalBasisInfo[i].atomID;
+  //
+  // coefficients of the projected Kohn-Sham orbitals in the orthonormal
+  // canonical basis Phi X, the overlap of the projections is then simply
+  // O = C^H C
+  //
+  profiler.enter("C computation");
+  std::vector<std::complex<double>> coeffArrayVecOfProj =
+    matrixTmatrixmul(X,
+                     totalDimOfBasis,
+                     reducedDimOfBasis,
+                     arrayVecOfProj,
+                     totalDimOfBasis,
+                     numOfKSOrbitals);
+  profiler.leave("C computation");
+  profiler.addFlops("C computation",
+                    populationProfiler::gemmFlops(reducedDimOfBasis,
+                                                  numOfKSOrbitals,
+                                                  totalDimOfBasis,
+                                                  true));
+
+  profiler.enter("O computation");
+  std::vector<std::complex<double>> O = matrixTmatrixmul(coeffArrayVecOfProj,
+                                                         reducedDimOfBasis,
+                                                         numOfKSOrbitals,
+                                                         coeffArrayVecOfProj,
+                                                         reducedDimOfBasis,
+                                                         numOfKSOrbitals);
+  profiler.leave("O computation");
+  profiler.addFlops("O computation",
+                    populationProfiler::gemmFlops(numOfKSOrbitals,
+                                                  numOfKSOrbitals,
+                                                  reducedDimOfBasis,
+                                                  true));
+
+  std::vector<double>               D_O(numOfKSOrbitals, 0.0);
+  std::vector<std::complex<double>> U_O(numOfKSOrbitals * numOfKSOrbitals,
+                                        std::complex<double>(0.0, 0.0));
+  profiler.enter("O diagonalization");
+  if (this_mpi_process == 0)
+    U_O = diagonalization(O, numOfKSOrbitals, D_O);
+  MPI_Bcast(&(D_O[0]),
+            numOfKSOrbitals,
+            dataTypes::mpi_type_id(&D_O[0]),
+            0,
+            mpi_communicator);
+  MPI_Bcast(&(U_O[0]),
+            numOfKSOrbitals * numOfKSOrbitals,
+            dataTypes::mpi_type_id(&U_O[0]),
+            0,
+            mpi_communicator);
+  profiler.leave("O diagonalization");
+
+  profiler.enter("O^-1/2");
+  std::vector<std::complex<double>> U_Ot = TransposeMatrix(U_O, numOfKSOrbitals);
+  std::vector<std::complex<double>> Ominushalf =
+    powerOfMatrix(-0.5, D_O, U_Ot, numOfKSOrbitals, U_Ot);
+  profiler.leave("O^-1/2");
+  profiler.addFlops("O^-1/2",
+                    populationProfiler::gemmFlops(numOfKSOrbitals,
+                                                  numOfKSOrbitals,
+                                                  numOfKSOrbitals,
+                                                  true));
 
-              std::vector<int> imageIdsList;
-              if (d_dftParamsPtr->periodicX || d_dftParamsPtr->periodicY ||
-                  d_dftParamsPtr->periodicZ)
-                
-                {
-                  imageIdsList = d_globalChargeIdToImageIdMap[atomChargeID];
-                }
-              else
-                {
-                  imageIdsList.push_back(atomChargeID);
-                }
- 
-                   OrbitalQuantumNumbers orbital = {globalBasisInfo[i].n,
-                                                   globalBasisInfo[i].l,
-                                                   globalBasisInfo[i].m};
-              //pcout<<"imageIdsList.size(): "<<imageIdsList.size()<<std::endl;
-              int counterlist = 0;
-              for (int imageID = 0; imageID < imageIdsList.size(); imageID++)
-                {
-                  int                 chargeId = imageIdsList[imageID];
-                  std::vector<double> atomPos(3, 0.0);
-                  if (chargeId < numOfAtoms)
-                    {
-                      atomPos[0] = atomLocations[chargeId][2];
-                      atomPos[1] = atomLocations[chargeId][3];
-                      atomPos[2] = atomLocations[chargeId][4];
-                    }
-                  else
-                    {
-                      atomPos[0] = d_imagePositions[chargeId - numOfAtoms][0];
-                      atomPos[1] = d_imagePositions[chargeId - numOfAtoms][1];
-                      atomPos[2] = d_imagePositions[chargeId - numOfAtoms][2];
-                    }
-                    auto relativeEvalPoint = relativeVector3d(node, atomPos);
-                    
-                    
-                    convertCartesianToSpherical(relativeEvalPoint, r, theta, phi);
-                 
-                  if(atomTypewiseSTOvector[atomTypeID].maxRadialcutoff < 0 || r <= atomTypewiseSTOvector[atomTypeID].maxRadialcutoff)
-                  {
-                    //pcout<<"kdotRm at imageId:" <<imageID<<" :"<<kdotRm<<" "<<exp(iota*kdotRm)<<std::endl;
-                    counterlist++;
-                   kdotRm = atomPos[0]*d_kPointCoordinates[kpoint*3+0] +
-                                                 atomPos[1]*d_kPointCoordinates[kpoint*3+1] +
-                                                  atomPos[2]*d_kPointCoordinates[kpoint*3+2] ;
-                  if (d_dftParamsPtr->AtomicOrbitalBasis == 1)
-                    {
-                      double realvalue = scaledOrbitalValues_FEnodes[count1 + i].real();
-                      double imaginaryValue = scaledOrbitalValues_FEnodes[count1 + i].imag();
-
-                      scaledOrbitalValues_FEnodes[count1 + i] +=
-                        d_kohnShamDFTOperatorPtr->d_sqrtMassVector
-                          .local_element(dof) *
-                        atomTypewiseSTOvector[atomTypeID].bungeOrbital(orbital,
-                                                                       node,
-                                                                       atomPos);//*std::exp(iota*kdotRm);
-                    }
-                  if (d_dftParamsPtr->AtomicOrbitalBasis == 0)
-                    {
-                      double realvalue = scaledOrbitalValues_FEnodes[count1 + i].real();
-                      double imaginaryValue = scaledOrbitalValues_FEnodes[count1 + i].imag();
-                      realvalue += d_kohnShamDFTOperatorPtr->d_sqrtMassVector
-                          .local_element(dof) *
-                        atomTypewiseSTOvector[atomTypeID]
-                          .PseudoAtomicOrbitalvalue(orbital, node, atomPos,r,theta,phi)*std::cos(kdotRm);
-                      imaginaryValue += d_kohnShamDFTOperatorPtr->d_sqrtMassVector
-                          .local_element(dof) *
-                        atomTypewiseSTOvector[atomTypeID]
-                          .PseudoAtomicOrbitalvalue(orbital, node, atomPos,r,theta,phi)*std::sin(kdotRm);                      
-                      
-                      scaledOrbitalValues_FEnodes[count1 + i].real(realvalue);
-                      scaledOrbitalValues_FEnodes[count1 + i].imag(imaginaryValue);
-                        
-                    }
-                  }  
-                  
-                }
-                SumCounter+=counterlist;
-            }
-        
-      //pcout<<" Line No 699"<<" "<<d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof)<<std::endl;  
-      auto count2 = numOfKSOrbitals * dof;
+  //
+  // orthonormalized projections in the canonical basis, mapped back to the
+  // atomic orbitals by X and to the Loewdin orbitals by U_k = S^{1/2} X
+  //
+  profiler.enter("C_bar computation");
+  std::vector<std::complex<double>> reducedC_bar =
+    matrixmatrixmul(coeffArrayVecOfProj,
+                    reducedDimOfBasis,
+                    numOfKSOrbitals,
+                    Ominushalf,
+                    numOfKSOrbitals,
+                    numOfKSOrbitals);
+  std::vector<std::complex<double>> C_bar = matrixmatrixmul(X,
+                                                            totalDimOfBasis,
+                                                            reducedDimOfBasis,
+                                                            reducedC_bar,
+                                                            reducedDimOfBasis,
+                                                            numOfKSOrbitals);
+  profiler.leave("C_bar computation");
+  profiler.addFlops("C_bar computation",
+                    populationProfiler::gemmFlops(reducedDimOfBasis,
+                                                  numOfKSOrbitals,
+                                                  numOfKSOrbitals,
+                                                  true) +
+                      populationProfiler::gemmFlops(totalDimOfBasis,
+                                                    numOfKSOrbitals,
+                                                    reducedDimOfBasis,
+                                                    true));
+
+  if (writePopulationFiles && this_mpi_process == 0)
+    {
+      writeVectorAs2DMatrix(C_bar,
+                            totalDimOfBasis,
+                            numOfKSOrbitals,
+                            "FePOP_v1Complex.txt");
+    }
 
-      for (unsigned int j = 0; j < numOfKSOrbitals; ++j)
+  profiler.enter("C_hat computation");
+  std::vector<std::complex<double>> C_hat = matrixmatrixmul(Uk,
+                                                            totalDimOfBasis,
+                                                            reducedDimOfBasis,
+                                                            reducedC_bar,
+                                                            reducedDimOfBasis,
+                                                            numOfKSOrbitals);
+  profiler.leave("C_hat computation");
+  profiler.addFlops("C_hat computation",
+                    populationProfiler::gemmFlops(totalDimOfBasis,
+                                                  numOfKSOrbitals,
+                                                  reducedDimOfBasis,
+                                                  true));
+  if (writePopulationFiles && this_mpi_process == 0)
+    {
+      writeVectorAs2DMatrix(C_hat,
+                            totalDimOfBasis,
+                            numOfKSOrbitals,
+                            "FePHP_v1Complex.txt");
+    }
+
+  profiler.enter("Hproj computation");
+  std::vector<std::complex<double>> Hproj_orbital =
+    computeHprojOrbital(C_hat,
+                        C_hat,
+                        totalDimOfBasis,
+                        numOfKSOrbitals,
+                        energyLevelsKS);
+  profiler.leave("Hproj computation");
+  profiler.addFlops("Hproj computation",
+                    populationProfiler::gemmFlops(totalDimOfBasis,
+                                                  totalDimOfBasis,
+                                                  numOfKSOrbitals,
+                                                  true));
+
+  if (writePopulationFiles && this_mpi_process == 0)
+    {
+      writeVectorAs2DMatrix(Hproj_orbital,
+                            totalDimOfBasis,
+                            totalDimOfBasis,
+                            "Hproj_orbitalCOmplex.txt");
+    }
+
+  //
+  // atom pair populations and ICOHP of the occupied projected bands for
+  // the irreducible atom pairs, accumulated for computePopulationAnalysis()
+  //
+  profiler.enter("Atom pair populations");
+  accumulateSelectedAtomPairContractions(C_bar,
+                                         S,
+                                         occupationNum,
+                                         totalDimOfBasis,
+                                         numOfKSOrbitals,
+                                         atomwiseGlobalbasisNum,
+                                         representativePairs,
+                                         populationWeight,
+                                         representativePopulations);
+  accumulateSelectedAtomPairContractions(C_hat,
+                                         Hproj_orbital,
+                                         occupationNum,
+                                         totalDimOfBasis,
+                                         numOfKSOrbitals,
+                                         atomwiseGlobalbasisNum,
+                                         representativePairs,
+                                         populationWeight,
+                                         representativeICOHP);
+  pairSymmetry.scatter(representativePopulations, pairPopulations);
+  pairSymmetry.scatter(representativeICOHP, pairICOHP);
+  profiler.leave("Atom pair populations");
+
+  std::vector<std::complex<double>>().swap(Hproj_orbital);
+  std::vector<std::complex<double>>().swap(C_hat);
+  std::vector<std::complex<double>>().swap(C_bar);
+  std::vector<std::complex<double>>().swap(reducedC_bar);
+  std::vector<std::complex<double>>().swap(O);
+  std::vector<std::complex<double>>().swap(U_O);
+
+  pcout
+    << "--------------------------COHP Data Saved------------------------------"
+    << std::endl;
+  if (writePopulationFiles && this_mpi_process == 0)
+    {
+      // writing the energy levels and the occupation numbers
+      unsigned int  kPointDummy = 0;
+      std::ofstream energyLevelsOccNumsFile("energyLevelsOccNums.txt");
+
+      if (energyLevelsOccNumsFile.is_open())
         {
-          if (d_dftParamsPtr->spinPolarized == 1)
-            {
-              scaledKSOrbitalValues_FEnodes_spinup[count2 + j] =
-                d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[2*kpoint+0][dof * d_numEigenValues + j]*std::exp(iota*kdotx);
-              // pcout<<"Accessing spin down"<<std::endl;
-              scaledKSOrbitalValues_FEnodes_spindown[count2 + j] =
-                d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[2*kpoint +1][dof * d_numEigenValues + j]*std::exp(iota*kdotx);
-            }
-          else
+          for (unsigned int i = 0; i < eigenValues[0].size(); ++i)
             {
-              //pcout<<"  Line 712"<<std::endl;
-              
-              scaledKSOrbitalValues_FEnodes[count2 + j] += d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                (d_eigenVectorsFlattenedSTL[kpoint][dof * d_numEigenValues + j]*std::exp(iota*kdotx));
-              /*double realValue = scaledKSOrbitalValues_FEnodes[count2 + j].real();
-              double imaginaryValue =  scaledKSOrbitalValues_FEnodes[count2 + j].imag();
-                realValue += d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[kpoint][dof * d_numEigenValues + j]*std::cos(kdotx);
-                imaginaryValue += d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[kpoint][dof * d_numEigenValues + j]*std::sin(kdotx);
-                scaledKSOrbitalValues_FEnodes[count2 + j].real(realValue);
-                scaledKSOrbitalValues_FEnodes[count2 + j].imag(imaginaryValue); */
+              const double partialOccupancy =
+                dftUtils::getPartialOccupancy(eigenValues[kPointDummy][i],
+                                              fermiEnergy,
+                                              C_kb,
+                                              d_dftParamsPtr->TVal);
+
+              energyLevelsOccNumsFile << eigenValues[kPointDummy][i] << " "
+                                      << partialOccupancy << '\n';
             }
+
+          energyLevelsOccNumsFile.close();
         }
-        }
-        //pcout<<" Line 722"<<std::endl;
+
+      else
+        pcout << "couldn't open energyLevelsOccNums.txt file!\n";
     }
-  //pcout<<"Line no 718"<<std::endl;  
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerCreatingMatrices = MPI_Wtime() - timerCreatingMatrices;
-  pcout<<" Creating PHI and PSI matrices: "<<timerCreatingMatrices<<std::endl;
-    MPI_Allreduce(&SumCounter,
-                &SumCounter,
-                1,
-                MPI_INT,
-                MPI_SUM,
-                MPI_COMM_WORLD);  
-  pcout<<"Sum of Counter: "<<SumCounter;
-  MPI_Barrier(MPI_COMM_WORLD);
-   timerScompute = MPI_Wtime();  
-  /*auto upperTriaOfSserial =
-    selfMatrixTmatrixmul(scaledOrbitalValues_FEnodes, n_dofs, totalDimOfBasis);
-  std::vector<std::complex<double>> upperTriaOfS((totalDimOfBasis * (totalDimOfBasis + 1) /
-                                    2),
-                                   std::complex<double> (0.0,0.0));
-  MPI_Allreduce(&upperTriaOfSserial[0],
-                &upperTriaOfS[0],
-                totalDimOfBasis * (totalDimOfBasis + 1) / 2,
-                dataTypes::mpi_type_id(&upperTriaOfSserial[0]),
-                MPI_SUM,
-                MPI_COMM_WORLD);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerScompute = MPI_Wtime() - timerScompute;
-  pcout<<" Computing S matrix: "<<timerScompute<<std::endl;
-  if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+#else
+  profiler.enter("S reduction");
+  std::vector<double> S = useQuadrature ?
+                            quadratureProjection->overlapMatrix() :
+                            overlapProjection->overlapMatrix();
+  profiler.leave("S reduction");
+  if (writePopulationFiles && this_mpi_process == 0)
     {
-      writeVectorToFile(upperTriaOfS, "overlapMatrixComplex.txt");
-      // printVector(upperTriaOfS);
+      std::vector<double> upperTriaOfS;
+      upperTriaOfS.reserve(totalDimOfBasis * (totalDimOfBasis + 1) / 2);
+      for (unsigned int i = 0; i < totalDimOfBasis; ++i)
+        for (unsigned int j = i; j < totalDimOfBasis; ++j)
+          upperTriaOfS.push_back(S[i * totalDimOfBasis + j]);
+      writeVectorToFile(upperTriaOfS, "overlapMatrix.txt");
     }
-   std::vector<std::complex<double>> S(totalDimOfBasis*totalDimOfBasis,std::complex<double> (0,0));
-   pcout<<"Printing the S overlap matrix: "<<std::endl;
-   int Scount=0;
-   for(int i = 0; i < totalDimOfBasis; i++)
-   {
-    for (int j=0; j < totalDimOfBasis; j++)
+
+  std::vector<double> D(totalDimOfBasis, 0.0);
+  std::vector<double> U(totalDimOfBasis * totalDimOfBasis, 0.0);
+  // the Phi^T Psi reductions are still in flight
+  profiler.enter("S diagonalization");
+  if (this_mpi_process == 0)
+    U = diagonalization(S, totalDimOfBasis, D);
+  MPI_Bcast(&(D[0]), totalDimOfBasis, MPI_DOUBLE, 0, mpi_communicator);
+  MPI_Bcast(&(U[0]),
+            totalDimOfBasis * totalDimOfBasis,
+            MPI_DOUBLE,
+            0,
+            mpi_communicator);
+  profiler.leave("S diagonalization");
+
+  profiler.enter("Canonical orthogonalization");
+  auto                Ut = TransposeMatrix(U, totalDimOfBasis);
+  std::vector<double> X, Uk;
+  const unsigned int  reducedDimOfBasis =
+    canonicalOrthogonalization(D,
+                               Ut,
+                               totalDimOfBasis,
+                               d_dftParamsPtr->overlapEigenvalueThreshold,
+                               X,
+                               Uk);
+  profiler.leave("Canonical orthogonalization");
+  AssertThrow(reducedDimOfBasis > 0,
+              dealii::ExcMessage(
+                "DFT-FE Error: all eigenvalues of the atomic orbital overlap "
+                "matrix are below OVERLAP EIGENVALUE THRESHOLD."));
+  pcout << "Overlap matrix eigenvalues in [" << D[0] << ", "
+        << D[totalDimOfBasis - 1] << "], "
+        << totalDimOfBasis - reducedDimOfBasis << " of " << totalDimOfBasis
+        << " basis directions discarded" << std::endl;
+
+  profiler.enter("Phi^T Psi reduction");
+  std::vector<double> arrayVecOfProj =
+    useQuadrature ? quadratureProjection->projections() :
+                    overlapProjection->projections();
+  profiler.leave("Phi^T Psi reduction");
+
+  //
+  // coefficients of the projected Kohn-Sham orbitals in the orthonormal
+  // canonical basis Phi X, the overlap of the projections is then simply
+  // O = C^T C
+  //
+  profiler.enter("C computation");
+  auto coeffArrayVecOfProj = matrixTmatrixmul(X,
+                                              totalDimOfBasis,
+                                              reducedDimOfBasis,
+                                              arrayVecOfProj,
+                                              totalDimOfBasis,
+                                              numOfKSOrbitals);
+  profiler.leave("C computation");
+  profiler.addFlops("C computation",
+                    populationProfiler::gemmFlops(reducedDimOfBasis,
+                                                  numOfKSOrbitals,
+                                                  totalDimOfBasis));
+
+  profiler.enter("O computation");
+  auto O = matrixTmatrixmul(coeffArrayVecOfProj,
+                            reducedDimOfBasis,
+                            numOfKSOrbitals,
+                            coeffArrayVecOfProj,
+                            reducedDimOfBasis,
+                            numOfKSOrbitals);
+  profiler.leave("O computation");
+  profiler.addFlops("O computation",
+                    populationProfiler::gemmFlops(numOfKSOrbitals,
+                                                  numOfKSOrbitals,
+                                                  reducedDimOfBasis));
+
+  std::vector<double> D_O(numOfKSOrbitals, 0.0);
+  std::vector<double> U_O(numOfKSOrbitals * numOfKSOrbitals, 0.0);
+  profiler.enter("O diagonalization");
+  if (this_mpi_process == 0)
+    U_O = diagonalization(O, numOfKSOrbitals, D_O);
+  MPI_Bcast(&(D_O[0]), numOfKSOrbitals, MPI_DOUBLE, 0, mpi_communicator);
+  MPI_Bcast(&(U_O[0]),
+            numOfKSOrbitals * numOfKSOrbitals,
+            MPI_DOUBLE,
+            0,
+            mpi_communicator);
+  profiler.leave("O diagonalization");
+
+  profiler.enter("O^-1/2");
+  auto U_Ot       = TransposeMatrix(U_O, numOfKSOrbitals);
+  auto Ominushalf = powerOfMatrix(-0.5, D_O, U_Ot, numOfKSOrbitals, U_Ot);
+  profiler.leave("O^-1/2");
+  profiler.addFlops("O^-1/2",
+                    populationProfiler::gemmFlops(numOfKSOrbitals,
+                                                  numOfKSOrbitals,
+                                                  numOfKSOrbitals));
+
+  //
+  // orthonormalized projections in the canonical basis, mapped back to the
+  // atomic orbitals by X and to the Loewdin orbitals by U_k = S^{1/2} X
+  //
+  profiler.enter("C_bar computation");
+  std::vector<double> reducedC_bar = matrixmatrixmul(coeffArrayVecOfProj,
+                                                     reducedDimOfBasis,
+                                                     numOfKSOrbitals,
+                                                     Ominushalf,
+                                                     numOfKSOrbitals,
+                                                     numOfKSOrbitals);
+  std::vector<double> C_bar        = matrixmatrixmul(X,
+                                              totalDimOfBasis,
+                                              reducedDimOfBasis,
+                                              reducedC_bar,
+                                              reducedDimOfBasis,
+                                              numOfKSOrbitals);
+  profiler.leave("C_bar computation");
+  profiler.addFlops("C_bar computation",
+                    populationProfiler::gemmFlops(reducedDimOfBasis,
+                                                  numOfKSOrbitals,
+                                                  numOfKSOrbitals) +
+                      populationProfiler::gemmFlops(totalDimOfBasis,
+                                                    numOfKSOrbitals,
+                                                    reducedDimOfBasis));
+
+  if (writePopulationFiles && this_mpi_process == 0)
     {
-      if(j >=i)
-      {
-        S[i*totalDimOfBasis+j] = upperTriaOfS[Scount];
-        S[j*totalDimOfBasis +i] = S[i*totalDimOfBasis+j];
-        Scount++;
-      }
-      pcout<<S[j*totalDimOfBasis +i]<<" ";
+      writeVectorAs2DMatrix(C_bar,
+                            totalDimOfBasis,
+                            numOfKSOrbitals,
+                            "FePOP_v1.txt");
     }
-      pcout<<std::endl;
-   } */
-auto Sserial =
-    selfMatrixTmatrixmul(scaledOrbitalValues_FEnodes, n_dofs, totalDimOfBasis);
-  std::vector<std::complex<double>> S((totalDimOfBasis *totalDimOfBasis
-                                    ),
-                                   std::complex<double> (0.0,0.0));
-  MPI_Allreduce(&Sserial[0],
-                &S[0],
-                totalDimOfBasis *totalDimOfBasis,
-                dataTypes::mpi_type_id(&Sserial[0]),
-                MPI_SUM,
-                MPI_COMM_WORLD);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerScompute = MPI_Wtime() - timerScompute;
-  pcout<<" Computing S matrix: "<<timerScompute<<std::endl;
-  if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+
+  profiler.enter("C_hat computation");
+  std::vector<double> C_hat = matrixmatrixmul(Uk,
+                                              totalDimOfBasis,
+                                              reducedDimOfBasis,
+                                              reducedC_bar,
+                                              reducedDimOfBasis,
+                                              numOfKSOrbitals);
+  profiler.leave("C_hat computation");
+  profiler.addFlops("C_hat computation",
+                    populationProfiler::gemmFlops(totalDimOfBasis,
+                                                  numOfKSOrbitals,
+                                                  reducedDimOfBasis));
+  if (writePopulationFiles && this_mpi_process == 0)
     {
-      //writeVectorToFile(S, "overlapMatrixComplex.txt");
-          writeVectorAs2DMatrix(S,
-                                totalDimOfBasis,
-                                totalDimOfBasis,
-                                "overlapMatrixComplex.txt");
+      writeVectorAs2DMatrix(C_hat,
+                            totalDimOfBasis,
+                            numOfKSOrbitals,
+                            "FePHP_v1.txt");
     }
-  pcout<<"Elements of  S: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
-    {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<S[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-
-  std::vector<double> D(totalDimOfBasis,0.0);
-  std::vector<std::complex<double>> U(totalDimOfBasis*totalDimOfBasis,std::complex<double> (0,0));
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSdiagonalization = MPI_Wtime();
-  if(this_mpi_process == 0)
-    U = diagonalization(S,totalDimOfBasis,D);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSdiagonalization = MPI_Wtime() - timerSdiagonalization;
-  pcout<<"Diagonalization of S: "<<timerSdiagonalization<<std::endl;
-    MPI_Bcast(
-      &(D[0]), totalDimOfBasis, dataTypes::mpi_type_id(&D[0]), 0, MPI_COMM_WORLD); 
-    MPI_Bcast(
-      &(U[0]), totalDimOfBasis*totalDimOfBasis, dataTypes::mpi_type_id(&U[0]), 0, MPI_COMM_WORLD);       
-  pcout<<"Eigenvalues of S: "<<std::endl;
-  for (int i = 0; i < totalDimOfBasis; i++)
-    pcout<<D[i]<<" ";
-  pcout<<std::endl;
-  pcout<<"Eigenvectors of S: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
+
+  profiler.enter("Hproj computation");
+  auto Hproj_orbital = computeHprojOrbital(
+    C_hat, C_hat, totalDimOfBasis, numOfKSOrbitals, energyLevelsKS);
+  profiler.leave("Hproj computation");
+  profiler.addFlops("Hproj computation",
+                    populationProfiler::gemmFlops(totalDimOfBasis,
+                                                  totalDimOfBasis,
+                                                  numOfKSOrbitals));
+
+  if (writePopulationFiles && this_mpi_process == 0)
     {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<U[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
+      writeVectorAs2DMatrix(Hproj_orbital,
+                            totalDimOfBasis,
+                            totalDimOfBasis,
+                            "Hproj_orbital.txt");
+    }
+
+  //
+  // atom pair populations and ICOHP of the occupied projected bands for
+  // the irreducible atom pairs, accumulated for computePopulationAnalysis()
+  //
+  profiler.enter("Atom pair populations");
+  accumulateSelectedAtomPairContractions(C_bar,
+                                         S,
+                                         occupationNum,
+                                         totalDimOfBasis,
+                                         numOfKSOrbitals,
+                                         atomwiseGlobalbasisNum,
+                                         representativePairs,
+                                         populationWeight,
+                                         representativePopulations);
+  accumulateSelectedAtomPairContractions(C_hat,
+                                         Hproj_orbital,
+                                         occupationNum,
+                                         totalDimOfBasis,
+                                         numOfKSOrbitals,
+                                         atomwiseGlobalbasisNum,
+                                         representativePairs,
+                                         populationWeight,
+                                         representativeICOHP);
+  pairSymmetry.scatter(representativePopulations, pairPopulations);
+  pairSymmetry.scatter(representativeICOHP, pairICOHP);
+  profiler.leave("Atom pair populations");
+
+  std::vector<double>().swap(Hproj_orbital);
+  std::vector<double>().swap(C_hat);
+  std::vector<double>().swap(C_bar);
+  std::vector<double>().swap(reducedC_bar);
+  std::vector<double>().swap(O);
+  std::vector<double>().swap(U_O);
 
-  MPI_Barrier(MPI_COMM_WORLD);
+  pcout
+    << "--------------------------COHP Data Saved------------------------------"
+    << std::endl;
+  if (writePopulationFiles && this_mpi_process == 0)
+    {
+      // writing the energy levels and the occupation numbers
+      unsigned int  kPointDummy = 0;
+      std::ofstream energyLevelsOccNumsFile("energyLevelsOccNums.txt");
 
+      if (energyLevelsOccNumsFile.is_open())
+        {
+          for (unsigned int i = 0; i < eigenValues[0].size(); ++i)
+            {
+              const double partialOccupancy =
+                dftUtils::getPartialOccupancy(eigenValues[kPointDummy][i],
+                                              fermiEnergy,
+                                              C_kb,
+                                              d_dftParamsPtr->TVal);
+
+              energyLevelsOccNumsFile << eigenValues[kPointDummy][i] << " "
+                                      << partialOccupancy << '\n';
+            }
 
-   timerUStranspose = MPI_Wtime();
-  std::vector<std::complex<double>> Ut = TransposeMatrix(U,totalDimOfBasis);
-   MPI_Barrier(MPI_COMM_WORLD);
-   timerUStranspose = MPI_Wtime()-timerUStranspose;
+          energyLevelsOccNumsFile.close();
+        }
 
+      else
+        pcout << "couldn't open energyLevelsOccNums.txt file!\n";
+    }
+#endif
 
-  MPI_Barrier(MPI_COMM_WORLD);
-  std::vector<std::complex<double>> S2 = powerOfMatrix(1,D,Ut,totalDimOfBasis,Ut);
-  pcout<<"Elements of  S2: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
-    {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<S2[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-   timerSinverse = MPI_Wtime();   
-  std::vector<std::complex<double>> invS = powerOfMatrix(-1,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSinverse = MPI_Wtime()-timerSinverse;
-  pcout<<" Computing S^-1: "<<timerSinverse<<std::endl;
-  pcout<<"Elements of invserse S: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
-    {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<invS[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-  std::vector<std::complex<double>> Identity = matrixmatrixmul(invS,totalDimOfBasis,totalDimOfBasis,S,totalDimOfBasis,totalDimOfBasis);
-  pcout<<"Elements of identity: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
-    {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<Identity[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-  std::vector<double> Dinv(totalDimOfBasis,0.0);
-  std::vector<std::complex<double>> Uinv(totalDimOfBasis*totalDimOfBasis,std::complex<double> (0,0));
-  if(this_mpi_process == 0)
-    Uinv = diagonalization(invS,totalDimOfBasis,Dinv);
-    MPI_Bcast(
-      &(Dinv[0]), totalDimOfBasis, dataTypes::mpi_type_id(&D[0]), 0, MPI_COMM_WORLD); 
-    MPI_Bcast(
-      &(Uinv[0]), totalDimOfBasis*totalDimOfBasis, dataTypes::mpi_type_id(&U[0]), 0, MPI_COMM_WORLD);        
-  pcout<<"Eigenvalues of invS: "<<std::endl;
-  for (int i = 0; i < numOfKSOrbitals; i++)
-    pcout<<Dinv[i]<<" ";
-  pcout<<std::endl;
-  pcout<<"Eigenvectors of invS: "<<std::endl;
-  for(int i = 0;i < numOfKSOrbitals; i++)
-    {
-      for(int j = 0; j < numOfKSOrbitals; j++)
-        pcout<<Uinv[i*numOfKSOrbitals+j]<<" ";
-      pcout<<std::endl;  
-    } 
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerSminushalf = MPI_Wtime();
-  std::vector<std::complex<double>> Sminushalf = powerOfMatrix(-0.5,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSminushalf = MPI_Wtime() - timerSminushalf;
-  
-
-  MPI_Barrier(MPI_COMM_WORLD);
-   timerShalf = MPI_Wtime();
-  std::vector<std::complex<double>> Shalf = powerOfMatrix(0.5,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerShalf = MPI_Wtime() - timerShalf;  
-  pcout<<" Computing S^0.5: "<<timerShalf<<std::endl;
-  pcout<<"Elements of  S^0.5: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
-    {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<Shalf[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerPhiTPsi = MPI_Wtime();
-      std::vector<std::complex<double>> arrayVecOfProjserial =
-        matrixTmatrixmul(scaledOrbitalValues_FEnodes,
-                         n_dofs,
-                         totalDimOfBasis,
-                         scaledKSOrbitalValues_FEnodes,
-                         n_dofs,
-                         numOfKSOrbitals);
-      std::vector<std::complex<double>> arrayVecOfProj(totalDimOfBasis * numOfKSOrbitals,
-                                         std::complex<double> (0.0,0.0));
-      MPI_Allreduce(&arrayVecOfProjserial[0],
-                    &arrayVecOfProj[0],
-                    (totalDimOfBasis * numOfKSOrbitals),
-                     dataTypes::mpi_type_id(&arrayVecOfProjserial[0]),
-                    MPI_SUM,
-                    MPI_COMM_WORLD);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerPhiTPsi = MPI_Wtime() - timerPhiTPsi;
-      pcout<<"Computing PHI^TPSI: "<<timerPhiTPsi<<std::endl;
-      pcout << "Matrix of projections with atomic orbitals: \n";
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerCcompute = MPI_Wtime();
-      std::vector<std::complex<double>> coeffArrayVecOfProj = matrixmatrixmul(invS,
-                                                 totalDimOfBasis,
-                                                 totalDimOfBasis,
-                                                 arrayVecOfProj,
-                                                 totalDimOfBasis,
-                                                 numOfKSOrbitals);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerCcompute = MPI_Wtime() - timerCcompute;  
-      pcout<<"Computing C: "<<timerCcompute<<std::endl;
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerOcompute = MPI_Wtime();
-      std::vector<std::complex<double>> B = matrixTmatrixmul(coeffArrayVecOfProj,totalDimOfBasis,numOfKSOrbitals,S,totalDimOfBasis,totalDimOfBasis);
-      std::vector<std::complex<double>> O = matrixmatrixmul(B,numOfKSOrbitals,totalDimOfBasis,coeffArrayVecOfProj,totalDimOfBasis,numOfKSOrbitals);                                               
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerOcompute = MPI_Wtime() -timerOcompute;
-      pcout<<" Computing O: "<<timerOcompute<<std::endl;
-        pcout<<"Elements of  O: "<<std::endl;
-  for(int i = 0;i < numOfKSOrbitals; i++)
-    {
-      for(int j = 0; j < numOfKSOrbitals; j++)
-        pcout<<O[i*numOfKSOrbitals+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-      std::vector<double> D_O(numOfKSOrbitals,0.0);
-      std::vector<std::complex<double>> U_O(numOfKSOrbitals*numOfKSOrbitals,std::complex<double>(0.0,0.0));
-      
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerOdiagnolaization = MPI_Wtime();
-       if(this_mpi_process == 0)
-	U_O =  diagonalization(O,numOfKSOrbitals,D_O);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerOdiagnolaization = MPI_Wtime()-timerOdiagnolaization; 
-    pcout<<" Diagonalization of O: "<<timerOdiagnolaization<<std::endl;     
-    MPI_Bcast(
-      &(D_O[0]), numOfKSOrbitals, dataTypes::mpi_type_id(&D_O[0]), 0, MPI_COMM_WORLD); 
-    MPI_Bcast(
-      &(U_O[0]), numOfKSOrbitals*numOfKSOrbitals, dataTypes::mpi_type_id(&U_O[0]), 0, MPI_COMM_WORLD); 
-     MPI_Barrier(MPI_COMM_WORLD);
-     timerOdiagnolaization = MPI_Wtime()-timerOdiagnolaization;
-  pcout<<"Eigenvalues of O: "<<std::endl;
-  for (int i = 0; i < numOfKSOrbitals; i++)
-    pcout<<D_O[i]<<" ";
-  pcout<<std::endl;
-  pcout<<"Eigenvectors of O: "<<std::endl;
-  for(int i = 0;i < numOfKSOrbitals; i++)
-    {
-      for(int j = 0; j < numOfKSOrbitals; j++)
-        pcout<<U_O[i*numOfKSOrbitals+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-  MPI_Barrier(MPI_COMM_WORLD);
-   timerUOtranspose = MPI_Wtime();
-  std::vector<std::complex<double>> U_Ot = TransposeMatrix(U_O,numOfKSOrbitals);
-   MPI_Barrier(MPI_COMM_WORLD);
-   timerUOtranspose = MPI_Wtime()-timerUOtranspose;  
-  
-  
-  
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerOminushalf = MPI_Wtime();
-      std::vector<std::complex<double>> Ominushalf = powerOfMatrix(-0.5,D_O,U_Ot,numOfKSOrbitals,U_Ot);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerOminushalf = MPI_Wtime() - timerOminushalf;
-      pcout<<" Computing O^-0.5: "<<timerOminushalf<<std::endl;
-  std::vector<std::complex<double>> Dpow(numOfKSOrbitals*numOfKSOrbitals,std::complex<double> (0.0,0.0));
-  for(int i = 0; i < numOfKSOrbitals; i++)
-    Dpow[i*numOfKSOrbitals+i].real(pow(D_O[i],-0.5)) ;
-  for (int i = 0; i < numOfKSOrbitals; i++)
-    pcout<<Dpow[i*numOfKSOrbitals+i]<<" ";
-  pcout<<std::endl;
-  pcout<<"Elements of O^-0.5: "<<std::endl;
-  for(int i = 0;i < numOfKSOrbitals; i++)
+  //
+  // orbital resolved weights of the projected Kohn-Sham orbitals
+  // S^{-1} Phi^H Psi = X C for the pDOS and fat bands
+  //
+  if (orbitalWeights != nullptr)
     {
-      for(int j = 0; j < numOfKSOrbitals; j++)
-        pcout<<Ominushalf[i*numOfKSOrbitals+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;      
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerCbarcompute = MPI_Wtime();
-      std::vector<std::complex<double>> C_bar = matrixmatrixmul(coeffArrayVecOfProj,totalDimOfBasis,numOfKSOrbitals,
-                                    Ominushalf,numOfKSOrbitals,numOfKSOrbitals);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerCbarcompute = MPI_Wtime() - timerCbarcompute;
-      pcout<<" Computing Cbar: "<<timerCbarcompute<<std::endl;
-
-      if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+      profiler.enter("Orbital weights");
+      if (d_dftParamsPtr->populationPdosWeights == "MULLIKEN")
         {
-          writeVectorAs2DMatrix(C_bar,
-                                totalDimOfBasis,
-                                numOfKSOrbitals,
-                                "FePOP_v1Complex.txt");
-          // printVector(CoeffofOrthonormalisedKSonAO);
+          const auto coeffsOfBasis = matrixmatrixmul(X,
+                                                     totalDimOfBasis,
+                                                     reducedDimOfBasis,
+                                                     coeffArrayVecOfProj,
+                                                     reducedDimOfBasis,
+                                                     numOfKSOrbitals);
+          const auto SCoeffsOfBasis = matrixmatrixmul(S,
+                                                      totalDimOfBasis,
+                                                      totalDimOfBasis,
+                                                      coeffsOfBasis,
+                                                      totalDimOfBasis,
+                                                      numOfKSOrbitals);
+          *orbitalWeights = orbitalWeightsOfProjection(coeffsOfBasis,
+                                                       SCoeffsOfBasis,
+                                                       totalDimOfBasis,
+                                                       numOfKSOrbitals);
         }
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerChatcompute = MPI_Wtime();
-      std::vector<std::complex<double>> C_hat = matrixmatrixmul(Shalf,totalDimOfBasis,totalDimOfBasis,C_bar,totalDimOfBasis,numOfKSOrbitals);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerChatcompute = MPI_Wtime() - timerChatcompute; 
-      pcout<<" Computing Chat: "<<timerChatcompute<<std::endl;
-      if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+      else
         {
-          writeVectorAs2DMatrix(C_hat,
-                                totalDimOfBasis,
-                                numOfKSOrbitals,
-                                "FePHP_v1Complex.txt");
+          // S^{1/2} X C = U_k C
+          const auto lowdinCoeffs = matrixmatrixmul(Uk,
+                                                    totalDimOfBasis,
+                                                    reducedDimOfBasis,
+                                                    coeffArrayVecOfProj,
+                                                    reducedDimOfBasis,
+                                                    numOfKSOrbitals);
+          *orbitalWeights = orbitalWeightsOfProjection(lowdinCoeffs,
+                                                       lowdinCoeffs,
+                                                       totalDimOfBasis,
+                                                       numOfKSOrbitals);
         }
+      profiler.leave("Orbital weights");
+    }
 
-        MPI_Barrier(MPI_COMM_WORLD);
-         timerHprojOrbital = MPI_Wtime();
-        std::vector<std::complex<double>> Hproj_orbital = computeHprojOrbital(C_hat,C_hat,
-                                               totalDimOfBasis,
-                                               numOfKSOrbitals,
-                                               eigenValues[kpoint]);
-        MPI_Barrier(MPI_COMM_WORLD);
-        timerHprojOrbital = MPI_Wtime()-timerHprojOrbital;                                       
-        pcout<<" Computing Projected Hamiltonian: "<<timerHprojOrbital<<std::endl;
-      
-      
-      if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
-        {
-          writeVectorAs2DMatrix(Hproj_orbital,
-                                totalDimOfBasis,
-                                totalDimOfBasis,
-                                "Hproj_orbitalCOmplex.txt");
-        } 
-      // Compute projected Hamiltonian of FE discretized Hamiltonian into
-      
-        Hproj_orbital.clear();
-	C_hat.clear();
-	C_bar.clear();	
-	O.clear();
-	U_O.clear();
-	B.clear();
-	
-	std::vector<std::complex<double>>().swap(Hproj_orbital);
-	std::vector<std::complex<double>>().swap(C_hat);
-	std::vector<std::complex<double>>().swap(C_bar);
-	std::vector<std::complex<double>>().swap(O);
-	std::vector<std::complex<double>>().swap(U_O);
-	std::vector<std::complex<double>>().swap(B);
-
-	pcout
-        << "--------------------------COHP Data Saved------------------------------"
-        << std::endl;
-      MPI_Barrier(MPI_COMM_WORLD);
-      if (this_mpi_process == 0)
-        {
-          // writing the energy levels and the occupation numbers
-          unsigned int  kPointDummy = 0;
-          std::ofstream energyLevelsOccNumsFile("energyLevelsOccNums.txt");
+  //
+  // projectabilities diag(C^H C) from the coefficients in the orthonormal
+  // canonical basis, distributed over the bands
+  //
+  profiler.enter("Spill factors");
+  std::vector<double> projectabilities =
+    projectabilitiesOfProjection(coeffArrayVecOfProj,
+                                 coeffArrayVecOfProj,
+                                 reducedDimOfBasis,
+                                 numOfKSOrbitals,
+                                 mpi_communicator);
+  const spillFactors spill =
+    spillFactorsFromProjectabilities(projectabilities, occupationNum);
+  profiler.leave("Spill factors");
+  profiler.addFlops("Spill factors",
+                    2.0 * reducedDimOfBasis * numOfKSOrbitals);
+
+  pcout << "\n-------------------------------------------------------\n";
+  pcout << "Projected SpillFactors are:" << std::endl;
+  pcout << "Number of Filled KS orbitals: "
+        << numberOfFilledBands(occupationNum) << std::endl;
+  pcout << "TSF: " << spill.totalSpilling << std::endl;
+  pcout << "TSFabs: " << spill.absTotalSpilling << std::endl;
+  pcout << "CSF: " << spill.occupiedBandsSpilling << std::endl;
+  pcout << "CSFabs: " << spill.absOccupiedBandsSpilling << std::endl;
+  pcout << "fCSF: " << spill.chargeSpilling << std::endl;
+  pcout << "fCSFabs: " << spill.absChargeSpilling << std::endl;
+  pcout << "\n-------------------------------------------------------\n";
+
+  if (writePopulationFiles)
+    profiler.writeReport("populationProfile.json", pcout);
+
+  return projectabilities;
+}
+
+
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::writeProjectabilitiesAndSpillFactors(
+  const std::vector<std::vector<double>> &projectabilitiesOfKPoints,
+  const std::vector<std::vector<double>> &eigenValuesInput)
+{
+  const unsigned int numSpins = 1 + d_dftParamsPtr->spinPolarized;
+
+  //
+  // occupations of the local k-points, with a constrained magnetization
+  // every spin has its own Fermi energy
+  //
+  std::vector<std::vector<double>> occupationsOfKPoints(
+    projectabilitiesOfKPoints.size());
+  for (unsigned int kPointSpin = 0;
+       kPointSpin < projectabilitiesOfKPoints.size();
+       ++kPointSpin)
+    {
+      const unsigned int kPoint    = kPointSpin / numSpins;
+      const unsigned int spinIndex = kPointSpin % numSpins;
+      const unsigned int numEigenValues =
+        eigenValuesInput[kPoint].size() / numSpins;
+      const double fermiEnergySpin =
+        !d_dftParamsPtr->constraintMagnetization ?
+          fermiEnergy :
+          (spinIndex == 0 ? fermiEnergyUp : fermiEnergyDown);
+      occupationsOfKPoints[kPointSpin].resize(
+        projectabilitiesOfKPoints[kPointSpin].size());
+      for (unsigned int iBand = 0;
+           iBand < occupationsOfKPoints[kPointSpin].size();
+           ++iBand)
+        occupationsOfKPoints[kPointSpin][iBand] =
+          dftUtils::getPartialOccupancy(
+            eigenValuesInput[kPoint][spinIndex * numEigenValues + iBand],
+            fermiEnergySpin,
+            C_kb,
+            d_dftParamsPtr->TVal);
+    }
+
+  //
+  // k-point weighted totals, the local k-points of every pool are summed
+  // and the sums reduced over the pools
+  //
+  double weightSum = 0.0, totalSpilling = 0.0, occupiedBandsSpilling = 0.0,
+         chargeSpilling = 0.0;
+  for (unsigned int kPointSpin = 0;
+       kPointSpin < projectabilitiesOfKPoints.size();
+       ++kPointSpin)
+    {
+      const spillFactors spill =
+        spillFactorsFromProjectabilities(projectabilitiesOfKPoints[kPointSpin],
+                                         occupationsOfKPoints[kPointSpin]);
+      const double weight = d_kPointWeights[kPointSpin / numSpins];
+      weightSum += weight;
+      totalSpilling += weight * spill.totalSpilling;
+      occupiedBandsSpilling += weight * spill.occupiedBandsSpilling;
+      chargeSpilling += weight * spill.chargeSpilling;
+    }
 
-          if (energyLevelsOccNumsFile.is_open())
+  //
+  // projectabilities of the bands, the pools append their k-points one
+  // after the other
+  //
+  if (d_dftParamsPtr->writePopulationFiles)
+    {
+      const bool isPoolWriter =
+        Utilities::MPI::this_mpi_process(mpi_communicator) == 0 &&
+        Utilities::MPI::this_mpi_process(interBandGroupComm) == 0;
+      const unsigned int thisPool =
+        Utilities::MPI::this_mpi_process(interpoolcomm);
+      for (unsigned int ipool = 0;
+           ipool < Utilities::MPI::n_mpi_processes(interpoolcomm);
+           ++ipool)
+        {
+          if (isPoolWriter && ipool == thisPool)
             {
-              for (unsigned int i = 0; i < eigenValues[0].size(); ++i)
+              std::ofstream projectabilitiesFile(
+                "projectabilities.txt",
+                ipool == 0 ? std::ofstream::out : std::ofstream::app);
+              if (ipool == 0)
+                projectabilitiesFile << "# kPoint spin weight band energy "
+                                        "occupation projectability\n";
+              projectabilitiesFile << std::setprecision(10);
+              for (unsigned int kPointSpin = 0;
+                   kPointSpin < projectabilitiesOfKPoints.size();
+                   ++kPointSpin)
                 {
-                  const double partialOccupancy =
-                    dftUtils::getPartialOccupancy(eigenValues[kPointDummy][i],
-                                                  fermiEnergy,
-                                                  C_kb,
-                                                  d_dftParamsPtr->TVal);
-
-                  energyLevelsOccNumsFile << eigenValues[kPointDummy][i] << " "
-                                          << partialOccupancy << '\n';
+                  const unsigned int kPoint    = kPointSpin / numSpins;
+                  const unsigned int spinIndex = kPointSpin % numSpins;
+                  const unsigned int numEigenValues =
+                    eigenValuesInput[kPoint].size() / numSpins;
+                  for (unsigned int iBand = 0;
+                       iBand < projectabilitiesOfKPoints[kPointSpin].size();
+                       ++iBand)
+                    projectabilitiesFile
+                      << lowerBoundKindex + kPoint << " " << spinIndex << " "
+                      << d_kPointWeights[kPoint] << " " << iBand << " "
+                      << eigenValuesInput[kPoint]
+                                         [spinIndex * numEigenValues + iBand]
+                      << " " << occupationsOfKPoints[kPointSpin][iBand] << " "
+                      << projectabilitiesOfKPoints[kPointSpin][iBand] << '\n';
                 }
-
-              energyLevelsOccNumsFile.close();
             }
-
-          else
-            pcout << "couldn't open energyLevelsOccNums.txt file!\n";
-        }
-      if (this_mpi_process == 0)
-        {
-          pcout
-            << "\n-------------------------------------------------------\n";
-          pcout << "Projected SpillFactors are:" << std::endl;
-          spillFactorsofProjectionwithCS(coeffArrayVecOfProj,
-                                         S,
-                                         occupationNum,
-                                         totalDimOfBasis,
-                                         numOfKSOrbitals,
-                                         totalDimOfBasis,
-                                         totalDimOfBasis);
-          pcout
-            << "\n-------------------------------------------------------\n";
+          MPI_Barrier(interpoolcomm);
         }
+    }
 
+  weightSum             = Utilities::MPI::sum(weightSum, interpoolcomm);
+  totalSpilling         = Utilities::MPI::sum(totalSpilling, interpoolcomm);
+  occupiedBandsSpilling = Utilities::MPI::sum(occupiedBandsSpilling,
+                                              interpoolcomm);
+  chargeSpilling        = Utilities::MPI::sum(chargeSpilling, interpoolcomm);
+
+  pcout << "k-point weighted spill factors over "
+        << Utilities::MPI::sum((unsigned int)projectabilitiesOfKPoints.size() /
+                                 numSpins,
+                               interpoolcomm)
+        << " k-points:" << std::endl;
+  pcout << "TSF: " << totalSpilling / weightSum << std::endl;
+  pcout << "CSF: " << occupiedBandsSpilling / weightSum << std::endl;
+  pcout << "fCSF: " << chargeSpilling / weightSum << std::endl;
+
+  d_populationAnalysisResults.totalSpilling         = totalSpilling / weightSum;
+  d_populationAnalysisResults.occupiedBandsSpilling =
+    occupiedBandsSpilling / weightSum;
+  d_populationAnalysisResults.chargeSpilling = chargeSpilling / weightSum;
+}
 
 
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::copyEigenVectorsToHost()
+{
+#ifdef DFTFE_WITH_DEVICE
+  // solve() only copies the eigenvectors to the host for the output options
+  if (d_dftParamsPtr->useDevice)
+    for (unsigned int kPoint = 0;
+         kPoint < (1 + d_dftParamsPtr->spinPolarized) * d_kPointWeights.size();
+         ++kPoint)
+      {
+        d_eigenVectorsFlattenedDevice.copyTo<dftfe::utils::MemorySpace::HOST>(
+          &d_eigenVectorsFlattenedSTL[kPoint][0],
+          d_eigenVectorsFlattenedSTL[kPoint].size(),
+          (kPoint * d_eigenVectorsFlattenedSTL[0].size()),
+          0);
+      }
+#endif
+}
 
-#else
 
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::computePopulationAnalysis()
+{
+  copyEigenVectorsToHost();
+
+  const unsigned int numAtoms = atomLocations.size();
+  d_populationAnalysisResults          = populationAnalysisResults();
+  d_populationAnalysisResults.numAtoms = numAtoms;
+  d_populationAnalysisResults.atomPairPopulations.assign(numAtoms * numAtoms,
+                                                         0.0);
+  d_populationAnalysisResults.atomPairICOHP.assign(numAtoms * numAtoms, 0.0);
+
+  // irreducible atom pairs of the current atoms and k-points
+  updatePopulationPairSymmetry();
+
+  const unsigned int numSpins = 1 + d_dftParamsPtr->spinPolarized;
+  const bool         computeOrbitalWeights =
+    d_dftParamsPtr->populationPdosWeights != "NONE";
+  std::vector<std::vector<double>> projectabilitiesOfKPoints(
+    d_kPointWeights.size() * numSpins);
+  std::vector<std::vector<double>> orbitalWeightsOfKPoints(
+    d_kPointWeights.size() * numSpins);
+  for (unsigned int kpt = 0; kpt < d_kPointWeights.size(); kpt++)
+    for (unsigned int spin = 0; spin < numSpins; spin++)
+      {
+        d_kohnShamDFTOperatorPtr->reinitkPointSpinIndex(kpt, spin);
+        projectabilitiesOfKPoints[numSpins * kpt + spin] =
+          orbitalPopulationCompute(
+            eigenValues,
+            kpt,
+            spin,
+            computeOrbitalWeights ?
+              &orbitalWeightsOfKPoints[numSpins * kpt + spin] :
+              nullptr);
+      }
+  writeProjectabilitiesAndSpillFactors(projectabilitiesOfKPoints, eigenValues);
+  if (computeOrbitalWeights)
+    writePopulationPdos(orbitalWeightsOfKPoints, eigenValues);
 
-  for (unsigned int dof = 0; dof < n_dofs; ++dof)
+  //
+  // orbitalPopulationCompute only reduces over the FE domain of a pool and
+  // sums the local k-points of the pool, the pools are reduced here
+  //
+  std::vector<double> &pairPopulations =
+    d_populationAnalysisResults.atomPairPopulations;
+  std::vector<double> &pairICOHP = d_populationAnalysisResults.atomPairICOHP;
+  Utilities::MPI::sum(pairPopulations, interpoolcomm, pairPopulations);
+  Utilities::MPI::sum(pairICOHP, interpoolcomm, pairICOHP);
+
+  d_populationAnalysisResults.grossPopulations.assign(numAtoms, 0.0);
+  d_populationAnalysisResults.atomCharges.assign(numAtoms, 0.0);
+  for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
     {
-      // get nodeID
-      const dealii::types::global_dof_index dofID = locallyOwnedDOFs[dof];
-      if (!constraintsNone.is_constrained(dofID))
-        {
-          // get coordinates of the finite-element node
-          Point<3> node = d_supportPoints[dofID];
-
-          auto count1 = totalDimOfBasis * dof;
-
-          for (unsigned int i = 0; i < totalDimOfBasis; ++i)
-            {
-              auto atomTypeID   = globalBasisInfo[i].atomTypeID;
-              auto atomChargeID = globalBasisInfo[i].atomID;
+      double grossPopulation = 0.0;
+      for (unsigned int jAtom = 0; jAtom < numAtoms; ++jAtom)
+        grossPopulation += pairPopulations[iAtom * numAtoms + jAtom];
+      d_populationAnalysisResults.grossPopulations[iAtom] = grossPopulation;
+      d_populationAnalysisResults.atomCharges[iAtom] =
+        atomLocations[iAtom][1] - grossPopulation;
+    }
 
-              std::vector<int> imageIdsList;
-              if (d_dftParamsPtr->periodicX || d_dftParamsPtr->periodicY ||
-                  d_dftParamsPtr->periodicZ)
-                
-                {
-                  imageIdsList = d_globalChargeIdToImageIdMap[atomChargeID];
-                }
-              else
-                {
-                  imageIdsList.push_back(atomChargeID);
-                }
- 
-                   OrbitalQuantumNumbers orbital = {globalBasisInfo[i].n,
-                                                   globalBasisInfo[i].l,
-                                                   globalBasisInfo[i].m};
-              //pcout<<"imageIdsList.size(): "<<imageIdsList.size()<<std::endl;
-              int counterlist = 0;
-              for (int imageID = 0; imageID < imageIdsList.size(); imageID++)
-                {
-                  int                 chargeId = imageIdsList[imageID];
-                  std::vector<double> atomPos(3, 0.0);
-                  if (chargeId < numOfAtoms)
-                    {
-                      atomPos[0] = atomLocations[chargeId][2];
-                      atomPos[1] = atomLocations[chargeId][3];
-                      atomPos[2] = atomLocations[chargeId][4];
-                    }
-                  else
-                    {
-                      atomPos[0] = d_imagePositions[chargeId - numOfAtoms][0];
-                      atomPos[1] = d_imagePositions[chargeId - numOfAtoms][1];
-                      atomPos[2] = d_imagePositions[chargeId - numOfAtoms][2];
-                    }
-                    auto relativeEvalPoint = relativeVector3d(node, atomPos);
+  pcout << "Mulliken charges of the projected occupied bands (atomID, gross "
+           "population, charge):"
+        << std::endl;
+  for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+    pcout << iAtom << " "
+          << d_populationAnalysisResults.grossPopulations[iAtom] << " "
+          << d_populationAnalysisResults.atomCharges[iAtom] << std::endl;
+}
 
-                    convertCartesianToSpherical(relativeEvalPoint, r, theta, phi);
-                 
-                  if(atomTypewiseSTOvector[atomTypeID].maxRadialcutoff < 0 || r <= atomTypewiseSTOvector[atomTypeID].maxRadialcutoff)
-                  {
-                    counterlist++;
-                  if (d_dftParamsPtr->AtomicOrbitalBasis == 1)
-                    {
-                      scaledOrbitalValues_FEnodes[count1 + i] +=
-                        d_kohnShamDFTOperatorPtr->d_sqrtMassVector
-                          .local_element(dof) *
-                        atomTypewiseSTOvector[atomTypeID].bungeOrbital(orbital,
-                                                                       node,
-                                                                       atomPos);
-                    }
-                  if (d_dftParamsPtr->AtomicOrbitalBasis == 0)
-                    {
-                      scaledOrbitalValues_FEnodes[count1 + i] +=
-                        d_kohnShamDFTOperatorPtr->d_sqrtMassVector
-                          .local_element(dof) *
-                        atomTypewiseSTOvector[atomTypeID]
-                          .PseudoAtomicOrbitalvalue(orbital, node, atomPos,r,theta,phi);
-                    }
-                  }  
-                  
-                }
-                SumCounter+=counterlist;
-            }
-        
-      //pcout<<" Line No 1099"<<" "<<d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof)<<std::endl; 
-      auto count2 = numOfKSOrbitals * dof;
 
-      for (unsigned int j = 0; j < numOfKSOrbitals; ++j)
-        {
-          if (d_dftParamsPtr->spinPolarized == 1)
-            {
-              scaledKSOrbitalValues_FEnodes_spinup[count2 + j] =
-                d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[0][dof * d_numEigenValues + j];
-              // pcout<<"Accessing spin down"<<std::endl;
-              scaledKSOrbitalValues_FEnodes_spindown[count2 + j] =
-                d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[1][dof * d_numEigenValues + j];
-            }
-          else
-            {
-              scaledKSOrbitalValues_FEnodes[count2 + j] =
-                d_kohnShamDFTOperatorPtr->d_sqrtMassVector.local_element(dof) *
-                d_eigenVectorsFlattenedSTL[0][dof * d_numEigenValues + j];
-            }
-        }}
-    }
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::scfPopulationCharges(
+  const unsigned int scfIter)
+{
+  TimerOutput::Scope scope(computing_timer, "SCF population charges");
+  copyEigenVectorsToHost();
 
+  const unsigned int numAtoms = atomLocations.size();
+  const unsigned int numSpins = 1 + d_dftParamsPtr->spinPolarized;
+  const unsigned int numOfKSOrbitals =
+    std::min(d_dftParamsPtr->NumofKSOrbitalsproj, d_numEigenValues);
 
+  std::vector<IndexSet::size_type> locallyOwnedDOFs;
+  dofHandler.locally_owned_dofs().fill_index_vector(locallyOwnedDOFs);
+  const unsigned int n_dofs = locallyOwnedDOFs.size();
 
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerCreatingMatrices = MPI_Wtime() - timerCreatingMatrices;
-  pcout<<" Creating PHI and PSI matrices: "<<timerCreatingMatrices<<std::endl;
-    MPI_Allreduce(&SumCounter,
-                &SumCounter,
-                1,
-                MPI_INT,
-                MPI_SUM,
-                MPI_COMM_WORLD);  
-  pcout<<"Sum of Counter: "<<SumCounter;
-  MPI_Barrier(MPI_COMM_WORLD);
-   timerScompute = MPI_Wtime();  
-  auto upperTriaOfSserial =
-    selfMatrixTmatrixmul(scaledOrbitalValues_FEnodes, n_dofs, totalDimOfBasis);
-  std::vector<double> upperTriaOfS((totalDimOfBasis * (totalDimOfBasis + 1) /
-                                    2),
-                                   0.0);
-  MPI_Allreduce(&upperTriaOfSserial[0],
-                &upperTriaOfS[0],
-                (totalDimOfBasis * (totalDimOfBasis + 1) / 2),
-                MPI_DOUBLE,
-                MPI_SUM,
-                MPI_COMM_WORLD);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerScompute = MPI_Wtime() - timerScompute;
-  pcout<<" Computing S matrix: "<<timerScompute<<std::endl;
-  if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+  //
+  // the atomic orbitals at the FE nodes and the factorized overlap matrix of
+  // the local k-points only depend on the atoms and the mesh and are
+  // evaluated at the first update of a ground state solve
+  //
+  if (d_scfPopulationProjections.empty())
     {
-      writeVectorToFile(upperTriaOfS, "overlapMatrix.txt");
-      // printVector(upperTriaOfS);
+      updatePopulationBasisCache();
+      std::vector<Point<3>> localPoints;
+      for (unsigned int dof = 0; dof < n_dofs; ++dof)
+        localPoints.push_back(d_supportPoints[locallyOwnedDOFs[dof]]);
+      updatePopulationNeighborList(localPoints);
+      const unsigned int totalDimOfBasis =
+        d_populationBasisCache.globalBasisInfo.size();
+      for (unsigned int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
+        {
+          std::vector<dataTypes::number> orbitalValues;
+          evaluateAtomicOrbitalsAtNodes(
+            d_populationBasisCache.globalBasisInfo,
+            d_populationBasisCache.atomTypewiseSTOvector,
+            locallyOwnedDOFs,
+            kPoint,
+            orbitalValues,
+            &d_populationBasisCache.neighborList);
+          d_scfPopulationProjections.push_back(
+            std::make_unique<cachedPopulationProjection<dataTypes::number>>(
+              orbitalValues,
+              n_dofs,
+              totalDimOfBasis,
+              d_dftParamsPtr->overlapEigenvalueThreshold,
+              mpi_communicator));
+        }
     }
-   std::vector<double> S(totalDimOfBasis*totalDimOfBasis,0.0);
-   int Scount=0;
-   for(int i = 0; i < totalDimOfBasis; i++)
-   {
-    for (int j=0; j < totalDimOfBasis; j++)
-    {
-      if(j >=i)
+
+  //
+  // one projection of the current Kohn-Sham orbitals per k-point and spin,
+  // the local k-points of every pool are summed and reduced over the pools
+  //
+  std::vector<double> mullikenPopulations(numAtoms, 0.0);
+  std::vector<double> loewdinPopulations(numAtoms, 0.0);
+  for (unsigned int kPoint = 0; kPoint < d_kPointWeights.size(); ++kPoint)
+    for (unsigned int spin = 0; spin < numSpins; ++spin)
       {
-        S[i*totalDimOfBasis+j] = upperTriaOfS[Scount];
-        S[j*totalDimOfBasis +i] = S[i*totalDimOfBasis+j];
-        Scount++;
+        const unsigned int numEigenValues =
+          eigenValues[kPoint].size() / numSpins;
+        const double fermiEnergySpin =
+          !d_dftParamsPtr->constraintMagnetization ?
+            fermiEnergy :
+            (spin == 0 ? fermiEnergyUp : fermiEnergyDown);
+        std::vector<double> occupationNum(numOfKSOrbitals, 0.0);
+        for (unsigned int iBand = 0; iBand < numOfKSOrbitals; ++iBand)
+          occupationNum[iBand] = dftUtils::getPartialOccupancy(
+            eigenValues[kPoint][spin * numEigenValues + iBand],
+            fermiEnergySpin,
+            C_kb,
+            d_dftParamsPtr->TVal);
+
+        const std::vector<dataTypes::number> scaledKSOrbitalValues =
+          scaledKohnShamOrbitalsAtNodes(
+            d_eigenVectorsFlattenedSTL[numSpins * kPoint + spin],
+            numOfKSOrbitals,
+            kPoint,
+            locallyOwnedDOFs);
+        d_scfPopulationProjections[kPoint]->accumulateAtomPopulations(
+          scaledKSOrbitalValues,
+          numOfKSOrbitals,
+          occupationNum,
+          d_populationBasisCache.atomwiseGlobalbasisNum,
+          (d_dftParamsPtr->spinPolarized == 1 ? 1.0 : 2.0) *
+            d_kPointWeights[kPoint],
+          mullikenPopulations,
+          loewdinPopulations);
       }
-    }
-   }
-  std::vector<double> D(totalDimOfBasis,0.0);
-  std::vector<double> U(totalDimOfBasis*totalDimOfBasis,0.0);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSdiagonalization = MPI_Wtime();
-  if(this_mpi_process == 0)
-    U = diagonalization(S,totalDimOfBasis,D);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSdiagonalization = MPI_Wtime() - timerSdiagonalization;
-  pcout<<"Diagonalization of S: "<<timerSdiagonalization<<std::endl;
-    MPI_Bcast(
-      &(D[0]), totalDimOfBasis, MPI_DOUBLE, 0, MPI_COMM_WORLD); 
-    MPI_Bcast(
-      &(U[0]), totalDimOfBasis*totalDimOfBasis, MPI_DOUBLE, 0, MPI_COMM_WORLD);       
-
-  pcout<<"Eigenvalues of S: "<<std::endl;
-  for (int i = 0; i < totalDimOfBasis; i++)
-    pcout<<D[i]<<" ";
-  pcout<<std::endl;
-  pcout<<"Eigenvectors of S: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
-    {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<U[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-  MPI_Barrier(MPI_COMM_WORLD);
-   timerUStranspose = MPI_Wtime();
-  auto Ut = TransposeMatrix(U,totalDimOfBasis);
-   MPI_Barrier(MPI_COMM_WORLD);
-   timerUStranspose = MPI_Wtime()-timerUStranspose;
-
-
-  MPI_Barrier(MPI_COMM_WORLD);
-   timerSinverse = MPI_Wtime();   
-  auto invS = powerOfMatrix(-1,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSinverse = MPI_Wtime()-timerSinverse;
-  pcout<<" Computing S^-1: "<<timerSinverse<<std::endl;
-  pcout<<"Elements of invserse S: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
-    {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<invS[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
- 
-
-
-
-  MPI_Barrier(MPI_COMM_WORLD);
-  double timerSminushalf = MPI_Wtime();
-  auto Sminushalf = powerOfMatrix(-0.5,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerSminushalf = MPI_Wtime() - timerSminushalf;
-  
-
-  MPI_Barrier(MPI_COMM_WORLD);
-   timerShalf = MPI_Wtime();
-  auto Shalf = powerOfMatrix(0.5,D,Ut,totalDimOfBasis,Ut);
-  MPI_Barrier(MPI_COMM_WORLD);
-  timerShalf = MPI_Wtime() - timerShalf;  
-  pcout<<" Computing S^0.5: "<<timerShalf<<std::endl;
-  pcout<<"Elements of  S^0.5: "<<std::endl;
-  for(int i = 0;i < totalDimOfBasis; i++)
+  Utilities::MPI::sum(mullikenPopulations, interpoolcomm, mullikenPopulations);
+  Utilities::MPI::sum(loewdinPopulations, interpoolcomm, loewdinPopulations);
+
+  const bool hasPreviousCharges = d_scfMullikenCharges.size() == numAtoms;
+  double     maxChargeChange    = 0.0;
+  d_scfMullikenCharges.resize(numAtoms, 0.0);
+  pcout << "Atom charges of SCF iteration " << scfIter + 1
+        << " (atomID, Mulliken, Loewdin):" << std::endl;
+  for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
     {
-      for(int j = 0; j < totalDimOfBasis; j++)
-        pcout<<Shalf[i*totalDimOfBasis+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-  MPI_Barrier(MPI_COMM_WORLD);
-       timerPhiTPsi = MPI_Wtime();
-      auto arrayVecOfProjserial =
-        matrixTmatrixmul(scaledOrbitalValues_FEnodes,
-                         n_dofs,
-                         totalDimOfBasis,
-                         scaledKSOrbitalValues_FEnodes,
-                         n_dofs,
-                         numOfKSOrbitals);
-      std::vector<double> arrayVecOfProj(totalDimOfBasis * numOfKSOrbitals,
-                                         0.0);
-      MPI_Allreduce(&arrayVecOfProjserial[0],
-                    &arrayVecOfProj[0],
-                    (totalDimOfBasis * numOfKSOrbitals),
-                    MPI_DOUBLE,
-                    MPI_SUM,
-                    MPI_COMM_WORLD);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerPhiTPsi = MPI_Wtime() - timerPhiTPsi;
-      pcout<<"Computing PHI^TPSI: "<<timerPhiTPsi<<std::endl;
-      pcout << "Matrix of projections with atomic orbitals: \n";
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerCcompute = MPI_Wtime();
-      auto coeffArrayVecOfProj = matrixmatrixmul(invS,
-                                                 totalDimOfBasis,
-                                                 totalDimOfBasis,
-                                                 arrayVecOfProj,
-                                                 totalDimOfBasis,
-                                                 numOfKSOrbitals);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerCcompute = MPI_Wtime() - timerCcompute;  
-      pcout<<"Computing C: "<<timerCcompute<<std::endl;
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerOcompute = MPI_Wtime();
-      auto B = matrixTmatrixmul(coeffArrayVecOfProj,totalDimOfBasis,numOfKSOrbitals,S,totalDimOfBasis,totalDimOfBasis);
-      auto O = matrixmatrixmul(B,numOfKSOrbitals,totalDimOfBasis,coeffArrayVecOfProj,totalDimOfBasis,numOfKSOrbitals);                                               
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerOcompute = MPI_Wtime() -timerOcompute;
-      pcout<<" Computing O: "<<timerOcompute<<std::endl;
-      std::vector<double> D_O(numOfKSOrbitals,0.0);
-      std::vector<double> U_O(numOfKSOrbitals*numOfKSOrbitals,0.0);
-      
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerOdiagnolaization = MPI_Wtime();
-       if(this_mpi_process == 0)
-	U_O =  diagonalization(O,numOfKSOrbitals,D_O);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerOdiagnolaization = MPI_Wtime()-timerOdiagnolaization; 
-    pcout<<" Diagonalization of O: "<<timerOdiagnolaization<<std::endl;     
-    MPI_Bcast(
-      &(D_O[0]), numOfKSOrbitals, MPI_DOUBLE, 0, MPI_COMM_WORLD); 
-    MPI_Bcast(
-      &(U_O[0]), numOfKSOrbitals*numOfKSOrbitals, MPI_DOUBLE, 0, MPI_COMM_WORLD); 
-     // MPI_Barrier(MPI_COMM_WORLD);
-     // timerOdiagnolaization = MPI_Wtime()-timerOdiagnolaization;
-  pcout<<"Eigenvalues of O: "<<std::endl;
-  for (int i = 0; i < numOfKSOrbitals; i++)
-    pcout<<D_O[i]<<" ";
-  pcout<<std::endl;
-  pcout<<"Eigenvectors of O: "<<std::endl;
-  for(int i = 0;i < numOfKSOrbitals; i++)
-    {
-      for(int j = 0; j < numOfKSOrbitals; j++)
-        pcout<<U_O[i*numOfKSOrbitals+j]<<" ";
-      pcout<<std::endl;  
-    }  
-  pcout<<"-------------------------"<<std::endl;
-  MPI_Barrier(MPI_COMM_WORLD);
-   timerUOtranspose = MPI_Wtime();
-  auto U_Ot = TransposeMatrix(U_O,numOfKSOrbitals);
-   MPI_Barrier(MPI_COMM_WORLD);
-   timerUOtranspose = MPI_Wtime()-timerUOtranspose;  
-  
-  
-  
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerOminushalf = MPI_Wtime();
-      auto Ominushalf = powerOfMatrix(-0.5,D_O,U_Ot,numOfKSOrbitals,U_Ot);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerOminushalf = MPI_Wtime() - timerOminushalf;
-      pcout<<" Computing O^-0.5: "<<timerOminushalf<<std::endl;
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerCbarcompute = MPI_Wtime();
-      std::vector<double> C_bar = matrixmatrixmul(coeffArrayVecOfProj,totalDimOfBasis,numOfKSOrbitals,
-                                    Ominushalf,numOfKSOrbitals,numOfKSOrbitals);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerCbarcompute = MPI_Wtime() - timerCbarcompute;
-      pcout<<" Computing Cbar: "<<timerCbarcompute<<std::endl;
-
-      if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
-        {
-          writeVectorAs2DMatrix(C_bar,
-                                totalDimOfBasis,
-                                numOfKSOrbitals,
-                                "FePOP_v1.txt");
-          // printVector(CoeffofOrthonormalisedKSonAO);
-        }
-      MPI_Barrier(MPI_COMM_WORLD);
-       timerChatcompute = MPI_Wtime();
-      std::vector<double> C_hat = matrixmatrixmul(Shalf,totalDimOfBasis,totalDimOfBasis,C_bar,totalDimOfBasis,numOfKSOrbitals);
-      MPI_Barrier(MPI_COMM_WORLD);
-      timerChatcompute = MPI_Wtime() - timerChatcompute; 
-      pcout<<" Computing Chat: "<<timerChatcompute<<std::endl;
-      if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
-        {
-          writeVectorAs2DMatrix(C_hat,
-                                totalDimOfBasis,
-                                numOfKSOrbitals,
-                                "FePHP_v1.txt");
-        }
+      const double mullikenCharge =
+        atomLocations[iAtom][1] - mullikenPopulations[iAtom];
+      const double loewdinCharge =
+        atomLocations[iAtom][1] - loewdinPopulations[iAtom];
+      maxChargeChange =
+        std::max(maxChargeChange,
+                 std::abs(mullikenCharge - d_scfMullikenCharges[iAtom]));
+      d_scfMullikenCharges[iAtom] = mullikenCharge;
+      pcout << iAtom << " " << mullikenCharge << " " << loewdinCharge
+            << std::endl;
+    }
+  if (hasPreviousCharges)
+    pcout << "Maximum change of the Mulliken charges since the last update: "
+          << maxChargeChange << std::endl;
+}
 
-        MPI_Barrier(MPI_COMM_WORLD);
-         timerHprojOrbital = MPI_Wtime();
-        auto Hproj_orbital = computeHprojOrbital(C_hat,C_hat,
-                                               totalDimOfBasis,
-                                               numOfKSOrbitals,
-                                               eigenValues[0]);
-        MPI_Barrier(MPI_COMM_WORLD);
-        timerHprojOrbital = MPI_Wtime()-timerHprojOrbital;                                       
-        pcout<<" Computing Projected Hamiltonian: "<<timerHprojOrbital<<std::endl;
-      
-      
-      if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
-        {
-          writeVectorAs2DMatrix(Hproj_orbital,
-                                totalDimOfBasis,
-                                totalDimOfBasis,
-                                "Hproj_orbital.txt");
-        }
-      // Compute projected Hamiltonian of FE discretized Hamiltonian into
-      
-        Hproj_orbital.clear();
-	C_hat.clear();
-	C_bar.clear();	
-	O.clear();
-	U_O.clear();
-	B.clear();
-	
-	std::vector<double>().swap(Hproj_orbital);
-	std::vector<double>().swap(C_hat);
-	std::vector<double>().swap(C_bar);
-	std::vector<double>().swap(O);
-	std::vector<double>().swap(U_O);
-	std::vector<double>().swap(B);
-
-	pcout
-        << "--------------------------COHP Data Saved------------------------------"
-        << std::endl;
-      MPI_Barrier(MPI_COMM_WORLD);
-      if (this_mpi_process == 0)
-        {
-          // writing the energy levels and the occupation numbers
-          unsigned int  kPointDummy = 0;
-          std::ofstream energyLevelsOccNumsFile("energyLevelsOccNums.txt");
 
-          if (energyLevelsOccNumsFile.is_open())
-            {
-              for (unsigned int i = 0; i < eigenValues[0].size(); ++i)
-                {
-                  const double partialOccupancy =
-                    dftUtils::getPartialOccupancy(eigenValues[kPointDummy][i],
-                                                  fermiEnergy,
-                                                  C_kb,
-                                                  d_dftParamsPtr->TVal);
-
-                  energyLevelsOccNumsFile << eigenValues[kPointDummy][i] << " "
-                                          << partialOccupancy << '\n';
-                }
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::trajectoryPopulationAnalysis(
+  const unsigned int step,
+  const double       time)
+{
+  const unsigned int frequency = d_dftParamsPtr->populationAnalysisFrequency;
+  if (frequency == 0 || step % frequency != 0)
+    return;
 
-              energyLevelsOccNumsFile.close();
-            }
+  computePopulationAnalysis();
 
-          else
-            pcout << "couldn't open energyLevelsOccNums.txt file!\n";
-        }
-      if (this_mpi_process == 0)
-        {
-          pcout
-            << "\n-------------------------------------------------------\n";
-          pcout << "Projected SpillFactors are:" << std::endl;
-          spillFactorsofProjectionwithCS(coeffArrayVecOfProj,
-                                         upperTriaOfS,
-                                         occupationNum,
-                                         totalDimOfBasis,
-                                         numOfKSOrbitals,
-                                         totalDimOfBasis,
-                                         totalDimOfBasis);
-          pcout
-            << "\n-------------------------------------------------------\n";
-        }
-#endif 
-  pcout<<"----------------------------------------------------------"<<std::endl;
-  pcout<<"------------------- OLD METHOD ----------------------------"<<std::endl;
-  pcout<<" Creating PHI and PSI matrices: "<<timerCreatingMatrices<<std::endl;
-  pcout<<" Computing S matrix: "<<timerScompute<<std::endl;
-  pcout<<"Computing PHI^TPSI: "<<timerPhiTPsi<<std::endl;
-  pcout<<"Diagonalization of S: "<<timerSdiagonalization<<std::endl;
-  pcout<<" Computing S^-1: "<<timerSinverse<<std::endl;
-  pcout<<"Computing C: "<<timerCcompute<<std::endl;
-  pcout<<" Computing O: "<<timerOcompute<<std::endl;
-  pcout<<" Diagonalization of O: "<<timerOdiagnolaization<<std::endl;
-  pcout<<" Computing O^-0.5: "<<timerOminushalf<<std::endl;
-  pcout<<" Computing Cbar: "<<timerCbarcompute<<std::endl;
-  pcout<<" Computing S^0.5: "<<timerShalf<<std::endl;
-  pcout<<" Computing Chat: "<<timerChatcompute<<std::endl;
-  pcout<<" Computing Projected Hamiltonian: "<<timerHprojOrbital<<std::endl;
-  pcout<<" Compute U transpose: "<<timerUStranspose<<std::endl ;
-  pcout<<" Compute U_O transpose: "<<timerUOtranspose<<std::endl ;
-  pcout<<" TOTAL TIME in sec: "<<timerScompute+timerPhiTPsi+timerSdiagonalization+timerSinverse+
-  timerCcompute+timerOcompute+timerOdiagnolaization+timerOminushalf+timerCbarcompute+timerShalf+timerChatcompute+
-  timerHprojOrbital<<std::endl;
-  pcout<<"----------------------------------------------------------"<<std::endl;
-  pcout<<std::endl;
-   pcout<<"----------------------------------------------------------"<<std::endl;
-
-
-    
+  if (Utilities::MPI::this_mpi_process(d_mpiCommParent) != 0)
+    return;
+
+  //
+  // one record per step, the pair matrices are reduced to their upper
+  // triangles with the bond quantities P_AB + P_BA off the diagonal
+  //
+  const populationAnalysisResults &results  = d_populationAnalysisResults;
+  const unsigned int               numAtoms = results.numAtoms;
+  const std::string                fileName = "populationTimeSeries.bin";
+  std::vector<double>              record;
+  record.reserve(4 + numAtoms + numAtoms * (numAtoms + 1));
+  record.push_back(time);
+  record.push_back(results.totalSpilling);
+  record.push_back(results.occupiedBandsSpilling);
+  record.push_back(results.chargeSpilling);
+  record.insert(record.end(),
+                results.atomCharges.begin(),
+                results.atomCharges.end());
+  for (const std::vector<double> *pairValues :
+       {&results.atomPairPopulations, &results.atomPairICOHP})
+    for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+      for (unsigned int jAtom = iAtom; jAtom < numAtoms; ++jAtom)
+        record.push_back(
+          iAtom == jAtom ?
+            (*pairValues)[iAtom * numAtoms + iAtom] :
+            (*pairValues)[iAtom * numAtoms + jAtom] +
+              (*pairValues)[jAtom * numAtoms + iAtom]);
+
+  //
+  // step 0 is only analysed at the start of a new trajectory, which
+  // replaces the file of an earlier run, restarted trajectories append
+  // to a file of the same atoms
+  //
+  bool writeHeader = step == 0;
+  if (!writeHeader)
+    {
+      std::ifstream existingFile(fileName, std::ios::binary);
+      char          magic[8] = {};
+      std::int32_t  storedVersion       = 0;
+      std::uint32_t storedNumberOfAtoms = 0;
+      existingFile.read(magic, 8);
+      existingFile.read(reinterpret_cast<char *>(&storedVersion),
+                        sizeof(storedVersion));
+      existingFile.read(reinterpret_cast<char *>(&storedNumberOfAtoms),
+                        sizeof(storedNumberOfAtoms));
+      writeHeader = !existingFile.good();
+      AssertThrow(writeHeader ||
+                    (std::string(magic, 8) == "DFTFEPOP" &&
+                     storedVersion == 1 && storedNumberOfAtoms == numAtoms),
+                  ExcMessage("DFT-FE Error: " + fileName +
+                             " of the restarted trajectory was written for " +
+                             std::to_string(storedNumberOfAtoms) +
+                             " atoms or in another format, the current " +
+                             "system has " + std::to_string(numAtoms) +
+                             " atoms."));
+    }
+  std::ofstream timeSeriesFile(fileName,
+                               std::ios::binary |
+                                 (writeHeader ? std::ios::trunc :
+                                                std::ios::app));
+  AssertThrow(timeSeriesFile.is_open(),
+              ExcMessage("DFT-FE Error: couldn't open " + fileName + "."));
+  if (writeHeader)
+    {
+      const std::int32_t  version       = 1;
+      const std::uint32_t numberOfAtoms = numAtoms;
+      timeSeriesFile.write("DFTFEPOP", 8);
+      timeSeriesFile.write(reinterpret_cast<const char *>(&version),
+                           sizeof(version));
+      timeSeriesFile.write(reinterpret_cast<const char *>(&numberOfAtoms),
+                           sizeof(numberOfAtoms));
+    }
+  const std::uint32_t stepIndex = step;
+  timeSeriesFile.write(reinterpret_cast<const char *>(&stepIndex),
+                       sizeof(stepIndex));
+  timeSeriesFile.write(reinterpret_cast<const char *>(&record[0]),
+                       record.size() * sizeof(double));
 }
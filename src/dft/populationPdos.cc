@@ -0,0 +1,195 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::writePopulationPdos(
+  const std::vector<std::vector<double>> &orbitalWeightsOfKPoints,
+  const std::vector<std::vector<double>> &eigenValuesInput)
+{
+  TimerOutput::Scope scope(computing_timer, "population pdos");
+
+  const unsigned int numSpins        = 1 + d_dftParamsPtr->spinPolarized;
+  const unsigned int numOfKSOrbitals = d_dftParamsPtr->NumofKSOrbitalsproj;
+
+  //
+  // atomic orbitals in the order of the population analysis
+  //
+  std::vector<std::vector<int>> shells;
+  readBasisFile(3, shells, "BasisInfo.inp");
+  const std::vector<unsigned int> atomTypesVec(atomTypes.begin(),
+                                               atomTypes.end());
+  const std::vector<LocalAtomicBasisInfo> basisInfo =
+    shellBasisInfo(shells, atomLocations, atomTypesVec, 0);
+  const unsigned int numOfBasis = basisInfo.size();
+
+  //
+  // energy grid and broadening of compute_tdos covering the projected bands
+  // of all k-points and spins
+  //
+  double eMin = std::numeric_limits<double>::max();
+  double eMax = -std::numeric_limits<double>::max();
+  for (unsigned int kPointSpin = 0; kPointSpin < orbitalWeightsOfKPoints.size();
+       ++kPointSpin)
+    {
+      const unsigned int kPoint    = kPointSpin / numSpins;
+      const unsigned int spinIndex = kPointSpin % numSpins;
+      const unsigned int numEigenValues =
+        eigenValuesInput[kPoint].size() / numSpins;
+      for (unsigned int iBand = 0; iBand < numOfKSOrbitals; ++iBand)
+        {
+          const double energy =
+            eigenValuesInput[kPoint][spinIndex * numEigenValues + iBand];
+          eMin = std::min(eMin, energy);
+          eMax = std::max(eMax, energy);
+        }
+    }
+  eMin = Utilities::MPI::min(eMin, interpoolcomm);
+  eMax = Utilities::MPI::max(eMax, interpoolcomm);
+
+  const double padding =
+    std::max(0.1, 20.0 * dosBroadeningWidth(*d_dftParamsPtr));
+  const dosBroadening broadening =
+    createDosBroadening(*d_dftParamsPtr, eMin - padding, eMax + padding);
+  const unsigned int numIntervals = broadening.numIntervals();
+
+  //
+  // k-point weighted broadened orbital weights of the local k-points,
+  // reduced over the pools
+  //
+  const double spinFactor = numSpins == 1 ? 2.0 : 1.0;
+  std::vector<std::vector<double>> pdos(
+    numSpins, std::vector<double>(numOfBasis * numIntervals, 0.0));
+  for (unsigned int kPointSpin = 0; kPointSpin < orbitalWeightsOfKPoints.size();
+       ++kPointSpin)
+    {
+      const unsigned int kPoint    = kPointSpin / numSpins;
+      const unsigned int spinIndex = kPointSpin % numSpins;
+      const unsigned int numEigenValues =
+        eigenValuesInput[kPoint].size() / numSpins;
+      AssertThrow(orbitalWeightsOfKPoints[kPointSpin].size() ==
+                    numOfBasis * numOfKSOrbitals,
+                  ExcMessage(
+                    "DFT-FE Error: orbital weights do not match the basis of "
+                    "BasisInfo.inp."));
+      const std::vector<double> energyLevels(
+        eigenValuesInput[kPoint].begin() + spinIndex * numEigenValues,
+        eigenValuesInput[kPoint].begin() + spinIndex * numEigenValues +
+          numOfKSOrbitals);
+      broadening.accumulate(energyLevels,
+                            orbitalWeightsOfKPoints[kPointSpin],
+                            numOfBasis,
+                            spinFactor * d_kPointWeights[kPoint],
+                            pdos[spinIndex]);
+    }
+  for (unsigned int spinIndex = 0; spinIndex < numSpins; ++spinIndex)
+    Utilities::MPI::sum(pdos[spinIndex], interpoolcomm, pdos[spinIndex]);
+
+  if (Utilities::MPI::this_mpi_process(d_mpiCommParent) == 0)
+    {
+      std::string tempFolder = "pdosPopulationOutputFolder";
+      mkdir(tempFolder.c_str(), ACCESSPERMS);
+
+      unsigned int basisStart = 0;
+      for (unsigned int iAtom = 0; iAtom < atomLocations.size(); ++iAtom)
+        {
+          unsigned int basisEnd = basisStart;
+          while (basisEnd < numOfBasis && basisInfo[basisEnd].atomID == iAtom)
+            ++basisEnd;
+
+          std::ofstream outputFile(tempFolder + "/pdosData_" +
+                                   dealii::Utilities::to_string(iAtom));
+          outputFile << "# energy(eV)";
+          for (unsigned int spinIndex = 0; spinIndex < numSpins; ++spinIndex)
+            for (unsigned int i = basisStart; i < basisEnd; ++i)
+              {
+                outputFile << " " << basisInfo[i].n << "," << basisInfo[i].l
+                           << "," << basisInfo[i].m;
+                if (numSpins == 2)
+                  outputFile << (spinIndex == 0 ? ",up" : ",down");
+              }
+          outputFile << '\n';
+
+          outputFile.setf(std::ios_base::fixed);
+          outputFile << std::setprecision(18);
+          for (unsigned int epsInt = 0; epsInt < numIntervals; ++epsInt)
+            {
+              outputFile << broadening.energy(epsInt) * 27.21138602;
+              for (unsigned int spinIndex = 0; spinIndex < numSpins;
+                   ++spinIndex)
+                for (unsigned int i = basisStart; i < basisEnd; ++i)
+                  outputFile << " "
+                             << pdos[spinIndex][i * numIntervals + epsInt];
+              outputFile << '\n';
+            }
+
+          basisStart = basisEnd;
+        }
+    }
+
+  //
+  // fat bands, the pools append their k-points one after the other
+  //
+  const bool isPoolWriter =
+    Utilities::MPI::this_mpi_process(mpi_communicator) == 0 &&
+    Utilities::MPI::this_mpi_process(interBandGroupComm) == 0;
+  const unsigned int thisPool = Utilities::MPI::this_mpi_process(interpoolcomm);
+  for (unsigned int ipool = 0;
+       ipool < Utilities::MPI::n_mpi_processes(interpoolcomm);
+       ++ipool)
+    {
+      if (isPoolWriter && ipool == thisPool)
+        {
+          std::ofstream fatBandsFile("fatBands.txt",
+                                     ipool == 0 ? std::ofstream::out :
+                                                  std::ofstream::app);
+          if (ipool == 0)
+            fatBandsFile << "# kPoint spin band energy(eV) weights of the "
+                         << numOfBasis << " atomic orbitals\n";
+          fatBandsFile << std::setprecision(10);
+          for (unsigned int kPointSpin = 0;
+               kPointSpin < orbitalWeightsOfKPoints.size();
+               ++kPointSpin)
+            {
+              const unsigned int kPoint    = kPointSpin / numSpins;
+              const unsigned int spinIndex = kPointSpin % numSpins;
+              const unsigned int numEigenValues =
+                eigenValuesInput[kPoint].size() / numSpins;
+              for (unsigned int iBand = 0; iBand < numOfKSOrbitals; ++iBand)
+                {
+                  fatBandsFile
+                    << lowerBoundKindex + kPoint << " " << spinIndex << " "
+                    << iBand << " "
+                    << eigenValuesInput[kPoint]
+                                       [spinIndex * numEigenValues + iBand] *
+                         27.21138602;
+                  for (unsigned int i = 0; i < numOfBasis; ++i)
+                    fatBandsFile
+                      << " "
+                      << orbitalWeightsOfKPoints[kPointSpin]
+                                                [i * numOfKSOrbitals + iBand];
+                  fatBandsFile << '\n';
+                }
+            }
+        }
+      MPI_Barrier(interpoolcomm);
+    }
+
+  pcout << "Projected density of states from the " << numOfBasis
+        << " atomic orbital " << d_dftParamsPtr->populationPdosWeights
+        << " weights written to pdosPopulationOutputFolder" << std::endl;
+}
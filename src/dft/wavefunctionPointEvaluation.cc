@@ -0,0 +1,316 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022 The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+
+// values of a range of wavefunctions of all k-points and spins at arbitrary
+// points
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::evaluateWavefunctionsAtPoints(
+  const std::vector<Point<3>> &   points,
+  const unsigned int              bandStart,
+  const unsigned int              numBands,
+  std::vector<dataTypes::number> &values)
+{
+  AssertThrow(
+    bandStart + numBands <= d_numEigenValues,
+    dealii::ExcMessage(
+      "DFT-FE Error: wavefunctions to evaluate exceed the number of wavefunctions."));
+
+  kohnShamDFTOperatorClass<FEOrder, FEOrderElectro> &kohnShamDFTEigenOperator =
+    *d_kohnShamDFTOperatorPtr;
+
+  const unsigned int numPoints = points.size();
+  const unsigned int numNodesPerElement =
+    matrix_free_data.get_dofs_per_cell(d_densityDofHandlerIndex);
+  const unsigned int numLocalDofs =
+    d_eigenVectorsFlattenedSTL[0].size() / d_numEigenValues;
+  const unsigned int numSpins       = 1 + d_dftParamsPtr->spinPolarized;
+  const unsigned int numKPointSpins = numSpins * d_kPointWeights.size();
+  const unsigned int numKPointsGlobal =
+    Utilities::MPI::sum((unsigned int)d_kPointWeights.size(), interpoolcomm);
+
+  //
+  // locate the points in the locally owned cells, in the cell order of the
+  // density calculator: candidate cells from the bins over the cell bounding
+  // boxes, then the exact test in the reference cell
+  //
+  std::vector<typename DoFHandler<3>::active_cell_iterator> locallyOwnedCells;
+  std::vector<std::array<double, 3>> lowerCorners, upperCorners;
+  typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(),
+                                               endc = dofHandler.end();
+  for (; cell != endc; ++cell)
+    if (cell->is_locally_owned())
+      {
+        std::array<double, 3> lower, upper;
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            lower[d] = cell->vertex(0)[d];
+            upper[d] = cell->vertex(0)[d];
+          }
+        for (unsigned int v = 1; v < GeometryInfo<3>::vertices_per_cell; ++v)
+          for (unsigned int d = 0; d < 3; ++d)
+            {
+              lower[d] = std::min(lower[d], cell->vertex(v)[d]);
+              upper[d] = std::max(upper[d], cell->vertex(v)[d]);
+            }
+        locallyOwnedCells.push_back(cell);
+        lowerCorners.push_back(lower);
+        upperCorners.push_back(upper);
+      }
+
+  cellBoundingBoxIndex cellIndex;
+  cellIndex.build(lowerCorners, upperCorners, 1e-8);
+
+  const unsigned int numProcs =
+    Utilities::MPI::n_mpi_processes(mpi_communicator);
+  const unsigned int thisProc =
+    Utilities::MPI::this_mpi_process(mpi_communicator);
+  MappingQ1<3, 3>           mapping;
+  std::vector<unsigned int> cellOfPoint(numPoints, 0);
+  std::vector<Point<3>>     unitPoints(numPoints);
+  std::vector<unsigned int> ownerOfPoint(numPoints, numProcs);
+  std::vector<unsigned int> candidates;
+  for (unsigned int point = 0; point < numPoints; ++point)
+    {
+      cellIndex.candidateCells({points[point][0],
+                                points[point][1],
+                                points[point][2]},
+                               candidates);
+      for (const unsigned int iElem : candidates)
+        {
+          try
+            {
+              const Point<3> unitPoint =
+                mapping.transform_real_to_unit_cell(locallyOwnedCells[iElem],
+                                                    points[point]);
+              if (GeometryInfo<3>::distance_to_unit_cell(unitPoint) < 1e-8)
+                {
+                  cellOfPoint[point]  = iElem;
+                  unitPoints[point]   = unitPoint;
+                  ownerOfPoint[point] = thisProc;
+                  break;
+                }
+            }
+          catch (MappingQ1<3>::ExcTransformationFailed)
+            {}
+        }
+    }
+
+  // points on the faces between processors are evaluated by the lowest one
+  Utilities::MPI::min(ownerOfPoint, mpi_communicator, ownerOfPoint);
+  const unsigned int numPointsOutside =
+    std::count(ownerOfPoint.begin(), ownerOfPoint.end(), numProcs);
+  if (numPointsOutside > 0)
+    pcout << "Number of points outside the domain in wavefunction evaluation: "
+          << numPointsOutside << std::endl;
+
+  //
+  // the owned points grouped by cell, with the shape function values at
+  // their reference points (numNodesPerElement x number of points of the
+  // cell), shared by all wavefunctions, k-points and spins
+  //
+  std::vector<unsigned int> ownedPoints;
+  for (unsigned int point = 0; point < numPoints; ++point)
+    if (ownerOfPoint[point] == thisProc)
+      ownedPoints.push_back(point);
+  std::stable_sort(ownedPoints.begin(),
+                   ownedPoints.end(),
+                   [&cellOfPoint](const unsigned int a, const unsigned int b) {
+                     return cellOfPoint[a] < cellOfPoint[b];
+                   });
+  const unsigned int numOwnedPoints = ownedPoints.size();
+
+  const FiniteElement<3> &       fe = dofHandler.get_fe();
+  std::vector<dataTypes::number> pointShapeFunctionValues(numNodesPerElement *
+                                                          numOwnedPoints);
+  for (unsigned int i = 0; i < numOwnedPoints; ++i)
+    for (unsigned int iNode = 0; iNode < numNodesPerElement; ++iNode)
+      pointShapeFunctionValues[i * numNodesPerElement + iNode] =
+        dataTypes::number(
+          fe.shape_value(iNode, unitPoints[ownedPoints[i]]));
+
+  std::vector<unsigned int> cellPointsStart(1, 0);
+  for (unsigned int i = 1; i <= numOwnedPoints; ++i)
+    if (i == numOwnedPoints ||
+        cellOfPoint[ownedPoints[i]] != cellOfPoint[ownedPoints[i - 1]])
+      cellPointsStart.push_back(i);
+
+  //
+  // blocks of wavefunctions assigned to the band groups in turn, a block is
+  // interpolated to all points of a cell with one GEMM
+  //
+  const unsigned int numberBandGroups =
+    dealii::Utilities::MPI::n_mpi_processes(interBandGroupComm);
+  const unsigned int bandGroupTaskId =
+    dealii::Utilities::MPI::this_mpi_process(interBandGroupComm);
+  const unsigned int BVec =
+    std::max(std::min(d_dftParamsPtr->chebyWfcBlockSize, numBands), 1u);
+
+  values.assign((std::size_t)numKPointsGlobal * numSpins * numPoints *
+                  numBands,
+                dataTypes::number(0.0));
+
+  distributedCPUVec<dataTypes::number> flattenedArrayBlock;
+  std::vector<dataTypes::number>       cellWaveFunctionMatrix(
+    numNodesPerElement * BVec);
+  std::vector<dataTypes::number> pointValues(numOwnedPoints * BVec);
+
+  unsigned int previousBlockSize = 0;
+  for (unsigned int jvec = 0; jvec < numBands; jvec += BVec)
+    {
+      const unsigned int currentBlockSize = std::min(BVec, numBands - jvec);
+      if ((jvec / BVec) % numberBandGroups != bandGroupTaskId)
+        continue;
+
+      if (currentBlockSize != previousBlockSize)
+        kohnShamDFTEigenOperator.reinit(currentBlockSize,
+                                        flattenedArrayBlock,
+                                        true);
+      previousBlockSize = currentBlockSize;
+
+      for (unsigned int kPointSpin = 0; kPointSpin < numKPointSpins;
+           ++kPointSpin)
+        {
+          const std::vector<dataTypes::number> &XCurrentKPoint =
+            d_eigenVectorsFlattenedSTL[kPointSpin];
+          for (unsigned int iNode = 0; iNode < numLocalDofs; ++iNode)
+            for (unsigned int iWave = 0; iWave < currentBlockSize; ++iWave)
+              flattenedArrayBlock.local_element(iNode * currentBlockSize +
+                                                iWave) =
+                XCurrentKPoint[iNode * d_numEigenValues + bandStart + jvec +
+                               iWave];
+
+          (kohnShamDFTEigenOperator.getOverloadedConstraintMatrix())
+            ->distribute(flattenedArrayBlock, currentBlockSize);
+
+          for (unsigned int group = 0; group + 1 < cellPointsStart.size();
+               ++group)
+            {
+              const unsigned int firstPoint = cellPointsStart[group];
+              const unsigned int numCellPoints =
+                cellPointsStart[group + 1] - firstPoint;
+              const unsigned int icell = cellOfPoint[ownedPoints[firstPoint]];
+
+              const unsigned int inc = 1;
+              for (unsigned int iNode = 0; iNode < numNodesPerElement; ++iNode)
+                xcopy(&currentBlockSize,
+                      flattenedArrayBlock.begin() +
+                        kohnShamDFTEigenOperator
+                          .getFlattenedArrayCellLocalProcIndexIdMap()
+                            [icell * numNodesPerElement + iNode],
+                      &inc,
+                      &cellWaveFunctionMatrix[currentBlockSize * iNode],
+                      &inc);
+
+              const dataTypes::number scalarCoeffAlpha =
+                                        dataTypes::number(1.0),
+                                      scalarCoeffBeta = dataTypes::number(0.0);
+              const char transA = 'N', transB = 'N';
+              xgemm(&transA,
+                    &transB,
+                    &currentBlockSize,
+                    &numCellPoints,
+                    &numNodesPerElement,
+                    &scalarCoeffAlpha,
+                    &cellWaveFunctionMatrix[0],
+                    &currentBlockSize,
+                    &pointShapeFunctionValues[firstPoint * numNodesPerElement],
+                    &numNodesPerElement,
+                    &scalarCoeffBeta,
+                    &pointValues[firstPoint * currentBlockSize],
+                    &currentBlockSize);
+            }
+
+          const unsigned int kPointSpinGlobal =
+            lowerBoundKindex * numSpins + kPointSpin;
+          for (unsigned int i = 0; i < numOwnedPoints; ++i)
+            for (unsigned int iWave = 0; iWave < currentBlockSize; ++iWave)
+              values[((std::size_t)kPointSpinGlobal * numPoints +
+                      ownedPoints[i]) *
+                       numBands +
+                     jvec + iWave] =
+                pointValues[i * currentBlockSize + iWave];
+        }
+    }
+
+  dealii::Utilities::MPI::sum(values, mpi_communicator, values);
+  dealii::Utilities::MPI::sum(values, interBandGroupComm, values);
+  dealii::Utilities::MPI::sum(values, interpoolcomm, values);
+}
+
+
+template <unsigned int FEOrder, unsigned int FEOrderElectro>
+void
+dftClass<FEOrder, FEOrderElectro>::writeWavefunctionsAtPoints(
+  const std::string &pointsFileName,
+  const std::string &outputFileName)
+{
+  std::vector<std::vector<double>> pointsData;
+  dftUtils::readFile(3, pointsData, pointsFileName);
+  std::vector<Point<3>> points(pointsData.size());
+  for (unsigned int point = 0; point < pointsData.size(); ++point)
+    for (unsigned int d = 0; d < 3; ++d)
+      points[point][d] = pointsData[point][d];
+
+  const unsigned int bandStart =
+    std::min(d_dftParamsPtr->wfcProbeBandStart, d_numEigenValues);
+  const unsigned int numBands =
+    d_dftParamsPtr->wfcProbeNumberBands == 0 ?
+      d_numEigenValues - bandStart :
+      std::min(d_dftParamsPtr->wfcProbeNumberBands,
+               d_numEigenValues - bandStart);
+
+  std::vector<dataTypes::number> values;
+  evaluateWavefunctionsAtPoints(points, bandStart, numBands, values);
+
+  //
+  // one line per point, one column per k-point, spin and wavefunction
+  //
+  const unsigned int numPoints = points.size();
+  const unsigned int numKPointSpins =
+    numPoints == 0 ? 0 : values.size() / ((std::size_t)numPoints * numBands);
+  if (dealii::Utilities::MPI::this_mpi_process(d_mpiCommParent) == 0)
+    {
+      std::ofstream outFile(outputFileName.c_str());
+      outFile.setf(std::ios_base::scientific);
+
+      if (outFile.is_open())
+        {
+          for (unsigned int point = 0; point < numPoints; ++point)
+            {
+              outFile << std::setprecision(10) << points[point][0] << " "
+                      << points[point][1] << " " << points[point][2];
+              for (unsigned int kPointSpin = 0; kPointSpin < numKPointSpins;
+                   ++kPointSpin)
+                for (unsigned int iWave = 0; iWave < numBands; ++iWave)
+                  {
+                    const dataTypes::number value =
+                      values[((std::size_t)kPointSpin * numPoints + point) *
+                               numBands +
+                             iWave];
+#ifdef USE_COMPLEX
+                    outFile << " " << value.real() << " " << value.imag();
+#else
+                    outFile << " " << value;
+#endif
+                  }
+              outFile << std::endl;
+            }
+        }
+    }
+}
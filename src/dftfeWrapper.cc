@@ -962,6 +962,17 @@ namespace dftfe
     return ionicForces;
   }
 
+  populationAnalysisResults
+  dftfeWrapper::computePopulationAnalysis()
+  {
+    AssertThrow(
+      d_mpi_comm_parent != MPI_COMM_NULL,
+      dealii::ExcMessage(
+        "DFT-FE Error: dftfeWrapper cannot be used on MPI_COMM_NULL."));
+    d_dftfeBasePtr->computePopulationAnalysis();
+    return d_dftfeBasePtr->getPopulationAnalysisResults();
+  }
+
   std::vector<std::vector<double>>
   dftfeWrapper::getCellStress() const
   {
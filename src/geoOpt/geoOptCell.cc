@@ -624,6 +624,7 @@ namespace dftfe
     d_dftPtr->solve(true, computeStress, d_isScfRestart);
     d_isScfRestart = false;
     d_totalUpdateCalls += 1;
+    d_dftPtr->trajectoryPopulationAnalysis(d_totalUpdateCalls, 0.0);
   }
 
 
@@ -667,6 +667,7 @@ namespace dftfe
     d_dftPtr->solve(computeForces, false, d_isScfRestart);
     d_isScfRestart = false;
     d_totalUpdateCalls += 1;
+    d_dftPtr->trajectoryPopulationAnalysis(d_totalUpdateCalls, 0.0);
   }
 
 
@@ -255,6 +255,7 @@ namespace dftfe
         if (d_cycle == 0 && !d_isRestart)
           {
             d_dftPtr->solve(true, true, false);
+            d_dftPtr->trajectoryPopulationAnalysis(0, 0.0);
           }
 
         if (d_status == 0)
@@ -1414,6 +1414,25 @@ namespace dftfe
   }
 
 
+  template <typename NumberType>
+  std::vector<double>
+  ScaLAPACKMatrix<NumberType>::eigenpairs_hermitian_by_value(
+    const std::pair<double, double> &value_limits,
+    const bool                       compute_eigenvectors)
+  {
+    Assert(!std::isnan(value_limits.first),
+           dealii::ExcMessage("value_limits.first is NaN"));
+    Assert(!std::isnan(value_limits.second),
+           dealii::ExcMessage("value_limits.second is NaN"));
+
+    const std::pair<unsigned int, unsigned int> indices =
+      std::make_pair(dealii::numbers::invalid_unsigned_int,
+                     dealii::numbers::invalid_unsigned_int);
+
+    return eigenpairs_hermitian(compute_eigenvectors, indices, value_limits);
+  }
+
+
   template <typename NumberType>
   std::vector<double>
   ScaLAPACKMatrix<NumberType>::eigenpairs_hermitian_MRRR(
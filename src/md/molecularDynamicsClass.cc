@@ -321,6 +321,7 @@ namespace dftfe
                         false,
                         d_dftPtr->getParametersObject().loadRhoData);
         force = d_dftPtr->getForceonAtoms();
+        d_dftPtr->trajectoryPopulationAnalysis(0, 0.0);
         if (d_dftPtr->getParametersObject().extrapolateDensity == 1 &&
             d_dftPtr->getParametersObject().spinPolarized != 1)
           DensityExtrapolation(0);
@@ -624,6 +625,9 @@ namespace dftfe
                          TotalEnergyVector,
                          d_TimeIndex);
         writeTotalDisplacementFile(displacements, d_TimeIndex);
+        d_dftPtr->trajectoryPopulationAnalysis(
+          d_TimeIndex,
+          d_TimeIndex * d_dftPtr->getParametersObject().timeStepBOMD);
 
         MPI_Barrier(d_mpiCommParent);
         curr_time = MPI_Wtime() - d_MDstartWallTime;
@@ -763,6 +767,9 @@ namespace dftfe
                          TotalEnergyVector,
                          d_TimeIndex);
         writeTotalDisplacementFile(displacements, d_TimeIndex);
+        d_dftPtr->trajectoryPopulationAnalysis(
+          d_TimeIndex,
+          d_TimeIndex * d_dftPtr->getParametersObject().timeStepBOMD);
 
         MPI_Barrier(d_mpiCommParent);
         curr_time = MPI_Wtime() - d_MDstartWallTime;
@@ -967,6 +974,9 @@ namespace dftfe
                             ThermostatMass,
                             d_TimeIndex);
         writeTotalDisplacementFile(displacements, d_TimeIndex);
+        d_dftPtr->trajectoryPopulationAnalysis(
+          d_TimeIndex,
+          d_TimeIndex * d_dftPtr->getParametersObject().timeStepBOMD);
 
         MPI_Barrier(d_mpiCommParent);
         curr_time = MPI_Wtime() - d_MDstartWallTime;
@@ -1105,6 +1115,9 @@ namespace dftfe
                          TotalEnergyVector,
                          d_TimeIndex);
         writeTotalDisplacementFile(displacements, d_TimeIndex);
+        d_dftPtr->trajectoryPopulationAnalysis(
+          d_TimeIndex,
+          d_TimeIndex * d_dftPtr->getParametersObject().timeStepBOMD);
 
         MPI_Barrier(d_mpiCommParent);
         curr_time = MPI_Wtime() - d_MDstartWallTime;
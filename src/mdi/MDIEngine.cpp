@@ -326,6 +326,13 @@ namespace dftfe
         d_actionflag = 1;
         send_stress();
       }
+    else if (strcmp(command, "<POPULATIONS") == 0)
+      {
+        if (!d_actionflag)
+          evaluate();
+        d_actionflag = 1;
+        send_populations();
+      }
     else if (strcmp(command, "<@") == 0)
       {
         if (d_root == 1)
@@ -387,6 +394,7 @@ namespace dftfe
     MDI_Register_command("@DEFAULT", "<ENERGY");
     MDI_Register_command("@DEFAULT", "<FORCES");
     MDI_Register_command("@DEFAULT", "<STRESS");
+    MDI_Register_command("@DEFAULT", "<POPULATIONS");
     MDI_Register_command("@DEFAULT", ">CELL");
     MDI_Register_command("@DEFAULT", "<CELL");
     MDI_Register_command("@DEFAULT", ">COORDS");
@@ -981,5 +989,45 @@ namespace dftfe
       }
     MPI_Barrier(d_dftfeMPIComm);
   }
+
+  /* ----------------------------------------------------------------------
+     <POPULATIONS command
+     send Natoms atom charges, Natoms x Natoms atom pair populations,
+     Natoms x Natoms atom pair ICOHP (rowwise) and the spill factors TSF,
+     CSF and fCSF, atoms are ordered by atomID, 1 to Natoms
+  ---------------------------------------------------------------------- */
+
+  void
+  MDIEngine::send_populations()
+  {
+    const populationAnalysisResults results =
+      d_dftfeWrapper.computePopulationAnalysis();
+
+    std::vector<double> populations;
+    populations.reserve(d_sys_natoms + 2 * d_sys_natoms * d_sys_natoms + 3);
+    populations.insert(populations.end(),
+                       results.atomCharges.begin(),
+                       results.atomCharges.end());
+    populations.insert(populations.end(),
+                       results.atomPairPopulations.begin(),
+                       results.atomPairPopulations.end());
+    populations.insert(populations.end(),
+                       results.atomPairICOHP.begin(),
+                       results.atomPairICOHP.end());
+    populations.push_back(results.totalSpilling);
+    populations.push_back(results.occupiedBandsSpilling);
+    populations.push_back(results.chargeSpilling);
+
+    if (d_root == 1)
+      {
+        int ierr = MDI_Send(&populations[0],
+                            populations.size(),
+                            MDI_DOUBLE,
+                            d_mdicomm);
+        if (ierr)
+          AssertThrow(false, dealii::ExcMessage("MDI: <POPULATIONS data"));
+      }
+    MPI_Barrier(d_dftfeMPIComm);
+  }
 } // namespace dftfe
 #endif
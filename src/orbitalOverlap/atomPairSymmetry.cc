@@ -0,0 +1,319 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <atomPairSymmetry.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+namespace dftfe
+{
+  namespace
+  {
+    double
+    wrapToUnitInterval(const double x)
+    {
+      const double wrapped = x - std::floor(x);
+      return wrapped >= 1.0 ? 0.0 : wrapped;
+    }
+
+    bool
+    isLatticeVector(const std::array<double, 3> &x, const double tolerance)
+    {
+      for (unsigned int d = 0; d < 3; ++d)
+        if (std::abs(x[d] - std::round(x[d])) > tolerance)
+          return false;
+      return true;
+    }
+
+    //
+    // atoms binned on a periodic grid of the unit cell with bins at least
+    // twice the tolerance wide, an atom within the tolerance of a point
+    // lies in one of the 27 bins around the bin of the point
+    //
+    class periodicAtomBins
+    {
+    public:
+      periodicAtomBins(const std::vector<std::array<double, 3>> &positions,
+                       const double                              tolerance)
+        : d_positions(positions)
+        , d_tolerance(tolerance)
+      {
+        d_numBins = (std::int64_t)std::max(
+          1.0, std::min(1024.0, std::floor(0.5 / tolerance)));
+        for (unsigned int i = 0; i < positions.size(); ++i)
+          d_bins[key(binOf(positions[i]))].push_back(i);
+      }
+
+      // atom of the given type at the point up to a lattice vector, or
+      // numAtoms if there is none
+      unsigned int
+      find(const std::array<double, 3> &    x,
+           const unsigned int               type,
+           const std::vector<unsigned int> &atomTypes) const
+      {
+        const std::array<std::int64_t, 3> bin = binOf(x);
+        for (std::int64_t i = -1; i <= 1; ++i)
+          for (std::int64_t j = -1; j <= 1; ++j)
+            for (std::int64_t k = -1; k <= 1; ++k)
+              {
+                const auto it =
+                  d_bins.find(key({bin[0] + i, bin[1] + j, bin[2] + k}));
+                if (it == d_bins.end())
+                  continue;
+                for (const unsigned int atom : it->second)
+                  if (atomTypes[atom] == type &&
+                      isLatticeVector({x[0] - d_positions[atom][0],
+                                       x[1] - d_positions[atom][1],
+                                       x[2] - d_positions[atom][2]},
+                                      d_tolerance))
+                    return atom;
+              }
+        return d_positions.size();
+      }
+
+    private:
+      std::array<std::int64_t, 3>
+      binOf(const std::array<double, 3> &x) const
+      {
+        std::array<std::int64_t, 3> bin;
+        for (unsigned int d = 0; d < 3; ++d)
+          bin[d] = std::min(d_numBins - 1,
+                            (std::int64_t)(wrapToUnitInterval(x[d]) *
+                                           d_numBins));
+        return bin;
+      }
+
+      std::int64_t
+      key(const std::array<std::int64_t, 3> &bin) const
+      {
+        std::int64_t k = 0;
+        for (unsigned int d = 0; d < 3; ++d)
+          k = k * d_numBins + ((bin[d] % d_numBins) + d_numBins) % d_numBins;
+        return k;
+      }
+
+      const std::vector<std::array<double, 3>> &d_positions;
+      const double                              d_tolerance;
+      std::int64_t                              d_numBins;
+      std::unordered_map<std::int64_t, std::vector<unsigned int>> d_bins;
+    };
+  } // namespace
+
+
+  atomPairSymmetry::atomPairSymmetry()
+    : d_numAtoms(0)
+    , d_numOperations(0)
+  {}
+
+
+  void
+  atomPairSymmetry::reinit(const unsigned int numAtoms)
+  {
+    d_numAtoms      = numAtoms;
+    d_numOperations = 1;
+    d_representativeOfPair.assign(numAtoms * numAtoms, 0);
+    d_representativePairs.clear();
+    for (unsigned int atomA = 0; atomA < numAtoms; ++atomA)
+      for (unsigned int atomB = atomA; atomB < numAtoms; ++atomB)
+        {
+          d_representativeOfPair[atomA * numAtoms + atomB] =
+            d_representativePairs.size();
+          d_representativeOfPair[atomB * numAtoms + atomA] =
+            d_representativePairs.size();
+          d_representativePairs.push_back({atomA, atomB});
+        }
+  }
+
+
+  void
+  atomPairSymmetry::reinit(
+    const std::vector<std::array<double, 3>> &            fractionalPositions,
+    const std::vector<unsigned int> &                     atomTypes,
+    const std::vector<std::array<std::array<int, 3>, 3>> &rotations,
+    const std::vector<std::array<double, 3>> &            translations,
+    const double                                          tolerance)
+  {
+    const unsigned int numAtoms = fractionalPositions.size();
+    AssertThrow(atomTypes.size() == numAtoms &&
+                  translations.size() == rotations.size(),
+                dealii::ExcMessage(
+                  "DFT-FE Error: inconsistent symmetry operations or atoms."));
+    AssertThrow(tolerance > 0.0 && tolerance < 0.25,
+                dealii::ExcMessage(
+                  "DFT-FE Error: symmetry tolerance out of range."));
+
+    //
+    // permutation of the atoms of every operation
+    //
+    const periodicAtomBins                 bins(fractionalPositions, tolerance);
+    std::vector<std::vector<unsigned int>> permutations;
+    for (unsigned int iOp = 0; iOp < rotations.size(); ++iOp)
+      {
+        std::vector<unsigned int> permutation(numAtoms);
+        std::vector<bool>         isImage(numAtoms, false);
+        bool                      isSymmetry = true;
+        for (unsigned int iAtom = 0; iAtom < numAtoms && isSymmetry; ++iAtom)
+          {
+            std::array<double, 3> x;
+            for (unsigned int d = 0; d < 3; ++d)
+              x[d] = rotations[iOp][d][0] * fractionalPositions[iAtom][0] +
+                     rotations[iOp][d][1] * fractionalPositions[iAtom][1] +
+                     rotations[iOp][d][2] * fractionalPositions[iAtom][2] +
+                     translations[iOp][d];
+            const unsigned int image =
+              bins.find(x, atomTypes[iAtom], atomTypes);
+            isSymmetry = image < numAtoms && !isImage[image];
+            if (isSymmetry)
+              {
+                permutation[iAtom] = image;
+                isImage[image]     = true;
+              }
+          }
+        if (isSymmetry)
+          permutations.push_back(permutation);
+      }
+
+    //
+    // orbits of the unordered pairs, the operations form a group and the
+    // orbit of a pair is its image under every operation
+    //
+    d_numAtoms      = numAtoms;
+    d_numOperations = std::max<unsigned int>(1, permutations.size());
+    const unsigned int unassigned = std::numeric_limits<unsigned int>::max();
+    d_representativeOfPair.assign(numAtoms * numAtoms, unassigned);
+    d_representativePairs.clear();
+    for (unsigned int atomA = 0; atomA < numAtoms; ++atomA)
+      for (unsigned int atomB = atomA; atomB < numAtoms; ++atomB)
+        {
+          if (d_representativeOfPair[atomA * numAtoms + atomB] != unassigned)
+            continue;
+          const unsigned int orbit = d_representativePairs.size();
+          d_representativePairs.push_back({atomA, atomB});
+          d_representativeOfPair[atomA * numAtoms + atomB] = orbit;
+          d_representativeOfPair[atomB * numAtoms + atomA] = orbit;
+          for (const std::vector<unsigned int> &permutation : permutations)
+            {
+              const unsigned int imageA = permutation[atomA];
+              const unsigned int imageB = permutation[atomB];
+              d_representativeOfPair[imageA * numAtoms + imageB] = orbit;
+              d_representativeOfPair[imageB * numAtoms + imageA] = orbit;
+            }
+        }
+  }
+
+
+  unsigned int
+  atomPairSymmetry::numberOfAtoms() const
+  {
+    return d_numAtoms;
+  }
+
+
+  unsigned int
+  atomPairSymmetry::numberOfOperations() const
+  {
+    return d_numOperations;
+  }
+
+
+  const std::vector<std::array<unsigned int, 2>> &
+  atomPairSymmetry::representativePairs() const
+  {
+    return d_representativePairs;
+  }
+
+
+  unsigned int
+  atomPairSymmetry::representativeOfPair(const unsigned int atomA,
+                                         const unsigned int atomB) const
+  {
+    return d_representativeOfPair[atomA * d_numAtoms + atomB];
+  }
+
+
+  void
+  atomPairSymmetry::scatter(const std::vector<double> &representativeValues,
+                            std::vector<double> &      atomPairValues) const
+  {
+    AssertThrow(representativeValues.size() == d_representativePairs.size() &&
+                  atomPairValues.size() == d_numAtoms * d_numAtoms,
+                dealii::ExcMessage(
+                  "DFT-FE Error: atom pair values do not match the atoms."));
+    for (unsigned int i = 0; i < d_numAtoms * d_numAtoms; ++i)
+      atomPairValues[i] += representativeValues[d_representativeOfPair[i]];
+  }
+
+
+  std::vector<unsigned int>
+  kPointInvariantOperations(
+    const std::vector<std::array<std::array<int, 3>, 3>> &rotations,
+    const std::vector<std::array<double, 3>> &             kPoints,
+    const std::vector<double> &                            kPointWeights,
+    const bool                                             timeReversal,
+    const double                                           tolerance)
+  {
+    AssertThrow(kPoints.size() == kPointWeights.size(),
+                dealii::ExcMessage(
+                  "DFT-FE Error: k-point weights do not match the k-points."));
+    double maxWeight = 0.0;
+    for (const double weight : kPointWeights)
+      maxWeight = std::max(maxWeight, std::abs(weight));
+
+    std::vector<unsigned int> invariantOperations;
+    for (unsigned int iOp = 0; iOp < rotations.size(); ++iOp)
+      {
+        bool isInvariant = true;
+        for (unsigned int ik = 0; ik < kPoints.size() && isInvariant; ++ik)
+          {
+            // k' = R^T k, as for the reduction of the Monkhorst-Pack grid
+            std::array<double, 3> kRotated;
+            for (unsigned int d = 0; d < 3; ++d)
+              kRotated[d] = kPoints[ik][0] * rotations[iOp][0][d] +
+                            kPoints[ik][1] * rotations[iOp][1][d] +
+                            kPoints[ik][2] * rotations[iOp][2][d];
+            isInvariant = false;
+            for (unsigned int jk = 0; jk < kPoints.size() && !isInvariant;
+                 ++jk)
+              {
+                if (std::abs(kPointWeights[ik] - kPointWeights[jk]) >
+                    tolerance * maxWeight)
+                  continue;
+                const std::array<double, 3> difference = {
+                  kRotated[0] - kPoints[jk][0],
+                  kRotated[1] - kPoints[jk][1],
+                  kRotated[2] - kPoints[jk][2]};
+                const std::array<double, 3> sum = {
+                  kRotated[0] + kPoints[jk][0],
+                  kRotated[1] + kPoints[jk][1],
+                  kRotated[2] + kPoints[jk][2]};
+                isInvariant = isLatticeVector(difference, tolerance) ||
+                              (timeReversal && isLatticeVector(sum, tolerance));
+              }
+          }
+        if (isInvariant)
+          invariantOperations.push_back(iOp);
+      }
+    return invariantOperations;
+  }
+
+} // namespace dftfe
@@ -0,0 +1,304 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <atomSpatialIndex.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace dftfe
+{
+  namespace
+  {
+    double
+    distanceSquared(const std::array<double, 3> &x,
+                    const std::array<double, 3> &y)
+    {
+      double distance = 0.0;
+      for (unsigned int d = 0; d < 3; ++d)
+        distance += (x[d] - y[d]) * (x[d] - y[d]);
+      return distance;
+    }
+  } // namespace
+
+
+  atomSpatialIndex::atomSpatialIndex()
+    : d_lower({0.0, 0.0, 0.0})
+    , d_binSize(1.0)
+    , d_numBins({1, 1, 1})
+    , d_binStart(2, 0)
+    , d_numberOfBuilds(0)
+  {}
+
+
+  bool
+  atomSpatialIndex::update(
+    const std::vector<std::array<double, 3>> &chargePositions,
+    const std::vector<unsigned int> &         atomIdsOfCharges)
+  {
+    AssertThrow(atomIdsOfCharges.size() == chargePositions.size(),
+                dealii::ExcMessage(
+                  "DFT-FE Error: atom ids do not match the charges."));
+    if (d_numberOfBuilds > 0 && chargePositions == d_chargePositions &&
+        atomIdsOfCharges == d_atomIdsOfCharges)
+      return false;
+
+    d_chargePositions  = chargePositions;
+    d_atomIdsOfCharges = atomIdsOfCharges;
+    build();
+    return true;
+  }
+
+
+  void
+  atomSpatialIndex::build()
+  {
+    const unsigned int numCharges = d_chargePositions.size();
+
+    std::array<double, 3> upper;
+    d_lower.fill(0.0);
+    upper.fill(0.0);
+    if (numCharges > 0)
+      {
+        d_lower = d_chargePositions[0];
+        upper   = d_chargePositions[0];
+      }
+    for (const std::array<double, 3> &x : d_chargePositions)
+      for (unsigned int d = 0; d < 3; ++d)
+        {
+          d_lower[d] = std::min(d_lower[d], x[d]);
+          upper[d]   = std::max(upper[d], x[d]);
+        }
+
+    //
+    // about one charge per bin, flat directions (slabs, wires, molecules in
+    // a plane) are given a small thickness and the bin size is grown until
+    // the number of bins is of the order of the number of charges
+    //
+    double maxExtent = 0.0;
+    for (unsigned int d = 0; d < 3; ++d)
+      maxExtent = std::max(maxExtent, upper[d] - d_lower[d]);
+    const double minExtent = std::max(1e-3 * maxExtent, 1e-8);
+    double       volume    = 1.0;
+    for (unsigned int d = 0; d < 3; ++d)
+      volume *= std::max(upper[d] - d_lower[d], minExtent);
+    d_binSize = std::cbrt(volume / std::max(numCharges, 1u));
+
+    double numBins = 0.0;
+    do
+      {
+        numBins = 1.0;
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            d_numBins[d] = (unsigned int)std::floor((upper[d] - d_lower[d]) /
+                                                    d_binSize) +
+                           1;
+            numBins *= d_numBins[d];
+          }
+        if (numBins > 2.0 * numCharges + 1.0)
+          d_binSize *= 1.25;
+      }
+    while (numBins > 2.0 * numCharges + 1.0);
+
+    //
+    // charges sorted by bin, in increasing order of their ids within a bin
+    //
+    std::vector<unsigned int> binOfCharge(numCharges);
+    d_binStart.assign((std::size_t)numBins + 1, 0);
+    for (unsigned int charge = 0; charge < numCharges; ++charge)
+      {
+        const std::array<double, 3> &x = d_chargePositions[charge];
+        binOfCharge[charge] =
+          (binIndex(x[0], 0) * d_numBins[1] + binIndex(x[1], 1)) *
+            d_numBins[2] +
+          binIndex(x[2], 2);
+        ++d_binStart[binOfCharge[charge] + 1];
+      }
+    for (unsigned int bin = 0; bin + 1 < d_binStart.size(); ++bin)
+      d_binStart[bin + 1] += d_binStart[bin];
+
+    std::vector<unsigned int> binFill(d_binStart.begin(), d_binStart.end() - 1);
+    d_binCharges.resize(numCharges);
+    for (unsigned int charge = 0; charge < numCharges; ++charge)
+      d_binCharges[binFill[binOfCharge[charge]]++] = charge;
+
+    ++d_numberOfBuilds;
+  }
+
+
+  unsigned int
+  atomSpatialIndex::binIndex(const double x, const unsigned int d) const
+  {
+    const double bin = std::floor((x - d_lower[d]) / d_binSize);
+    if (bin <= 0.0)
+      return 0;
+    return (unsigned int)std::min(bin, (double)(d_numBins[d] - 1));
+  }
+
+
+  unsigned int
+  atomSpatialIndex::numberOfCharges() const
+  {
+    return d_chargePositions.size();
+  }
+
+
+  const std::array<double, 3> &
+  atomSpatialIndex::chargePosition(const unsigned int chargeId) const
+  {
+    return d_chargePositions[chargeId];
+  }
+
+
+  unsigned int
+  atomSpatialIndex::atomIdOfCharge(const unsigned int chargeId) const
+  {
+    return d_atomIdsOfCharges[chargeId];
+  }
+
+
+  unsigned int
+  atomSpatialIndex::nearestCharge(const std::array<double, 3> &point) const
+  {
+    AssertThrow(!d_chargePositions.empty(),
+                dealii::ExcMessage(
+                  "DFT-FE Error: nearest charge query without charges."));
+
+    // squared distance of the point to the box of the bins
+    double             outsideDistance = 0.0;
+    std::array<int, 3> center, numBins;
+    int                maxShell = 0;
+    for (unsigned int d = 0; d < 3; ++d)
+      {
+        const double outside =
+          std::max(0.0,
+                   std::max(d_lower[d] - point[d],
+                            point[d] - d_lower[d] - d_numBins[d] * d_binSize));
+        outsideDistance += outside * outside;
+        center[d]  = binIndex(point[d], d);
+        numBins[d] = d_numBins[d];
+        maxShell   = std::max(maxShell,
+                            std::max(center[d], numBins[d] - 1 - center[d]));
+      }
+
+    double       bestDistance = std::numeric_limits<double>::max();
+    unsigned int bestCharge   = 0;
+    auto         visitBin     = [&](const int i, const int j, const int k) {
+      const unsigned int bin = (i * numBins[1] + j) * numBins[2] + k;
+      for (unsigned int c = d_binStart[bin]; c < d_binStart[bin + 1]; ++c)
+        {
+          const unsigned int charge = d_binCharges[c];
+          const double       distance =
+            distanceSquared(point, d_chargePositions[charge]);
+          if (distance < bestDistance ||
+              (distance == bestDistance && charge < bestCharge))
+            {
+              bestDistance = distance;
+              bestCharge   = charge;
+            }
+        }
+    };
+
+    //
+    // the bins of the shell s + 1 around the (clamped) bin of the point are
+    // at least s bin sizes away from the projection of the point onto the
+    // box of the bins, which lies in the bin of the point
+    //
+    for (int s = 0; s <= maxShell; ++s)
+      {
+        for (int i = std::max(0, center[0] - s);
+             i <= std::min(numBins[0] - 1, center[0] + s);
+             ++i)
+          for (int j = std::max(0, center[1] - s);
+               j <= std::min(numBins[1] - 1, center[1] + s);
+               ++j)
+            {
+              if (std::abs(i - center[0]) == s || std::abs(j - center[1]) == s)
+                {
+                  for (int k = std::max(0, center[2] - s);
+                       k <= std::min(numBins[2] - 1, center[2] + s);
+                       ++k)
+                    visitBin(i, j, k);
+                }
+              else
+                {
+                  if (center[2] - s >= 0)
+                    visitBin(i, j, center[2] - s);
+                  if (center[2] + s < numBins[2])
+                    visitBin(i, j, center[2] + s);
+                }
+            }
+        const double shellDistance = s * d_binSize;
+        if (bestDistance < outsideDistance + shellDistance * shellDistance)
+          break;
+      }
+
+    return bestCharge;
+  }
+
+
+  unsigned int
+  atomSpatialIndex::nearestAtom(const std::array<double, 3> &point) const
+  {
+    return d_atomIdsOfCharges[nearestCharge(point)];
+  }
+
+
+  void
+  atomSpatialIndex::chargesWithinRadius(
+    const std::array<double, 3> &point,
+    const double                 radius,
+    std::vector<unsigned int> &  chargeIds) const
+  {
+    chargeIds.clear();
+    if (d_chargePositions.empty() || radius < 0.0)
+      return;
+
+    std::array<unsigned int, 3> lowerBin, upperBin;
+    for (unsigned int d = 0; d < 3; ++d)
+      {
+        lowerBin[d] = binIndex(point[d] - radius, d);
+        upperBin[d] = binIndex(point[d] + radius, d);
+      }
+
+    const double radiusSquared = radius * radius;
+    for (unsigned int i = lowerBin[0]; i <= upperBin[0]; ++i)
+      for (unsigned int j = lowerBin[1]; j <= upperBin[1]; ++j)
+        for (unsigned int k = lowerBin[2]; k <= upperBin[2]; ++k)
+          {
+            const unsigned int bin = (i * d_numBins[1] + j) * d_numBins[2] + k;
+            for (unsigned int c = d_binStart[bin]; c < d_binStart[bin + 1];
+                 ++c)
+              if (distanceSquared(point,
+                                  d_chargePositions[d_binCharges[c]]) <=
+                  radiusSquared)
+                chargeIds.push_back(d_binCharges[c]);
+          }
+    std::sort(chargeIds.begin(), chargeIds.end());
+  }
+
+
+  unsigned int
+  atomSpatialIndex::numberOfBuilds() const
+  {
+    return d_numberOfBuilds;
+  }
+
+} // namespace dftfe
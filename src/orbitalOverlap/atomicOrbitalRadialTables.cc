@@ -0,0 +1,144 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <atomicOrbitalRadialTables.h>
+#include <fileReaders.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <cmath>
+#include <vector>
+
+namespace dftfe
+{
+  namespace
+  {
+    std::array<unsigned int, 4>
+    tableKey(const atomicOrbitalRadialTables::source fileSource,
+             const unsigned int                      Z,
+             const unsigned int                      n,
+             const unsigned int                      l)
+    {
+      return {(unsigned int)fileSource, Z, n, l};
+    }
+  } // namespace
+
+
+  const atomicOrbitalRadialTables::radialTable *
+  atomicOrbitalRadialTables::table(const source       fileSource,
+                                   const unsigned int Z,
+                                   const unsigned int n,
+                                   const unsigned int l,
+                                   const std::string &fileName)
+  {
+    const std::array<unsigned int, 4> key = tableKey(fileSource, Z, n, l);
+    const auto                        it  = d_tables.find(key);
+    if (it != d_tables.end())
+      return it->second.get();
+
+    std::vector<std::vector<double>> values;
+    const int isRead = dftUtils::readPsiFile(2, values, fileName);
+    AssertThrow(isRead > 0 || fileSource == source::singleAtomWavefunction,
+                dealii::ExcMessage("DFT-FE Error: could not read the "
+                                   "pseudo-atomic orbital file " +
+                                   fileName + "."));
+    if (isRead == 0)
+      {
+        d_tables[key] = nullptr;
+        return nullptr;
+      }
+
+    // the last row of the single atom data is not a data point
+    const int numRows = fileSource == source::singleAtomWavefunction ?
+                          (int)values.size() - 1 :
+                          (int)values.size();
+    AssertThrow(numRows >= 2,
+                dealii::ExcMessage("DFT-FE Error: too few radial points in " +
+                                   fileName + "."));
+
+    std::unique_ptr<radialTable> radial(new radialTable);
+    std::vector<double>          xData(numRows), yData(numRows);
+    alglib::ae_int_t             rightBoundType = 0;
+    if (fileSource == source::singleAtomWavefunction)
+      {
+        for (int irow = 0; irow < numRows; ++irow)
+          {
+            xData[irow] = values[irow][0];
+            yData[irow] = values[irow][1];
+          }
+      }
+    else
+      {
+        // r R(r) is tabulated, R(0) is taken from the first point off the
+        // origin
+        for (int irow = 0; irow < numRows; ++irow)
+          {
+            xData[irow] = values[irow][0];
+            if (xData[irow] <= 0.00001)
+              yData[irow] = values[irow + 1][1] / values[irow + 1][0];
+            else
+              yData[irow] = values[irow][1] / xData[irow];
+          }
+        yData[0]       = yData[1];
+        rightBoundType = 1;
+      }
+
+    const double truncationTol = 1e-8;
+    unsigned int truncRowId    = 0;
+    for (unsigned int irow = 0; irow < yData.size(); ++irow)
+      if (std::fabs(yData[irow]) > truncationTol)
+        truncRowId = irow;
+    radial->rmin = fileSource == source::pseudoAtomicOrbital ? xData[1] :
+                                                               xData[0];
+    radial->rmax = xData.back();
+    radial->truncationRadius =
+      fileSource == source::pseudoAtomicOrbital ? xData.back() :
+                                                  xData[truncRowId];
+
+    alglib::real_1d_array x;
+    x.setcontent(xData.size(), &xData[0]);
+    alglib::real_1d_array y;
+    y.setcontent(yData.size(), &yData[0]);
+    alglib::spline1dbuildcubic(
+      x, y, xData.size(), 0, 0.0, rightBoundType, 0.0, radial->spline);
+
+    d_tables[key] = std::move(radial);
+    return d_tables[key].get();
+  }
+
+
+  bool
+  atomicOrbitalRadialTables::isKnown(const source       fileSource,
+                                     const unsigned int Z,
+                                     const unsigned int n,
+                                     const unsigned int l) const
+  {
+    return d_tables.count(tableKey(fileSource, Z, n, l)) > 0;
+  }
+
+
+  unsigned int
+  atomicOrbitalRadialTables::numberOfTables() const
+  {
+    unsigned int numTables = 0;
+    for (const auto &entry : d_tables)
+      if (entry.second)
+        ++numTables;
+    return numTables;
+  }
+
+} // namespace dftfe
@@ -0,0 +1,180 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <cachedPopulationProjection.h>
+#include <matrixmatrixmul.h>
+#include <overlapPopulationAnalysis.h>
+#include <dftfeDataTypes.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include <complex>
+
+namespace dftfe
+{
+  template <typename T>
+  cachedPopulationProjection<T>::cachedPopulationProjection(
+    const std::vector<T> &Phi,
+    const unsigned int    nDofs,
+    const unsigned int    nBasis,
+    const double          overlapEigenvalueThreshold,
+    const MPI_Comm &      mpiComm)
+    : d_nDofs(nDofs)
+    , d_nBasis(nBasis)
+    , d_mpiComm(mpiComm)
+    , d_Phi(Phi)
+    , d_S(nBasis * nBasis, T(0.0))
+    , d_retainedDim(0)
+  {
+    AssertThrow(Phi.size() == (std::size_t)nDofs * nBasis,
+                dealii::ExcMessage(
+                  "DFT-FE Error: basis values do not match the number of FE "
+                  "nodes and basis functions."));
+    if (nBasis == 0)
+      return;
+
+    if (nDofs > 0)
+      d_S = matrixTmatrixmul(d_Phi, nDofs, nBasis, d_Phi, nDofs, nBasis);
+    MPI_Allreduce(MPI_IN_PLACE,
+                  &d_S[0],
+                  d_S.size(),
+                  dataTypes::mpi_type_id(&d_S[0]),
+                  MPI_SUM,
+                  d_mpiComm);
+
+    std::vector<double> D(nBasis, 0.0);
+    std::vector<T>      U(nBasis * nBasis, T(0.0));
+    if (dealii::Utilities::MPI::this_mpi_process(d_mpiComm) == 0)
+      {
+        std::vector<T> S(d_S);
+        U = diagonalization(S, nBasis, D);
+      }
+    MPI_Bcast(&D[0], nBasis, MPI_DOUBLE, 0, d_mpiComm);
+    MPI_Bcast(
+      &U[0], nBasis * nBasis, dataTypes::mpi_type_id(&U[0]), 0, d_mpiComm);
+
+    std::vector<T> Ut = TransposeMatrix(U, nBasis);
+    d_retainedDim     = canonicalOrthogonalization(
+      D, Ut, nBasis, overlapEigenvalueThreshold, d_X, d_Uk);
+    AssertThrow(d_retainedDim > 0,
+                dealii::ExcMessage(
+                  "DFT-FE Error: all eigenvalues of the atomic orbital overlap "
+                  "matrix are below OVERLAP EIGENVALUE THRESHOLD."));
+  }
+
+
+  template <typename T>
+  unsigned int
+  cachedPopulationProjection<T>::basisDimension() const
+  {
+    return d_nBasis;
+  }
+
+
+  template <typename T>
+  unsigned int
+  cachedPopulationProjection<T>::retainedDimension() const
+  {
+    return d_retainedDim;
+  }
+
+
+  template <typename T>
+  void
+  cachedPopulationProjection<T>::accumulateAtomPopulations(
+    const std::vector<T> &           Psi,
+    const unsigned int               nKS,
+    const std::vector<double> &      occupations,
+    const std::vector<unsigned int> &atomBasisStart,
+    const double                     weight,
+    std::vector<double> &            mullikenPopulations,
+    std::vector<double> &            loewdinPopulations) const
+  {
+    const unsigned int numAtoms = mullikenPopulations.size();
+    AssertThrow(Psi.size() == (std::size_t)d_nDofs * nKS &&
+                  occupations.size() >= nKS,
+                dealii::ExcMessage(
+                  "DFT-FE Error: Kohn-Sham orbital values do not match the "
+                  "number of FE nodes and orbitals."));
+    AssertThrow(atomBasisStart.size() == numAtoms + 1 &&
+                  loewdinPopulations.size() == numAtoms &&
+                  atomBasisStart[numAtoms] == d_nBasis,
+                dealii::ExcMessage(
+                  "DFT-FE Error: atom populations do not match the basis."));
+    const unsigned int n = d_nBasis;
+    const unsigned int k = d_retainedDim;
+    if (n == 0 || nKS == 0)
+      return;
+
+    std::vector<T> PhiTPsi(n * nKS, T(0.0));
+    if (d_nDofs > 0)
+      PhiTPsi = matrixTmatrixmul(d_Phi, d_nDofs, n, Psi, d_nDofs, nKS);
+    MPI_Allreduce(MPI_IN_PLACE,
+                  &PhiTPsi[0],
+                  PhiTPsi.size(),
+                  dataTypes::mpi_type_id(&PhiTPsi[0]),
+                  MPI_SUM,
+                  d_mpiComm);
+
+    //
+    // C = X^H Phi^H Psi, O = C^H C and C O^{-1/2}, as in the full analysis
+    //
+    const std::vector<T> C = matrixTmatrixmul(d_X, n, k, PhiTPsi, n, nKS);
+    std::vector<T>       O = matrixTmatrixmul(C, k, nKS, C, k, nKS);
+
+    std::vector<double> D_O(nKS, 0.0);
+    std::vector<T>      U_O(nKS * nKS, T(0.0));
+    if (dealii::Utilities::MPI::this_mpi_process(d_mpiComm) == 0)
+      U_O = diagonalization(O, nKS, D_O);
+    MPI_Bcast(&D_O[0], nKS, MPI_DOUBLE, 0, d_mpiComm);
+    MPI_Bcast(
+      &U_O[0], nKS * nKS, dataTypes::mpi_type_id(&U_O[0]), 0, d_mpiComm);
+
+    std::vector<T>       U_Ot       = TransposeMatrix(U_O, nKS);
+    const std::vector<T> Ominushalf = powerOfMatrix(-0.5, D_O, U_Ot, nKS, U_Ot);
+    const std::vector<T> reducedC_bar =
+      matrixmatrixmul(C, k, nKS, Ominushalf, nKS, nKS);
+
+    const std::vector<T> C_bar =
+      matrixmatrixmul(d_X, n, k, reducedC_bar, k, nKS);
+    const std::vector<T> SC_bar =
+      matrixmatrixmul(d_S, n, n, C_bar, n, nKS);
+    const std::vector<T> C_hat =
+      matrixmatrixmul(d_Uk, n, k, reducedC_bar, k, nKS);
+    const std::vector<double> mullikenWeights =
+      orbitalWeightsOfProjection(C_bar, SC_bar, n, nKS);
+    const std::vector<double> loewdinWeights =
+      orbitalWeightsOfProjection(C_hat, C_hat, n, nKS);
+
+    for (unsigned int atom = 0; atom < numAtoms; ++atom)
+      for (unsigned int a = atomBasisStart[atom]; a < atomBasisStart[atom + 1];
+           ++a)
+        for (unsigned int j = 0; j < nKS; ++j)
+          {
+            mullikenPopulations[atom] +=
+              weight * occupations[j] * mullikenWeights[a * nKS + j];
+            loewdinPopulations[atom] +=
+              weight * occupations[j] * loewdinWeights[a * nKS + j];
+          }
+  }
+
+
+  template class cachedPopulationProjection<double>;
+  template class cachedPopulationProjection<std::complex<double>>;
+
+} // namespace dftfe
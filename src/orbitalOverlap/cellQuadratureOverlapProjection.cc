@@ -0,0 +1,181 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <cellQuadratureOverlapProjection.h>
+#include <matrixmatrixmul.h>
+#include <dftfeDataTypes.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <complex>
+
+namespace dftfe
+{
+  template <typename T>
+  cellQuadratureOverlapProjection<T>::cellQuadratureOverlapProjection(
+    const unsigned int         nBasis,
+    const unsigned int         nKS,
+    const unsigned int         nQuadPointsPerCell,
+    const unsigned int         nNodesPerCell,
+    const std::vector<double> &shapeFunctionValues,
+    const MPI_Comm &           mpiComm)
+    : d_nBasis(nBasis)
+    , d_nKS(nKS)
+    , d_nQuadPointsPerCell(nQuadPointsPerCell)
+    , d_nNodesPerCell(nNodesPerCell)
+    , d_mpiComm(mpiComm)
+    , d_shapeFunctionValues(shapeFunctionValues.begin(),
+                            shapeFunctionValues.end())
+    , d_S(nBasis * nBasis, T(0.0))
+    , d_projections(nBasis * nKS, T(0.0))
+    , d_projectionRequest(MPI_REQUEST_NULL)
+    , d_isProjectionReductionPosted(false)
+  {
+    AssertThrow(shapeFunctionValues.size() ==
+                  (std::size_t)nQuadPointsPerCell * nNodesPerCell,
+                dealii::ExcMessage(
+                  "DFT-FE Error: shape function values do not match the "
+                  "number of quadrature points and nodes of the cells."));
+  }
+
+
+  template <typename T>
+  cellQuadratureOverlapProjection<T>::~cellQuadratureOverlapProjection()
+  {
+    MPI_Wait(&d_projectionRequest, MPI_STATUS_IGNORE);
+  }
+
+
+  template <typename T>
+  unsigned int
+  cellQuadratureOverlapProjection<T>::cellsPerBatch(
+    const unsigned int nQuadPointsPerCell,
+    const unsigned int nNodesPerCell,
+    const unsigned int nColumns,
+    const std::size_t  cacheBytes)
+  {
+    const std::size_t bytesPerCell =
+      sizeof(T) * (std::size_t)(nQuadPointsPerCell + nNodesPerCell) *
+      std::max(nColumns, 1u);
+    return std::max<std::size_t>(1, cacheBytes / bytesPerCell);
+  }
+
+
+  template <typename T>
+  void
+  cellQuadratureOverlapProjection<T>::addCells(
+    const std::vector<T> &           cellNodalPsi,
+    const std::vector<T> &           quadPointScaling,
+    const std::vector<T> &           Phi,
+    const std::vector<unsigned int> &basisIds,
+    const unsigned int               nCells)
+  {
+    const unsigned int nRows = d_nQuadPointsPerCell * nCells;
+    const unsigned int m     = basisIds.size();
+    AssertThrow(cellNodalPsi.size() ==
+                    (std::size_t)d_nNodesPerCell * nCells * d_nKS &&
+                  quadPointScaling.size() == nRows &&
+                  Phi.size() == (std::size_t)nRows * m,
+                dealii::ExcMessage(
+                  "DFT-FE Error: cell batch values do not match the number "
+                  "of cells, quadrature points and basis functions."));
+    AssertThrow(!d_isProjectionReductionPosted,
+                dealii::ExcMessage(
+                  "DFT-FE Error: cells added after the reduction."));
+    if (nCells == 0 || m == 0)
+      return;
+
+    // Kohn-Sham orbitals at the quadrature points of all cells of the batch,
+    // (nQ x nNodes) (nNodes x nCells nKS) gives the rows q * nCells + c
+    std::vector<T> PsiQuad = matrixmatrixmul(d_shapeFunctionValues,
+                                             d_nQuadPointsPerCell,
+                                             d_nNodesPerCell,
+                                             cellNodalPsi,
+                                             d_nNodesPerCell,
+                                             nCells * d_nKS);
+    for (unsigned int row = 0; row < nRows; ++row)
+      for (unsigned int j = 0; j < d_nKS; ++j)
+        PsiQuad[row * d_nKS + j] *= quadPointScaling[row];
+
+    const std::vector<T> SBatch =
+      matrixTmatrixmul(Phi, nRows, m, Phi, nRows, m);
+    for (unsigned int a = 0; a < m; ++a)
+      for (unsigned int b = 0; b < m; ++b)
+        d_S[basisIds[a] * d_nBasis + basisIds[b]] += SBatch[a * m + b];
+
+    if (d_nKS == 0)
+      return;
+    const std::vector<T> PBatch =
+      matrixTmatrixmul(Phi, nRows, m, PsiQuad, nRows, d_nKS);
+    for (unsigned int a = 0; a < m; ++a)
+      for (unsigned int j = 0; j < d_nKS; ++j)
+        d_projections[basisIds[a] * d_nKS + j] += PBatch[a * d_nKS + j];
+  }
+
+
+  template <typename T>
+  std::vector<T>
+  cellQuadratureOverlapProjection<T>::overlapMatrix()
+  {
+    std::vector<T> S(d_S);
+    if (!S.empty())
+      MPI_Allreduce(MPI_IN_PLACE,
+                    &S[0],
+                    S.size(),
+                    dataTypes::mpi_type_id(&S[0]),
+                    MPI_SUM,
+                    d_mpiComm);
+
+    // the projections are reduced while S is diagonalized
+    postProjectionReduction();
+    return S;
+  }
+
+
+  template <typename T>
+  std::vector<T>
+  cellQuadratureOverlapProjection<T>::projections()
+  {
+    postProjectionReduction();
+    MPI_Wait(&d_projectionRequest, MPI_STATUS_IGNORE);
+    return d_projections;
+  }
+
+
+  template <typename T>
+  void
+  cellQuadratureOverlapProjection<T>::postProjectionReduction()
+  {
+    if (d_isProjectionReductionPosted)
+      return;
+    if (!d_projections.empty())
+      MPI_Iallreduce(MPI_IN_PLACE,
+                     &d_projections[0],
+                     d_projections.size(),
+                     dataTypes::mpi_type_id(&d_projections[0]),
+                     MPI_SUM,
+                     d_mpiComm,
+                     &d_projectionRequest);
+    d_isProjectionReductionPosted = true;
+  }
+
+
+  template class cellQuadratureOverlapProjection<double>;
+  template class cellQuadratureOverlapProjection<std::complex<double>>;
+
+} // namespace dftfe
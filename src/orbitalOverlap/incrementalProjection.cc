@@ -0,0 +1,215 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <incrementalProjection.h>
+#include <matrixmatrixmul.h>
+#include <dftfeDataTypes.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include <complex>
+
+namespace dftfe
+{
+  template <typename T>
+  incrementalProjection<T>::incrementalProjection(
+    const std::vector<T> &Psi,
+    const unsigned int    nDofs,
+    const unsigned int    nKS,
+    const double          overlapEigenvalueThreshold,
+    const MPI_Comm &      mpiComm)
+    : d_Psi(Psi)
+    , d_nDofs(nDofs)
+    , d_nKS(nKS)
+    , d_overlapEigenvalueThreshold(overlapEigenvalueThreshold)
+    , d_mpiComm(mpiComm)
+    , d_projectabilities(nKS, 0.0)
+    , d_basisDim(0)
+    , d_retainedDim(0)
+  {
+    AssertThrow(Psi.size() == (std::size_t)nDofs * nKS,
+                dealii::ExcMessage(
+                  "DFT-FE Error: Kohn-Sham orbital values do not match the "
+                  "number of FE nodes and orbitals."));
+  }
+
+
+  template <typename T>
+  unsigned int
+  incrementalProjection<T>::appendBasis(const std::vector<T> &PhiNew,
+                                        const unsigned int    m)
+  {
+    AssertThrow(PhiNew.size() == (std::size_t)d_nDofs * m,
+                dealii::ExcMessage(
+                  "DFT-FE Error: appended basis values do not match the "
+                  "number of FE nodes."));
+    if (m == 0)
+      return 0;
+
+    const unsigned int n = d_basisDim;
+    const unsigned int k = d_retainedDim;
+    const unsigned int N = d_nKS;
+
+    //
+    // new blocks S_12 (n x m), S_22 (m x m) and Phi_2^H Psi (m x N) reduced
+    // over the FE nodes in a single message
+    //
+    std::vector<T> buffer(n * m + m * m + m * N, T(0.0));
+    if (d_nDofs > 0)
+      {
+        if (n > 0)
+          {
+            const std::vector<T> S12 =
+              matrixTmatrixmul(d_Phi, d_nDofs, n, PhiNew, d_nDofs, m);
+            std::copy(S12.begin(), S12.end(), buffer.begin());
+          }
+        const std::vector<T> S22 =
+          matrixTmatrixmul(PhiNew, d_nDofs, m, PhiNew, d_nDofs, m);
+        std::copy(S22.begin(), S22.end(), buffer.begin() + n * m);
+        const std::vector<T> P2 =
+          matrixTmatrixmul(PhiNew, d_nDofs, m, d_Psi, d_nDofs, N);
+        std::copy(P2.begin(), P2.end(), buffer.begin() + n * m + m * m);
+      }
+    MPI_Allreduce(MPI_IN_PLACE,
+                  &buffer[0],
+                  buffer.size(),
+                  dataTypes::mpi_type_id(&buffer[0]),
+                  MPI_SUM,
+                  d_mpiComm);
+
+    const std::vector<T> S12(buffer.begin(), buffer.begin() + n * m);
+    std::vector<T>       complementS(buffer.begin() + n * m,
+                               buffer.begin() + n * m + m * m);
+    std::vector<T>       complementP(buffer.begin() + n * m + m * m,
+                               buffer.end());
+
+    //
+    // overlap S_22 - Q^H Q and projections Phi_2^H Psi - Q^H C of the part of
+    // Phi_2 orthogonal to the current orthonormal basis
+    //
+    std::vector<T> Q;
+    if (k > 0)
+      {
+        Q = matrixTmatrixmul(d_W, n, k, S12, n, m);
+        const std::vector<T> QhQ = matrixTmatrixmul(Q, k, m, Q, k, m);
+        const std::vector<T> QhC = matrixTmatrixmul(Q, k, m, d_C, k, N);
+        for (unsigned int i = 0; i < m * m; ++i)
+          complementS[i] -= QhQ[i];
+        for (unsigned int i = 0; i < m * N; ++i)
+          complementP[i] -= QhC[i];
+      }
+
+    std::vector<double> D(m, 0.0);
+    std::vector<T>      U(m * m, T(0.0));
+    if (dealii::Utilities::MPI::this_mpi_process(d_mpiComm) == 0)
+      U = diagonalization(complementS, m, D);
+    MPI_Bcast(&D[0], m, MPI_DOUBLE, 0, d_mpiComm);
+    MPI_Bcast(&U[0], m * m, dataTypes::mpi_type_id(&U[0]), 0, d_mpiComm);
+
+    std::vector<T>     Ut = TransposeMatrix(U, m);
+    std::vector<T>     Y, Uk;
+    const unsigned int kNew = canonicalOrthogonalization(
+      D, Ut, m, d_overlapEigenvalueThreshold, Y, Uk);
+
+    //
+    // W <- [W, -W Q Y; 0, Y] and C <- [C; Y^H (Phi_2^H Psi - Q^H C)]
+    //
+    std::vector<T> W((n + m) * (k + kNew), T(0.0));
+    for (unsigned int i = 0; i < n; ++i)
+      for (unsigned int j = 0; j < k; ++j)
+        W[i * (k + kNew) + j] = d_W[i * k + j];
+    if (kNew > 0)
+      {
+        if (k > 0)
+          {
+            const std::vector<T> QY  = matrixmatrixmul(Q, k, m, Y, m, kNew);
+            const std::vector<T> WQY = matrixmatrixmul(d_W, n, k, QY, k, kNew);
+            for (unsigned int i = 0; i < n; ++i)
+              for (unsigned int j = 0; j < kNew; ++j)
+                W[i * (k + kNew) + k + j] = -WQY[i * kNew + j];
+          }
+        for (unsigned int i = 0; i < m; ++i)
+          for (unsigned int j = 0; j < kNew; ++j)
+            W[(n + i) * (k + kNew) + k + j] = Y[i * kNew + j];
+
+        const std::vector<T> CNew =
+          matrixTmatrixmul(Y, m, kNew, complementP, m, N);
+        d_C.insert(d_C.end(), CNew.begin(), CNew.end());
+        for (unsigned int r = 0; r < kNew; ++r)
+          for (unsigned int i = 0; i < N; ++i)
+            d_projectabilities[i] += std::norm(CNew[r * N + i]);
+      }
+    d_W.swap(W);
+
+    std::vector<T> Phi(d_nDofs * (n + m));
+    for (unsigned int dof = 0; dof < d_nDofs; ++dof)
+      {
+        std::copy(d_Phi.begin() + dof * n,
+                  d_Phi.begin() + (dof + 1) * n,
+                  Phi.begin() + dof * (n + m));
+        std::copy(PhiNew.begin() + dof * m,
+                  PhiNew.begin() + (dof + 1) * m,
+                  Phi.begin() + dof * (n + m) + n);
+      }
+    d_Phi.swap(Phi);
+
+    d_basisDim += m;
+    d_retainedDim += kNew;
+    return kNew;
+  }
+
+
+  template <typename T>
+  unsigned int
+  incrementalProjection<T>::basisDimension() const
+  {
+    return d_basisDim;
+  }
+
+
+  template <typename T>
+  unsigned int
+  incrementalProjection<T>::retainedDimension() const
+  {
+    return d_retainedDim;
+  }
+
+
+  template <typename T>
+  const std::vector<double> &
+  incrementalProjection<T>::projectabilities() const
+  {
+    return d_projectabilities;
+  }
+
+
+  template <typename T>
+  std::vector<T>
+  incrementalProjection<T>::coefficients() const
+  {
+    if (d_retainedDim == 0)
+      return std::vector<T>(d_basisDim * d_nKS, T(0.0));
+    return matrixmatrixmul(
+      d_W, d_basisDim, d_retainedDim, d_C, d_retainedDim, d_nKS);
+  }
+
+
+  template class incrementalProjection<double>;
+  template class incrementalProjection<std::complex<double>>;
+
+} // namespace dftfe
@@ -534,18 +534,9 @@ std::vector<std::complex<double>> diagonalization(std::vector<std::complex<doubl
       std::vector<std::complex<double>>().swap(work);
       std::vector<double>().swap(rwork);
       std::vector<int>().swap(iwork);
-  std::cout<<"Info Value: "<<info<<std::endl;    
   if (info > 0)
     std::cout << "Eigen Value Decomposition Falied!!" << std::endl;  
 
-  auto Identity = matrixTmatrixmul(Stemp,N,N,Stemp,N,N);
-  std::cout<<"Ortho check"<<std::endl;
-  for (int i = 0; i < N; i++)
-  {
-    for (int j = 0; j < N; j++)
-      std::cout<<Identity[i*N+j]<<" ";
-    std::cout<<std::endl;  
-  }
   return Stemp;
 
 }
@@ -564,6 +555,36 @@ TransposeMatrix(std::vector<std::complex<double>> &A, int N)
   return B;
 
 }
+
+unsigned int
+canonicalOrthogonalization(const std::vector<double> &              D,
+                           const std::vector<std::complex<double>> &Ut,
+                           const unsigned int                       N,
+                           const double                             threshold,
+                           std::vector<std::complex<double>> &      X,
+                           std::vector<std::complex<double>> &      Uk)
+{
+  std::vector<unsigned int> keptIndices;
+  for (unsigned int j = 0; j < N; j++)
+    if (D[j] > threshold)
+      keptIndices.push_back(j);
+
+  const unsigned int k = keptIndices.size();
+  X.assign(N * k, std::complex<double>(0.0, 0.0));
+  Uk.assign(N * k, std::complex<double>(0.0, 0.0));
+  for (unsigned int c = 0; c < k; c++)
+    {
+      const unsigned int j           = keptIndices[c];
+      const double       invSqrtDiag = 1.0 / std::sqrt(D[j]);
+      for (unsigned int i = 0; i < N; i++)
+        {
+          Uk[i * k + c] = Ut[i * N + j];
+          X[i * k + c]  = invSqrtDiag * Ut[i * N + j];
+        }
+    }
+
+  return k;
+}
 std::vector<std::complex<double>>
 computeHprojOrbital(std::vector<std::complex<double>>              C,
                     std::vector<std::complex<double>> &C_hat,
@@ -1285,7 +1306,7 @@ computeHprojOrbital(std::vector<double>              C,
 
   dftfe::dlascl2_(&N,&m,&H[0],&C[0],&N);
 
-  auto Hproj  = matrixmatrixTmul(C_hat, m, N, C, N, m);
+  auto Hproj  = matrixmatrixTmul(C_hat, m, N, C, m, N);
 
 
   return Hproj;
@@ -1360,6 +1381,36 @@ TransposeMatrix(std::vector<double> &A, int N)
   return B;
 
 }
+
+unsigned int
+canonicalOrthogonalization(const std::vector<double> &D,
+                           const std::vector<double> &Ut,
+                           const unsigned int         N,
+                           const double               threshold,
+                           std::vector<double> &      X,
+                           std::vector<double> &      Uk)
+{
+  std::vector<unsigned int> keptIndices;
+  for (unsigned int j = 0; j < N; j++)
+    if (D[j] > threshold)
+      keptIndices.push_back(j);
+
+  const unsigned int k = keptIndices.size();
+  X.assign(N * k, 0.0);
+  Uk.assign(N * k, 0.0);
+  for (unsigned int c = 0; c < k; c++)
+    {
+      const unsigned int j           = keptIndices[c];
+      const double       invSqrtDiag = 1.0 / std::sqrt(D[j]);
+      for (unsigned int i = 0; i < N; i++)
+        {
+          Uk[i * k + c] = Ut[i * N + j];
+          X[i * k + c]  = invSqrtDiag * Ut[i * N + j];
+        }
+    }
+
+  return k;
+}
 //#endif
 
 
@@ -223,7 +223,7 @@ spillFactorsOfProjection(const std::vector<double> &coeffMatrixVecOfProj,
 }
 
 
-void
+spillFactors
 spillFactorsofProjectionwithCS(const std::vector<double> &C,
                                const std::vector<double> &Sold,
                                const std::vector<double> &occupationNum,
@@ -239,13 +239,13 @@ spillFactorsofProjectionwithCS(const std::vector<double> &C,
     {
       for (int j = i; j < n2; j++)
         {
-          S[i * n1 + j] = Sold[count];
-          S[j * m1 + i] = Sold[count];
+          S[i * n2 + j] = Sold[count];
+          S[j * n2 + i] = Sold[count];
           count++;
         }
     }
-  auto         temp                = matrixTmatrixmul(C, n1, m1, S, m2, n2);
-  auto         O                   = matrixmatrixmul(temp, n1, n2, C, n1, m1);
+  auto         temp                = matrixTmatrixmul(C, m1, n1, S, m2, n2);
+  auto         O                   = matrixmatrixmul(temp, n1, n2, C, m1, n1);
   double       TSF                 = 0.0;
   double       CSF                 = 0.0;
   double       fCSF                = 0.0;
@@ -290,7 +290,371 @@ spillFactorsofProjectionwithCS(const std::vector<double> &C,
   std::cout << "CSFabs: " << CSFabs << std::endl;
   std::cout << "fCSF: " << fCSF << std::endl;
   std::cout << "fCSFabs: " << fCSFabs << std::endl;
+
+  spillFactors spillvalues             = {};
+  spillvalues.totalSpilling            = TSF;
+  spillvalues.absTotalSpilling         = TSFabs;
+  spillvalues.occupiedBandsSpilling    = CSF;
+  spillvalues.absOccupiedBandsSpilling = CSFabs;
+  spillvalues.chargeSpilling           = fCSF;
+  spillvalues.absChargeSpilling        = fCSFabs;
+  spillvalues.projectabilities.resize(N);
+  for (int i = 0; i < N; i++)
+    spillvalues.projectabilities[i] = O[i * N + i];
+
+  return spillvalues;
+}
+template <typename T>
+static std::vector<double>
+projectabilitiesOfProjectionImpl(const std::vector<T> &C,
+                                 const std::vector<T> &PhiTPsi,
+                                 const unsigned int    nBasis,
+                                 const unsigned int    nKS,
+                                 const MPI_Comm &      mpiComm)
+{
+  const unsigned int thisRank =
+    dealii::Utilities::MPI::this_mpi_process(mpiComm);
+  const unsigned int numRanks =
+    dealii::Utilities::MPI::n_mpi_processes(mpiComm);
+
+  // contiguous block of bands owned by this rank
+  const unsigned int bandsPerRank = (nKS + numRanks - 1) / numRanks;
+  const unsigned int bandStart    = std::min(thisRank * bandsPerRank, nKS);
+  const unsigned int bandEnd      = std::min(bandStart + bandsPerRank, nKS);
+
+  std::vector<double> projectabilities(nKS, 0.0);
+  for (unsigned int a = 0; a < nBasis; ++a)
+    for (unsigned int i = bandStart; i < bandEnd; ++i)
+      projectabilities[i] +=
+        std::real(std::conj(C[a * nKS + i]) * PhiTPsi[a * nKS + i]);
+
+  MPI_Allreduce(MPI_IN_PLACE,
+                &projectabilities[0],
+                nKS,
+                MPI_DOUBLE,
+                MPI_SUM,
+                mpiComm);
+
+  return projectabilities;
 }
+
+
+std::vector<double>
+projectabilitiesOfProjection(const std::vector<double> &C,
+                             const std::vector<double> &PhiTPsi,
+                             const unsigned int         nBasis,
+                             const unsigned int         nKS,
+                             const MPI_Comm &           mpiComm)
+{
+  return projectabilitiesOfProjectionImpl(C, PhiTPsi, nBasis, nKS, mpiComm);
+}
+
+
+std::vector<double>
+projectabilitiesOfProjection(const std::vector<std::complex<double>> &C,
+                             const std::vector<std::complex<double>> &PhiTPsi,
+                             const unsigned int                       nBasis,
+                             const unsigned int                       nKS,
+                             const MPI_Comm &                         mpiComm)
+{
+  return projectabilitiesOfProjectionImpl(C, PhiTPsi, nBasis, nKS, mpiComm);
+}
+
+
+template <typename T>
+static std::vector<double>
+orbitalWeightsOfProjectionImpl(const std::vector<T> &A,
+                               const std::vector<T> &B,
+                               const unsigned int    nBasis,
+                               const unsigned int    nKS)
+{
+  std::vector<double> orbitalWeights(nBasis * nKS, 0.0);
+  for (unsigned int i = 0; i < nBasis * nKS; ++i)
+    orbitalWeights[i] = std::real(std::conj(A[i]) * B[i]);
+
+  return orbitalWeights;
+}
+
+
+std::vector<double>
+orbitalWeightsOfProjection(const std::vector<double> &A,
+                           const std::vector<double> &B,
+                           const unsigned int         nBasis,
+                           const unsigned int         nKS)
+{
+  return orbitalWeightsOfProjectionImpl(A, B, nBasis, nKS);
+}
+
+
+std::vector<double>
+orbitalWeightsOfProjection(const std::vector<std::complex<double>> &A,
+                           const std::vector<std::complex<double>> &B,
+                           const unsigned int                       nBasis,
+                           const unsigned int                       nKS)
+{
+  return orbitalWeightsOfProjectionImpl(A, B, nBasis, nKS);
+}
+
+
+template <typename T>
+static void
+accumulateAtomPairContractionsImpl(
+  const std::vector<T> &           C,
+  const std::vector<T> &           M,
+  const std::vector<double> &      occupationNum,
+  const unsigned int               nBasis,
+  const unsigned int               nKS,
+  const std::vector<unsigned int> &atomOfBasis,
+  const unsigned int               numAtoms,
+  const double                     weight,
+  std::vector<double> &            atomPairValues)
+{
+  if (nBasis == 0 || nKS == 0)
+    return;
+
+  // C^T and f C^T, nKS x nBasis
+  std::vector<T> Ct(nKS * nBasis), fCt(nKS * nBasis);
+  for (unsigned int a = 0; a < nBasis; ++a)
+    for (unsigned int j = 0; j < nKS; ++j)
+      {
+        Ct[j * nBasis + a]  = C[a * nKS + j];
+        fCt[j * nBasis + a] = occupationNum[j] * C[a * nKS + j];
+      }
+
+  // E = conj(C) f C^T, i.e. E_{ba} = P_{ab} for the density matrix
+  // P = C f C^H
+  const std::vector<T> E = matrixTmatrixmul(Ct, nKS, nBasis, fCt, nKS, nBasis);
+  for (unsigned int b = 0; b < nBasis; ++b)
+    for (unsigned int a = 0; a < nBasis; ++a)
+      atomPairValues[atomOfBasis[a] * numAtoms + atomOfBasis[b]] +=
+        weight * std::real(E[b * nBasis + a] * M[b * nBasis + a]);
+}
+
+
+void
+accumulateAtomPairContractions(const std::vector<double> &      C,
+                               const std::vector<double> &      M,
+                               const std::vector<double> &      occupationNum,
+                               const unsigned int               nBasis,
+                               const unsigned int               nKS,
+                               const std::vector<unsigned int> &atomOfBasis,
+                               const unsigned int               numAtoms,
+                               const double                     weight,
+                               std::vector<double> &            atomPairValues)
+{
+  accumulateAtomPairContractionsImpl(C,
+                                     M,
+                                     occupationNum,
+                                     nBasis,
+                                     nKS,
+                                     atomOfBasis,
+                                     numAtoms,
+                                     weight,
+                                     atomPairValues);
+}
+
+
+void
+accumulateAtomPairContractions(
+  const std::vector<std::complex<double>> &C,
+  const std::vector<std::complex<double>> &M,
+  const std::vector<double> &              occupationNum,
+  const unsigned int                       nBasis,
+  const unsigned int                       nKS,
+  const std::vector<unsigned int> &        atomOfBasis,
+  const unsigned int                       numAtoms,
+  const double                             weight,
+  std::vector<double> &                    atomPairValues)
+{
+  accumulateAtomPairContractionsImpl(C,
+                                     M,
+                                     occupationNum,
+                                     nBasis,
+                                     nKS,
+                                     atomOfBasis,
+                                     numAtoms,
+                                     weight,
+                                     atomPairValues);
+}
+
+
+template <typename T>
+void
+accumulateSelectedAtomPairContractionsImpl(
+  const std::vector<T> &                          C,
+  const std::vector<T> &                          M,
+  const std::vector<double> &                     occupationNum,
+  const unsigned int                              nBasis,
+  const unsigned int                              nKS,
+  const std::vector<unsigned int> &               atomBasisStart,
+  const std::vector<std::array<unsigned int, 2>> &atomPairs,
+  const double                                    weight,
+  std::vector<double> &                           pairValues)
+{
+  if (nBasis == 0 || nKS == 0 || atomPairs.empty())
+    return;
+
+  // pairs grouped by their first atom
+  std::vector<unsigned int> pairOrder(atomPairs.size());
+  std::iota(pairOrder.begin(), pairOrder.end(), 0);
+  std::stable_sort(pairOrder.begin(),
+                   pairOrder.end(),
+                   [&atomPairs](const unsigned int p, const unsigned int q) {
+                     return atomPairs[p][0] < atomPairs[q][0];
+                   });
+
+  unsigned int groupBegin = 0;
+  while (groupBegin < pairOrder.size())
+    {
+      const unsigned int atomA = atomPairs[pairOrder[groupBegin]][0];
+      unsigned int       groupEnd = groupBegin;
+      while (groupEnd < pairOrder.size() &&
+             atomPairs[pairOrder[groupEnd]][0] == atomA)
+        ++groupEnd;
+
+      const unsigned int startA = atomBasisStart[atomA];
+      const unsigned int nA     = atomBasisStart[atomA + 1] - startA;
+      unsigned int       nB     = 0;
+      for (unsigned int p = groupBegin; p < groupEnd; ++p)
+        {
+          const unsigned int atomB = atomPairs[pairOrder[p]][1];
+          nB += atomBasisStart[atomB + 1] - atomBasisStart[atomB];
+        }
+      if (nA == 0 || nB == 0)
+        {
+          groupBegin = groupEnd;
+          continue;
+        }
+
+      // C_A^T (nKS x nA) and f C_B^T of the second atoms (nKS x nB)
+      std::vector<T> CtA(nKS * nA), fCtB(nKS * nB);
+      for (unsigned int a = 0; a < nA; ++a)
+        for (unsigned int j = 0; j < nKS; ++j)
+          CtA[j * nA + a] = C[(startA + a) * nKS + j];
+      unsigned int column = 0;
+      for (unsigned int p = groupBegin; p < groupEnd; ++p)
+        {
+          const unsigned int atomB = atomPairs[pairOrder[p]][1];
+          for (unsigned int b = atomBasisStart[atomB];
+               b < atomBasisStart[atomB + 1];
+               ++b, ++column)
+            for (unsigned int j = 0; j < nKS; ++j)
+              fCtB[j * nB + column] = occupationNum[j] * C[b * nKS + j];
+        }
+
+      // X_{ab} = P_{ba}, and Re(P_{ab} M_{ba}) = Re(X_{ab} M_{ab})
+      const std::vector<T> X = matrixTmatrixmul(CtA, nKS, nA, fCtB, nKS, nB);
+      column                 = 0;
+      for (unsigned int p = groupBegin; p < groupEnd; ++p)
+        {
+          const unsigned int atomB = atomPairs[pairOrder[p]][1];
+          double             value = 0.0;
+          for (unsigned int a = 0; a < nA; ++a)
+            for (unsigned int b = atomBasisStart[atomB], c = column;
+                 b < atomBasisStart[atomB + 1];
+                 ++b, ++c)
+              value +=
+                std::real(X[a * nB + c] * M[(startA + a) * nBasis + b]);
+          pairValues[pairOrder[p]] += weight * value;
+          column += atomBasisStart[atomB + 1] - atomBasisStart[atomB];
+        }
+      groupBegin = groupEnd;
+    }
+}
+
+
+void
+accumulateSelectedAtomPairContractions(
+  const std::vector<double> &                     C,
+  const std::vector<double> &                     M,
+  const std::vector<double> &                     occupationNum,
+  const unsigned int                              nBasis,
+  const unsigned int                              nKS,
+  const std::vector<unsigned int> &               atomBasisStart,
+  const std::vector<std::array<unsigned int, 2>> &atomPairs,
+  const double                                    weight,
+  std::vector<double> &                           pairValues)
+{
+  accumulateSelectedAtomPairContractionsImpl(C,
+                                             M,
+                                             occupationNum,
+                                             nBasis,
+                                             nKS,
+                                             atomBasisStart,
+                                             atomPairs,
+                                             weight,
+                                             pairValues);
+}
+
+
+void
+accumulateSelectedAtomPairContractions(
+  const std::vector<std::complex<double>> &       C,
+  const std::vector<std::complex<double>> &       M,
+  const std::vector<double> &                     occupationNum,
+  const unsigned int                              nBasis,
+  const unsigned int                              nKS,
+  const std::vector<unsigned int> &               atomBasisStart,
+  const std::vector<std::array<unsigned int, 2>> &atomPairs,
+  const double                                    weight,
+  std::vector<double> &                           pairValues)
+{
+  accumulateSelectedAtomPairContractionsImpl(C,
+                                             M,
+                                             occupationNum,
+                                             nBasis,
+                                             nKS,
+                                             atomBasisStart,
+                                             atomPairs,
+                                             weight,
+                                             pairValues);
+}
+
+
+spillFactors
+spillFactorsFromProjectabilities(const std::vector<double> &projectabilities,
+                                 const std::vector<double> &occupationNum)
+{
+  spillFactors spillvalues     = {};
+  spillvalues.projectabilities = projectabilities;
+
+  const unsigned int numOfKSOrbitals = projectabilities.size();
+  const unsigned int numOfFilledKSorbitals =
+    std::min(numberOfFilledBands(occupationNum), numOfKSOrbitals);
+
+  double fsum = 0.0, fCSF = 0.0, fCSFabs = 0.0;
+  for (unsigned int i = 0; i < numOfKSOrbitals; ++i)
+    {
+      const double spill = 1.0 - projectabilities[i];
+      spillvalues.totalSpilling += spill;
+      spillvalues.absTotalSpilling += std::fabs(spill);
+      if (i < numOfFilledKSorbitals)
+        {
+          spillvalues.occupiedBandsSpilling += spill;
+          spillvalues.absOccupiedBandsSpilling += std::fabs(spill);
+        }
+      fCSF += occupationNum[i] * projectabilities[i];
+      fCSFabs += std::fabs(occupationNum[i] * projectabilities[i]);
+      fsum += occupationNum[i];
+    }
+
+  spillvalues.totalSpilling /= numOfKSOrbitals;
+  spillvalues.absTotalSpilling /= numOfKSOrbitals;
+  if (numOfFilledKSorbitals > 0)
+    {
+      spillvalues.occupiedBandsSpilling /= numOfFilledKSorbitals;
+      spillvalues.absOccupiedBandsSpilling /= numOfFilledKSorbitals;
+    }
+  if (fsum > 0.0)
+    {
+      spillvalues.chargeSpilling    = 1.0 - fCSF / fsum;
+      spillvalues.absChargeSpilling = 1.0 - fCSFabs / fsum;
+    }
+
+  return spillvalues;
+}
+
+
 void
 spillFactorsofProjectionwithCS(const std::vector<double> &C_up,
                                const std::vector<double> &C_down,
@@ -308,15 +672,15 @@ spillFactorsofProjectionwithCS(const std::vector<double> &C_up,
     {
       for (int j = i; j < n2; j++)
         {
-          S[i * n1 + j] = Sold[count];
-          S[j * m1 + i] = Sold[count];
+          S[i * n2 + j] = Sold[count];
+          S[j * n2 + i] = Sold[count];
           count++;
         }
     }
-  auto         temp_up   = matrixTmatrixmul(C_up, n1, m1, S, m2, n2);
-  auto         O_up      = matrixmatrixmul(temp_up, n1, n2, C_up, n1, m1);
-  auto         temp_down = matrixTmatrixmul(C_down, n1, m1, S, m2, n2);
-  auto         O_down    = matrixmatrixmul(temp_down, n1, n2, C_down, n1, m1);
+  auto         temp_up   = matrixTmatrixmul(C_up, m1, n1, S, m2, n2);
+  auto         O_up      = matrixmatrixmul(temp_up, n1, n2, C_up, m1, n1);
+  auto         temp_down = matrixTmatrixmul(C_down, m1, n1, S, m2, n2);
+  auto         O_down    = matrixmatrixmul(temp_down, n1, n2, C_down, m1, n1);
   double       TSF_up    = 0.0;
   double       CSF_up    = 0.0;
   double       fCSF_up   = 0.0;
@@ -523,7 +887,7 @@ pCOHPvsEnergyTest(std::vector<double>        epsvalues,
   return pCOHPvalues;
 }
 // can use auto pCOHPvector to collect the return vector
-void
+spillFactors
 spillFactorsofProjectionwithCS(const std::vector<std::complex<double>> &C,
                                const std::vector<std::complex<double>> &S,
                                const std::vector<double> &occupationNum,
@@ -532,12 +896,10 @@ spillFactorsofProjectionwithCS(const std::vector<std::complex<double>> &C,
                                int                        m2,
                                int                        n2)
 {
-  int                 N = n1;
-  //std::vector<std::complex<double>> S(m2 * n2, std::complex<double> (0.0, 0.0));
-  int                 count = 0;
+  int N = n1;
 
-  auto         temp                = matrixTmatrixmul(C, n1, m1, S, m2, n2);
-  auto         O                   = matrixmatrixmul(temp, n1, n2, C, n1, m1);
+  auto         temp                = matrixTmatrixmul(C, m1, n1, S, m2, n2);
+  auto         O                   = matrixmatrixmul(temp, n1, n2, C, m1, n1);
   double       TSF                 = 0.0;
   double       CSF                 = 0.0;
   double       fCSF                = 0.0;
@@ -582,4 +944,17 @@ spillFactorsofProjectionwithCS(const std::vector<std::complex<double>> &C,
   std::cout << "CSFabs: " << CSFabs << std::endl;
   std::cout << "fCSF: " << fCSF << std::endl;
   std::cout << "fCSFabs: " << fCSFabs << std::endl;
+
+  spillFactors spillvalues             = {};
+  spillvalues.totalSpilling            = TSF;
+  spillvalues.absTotalSpilling         = TSFabs;
+  spillvalues.occupiedBandsSpilling    = CSF;
+  spillvalues.absOccupiedBandsSpilling = CSFabs;
+  spillvalues.chargeSpilling           = fCSF;
+  spillvalues.absChargeSpilling        = fCSFabs;
+  spillvalues.projectabilities.resize(N);
+  for (int i = 0; i < N; i++)
+    spillvalues.projectabilities[i] = O[i * N + i].real();
+
+  return spillvalues;
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <pipelinedOverlapProjection.h>
+#include <matrixmatrixmul.h>
+#include <dftfeDataTypes.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <complex>
+
+namespace dftfe
+{
+  namespace
+  {
+    double
+    conjugate(const double x)
+    {
+      return x;
+    }
+
+    std::complex<double>
+    conjugate(const std::complex<double> &x)
+    {
+      return std::conj(x);
+    }
+  } // namespace
+
+
+  template <typename T>
+  pipelinedOverlapProjection<T>::pipelinedOverlapProjection(
+    const std::vector<T> &Psi,
+    const unsigned int    nDofs,
+    const unsigned int    nKS,
+    const MPI_Comm &      mpiComm)
+    : d_Psi(Psi)
+    , d_nDofs(nDofs)
+    , d_nKS(nKS)
+    , d_mpiComm(mpiComm)
+    , d_basisDim(0)
+  {
+    AssertThrow(Psi.size() == (std::size_t)nDofs * nKS,
+                dealii::ExcMessage(
+                  "DFT-FE Error: Kohn-Sham orbital values do not match the "
+                  "number of FE nodes and orbitals."));
+  }
+
+
+  template <typename T>
+  pipelinedOverlapProjection<T>::~pipelinedOverlapProjection()
+  {
+    if (!d_overlapRequests.empty())
+      MPI_Waitall(d_overlapRequests.size(),
+                  &d_overlapRequests[0],
+                  MPI_STATUSES_IGNORE);
+    if (!d_projectionRequests.empty())
+      MPI_Waitall(d_projectionRequests.size(),
+                  &d_projectionRequests[0],
+                  MPI_STATUSES_IGNORE);
+  }
+
+
+  template <typename T>
+  void
+  pipelinedOverlapProjection<T>::appendBasis(std::vector<T> &   PhiNew,
+                                             const unsigned int m)
+  {
+    AssertThrow(PhiNew.size() == (std::size_t)d_nDofs * m,
+                dealii::ExcMessage(
+                  "DFT-FE Error: appended basis values do not match the "
+                  "number of FE nodes."));
+    if (m == 0)
+      return;
+
+    const unsigned int n = d_basisDim;
+
+    //
+    // column block [Phi_1 ... Phi_j]^H Phi_j of S, stacked from the products
+    // with the earlier blocks, and the rows Phi_j^H Psi
+    //
+    std::vector<T> overlapBlock((n + m) * m, T(0.0));
+    std::vector<T> projectionBlock(m * d_nKS, T(0.0));
+    if (d_nDofs > 0)
+      {
+        for (unsigned int b = 0; b < d_PhiBlocks.size(); ++b)
+          {
+            const std::vector<T> Sbj = matrixTmatrixmul(
+              d_PhiBlocks[b], d_nDofs, d_blockSizes[b], PhiNew, d_nDofs, m);
+            std::copy(Sbj.begin(),
+                      Sbj.end(),
+                      overlapBlock.begin() + d_blockStarts[b] * m);
+          }
+        const std::vector<T> Sjj =
+          matrixTmatrixmul(PhiNew, d_nDofs, m, PhiNew, d_nDofs, m);
+        std::copy(Sjj.begin(), Sjj.end(), overlapBlock.begin() + n * m);
+        projectionBlock =
+          matrixTmatrixmul(PhiNew, d_nDofs, m, d_Psi, d_nDofs, d_nKS);
+      }
+
+    //
+    // the heap buffers of the blocks keep their addresses when the outer
+    // vectors grow, so the reductions can run in place
+    //
+    d_overlapBlocks.push_back(std::move(overlapBlock));
+    d_projectionBlocks.push_back(std::move(projectionBlock));
+    d_overlapRequests.push_back(MPI_REQUEST_NULL);
+    d_projectionRequests.push_back(MPI_REQUEST_NULL);
+    std::vector<T> &S = d_overlapBlocks.back();
+    std::vector<T> &P = d_projectionBlocks.back();
+    MPI_Iallreduce(MPI_IN_PLACE,
+                   &S[0],
+                   S.size(),
+                   dataTypes::mpi_type_id(&S[0]),
+                   MPI_SUM,
+                   d_mpiComm,
+                   &d_overlapRequests.back());
+    if (d_nKS > 0)
+      MPI_Iallreduce(MPI_IN_PLACE,
+                     &P[0],
+                     P.size(),
+                     dataTypes::mpi_type_id(&P[0]),
+                     MPI_SUM,
+                     d_mpiComm,
+                     &d_projectionRequests.back());
+
+    d_PhiBlocks.push_back(std::move(PhiNew));
+    d_blockSizes.push_back(m);
+    d_blockStarts.push_back(n);
+    d_basisDim += m;
+
+    // many MPI implementations only progress non-blocking collectives
+    // inside MPI calls
+    int flag;
+    MPI_Testall(d_overlapRequests.size(),
+                &d_overlapRequests[0],
+                &flag,
+                MPI_STATUSES_IGNORE);
+    MPI_Testall(d_projectionRequests.size(),
+                &d_projectionRequests[0],
+                &flag,
+                MPI_STATUSES_IGNORE);
+  }
+
+
+  template <typename T>
+  unsigned int
+  pipelinedOverlapProjection<T>::basisDimension() const
+  {
+    return d_basisDim;
+  }
+
+
+  template <typename T>
+  std::vector<T>
+  pipelinedOverlapProjection<T>::overlapMatrix()
+  {
+    if (!d_overlapRequests.empty())
+      MPI_Waitall(d_overlapRequests.size(),
+                  &d_overlapRequests[0],
+                  MPI_STATUSES_IGNORE);
+
+    const unsigned int N = d_basisDim;
+    std::vector<T>     S(N * N, T(0.0));
+    for (unsigned int j = 0; j < d_overlapBlocks.size(); ++j)
+      {
+        const unsigned int m     = d_blockSizes[j];
+        const unsigned int start = d_blockStarts[j];
+        for (unsigned int r = 0; r < start + m; ++r)
+          for (unsigned int c = 0; c < m; ++c)
+            {
+              const T value          = d_overlapBlocks[j][r * m + c];
+              S[r * N + start + c]   = value;
+              S[(start + c) * N + r] = conjugate(value);
+            }
+      }
+    return S;
+  }
+
+
+  template <typename T>
+  std::vector<T>
+  pipelinedOverlapProjection<T>::projections()
+  {
+    if (!d_projectionRequests.empty())
+      MPI_Waitall(d_projectionRequests.size(),
+                  &d_projectionRequests[0],
+                  MPI_STATUSES_IGNORE);
+
+    std::vector<T> P;
+    P.reserve(d_basisDim * d_nKS);
+    for (const auto &block : d_projectionBlocks)
+      P.insert(P.end(), block.begin(), block.end());
+    return P;
+  }
+
+
+  template class pipelinedOverlapProjection<double>;
+  template class pipelinedOverlapProjection<std::complex<double>>;
+
+} // namespace dftfe
@@ -0,0 +1,159 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <populationNeighborList.h>
+
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace dftfe
+{
+  namespace
+  {
+    double
+    distanceToBox(const std::array<double, 3> &x,
+                  const std::array<double, 3> &boxLower,
+                  const std::array<double, 3> &boxUpper)
+    {
+      double distanceSquared = 0.0;
+      for (unsigned int d = 0; d < 3; ++d)
+        {
+          const double outside =
+            std::max(0.0, std::max(boxLower[d] - x[d], x[d] - boxUpper[d]));
+          distanceSquared += outside * outside;
+        }
+      return std::sqrt(distanceSquared);
+    }
+  } // namespace
+
+
+  populationNeighborList::populationNeighborList()
+    : d_referenceBoxLower({0.0, 0.0, 0.0})
+    , d_referenceBoxUpper({0.0, 0.0, 0.0})
+    , d_skin(0.0)
+    , d_numberOfBuilds(0)
+  {}
+
+
+  bool
+  populationNeighborList::update(
+    const std::vector<std::array<double, 3>> &chargePositions,
+    const std::vector<std::vector<int>> &     chargeIdsOfAtoms,
+    const std::vector<double> &               cutoffOfAtoms,
+    const std::array<double, 3> &             boxLower,
+    const std::array<double, 3> &             boxUpper,
+    const double                              skin)
+  {
+    AssertThrow(cutoffOfAtoms.size() == chargeIdsOfAtoms.size(),
+                dealii::ExcMessage(
+                  "DFT-FE Error: radial cutoffs do not match the atoms."));
+    AssertThrow(skin >= 0.0,
+                dealii::ExcMessage(
+                  "DFT-FE Error: neighbor list skin has to be non-negative."));
+
+    bool isOutdated = d_numberOfBuilds == 0 || skin != d_skin ||
+                      chargeIdsOfAtoms != d_referenceChargeIds ||
+                      cutoffOfAtoms != d_referenceCutoffs ||
+                      chargePositions.size() != d_referencePositions.size();
+    if (!isOutdated)
+      {
+        double boxShiftSquared = 0.0;
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            const double shift =
+              std::max(std::abs(boxLower[d] - d_referenceBoxLower[d]),
+                       std::abs(boxUpper[d] - d_referenceBoxUpper[d]));
+            boxShiftSquared += shift * shift;
+          }
+        double maxDisplacementSquared = 0.0;
+        for (unsigned int i = 0; i < chargePositions.size(); ++i)
+          {
+            double displacementSquared = 0.0;
+            for (unsigned int d = 0; d < 3; ++d)
+              {
+                const double displacement =
+                  chargePositions[i][d] - d_referencePositions[i][d];
+                displacementSquared += displacement * displacement;
+              }
+            maxDisplacementSquared =
+              std::max(maxDisplacementSquared, displacementSquared);
+          }
+        isOutdated =
+          std::sqrt(maxDisplacementSquared) + std::sqrt(boxShiftSquared) >
+          d_skin;
+      }
+
+    if (isOutdated)
+      build(chargePositions,
+            chargeIdsOfAtoms,
+            cutoffOfAtoms,
+            boxLower,
+            boxUpper,
+            skin);
+    return isOutdated;
+  }
+
+
+  void
+  populationNeighborList::build(
+    const std::vector<std::array<double, 3>> &chargePositions,
+    const std::vector<std::vector<int>> &     chargeIdsOfAtoms,
+    const std::vector<double> &               cutoffOfAtoms,
+    const std::array<double, 3> &             boxLower,
+    const std::array<double, 3> &             boxUpper,
+    const double                              skin)
+  {
+    d_chargeIdsNearNodes.assign(chargeIdsOfAtoms.size(), std::vector<int>());
+    for (unsigned int iAtom = 0; iAtom < chargeIdsOfAtoms.size(); ++iAtom)
+      for (const int chargeId : chargeIdsOfAtoms[iAtom])
+        {
+          AssertThrow(chargeId >= 0 &&
+                        (unsigned int)chargeId < chargePositions.size(),
+                      dealii::ExcMessage(
+                        "DFT-FE Error: charge id outside the charges."));
+          if (cutoffOfAtoms[iAtom] < 0.0 ||
+              distanceToBox(chargePositions[chargeId], boxLower, boxUpper) <=
+                cutoffOfAtoms[iAtom] + skin)
+            d_chargeIdsNearNodes[iAtom].push_back(chargeId);
+        }
+
+    d_referencePositions = chargePositions;
+    d_referenceChargeIds = chargeIdsOfAtoms;
+    d_referenceCutoffs   = cutoffOfAtoms;
+    d_referenceBoxLower  = boxLower;
+    d_referenceBoxUpper  = boxUpper;
+    d_skin               = skin;
+    ++d_numberOfBuilds;
+  }
+
+
+  const std::vector<int> &
+  populationNeighborList::chargeIdsNearNodes(const unsigned int atomId) const
+  {
+    return d_chargeIdsNearNodes[atomId];
+  }
+
+
+  unsigned int
+  populationNeighborList::numberOfBuilds() const
+  {
+    return d_numberOfBuilds;
+  }
+
+} // namespace dftfe
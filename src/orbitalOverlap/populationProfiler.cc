@@ -0,0 +1,276 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022  The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+#include <populationProfiler.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace dftfe
+{
+  populationProfiler::populationProfiler(const MPI_Comm &mpiComm)
+    : d_mpiComm(mpiComm)
+  {}
+
+
+  populationProfiler::regionData &
+  populationProfiler::getRegion(const std::string &regionName)
+  {
+    auto it = d_regions.find(regionName);
+    if (it == d_regions.end())
+      {
+        d_regionNames.push_back(regionName);
+        it = d_regions.insert({regionName, regionData()}).first;
+      }
+    return it->second;
+  }
+
+
+  double
+  populationProfiler::currentResidentMemoryMB()
+  {
+    dealii::Utilities::System::MemoryStats stats;
+    dealii::Utilities::System::get_memory_stats(stats);
+    return stats.VmRSS / 1024.0;
+  }
+
+
+  void
+  populationProfiler::enter(const std::string &regionName)
+  {
+    regionData &region = getRegion(regionName);
+    AssertThrow(!region.isActive,
+                dealii::ExcMessage("DFT-FE Error: profiler region " +
+                                   regionName + " entered twice."));
+    region.isActive     = true;
+    region.peakMemoryMB = std::max(region.peakMemoryMB,
+                                   currentResidentMemoryMB());
+    region.startTime    = MPI_Wtime();
+  }
+
+
+  void
+  populationProfiler::leave(const std::string &regionName)
+  {
+    const double endTime = MPI_Wtime();
+    regionData & region  = getRegion(regionName);
+    AssertThrow(region.isActive,
+                dealii::ExcMessage("DFT-FE Error: profiler region " +
+                                   regionName + " left without entering."));
+    region.isActive = false;
+    region.wallTime += endTime - region.startTime;
+    region.numCalls += 1;
+    region.peakMemoryMB = std::max(region.peakMemoryMB,
+                                   currentResidentMemoryMB());
+  }
+
+
+  void
+  populationProfiler::addFlops(const std::string &regionName,
+                               const double       flops)
+  {
+    getRegion(regionName).flops += flops;
+  }
+
+
+  void
+  populationProfiler::addBytes(const std::string &regionName,
+                               const double       bytes)
+  {
+    getRegion(regionName).bytes += bytes;
+  }
+
+
+  double
+  populationProfiler::gemmFlops(const double m,
+                                const double n,
+                                const double k,
+                                const bool   isComplex)
+  {
+    return (isComplex ? 8.0 : 2.0) * m * n * k;
+  }
+
+
+  double
+  populationProfiler::gemmBytes(const double m,
+                                const double n,
+                                const double k,
+                                const bool   isComplex)
+  {
+    return (isComplex ? 16.0 : 8.0) * (m * k + k * n + m * n);
+  }
+
+
+  void
+  populationProfiler::writeReport(const std::string &         fileName,
+                                  dealii::ConditionalOStream &pcout) const
+  {
+    const unsigned int thisRank =
+      dealii::Utilities::MPI::this_mpi_process(d_mpiComm);
+    const unsigned int numRanks =
+      dealii::Utilities::MPI::n_mpi_processes(d_mpiComm);
+
+    //
+    // rank zero defines the region list; regions a rank never entered
+    // contribute zeros
+    //
+    std::string namesConcatenated;
+    if (thisRank == 0)
+      for (const auto &name : d_regionNames)
+        namesConcatenated += name + '\n';
+
+    int numChars = namesConcatenated.size();
+    MPI_Bcast(&numChars, 1, MPI_INT, 0, d_mpiComm);
+    namesConcatenated.resize(numChars);
+    MPI_Bcast(&namesConcatenated[0], numChars, MPI_CHAR, 0, d_mpiComm);
+
+    std::vector<std::string> regionNames;
+    std::istringstream       namesStream(namesConcatenated);
+    std::string              name;
+    while (std::getline(namesStream, name))
+      regionNames.push_back(name);
+
+    const unsigned int  numRegions = regionNames.size();
+    std::vector<double> wallTimes(numRegions, 0.0),
+      counters(3 * numRegions, 0.0), peakMemory(numRegions, 0.0);
+    std::vector<unsigned int> numCalls(numRegions, 0);
+    for (unsigned int iRegion = 0; iRegion < numRegions; ++iRegion)
+      {
+        auto it = d_regions.find(regionNames[iRegion]);
+        if (it == d_regions.end())
+          continue;
+        wallTimes[iRegion]        = it->second.wallTime;
+        counters[3 * iRegion + 0] = it->second.flops;
+        counters[3 * iRegion + 1] = it->second.bytes;
+        counters[3 * iRegion + 2] = it->second.wallTime;
+        peakMemory[iRegion]       = it->second.peakMemoryMB;
+        numCalls[iRegion]         = it->second.numCalls;
+      }
+
+    std::vector<double> wallTimesMin(numRegions, 0.0),
+      wallTimesMax(numRegions, 0.0), countersSum(3 * numRegions, 0.0),
+      peakMemoryMax(numRegions, 0.0);
+    std::vector<unsigned int> numCallsMax(numRegions, 0);
+
+    if (numRegions > 0)
+      {
+        MPI_Reduce(wallTimes.data(),
+                   wallTimesMin.data(),
+                   numRegions,
+                   MPI_DOUBLE,
+                   MPI_MIN,
+                   0,
+                   d_mpiComm);
+        MPI_Reduce(wallTimes.data(),
+                   wallTimesMax.data(),
+                   numRegions,
+                   MPI_DOUBLE,
+                   MPI_MAX,
+                   0,
+                   d_mpiComm);
+        MPI_Reduce(counters.data(),
+                   countersSum.data(),
+                   3 * numRegions,
+                   MPI_DOUBLE,
+                   MPI_SUM,
+                   0,
+                   d_mpiComm);
+        MPI_Reduce(peakMemory.data(),
+                   peakMemoryMax.data(),
+                   numRegions,
+                   MPI_DOUBLE,
+                   MPI_MAX,
+                   0,
+                   d_mpiComm);
+        MPI_Reduce(numCalls.data(),
+                   numCallsMax.data(),
+                   numRegions,
+                   MPI_UNSIGNED,
+                   MPI_MAX,
+                   0,
+                   d_mpiComm);
+      }
+
+    if (thisRank != 0)
+      return;
+
+    pcout << std::endl
+          << "Population analysis profile (wall times in s over " << numRanks
+          << " ranks)" << std::endl;
+    pcout << std::left << std::setw(40) << "region" << std::right
+          << std::setw(8) << "calls" << std::setw(12) << "min"
+          << std::setw(12) << "avg" << std::setw(12) << "max" << std::setw(12)
+          << "GFLOP/s" << std::setw(14) << "peak RSS(MB)" << std::endl;
+
+    std::ofstream reportFile(fileName);
+    reportFile << std::setprecision(10);
+    reportFile << "{\n  \"numRanks\": " << numRanks << ",\n  \"regions\": [";
+
+    for (unsigned int iRegion = 0; iRegion < numRegions; ++iRegion)
+      {
+        const double avgTime = countersSum[3 * iRegion + 2] / numRanks;
+        const double gflopsRate =
+          wallTimesMax[iRegion] > 0.0 ?
+            countersSum[3 * iRegion + 0] / wallTimesMax[iRegion] / 1e+9 :
+            0.0;
+
+        pcout << std::left << std::setw(40) << regionNames[iRegion]
+              << std::right << std::setw(8) << numCallsMax[iRegion]
+              << std::setw(12) << std::setprecision(4) << std::fixed
+              << wallTimesMin[iRegion] << std::setw(12) << avgTime
+              << std::setw(12) << wallTimesMax[iRegion] << std::setw(12)
+              << gflopsRate << std::setw(14) << peakMemoryMax[iRegion]
+              << std::endl;
+
+        reportFile << (iRegion == 0 ? "\n" : ",\n") << "    {\"name\": \""
+                   << regionNames[iRegion]
+                   << "\", \"calls\": " << numCallsMax[iRegion]
+                   << ", \"wallTimeMin\": " << wallTimesMin[iRegion]
+                   << ", \"wallTimeAvg\": " << avgTime
+                   << ", \"wallTimeMax\": " << wallTimesMax[iRegion]
+                   << ", \"flops\": " << countersSum[3 * iRegion + 0]
+                   << ", \"bytes\": " << countersSum[3 * iRegion + 1]
+                   << ", \"gflopsPerSecond\": " << gflopsRate
+                   << ", \"peakMemoryMB\": " << peakMemoryMax[iRegion] << "}";
+      }
+    reportFile << "\n  ]\n}\n";
+    reportFile.close();
+  }
+
+
+  populationProfilerScope::populationProfilerScope(
+    populationProfiler &profiler,
+    const std::string & regionName)
+    : d_profiler(profiler)
+    , d_regionName(regionName)
+  {
+    d_profiler.enter(d_regionName);
+  }
+
+
+  populationProfilerScope::~populationProfilerScope()
+  {
+    d_profiler.leave(d_regionName);
+  }
+
+} // namespace dftfe
@@ -0,0 +1,486 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2022 The Regents of the University of Michigan and DFT-FE
+// authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+//
+// checks the population analysis output of a dftfe run in the current
+// directory: the pFOP charges of the log, the pDOS files, bands.bin and
+// wfcProbes.out. The atoms of the input are assumed to be equivalent by
+// symmetries of the finite element mesh, so that their charges and pDOS
+// agree to the solver tolerances.
+//
+// usage: populationOutputRegression log domainVectorsFile kPointFile
+//        probePointsFile numAtoms valenceCharge numProbeBands
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const double hartreeToEv = 27.21138602;
+
+  struct regressionChecks
+  {
+    bool passed = true;
+
+    void
+    check(const std::string &name, const double error, const double tolerance)
+    {
+      const bool ok = std::isfinite(error) && error <= tolerance;
+      std::cout << "  " << (ok ? "PASSED " : "FAILED ") << name
+                << ": error = " << error << " (tolerance " << tolerance << ")"
+                << std::endl;
+      passed = passed && ok;
+    }
+  };
+
+
+  //
+  // rows of whitespace separated numbers, blank lines skipped
+  //
+  std::vector<std::vector<double>>
+  readTable(const std::string &fileName)
+  {
+    std::vector<std::vector<double>> table;
+    std::ifstream                    file(fileName.c_str());
+    std::string                      line;
+    while (std::getline(file, line))
+      {
+        std::istringstream  lineStream(line);
+        std::vector<double> row;
+        double              value;
+        while (lineStream >> value)
+          row.push_back(value);
+        if (!row.empty())
+          table.push_back(row);
+      }
+    return table;
+  }
+
+
+  //
+  // the (gross population, charge) of every atom from the last pFOP block of
+  // the log
+  //
+  std::vector<std::vector<double>>
+  readPfopCharges(const std::string &logFileName, const unsigned int numAtoms)
+  {
+    std::vector<std::vector<double>> charges;
+    std::ifstream                    file(logFileName.c_str());
+    std::string                      line;
+    while (std::getline(file, line))
+      if (line.find("Mulliken charges of the projected occupied bands") !=
+          std::string::npos)
+        {
+          charges.assign(numAtoms, std::vector<double>());
+          for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+            {
+              unsigned int atomId = numAtoms;
+              double       grossPopulation, charge;
+              if (!std::getline(file, line))
+                break;
+              std::istringstream lineStream(line);
+              if (lineStream >> atomId >> grossPopulation >> charge &&
+                  atomId < numAtoms)
+                charges[atomId] = {grossPopulation, charge};
+            }
+        }
+    return charges;
+  }
+
+
+  void
+  checkPfopCharges(const std::string &logFileName,
+                   const unsigned int numAtoms,
+                   const double       valenceCharge,
+                   const double       numElectrons,
+                   regressionChecks & checks)
+  {
+    std::cout << "pFOP charges of " << logFileName << std::endl;
+    const std::vector<std::vector<double>> charges =
+      readPfopCharges(logFileName, numAtoms);
+    double missing = charges.size() == numAtoms ? 0.0 : numAtoms;
+    for (const std::vector<double> &atomCharges : charges)
+      missing += atomCharges.size() == 2 ? 0.0 : 1.0;
+    checks.check("charges of all atoms in the log", missing, 0.0);
+    if (missing > 0.0)
+      return;
+
+    double chargeSumError = 0.0, equivalenceError = 0.0,
+           totalPopulation = 0.0, minPopulation = charges[0][0];
+    for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+      {
+        chargeSumError =
+          std::max(chargeSumError,
+                   std::abs(charges[iAtom][0] + charges[iAtom][1] -
+                            valenceCharge));
+        equivalenceError =
+          std::max(equivalenceError,
+                   std::abs(charges[iAtom][1] - charges[0][1]));
+        totalPopulation += charges[iAtom][0];
+        minPopulation = std::min(minPopulation, charges[iAtom][0]);
+      }
+    checks.check("gross population plus charge is the valence charge",
+                 chargeSumError,
+                 1e-6);
+    checks.check("charges of the equivalent atoms", equivalenceError, 1e-4);
+    checks.check("gross populations are positive",
+                 std::max(0.0, -minPopulation),
+                 0.0);
+    // the projections of the bands hold at most their electrons
+    checks.check("gross populations within the occupied electrons",
+                 std::max(0.0, totalPopulation - numElectrons) / numElectrons,
+                 1e-6);
+  }
+
+
+  struct bandFileData
+  {
+    bool                valid = false;
+    std::int32_t        version, numSpins, numBands, numKPoints;
+    double              fermiEnergies[2];
+    std::vector<double> records;
+  };
+
+
+  bandFileData
+  readBandFile(const std::string &fileName)
+  {
+    bandFileData  data;
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    char          tag[8];
+    std::int32_t  sizes[4];
+    if (!file.read(tag, 8) || std::strncmp(tag, "DFTFEBND", 8) != 0 ||
+        !file.read(reinterpret_cast<char *>(sizes), sizeof(sizes)) ||
+        !file.read(reinterpret_cast<char *>(data.fermiEnergies),
+                   sizeof(data.fermiEnergies)))
+      return data;
+    data.version    = sizes[0];
+    data.numSpins   = sizes[1];
+    data.numBands   = sizes[2];
+    data.numKPoints = sizes[3];
+    if (data.numSpins < 1 || data.numSpins > 2 || data.numBands < 1 ||
+        data.numKPoints < 1)
+      return data;
+
+    const std::size_t numDoubles =
+      (std::size_t)data.numKPoints * (4 + 2 * data.numSpins * data.numBands);
+    data.records.resize(numDoubles);
+    data.valid = (bool)file.read(reinterpret_cast<char *>(&data.records[0]),
+                                 numDoubles * sizeof(double)) &&
+                 file.peek() == std::ifstream::traits_type::eof();
+    return data;
+  }
+
+
+  //
+  // k-point weighted occupations of the band file, two electrons per level
+  // without spin polarization
+  //
+  double
+  numberOfElectrons(const bandFileData &bands)
+  {
+    const unsigned int numBands      = bands.numBands;
+    const unsigned int recordDoubles = 4 + 2 * bands.numSpins * numBands;
+    double             numElectrons  = 0.0;
+    for (int kPoint = 0; kPoint < bands.numKPoints; ++kPoint)
+      {
+        const double *record = &bands.records[kPoint * recordDoubles];
+        for (int spin = 0; spin < bands.numSpins; ++spin)
+          for (unsigned int iWave = 0; iWave < numBands; ++iWave)
+            numElectrons += (2.0 / bands.numSpins) * record[3] *
+                            record[4 + (2 * spin + 1) * numBands + iWave];
+      }
+    return numElectrons;
+  }
+
+
+  //
+  // reciprocal lattice vectors b_i = 2 pi (a_j x a_k) / (a_i . (a_j x a_k))
+  //
+  std::vector<std::vector<double>>
+  reciprocalVectors(const std::vector<std::vector<double>> &latticeVectors)
+  {
+    std::vector<std::vector<double>> reciprocal(3, std::vector<double>(3));
+    for (unsigned int i = 0; i < 3; ++i)
+      {
+        const std::vector<double> &a = latticeVectors[(i + 1) % 3];
+        const std::vector<double> &b = latticeVectors[(i + 2) % 3];
+        const double cross[3] = {a[1] * b[2] - a[2] * b[1],
+                                 a[2] * b[0] - a[0] * b[2],
+                                 a[0] * b[1] - a[1] * b[0]};
+        const double volume   = latticeVectors[i][0] * cross[0] +
+                              latticeVectors[i][1] * cross[1] +
+                              latticeVectors[i][2] * cross[2];
+        for (unsigned int d = 0; d < 3; ++d)
+          reciprocal[i][d] = 2.0 * M_PI / volume * cross[d];
+      }
+    return reciprocal;
+  }
+
+
+  void
+  checkBandFile(const bandFileData &                    bands,
+                const std::vector<std::vector<double>> &latticeVectors,
+                const std::vector<std::vector<double>> &kPoints,
+                regressionChecks &                      checks)
+  {
+    std::cout << "bands.bin" << std::endl;
+    checks.check("header and size of bands.bin", bands.valid ? 0.0 : 1.0, 0.0);
+    if (!bands.valid)
+      return;
+    checks.check("band file version", std::abs(bands.version - 1), 0.0);
+    checks.check("k-points of bands.bin and the k-point file",
+                 std::abs(bands.numKPoints - (double)kPoints.size()),
+                 0.0);
+    if (bands.numKPoints != (std::int32_t)kPoints.size())
+      return;
+
+    const std::vector<std::vector<double>> reciprocal =
+      reciprocalVectors(latticeVectors);
+    const unsigned int numBands      = bands.numBands;
+    const unsigned int recordDoubles = 4 + 2 * bands.numSpins * numBands;
+    double coordinateError = 0.0, weightError = 0.0, orderError = 0.0,
+           occupationError = 0.0, emptyRecords = 0.0;
+    for (unsigned int kPoint = 0; kPoint < kPoints.size(); ++kPoint)
+      {
+        const double *record = &bands.records[kPoint * recordDoubles];
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            double coordinate = 0.0;
+            for (unsigned int i = 0; i < 3; ++i)
+              coordinate += kPoints[kPoint][i] * reciprocal[i][d];
+            coordinateError =
+              std::max(coordinateError, std::abs(record[d] - coordinate));
+          }
+        weightError =
+          std::max(weightError, std::abs(record[3] - kPoints[kPoint][3]));
+
+        // unwritten records are zeros, written ones have nonzero levels
+        double maxAbsLevel = 0.0;
+        for (int spin = 0; spin < bands.numSpins; ++spin)
+          {
+            const double *eigenValues  = record + 4 + 2 * spin * numBands;
+            const double *occupations  = eigenValues + numBands;
+            for (unsigned int iWave = 0; iWave < numBands; ++iWave)
+              {
+                maxAbsLevel =
+                  std::max(maxAbsLevel, std::abs(eigenValues[iWave]));
+                if (iWave > 0)
+                  orderError =
+                    std::max(orderError,
+                             eigenValues[iWave - 1] - eigenValues[iWave]);
+                occupationError =
+                  std::max(occupationError,
+                           std::max(-occupations[iWave],
+                                    occupations[iWave] - 1.0));
+                // occupations follow the Fermi energy of the header
+                if (iWave > 0 && eigenValues[iWave] > eigenValues[iWave - 1])
+                  occupationError =
+                    std::max(occupationError,
+                             occupations[iWave] - occupations[iWave - 1]);
+              }
+            if (eigenValues[0] < bands.fermiEnergies[spin])
+              occupationError =
+                std::max(occupationError, 0.5 - occupations[0]);
+          }
+        if (maxAbsLevel == 0.0)
+          emptyRecords += 1.0;
+      }
+    checks.check("records of all k-points written", emptyRecords, 0.0);
+    checks.check("Cartesian k-point coordinates", coordinateError, 1e-10);
+    checks.check("k-point weights", weightError, 1e-10);
+    checks.check("eigenvalues in ascending order", orderError, 1e-10);
+    checks.check("occupations", occupationError, 1e-12);
+  }
+
+
+  void
+  checkPdos(const unsigned int  numAtoms,
+            const bandFileData &bands,
+            regressionChecks &  checks)
+  {
+    std::cout << "pdosOutputFolder" << std::endl;
+    std::vector<std::vector<std::vector<double>>> pdos(numAtoms);
+    double                                        layoutError = 0.0;
+    for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+      {
+        pdos[iAtom] = readTable("pdosOutputFolder/pdosData_" +
+                                std::to_string(iAtom));
+        if (pdos[iAtom].empty() || pdos[iAtom][0].size() < 2)
+          layoutError += 1.0;
+        else if (pdos[iAtom].size() != pdos[0].size())
+          layoutError += 1.0;
+        else
+          for (const std::vector<double> &row : pdos[iAtom])
+            layoutError += row.size() == pdos[0][0].size() ? 0.0 : 1.0;
+      }
+    checks.check("pDOS files of all atoms with equal layout", layoutError, 0.0);
+    if (layoutError > 0.0)
+      return;
+
+    //
+    // equivalent atoms up to 2 eV above the Fermi energy, where no
+    // degenerate levels are cut off by the number of wavefunctions
+    //
+    const double maxEnergy =
+      (bands.valid ? bands.fermiEnergies[0] * hartreeToEv : 0.0) + 2.0;
+    double maxPdos = 0.0, negativeError = 0.0, orderError = 0.0,
+           equivalenceError = 0.0;
+    for (unsigned int iAtom = 0; iAtom < numAtoms; ++iAtom)
+      for (unsigned int epsInt = 0; epsInt < pdos[iAtom].size(); ++epsInt)
+        {
+          const std::vector<double> &row = pdos[iAtom][epsInt];
+          if (epsInt > 0)
+            orderError = std::max(orderError,
+                                  pdos[iAtom][epsInt - 1][0] - row[0] + 1e-12);
+          for (unsigned int column = 1; column < row.size(); ++column)
+            {
+              if (!std::isfinite(row[column]))
+                negativeError = INFINITY;
+              maxPdos       = std::max(maxPdos, row[column]);
+              negativeError = std::max(negativeError, -row[column]);
+              if (row[0] <= maxEnergy)
+                equivalenceError =
+                  std::max(equivalenceError,
+                           std::abs(row[column] - pdos[0][epsInt][column]));
+            }
+        }
+    checks.check("pDOS energies in ascending order", orderError, 0.0);
+    checks.check("pDOS is finite and not negative", negativeError, 1e-12);
+    checks.check("pDOS is not zero", maxPdos > 0.0 ? 0.0 : 1.0, 0.0);
+    checks.check("pDOS of the equivalent atoms",
+                 equivalenceError / std::max(maxPdos, 1e-300),
+                 1e-3);
+  }
+
+
+  //
+  // the probe points come in pairs, the first pair duplicated and the others
+  // opposite points of the periodic faces of the domain with equal moduli
+  // of the Bloch waves
+  //
+  void
+  checkWavefunctionProbes(const std::vector<std::vector<double>> &points,
+                          const unsigned int numKPoints,
+                          const unsigned int numSpins,
+                          const unsigned int numProbeBands,
+                          regressionChecks & checks)
+  {
+    std::cout << "wfcProbes.out" << std::endl;
+    const std::vector<std::vector<double>> probes = readTable("wfcProbes.out");
+    const unsigned int                     numColumns =
+      3 + 2 * numKPoints * numSpins * numProbeBands;
+    double layoutError = probes.size() == points.size() ? 0.0 : 1.0;
+    for (const std::vector<double> &row : probes)
+      layoutError += row.size() == numColumns ? 0.0 : 1.0;
+    checks.check("rows and columns of wfcProbes.out", layoutError, 0.0);
+    if (layoutError > 0.0)
+      return;
+
+    double pointError = 0.0, finiteError = 0.0, maxModulus = 0.0;
+    for (unsigned int point = 0; point < points.size(); ++point)
+      for (unsigned int column = 0; column < numColumns; ++column)
+        {
+          if (!std::isfinite(probes[point][column]))
+            finiteError += 1.0;
+          if (column < 3)
+            pointError = std::max(pointError,
+                                  std::abs(probes[point][column] -
+                                           points[point][column]));
+          else
+            maxModulus = std::max(maxModulus, std::abs(probes[point][column]));
+        }
+    checks.check("probe point coordinates", pointError, 1e-8);
+    checks.check("probe values are finite", finiteError, 0.0);
+    checks.check("probe values are not zero",
+                 maxModulus > 0.0 ? 0.0 : 1.0,
+                 0.0);
+
+    double duplicateError = 0.0, periodicError = 0.0;
+    for (unsigned int column = 3; column < numColumns; ++column)
+      duplicateError = std::max(duplicateError,
+                                std::abs(probes[0][column] -
+                                         probes[1][column]));
+    for (unsigned int point = 2; point + 1 < points.size(); point += 2)
+      for (unsigned int column = 3; column < numColumns; column += 2)
+        periodicError =
+          std::max(periodicError,
+                   std::abs(std::hypot(probes[point][column],
+                                       probes[point][column + 1]) -
+                            std::hypot(probes[point + 1][column],
+                                       probes[point + 1][column + 1])));
+    checks.check("duplicated probe points", duplicateError, 0.0);
+    checks.check("probe points on opposite periodic faces",
+                 periodicError / maxModulus,
+                 1e-6);
+  }
+} // namespace
+
+
+int
+main(int argc, char *argv[])
+{
+  if (argc < 8)
+    {
+      std::cerr << "usage: " << argv[0]
+                << " log domainVectorsFile kPointFile probePointsFile"
+                   " numAtoms valenceCharge numProbeBands"
+                << std::endl;
+      return 1;
+    }
+  const std::string  logFileName     = argv[1];
+  const unsigned int numAtoms        = std::atoi(argv[5]);
+  const double       valenceCharge   = std::atof(argv[6]);
+  const unsigned int numProbeBands   = std::atoi(argv[7]);
+  const std::vector<std::vector<double>> latticeVectors = readTable(argv[2]);
+  const std::vector<std::vector<double>> kPoints        = readTable(argv[3]);
+  const std::vector<std::vector<double>> probePoints    = readTable(argv[4]);
+
+  regressionChecks   checks;
+  const bandFileData bands = readBandFile("bands.bin");
+  checkBandFile(bands, latticeVectors, kPoints, checks);
+
+  checkPfopCharges(logFileName,
+                   numAtoms,
+                   valenceCharge,
+                   bands.valid ? numberOfElectrons(bands) :
+                                 numAtoms * valenceCharge,
+                   checks);
+
+  checkPdos(numAtoms, bands, checks);
+
+  checkWavefunctionProbes(probePoints,
+                          kPoints.size(),
+                          bands.valid ? bands.numSpins : 1,
+                          numProbeBands,
+                          checks);
+
+  std::cout << std::endl
+            << (checks.passed ? "Population output regression PASSED" :
+                                "Population output regression FAILED")
+            << std::endl;
+  return checks.passed ? 0 : 1;
+}
@@ -149,25 +149,97 @@ namespace dftfe
           Patterns::Bool(),
           "[Standard] Writes DFT ground state electron-density solution fields (FEM mesh nodal values) to densityOutput.vtu file for visualization purposes. The electron-density solution field in densityOutput.vtu is named density. In case of spin-polarized calculation, two additional solution fields- density\_0 and density\_1 are also written where 0 and 1 denote the spin indices. In the case of geometry optimization, the electron-density corresponding to the last ground-state solve is written. Default: false.");
 
+        prm.declare_entry(
+          "FIELD OUTPUT FORMAT",
+          "VTU",
+          Patterns::Selection("VTU|PARALLEL VTU|HDF5"),
+          "[Standard] File format of WRITE WFC and WRITE DENSITY. VTU writes one vtu file per processor of the domain decomposition together with pvtu and visit records. PARALLEL VTU writes a single vtu file (single precision) per output with MPI-IO. HDF5 writes a single h5 file (double precision) per output with parallel HDF5 together with an xdmf record, and requires deal.II with HDF5. With PARALLEL VTU and HDF5 the band groups split the wavefunctions between them, and the wavefunctions of all k point pools and band groups are gathered into a single file written by the first pool and band group. Default: VTU.");
+
+        prm.declare_entry(
+          "FIELD OUTPUT COMPRESSION",
+          "BEST",
+          Patterns::Selection("NONE|SPEED|DEFAULT|BEST"),
+          "[Advanced] zlib compression level of the VTU and PARALLEL VTU output: no compression, best speed, the zlib default or best compression. Default: BEST.");
+
+        prm.declare_entry(
+          "WFC OUTPUT ENERGY MIN",
+          "0.0",
+          Patterns::Double(),
+          "[Standard] Lower end (Hartree) of the energy window relative to the Fermi energy of the wavefunctions written by WRITE WFC. A wavefunction index is written if the eigenvalue of any k point and spin lies in the window. Only used if less than WFC OUTPUT ENERGY MAX, otherwise all wavefunctions are written. Default: 0.0.");
+
+        prm.declare_entry(
+          "WFC OUTPUT ENERGY MAX",
+          "0.0",
+          Patterns::Double(),
+          "[Standard] Upper end (Hartree) of the energy window relative to the Fermi energy of the wavefunctions written by WRITE WFC, see WFC OUTPUT ENERGY MIN. Default: 0.0.");
+
 
 
         prm.declare_entry(
           "WRITE DENSITY OF STATES",
           "false",
           Patterns::Bool(),
-          "[Standard] Computes density of states using Lorentzians. Uses specified Temperature for SCF as the broadening parameter. Outputs a file name 'dosData.out' containing two columns with first column indicating the energy in eV and second column indicating the density of states");
+          "[Standard] Computes density of states, broadened as set by DOS BROADENING TYPE and DOS BROADENING WIDTH (Lorentzians with the SCF temperature as width by default), or with the linear tetrahedron method if DOS TETRAHEDRON is set. Outputs a file name 'dosData.out' containing two columns with first column indicating the energy in eV and second column indicating the density of states (one column per spin in the spin-polarized case). The levels of all k-points of all pools are weighted by the k-point weights. Also outputs a file name 'integrated_dosData.out' with the energy in eV, the energy relative to the Fermi energy in eV and the integrated density of states (number of states up to the energy, one column per spin), and prints the integrated density of states at the Fermi energy.");
 
         prm.declare_entry(
           "WRITE LOCAL DENSITY OF STATES",
           "false",
           Patterns::Bool(),
-          "[Standard] Computes local density of states on each atom using Lorentzians. Uses specified Temperature for SCF as the broadening parameter. Outputs a file name 'ldosData.out' containing NUMATOM+1 columns with first column indicating the energy in eV and all other NUMATOM columns indicating local density of states for each of the NUMATOM atoms.");
+          "[Standard] Computes local density of states on each atom, broadened as set by DOS BROADENING TYPE and DOS BROADENING WIDTH (Lorentzians with the SCF temperature as width by default). Outputs a file name 'ldosData.out' containing NUMATOM+1 columns with first column indicating the energy in eV and all other NUMATOM columns indicating local density of states for each of the NUMATOM atoms.");
 
         prm.declare_entry(
           "WRITE PROJECTED DENSITY OF STATES",
           "false",
           Patterns::Bool(),
-          "[Standard] Computes projected density of states on each atom using Lorentzians. Uses specified Temperature for SCF as the broadening parameter. Outputs a file name 'pdosData\_x' with x denoting atomID. This file contains columns with first column indicating the energy in eV and all other columns indicating projected density of states corresponding to single atom wavefunctions.");
+          "[Standard] Computes projected density of states on each atom, broadened as set by DOS BROADENING TYPE and DOS BROADENING WIDTH (Lorentzians with the SCF temperature as width by default). Outputs a file name 'pdosData\_x' with x denoting atomID. This file contains columns with first column indicating the energy in eV and all other columns indicating projected density of states corresponding to single atom wavefunctions, k-point weighted. For spin-polarized problems the spin up columns of all single atom wavefunctions are followed by their spin down columns.");
+
+        prm.declare_entry(
+          "DOS BROADENING TYPE",
+          "LORENTZIAN",
+          Patterns::Selection("LORENTZIAN|GAUSSIAN|METHFESSEL-PAXTON"),
+          "[Advanced] Kernel broadening the energy levels in the total, local and projected density of states. The kernel is truncated at DOS KERNEL CUTOFF widths from the level, so that every level only touches the energy grid points nearby. Default: LORENTZIAN.");
+
+        prm.declare_entry(
+          "DOS BROADENING WIDTH",
+          "0.0",
+          Patterns::Double(0.0),
+          "[Advanced] Width (Hartree) of the DOS broadening: the half width of the Lorentzian, the standard deviation of the Gaussian and sigma of exp(-(E/sigma)^2) of the Methfessel-Paxton kernel. Default: 0.0, the SCF temperature times the Boltzmann constant.");
+
+        prm.declare_entry(
+          "DOS METHFESSEL PAXTON ORDER",
+          "1",
+          Patterns::Integer(0),
+          "[Advanced] Order of the Methfessel-Paxton DOS broadening, order 0 is a Gaussian. Default: 1.");
+
+        prm.declare_entry(
+          "DOS KERNEL CUTOFF",
+          "0.0",
+          Patterns::Double(0.0),
+          "[Advanced] Distance, in units of DOS BROADENING WIDTH, beyond which the DOS broadening kernel is set to zero. The truncated Lorentzian and Gaussian are rescaled to unit weight. Default: 0.0, 100 widths for the Lorentzian and 8 widths for the other kernels.");
+
+        prm.declare_entry(
+          "DOS ENERGY SPACING",
+          "0.001",
+          Patterns::Double(1e-8),
+          "[Advanced] Spacing (Hartree) of the energy grid of the density of states. Default: 0.001.");
+
+        prm.declare_entry(
+          "DOS ENERGY MIN",
+          "0.0",
+          Patterns::Double(),
+          "[Advanced] Lower end (Hartree) of the energy grid of the density of states. Only used if less than DOS ENERGY MAX, otherwise the grid spans 1.5 times the lowest to 1.5 times the highest eigenvalue. Default: 0.0.");
+
+        prm.declare_entry(
+          "DOS ENERGY MAX",
+          "0.0",
+          Patterns::Double(),
+          "[Advanced] Upper end (Hartree) of the energy grid of the density of states, see DOS ENERGY MIN. Default: 0.0.");
+
+        prm.declare_entry(
+          "DOS TETRAHEDRON",
+          "false",
+          Patterns::Bool(),
+          "[Advanced] Total density of states of the Monkhorst-Pack grid of k-points with the linear tetrahedron method instead of broadening. The bands of the irreducible k-points of all pools are mapped to the full grid, every grid subcell is split into 6 tetrahedra along its shortest diagonal, and the DOS at an energy grid point is the number of states in its interval divided by DOS ENERGY SPACING. Requires the k-points of the Monkhorst-Pack grid, not of a k-point file. Default: false.");
 
         prm.declare_entry(
           "READ ATOMIC WFC PDOS FROM PSP FILE",
@@ -179,7 +251,25 @@ namespace dftfe
           "WRITE LOCALIZATION LENGTHS",
           "false",
           Patterns::Bool(),
-          "[Standard] Computes localization lengths of all wavefunctions which is defined as the deviation around the mean position of a given wavefunction. Outputs a file name 'localizationLengths.out' containing 2 columns with first column indicating the wavefunction index and second column indicating localization length of the corresponding wavefunction.");
+          "[Standard] Computes localization lengths of all wavefunctions which is defined as the deviation around the mean position of a given wavefunction. Outputs a file name 'localizationLengths.out' with first column indicating the wavefunction index and one column per k-point and spin (k-point major) indicating localization length of the corresponding wavefunction.");
+
+        prm.declare_entry(
+          "WFC PROBE POINTS FILE",
+          "",
+          Patterns::Anything(),
+          "[Standard] File with the Cartesian coordinates (Bohr) of points, one point per line, at which the wavefunctions WFC PROBE BAND START to WFC PROBE BAND START + WFC PROBE NUMBER OF BANDS - 1 of all k-points and spins are evaluated, for instance along a line or on a plane for STM-like images and bonding plots. Outputs a file name 'wfcProbes.out' with one line per point: the point followed by one column per k-point, spin (k-point major) and wavefunction (two columns, real and imaginary part, in the complex case). For non-zero k-points these are the periodic parts of the Bloch wavefunctions. Points outside the domain get zeros. No evaluation if empty. Default: empty.");
+
+        prm.declare_entry(
+          "WFC PROBE BAND START",
+          "0",
+          Patterns::Integer(0),
+          "[Standard] Index of the first wavefunction evaluated at the points of WFC PROBE POINTS FILE. Default: 0.");
+
+        prm.declare_entry(
+          "WFC PROBE NUMBER OF BANDS",
+          "0",
+          Patterns::Integer(0),
+          "[Standard] Number of wavefunctions evaluated at the points of WFC PROBE POINTS FILE, all wavefunctions from WFC PROBE BAND START on if zero. Default: 0.");
 
         prm.declare_entry("NUMBER OF PROJECTED KS ORBITALS",
                           "1",
@@ -200,6 +290,78 @@ namespace dftfe
           "0",
           Patterns::Integer(0),
           "[Standard] Parameter that selects the atomic orbital basis function 0: Pseudoatomic basis 1: BungeOrbitals basis");
+
+        prm.declare_entry(
+          "OVERLAP EIGENVALUE THRESHOLD",
+          "0.0",
+          Patterns::Double(0.0),
+          "[Advanced] Eigenvalues of the atomic orbital overlap matrix below or equal to this threshold are discarded in the population analysis, which is then carried out in the reduced canonically orthogonalized basis. Removes near linear dependencies of diffuse basis sets instead of raising the tiny eigenvalues to negative powers. Default: 0.0, only non-positive eigenvalues are discarded.");
+
+        prm.declare_entry(
+          "BASIS AUGMENTATION FILE",
+          "",
+          Patterns::Anything(),
+          "[Advanced] File with lines of atomic number, n and l in the format of BasisInfo.inp. If provided, the basis of BasisInfo.inp is augmented one shell at a time by these lines, appending the shell to all atoms of that atomic number, and the spill factors after every step are written to basisAugmentationScan.txt. Only the new basis blocks are evaluated and projected in every step. Not implemented for spin polarized calculations. Default: empty, no scan.");
+
+        prm.declare_entry(
+          "POPULATION PDOS WEIGHTS",
+          "NONE",
+          Patterns::Selection("NONE|LOWDIN|MULLIKEN"),
+          "[Standard] With COMPUTE PFOP, orbital resolved projected density of states and fat bands from the coefficients of the projected Kohn-Sham orbitals instead of quadrature. LOWDIN uses the weights |(S^{1/2} C)_{aj}|^2, MULLIKEN the weights Re(C_{aj}^* (S C)_{aj}), C = S^{-1} Phi^H Psi, both summing over the basis to the projectability of band j. The k-point weighted weights of all k-points and spins are broadened as set by DOS BROADENING TYPE and DOS BROADENING WIDTH and written to 'pdosPopulationOutputFolder/pdosData\\_x' (x the atomID, first column the energy in eV and one column per atomic orbital and spin), the per band weights to 'fatBands.txt'. Default: NONE.");
+
+        prm.declare_entry(
+          "WRITE POPULATION FILES",
+          "true",
+          Patterns::Bool(),
+          "[Standard] With COMPUTE PFOP or COMPUTE PFHP, write the population analysis to disk (the overlap, projected Hamiltonian and coefficient matrices, 'energyLevelsOccNums.txt', 'atomWiseAtomicOrbitalInfo.txt', 'projectabilities.txt' and 'populationProfile.json'). The atom charges, atom pair populations, ICOHP and spill factors are always kept in memory and are available from the dftfeWrapper and the MDI engine, so drivers calling the population analysis repeatedly can switch the files off. Default: true.");
+
+        prm.declare_entry(
+          "POPULATION ANALYSIS FREQUENCY",
+          "0",
+          Patterns::Integer(0),
+          "[Standard] Population analysis every N steps of the molecular dynamics (SOLVER MODE = MD) or of the ion and cell relaxation (SOLVER MODE = GEOOPT), 0 switches it off. The atomic orbital basis of 'BasisInfo.inp' and NUMBER OF PROJECTED KS ORBITALS are used as for COMPUTE PFOP. Every analysed step appends a record to the binary time series 'populationTimeSeries.bin': a header of the characters DFTFEPOP, the int32 version 1 and the uint32 number of atoms N written at the start of a trajectory, which replaces the file of an earlier run, while restarted trajectories append to the file of the same atoms, then per record the uint32 step, the double time in fs (0 for relaxations), the doubles TSF, CSF and fCSF, the N atom charges, and the upper triangles (row wise, diagonal included) of the atom pair populations and ICOHP with the off diagonal entries being the bond orders and bond ICOHP (Hartree) of the atom pairs. Default: 0.");
+
+        prm.declare_entry(
+          "POPULATION ENERGY WINDOW MIN",
+          "0.0",
+          Patterns::Double(),
+          "[Standard] Lower end (Hartree) of the energy window relative to the Fermi energy of the pFHOP/pFHHP analysis of COMPUTE PFHP. The Kohn-Sham orbitals with eigenvalues in the window replace the first NUMBER OF PROJECTED KS ORBITALS, and only the eigenpairs of the projected Hamiltonian with eigenvalues in the window are computed, with a distributed subset eigensolver instead of a full diagonalization. Only used if less than POPULATION ENERGY WINDOW MAX. Default: 0.0.");
+
+        prm.declare_entry(
+          "POPULATION ENERGY WINDOW MAX",
+          "0.0",
+          Patterns::Double(),
+          "[Standard] Upper end (Hartree) of the energy window relative to the Fermi energy of the pFHOP/pFHHP analysis, see POPULATION ENERGY WINDOW MIN. Default: 0.0.");
+
+        prm.declare_entry(
+          "POPULATION NEIGHBOR SKIN",
+          "1.0",
+          Patterns::Double(0.0),
+          "[Advanced] Skin distance (Bohr) of the lists of periodic images near the local FE nodes used to evaluate the atomic orbitals of the population analysis. The lists are kept across analyses and only rebuilt once the atoms have moved by more than the skin since the last build. Default: 1.0.");
+
+        prm.declare_entry(
+          "POPULATION PAIR SYMMETRY",
+          "false",
+          Patterns::Bool(),
+          "[Advanced] Evaluate the atom pair populations and ICOHP of the population analysis only for one atom pair of every orbit under the space group operations of the atoms that leave the k-point set invariant, and copy them to the equivalent pairs. Only used for fully periodic, spin unpolarized calculations. The density is assumed to have the symmetry of the atoms, which is not checked, so it should only be set for converged ground states that keep the symmetry. Default: false.");
+
+        prm.declare_entry(
+          "POPULATION PSP ORBITALS",
+          "false",
+          Patterns::Bool(),
+          "[Advanced] Take the radial parts of the pseudo-atomic orbital basis of the population analysis (BASIS TO PROJECT = 0) from the single atom wavefunctions of the pseudopotential (the PP_PSWFC data), which are also used by the projected density of states, instead of the PA_<Z>_<n>_<l>.txt files. The radial tables are read once per run and shared by both, so that running both analyses keeps one basis. Default: false.");
+
+        prm.declare_entry(
+          "POPULATION PROJECTION QUADRATURE",
+          "false",
+          Patterns::Bool(),
+          "[Advanced] Form the overlap matrix of the atomic orbitals and their projections onto the Kohn-Sham orbitals of the population analysis with the density Gauss quadrature of the cells instead of the lumped mass matrix at the FE nodes. The cells are processed in cache sized batches and only the atomic orbitals of the atoms near a batch enter its products. More accurate for coarse meshes, at a higher cost. Default: false.");
+
+        prm.declare_entry(
+          "POPULATION SCF FREQUENCY",
+          "0",
+          Patterns::Integer(0),
+          "[Advanced] Print the Mulliken and Loewdin charges of the atoms from the current Kohn-Sham orbitals every N SCF iterations, 0 switches it off. The atomic orbital basis of 'BasisInfo.inp' and NUMBER OF PROJECTED KS ORBITALS are used as for COMPUTE PFOP. The atomic orbitals at the FE nodes, their overlap matrix and its canonical orthogonalization are computed once per ground state solve and k-point, so an update only costs the projections of the Kohn-Sham orbitals and dense algebra of the size of the basis. Default: 0.");
       }
       prm.leave_subsection();
 
@@ -634,6 +796,12 @@ namespace dftfe
           Patterns::Anything(),
           "[Developer] File providing list of k points on which eigen values are to be computed from converged KS Hamiltonian. The first three columns specify the crystal coordinates of the k points. The fourth column provides weights of the corresponding points, which is currently not used. The eigen values are written on an output file bands.out");
 
+        prm.declare_entry(
+          "BANDS FILE FORMAT",
+          "TEXT",
+          Patterns::Selection("TEXT|BINARY"),
+          "[Developer] Format of the eigen values written for the k points of kPOINT RULE FILE. TEXT gathers them to one processor and writes bands.out. BINARY writes bands.bin with MPI-IO from every k point pool, streaming the k points as the non-selfconsistent solve converges them: a header with the characters DFTFEBND, the int32 values version, number of spins, number of bands and number of k points and the double Fermi energies of spin up and down, followed by one record of doubles per k point with its Cartesian coordinates, weight and, for every spin, the eigen values and occupations (Hartree).");
+
         prm.declare_entry(
           "USE GROUP SYMMETRY",
           "false",
@@ -1177,6 +1345,7 @@ namespace dftfe
     std::string coordinatesFile = "";
     domainBoundingVectorsFile   = "";
     kPointDataFile              = "";
+    bandsFileFormat             = "TEXT";
     ionRelaxFlagsFile           = "";
     orthogType                  = "";
     algoType                    = "";
@@ -1218,6 +1387,10 @@ namespace dftfe
     startingWFCType                                = "";
     writeWfcSolutionFields                         = false;
     writeDensitySolutionFields                     = false;
+    fieldOutputFormat                              = "VTU";
+    fieldOutputCompression                         = "BEST";
+    wfcOutputEnergyMin                             = 0.0;
+    wfcOutputEnergyMax                             = 0.0;
     wfcBlockSize                                   = 400;
     chebyWfcBlockSize                              = 400;
     subspaceRotDofsBlockSize                       = 2000;
@@ -1244,6 +1417,29 @@ namespace dftfe
     bandParalOpt                                   = true;
     autoAdaptBaseMeshSize                          = true;
     readWfcForPdosPspFile                          = false;
+    dosBroadeningType                              = "LORENTZIAN";
+    dosBroadeningWidth                             = 0.0;
+    dosMethfesselPaxtonOrder                       = 1;
+    dosKernelCutoff                                = 0.0;
+    dosEnergySpacing                               = 0.001;
+    dosEnergyMin                                   = 0.0;
+    dosEnergyMax                                   = 0.0;
+    dosTetrahedron                                 = false;
+    wfcProbePointsFile                             = "";
+    wfcProbeBandStart                              = 0;
+    wfcProbeNumberBands                            = 0;
+    overlapEigenvalueThreshold                     = 0.0;
+    basisAugmentationFile                          = "";
+    populationPdosWeights                          = "NONE";
+    writePopulationFiles                           = true;
+    populationAnalysisFrequency                    = 0;
+    populationNeighborSkin                         = 1.0;
+    populationEnergyWindowMin                      = 0.0;
+    populationEnergyWindowMax                      = 0.0;
+    populationPairSymmetry                         = false;
+    populationProjectionQuadrature                 = false;
+    populationPspOrbitals                          = false;
+    populationScfFrequency                         = 0;
     useDevice                                      = false;
     useTF32Device                                  = false;
     deviceFineGrainedTimings                       = false;
@@ -1349,16 +1545,49 @@ namespace dftfe
     {
       writeWfcSolutionFields     = prm.get_bool("WRITE WFC");
       writeDensitySolutionFields = prm.get_bool("WRITE DENSITY");
+      fieldOutputFormat          = prm.get("FIELD OUTPUT FORMAT");
+      fieldOutputCompression     = prm.get("FIELD OUTPUT COMPRESSION");
+      wfcOutputEnergyMin         = prm.get_double("WFC OUTPUT ENERGY MIN");
+      wfcOutputEnergyMax         = prm.get_double("WFC OUTPUT ENERGY MAX");
       writeDosFile               = prm.get_bool("WRITE DENSITY OF STATES");
       writeLdosFile            = prm.get_bool("WRITE LOCAL DENSITY OF STATES");
       writeLocalizationLengths = prm.get_bool("WRITE LOCALIZATION LENGTHS");
       readWfcForPdosPspFile =
         prm.get_bool("READ ATOMIC WFC PDOS FROM PSP FILE");
+      dosBroadeningType  = prm.get("DOS BROADENING TYPE");
+      dosBroadeningWidth = prm.get_double("DOS BROADENING WIDTH");
+      dosMethfesselPaxtonOrder =
+        prm.get_integer("DOS METHFESSEL PAXTON ORDER");
+      dosKernelCutoff  = prm.get_double("DOS KERNEL CUTOFF");
+      dosEnergySpacing = prm.get_double("DOS ENERGY SPACING");
+      dosEnergyMin     = prm.get_double("DOS ENERGY MIN");
+      dosEnergyMax     = prm.get_double("DOS ENERGY MAX");
+      dosTetrahedron   = prm.get_bool("DOS TETRAHEDRON");
+      wfcProbePointsFile  = prm.get("WFC PROBE POINTS FILE");
+      wfcProbeBandStart   = prm.get_integer("WFC PROBE BAND START");
+      wfcProbeNumberBands = prm.get_integer("WFC PROBE NUMBER OF BANDS");
       writeLocalizationLengths = prm.get_bool("WRITE LOCALIZATION LENGTHS");
       NumofKSOrbitalsproj = prm.get_integer("NUMBER OF PROJECTED KS ORBITALS");
       ComputePFOP        = prm.get_bool("COMPUTE PFOP");
       ComputePFHP        = prm.get_bool("COMPUTE PFHP");
       AtomicOrbitalBasis  = prm.get_integer("BASIS TO PROJECT");
+      overlapEigenvalueThreshold =
+        prm.get_double("OVERLAP EIGENVALUE THRESHOLD");
+      basisAugmentationFile = prm.get("BASIS AUGMENTATION FILE");
+      populationPdosWeights = prm.get("POPULATION PDOS WEIGHTS");
+      writePopulationFiles  = prm.get_bool("WRITE POPULATION FILES");
+      populationAnalysisFrequency =
+        prm.get_integer("POPULATION ANALYSIS FREQUENCY");
+      populationNeighborSkin = prm.get_double("POPULATION NEIGHBOR SKIN");
+      populationEnergyWindowMin =
+        prm.get_double("POPULATION ENERGY WINDOW MIN");
+      populationEnergyWindowMax =
+        prm.get_double("POPULATION ENERGY WINDOW MAX");
+      populationPairSymmetry = prm.get_bool("POPULATION PAIR SYMMETRY");
+      populationProjectionQuadrature =
+        prm.get_bool("POPULATION PROJECTION QUADRATURE");
+      populationPspOrbitals = prm.get_bool("POPULATION PSP ORBITALS");
+      populationScfFrequency = prm.get_integer("POPULATION SCF FREQUENCY");
       writePdosFile       = prm.get_bool("WRITE PROJECTED DENSITY OF STATES");
     }
     prm.leave_subsection();
@@ -1483,9 +1712,10 @@ namespace dftfe
       }
       prm.leave_subsection();
 
-      useSymm        = prm.get_bool("USE GROUP SYMMETRY");
-      timeReversal   = prm.get_bool("USE TIME REVERSAL SYMMETRY");
-      kPointDataFile = prm.get("kPOINT RULE FILE");
+      useSymm         = prm.get_bool("USE GROUP SYMMETRY");
+      timeReversal    = prm.get_bool("USE TIME REVERSAL SYMMETRY");
+      kPointDataFile  = prm.get("kPOINT RULE FILE");
+      bandsFileFormat = prm.get("BANDS FILE FORMAT");
     }
     prm.leave_subsection();
 
@@ -215,6 +215,63 @@ namespace dftfe
         }
     }
 
+    void
+    writeDataParallelSingleFile(dealii::DataOut<3> &dataOut,
+                                const MPI_Comm &    mpiCommDomain,
+                                const std::string & folderName,
+                                const std::string & fileName,
+                                const std::string & format,
+                                const std::string & compression)
+    {
+      if (format == "HDF5")
+        {
+#ifdef DEAL_II_WITH_HDF5
+          dealii::DataOutBase::DataOutFilter dataFilter(
+            dealii::DataOutBase::DataOutFilterFlags(true, true));
+          dataOut.write_filtered_data(dataFilter);
+          const std::string h5FileName = fileName + ".h5";
+          dataOut.write_hdf5_parallel(dataFilter,
+                                      folderName + "/" + h5FileName,
+                                      mpiCommDomain);
+          const std::vector<dealii::XDMFEntry> xdmfEntries(
+            1,
+            dataOut.create_xdmf_entry(dataFilter,
+                                      h5FileName,
+                                      0.0,
+                                      mpiCommDomain));
+          dataOut.write_xdmf_file(xdmfEntries,
+                                  folderName + "/" + fileName + ".xdmf",
+                                  mpiCommDomain);
+#else
+          AssertThrow(
+            false,
+            dealii::ExcMessage(
+              "DFT-FE Error: FIELD OUTPUT FORMAT HDF5 requires deal.II with HDF5."));
+#endif
+        }
+      else
+        {
+#if DEAL_II_VERSION_GTE(9, 5, 0)
+          typedef dealii::DataOutBase::CompressionLevel compressionLevel;
+#else
+          typedef dealii::DataOutBase::VtkFlags::ZlibCompressionLevel
+            compressionLevel;
+#endif
+          dealii::DataOutBase::VtkFlags flags;
+          if (compression == "NONE")
+            flags.compression_level = compressionLevel::no_compression;
+          else if (compression == "SPEED")
+            flags.compression_level = compressionLevel::best_speed;
+          else if (compression == "DEFAULT")
+            flags.compression_level = compressionLevel::default_compression;
+          else
+            flags.compression_level = compressionLevel::best_compression;
+          dataOut.set_flags(flags);
+          dataOut.write_vtu_in_parallel(folderName + "/" + fileName + ".vtu",
+                                        mpiCommDomain);
+        }
+    }
+
     void
     createBandParallelizationIndices(
       const MPI_Comm &           interBandGroupComm,